@@ -0,0 +1,59 @@
+#ifndef GATRIX_ACTIVATION_SCHEDULE_H
+#define GATRIX_ACTIVATION_SCHEDULE_H
+
+#include "GatrixTypes.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/** Flag records the server published ahead of their activation time */
+struct ScheduledChange {
+  std::string id;                   // stable per scheduled change; a resend replaces it
+  long long activateAtMs = 0;       // server time (epoch ms)
+  int jitterMs = 0;                 // window each client spreads its activation over
+  bool cancelled = false;           // withdraws an earlier change of the same id
+  std::vector<EvaluatedFlag> flags; // upserted at activation
+  std::vector<std::string> removed; // deleted at activation
+  long long deadlineMs = 0;         // activateAtMs plus this client's jitter offset
+  std::string contextHash;          // context the records were evaluated for
+};
+
+/**
+ * Pending scheduled changes ordered by deadline (a priority queue that also
+ * replaces or withdraws entries by id).
+ *
+ * A live-ops event starting at a fixed time is published minutes ahead; each
+ * client holds the records and applies them at the deadline on its own, so
+ * the start of the event causes no fetches at all.
+ *
+ * Not thread-safe; owned and driven by FeaturesClient on the cocos thread.
+ */
+class ActivationSchedule {
+public:
+  /** Add a change, replacing a pending one of the same id */
+  void put(ScheduledChange change);
+
+  /** Withdraw a pending change; false if none has the id */
+  bool cancel(const std::string& id);
+
+  void clear();
+
+  bool empty() const { return _queue.empty(); }
+  int size() const { return static_cast<int>(_queue.size()); }
+
+  /** Earliest deadline (server epoch ms); only meaningful when not empty */
+  long long nextDeadlineMs() const { return _queue.begin()->first; }
+
+  /** Remove and return the changes due at serverNowMs, in deadline order */
+  std::vector<ScheduledChange> takeDue(long long serverNowMs);
+
+private:
+  std::multimap<long long, ScheduledChange> _queue; // by deadline
+  std::map<std::string, long long> _deadlines;      // id -> deadline of its queue entry
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_ACTIVATION_SCHEDULE_H
@@ -14,9 +14,22 @@ namespace gatrix {
 
 /**
  * GatrixClient - Main entry point for Gatrix SDK (from CLIENT_SDK_SPEC.md)
+ *
+ * getInstance() is the process-wide default client. Further, independently
+ * configured clients (split-screen players, other environments) are
+ * constructed directly; each has its own context, flags and events.
+ * Instances share the HTTP transport of the same backend configuration,
+ * one streaming connection per environment and, per environment, the
+ * context snapshot cache and compiled local-evaluation definitions.
  */
 class GatrixClient {
 public:
+  GatrixClient();
+  ~GatrixClient();
+
+  GatrixClient(const GatrixClient&) = delete;
+  GatrixClient& operator=(const GatrixClient&) = delete;
+
   static GatrixClient* getInstance();
   static const char* sdkName() { return SDK_NAME; }
   static const char* sdkVersion() { return SDK_VERSION; }
@@ -64,9 +77,6 @@ public:
              const std::unordered_map<std::string, std::string>& properties = {});
 
 private:
-  GatrixClient();
-  ~GatrixClient();
-
   /** Internal initialization logic (validates config, creates FeaturesClient) */
   bool initInternal(const GatrixClientConfig& config);
 
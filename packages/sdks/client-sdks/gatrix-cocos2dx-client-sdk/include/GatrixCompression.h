@@ -0,0 +1,66 @@
+#ifndef GATRIX_COMPRESSION_H
+#define GATRIX_COMPRESSION_H
+
+#include <cstddef>
+#include <string>
+
+namespace gatrix {
+
+/**
+ * gzip/deflate helpers backed by the zlib bundled with cocos2d-x.
+ */
+struct GatrixCompression {
+  /** True if the buffer starts with a gzip or zlib (deflate) header. */
+  static bool isCompressed(const char* data, size_t len);
+
+  /** gzip-encode a request body. Returns false on zlib failure. */
+  static bool gzip(const std::string& input, std::string& output);
+};
+
+/**
+ * rapidjson-compatible read stream that inflates gzip or zlib input on
+ * demand, so the parser consumes decompressed bytes chunk by chunk without
+ * materializing the whole document as a string first.
+ *
+ * Usage: InflateStream s(data, len); doc.ParseStream(s);
+ */
+class InflateStream {
+public:
+  typedef char Ch;
+
+  InflateStream(const char* data, size_t len);
+  ~InflateStream();
+
+  InflateStream(const InflateStream&) = delete;
+  InflateStream& operator=(const InflateStream&) = delete;
+
+  Ch Peek() const;
+  Ch Take();
+  size_t Tell() const { return _consumed + _pos; }
+
+  // Write interface (unused, required by rapidjson's Stream concept)
+  Ch* PutBegin() { return nullptr; }
+  void Put(Ch) {}
+  void Flush() {}
+  size_t PutEnd(Ch*) { return 0; }
+
+  bool hasError() const { return _error; }
+  size_t totalOut() const { return _consumed + _len; }
+
+private:
+  bool refill() const;
+
+  static const size_t CHUNK_SIZE = 16 * 1024;
+
+  void* _zs = nullptr; // z_stream (kept opaque to avoid leaking zlib.h)
+  mutable char _buffer[CHUNK_SIZE];
+  mutable size_t _pos = 0;
+  mutable size_t _len = 0;
+  mutable size_t _consumed = 0;
+  mutable bool _finished = false;
+  mutable bool _error = false;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_COMPRESSION_H
@@ -0,0 +1,48 @@
+#ifndef GATRIX_CURL_TRANSPORT_H
+#define GATRIX_CURL_TRANSPORT_H
+
+#include "GatrixTransport.h"
+#include <memory>
+
+namespace gatrix {
+
+/**
+ * ITransport backend on one libcurl multi handle driven by a worker thread.
+ *
+ * Every request goes through the same multi handle, so connections stay
+ * open between fetches and are reused instead of paying a new TCP + TLS
+ * handshake each time; with http2 the requests to a host are multiplexed
+ * over a single connection. The SSE stream runs on its own thread but shares
+ * DNS, TLS sessions and the connection cache with the multi handle (libcurl
+ * share interface), so a reconnect resumes the TLS session.
+ *
+ * Connection setup is measured per request (TransportResponse::timed).
+ * Responses are delivered on the cocos thread. Requests still in flight when
+ * the transport is destroyed are abandoned without a callback.
+ */
+class CurlMultiTransport : public ITransport {
+public:
+  explicit CurlMultiTransport(const HttpConfig& config);
+  ~CurlMultiTransport() override;
+
+  CurlMultiTransport(const CurlMultiTransport&) = delete;
+  CurlMultiTransport& operator=(const CurlMultiTransport&) = delete;
+
+  const char* name() const override { return "curl-multi"; }
+
+  void send(const TransportRequest& request, ResponseCallback callback) override;
+
+  SseReader::Result stream(const std::string& url, const std::vector<std::string>& headers,
+                           const SseReader::OpenCallback& onOpen,
+                           const SseReader::DataCallback& onData,
+                           const SseReader::CancelCheck& isCancelled,
+                           int idleTimeoutSec) override;
+
+private:
+  struct Impl; // libcurl state and the worker thread
+  std::unique_ptr<Impl> _impl;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_CURL_TRANSPORT_H
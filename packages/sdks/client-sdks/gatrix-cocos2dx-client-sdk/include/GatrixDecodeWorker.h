@@ -0,0 +1,53 @@
+#ifndef GATRIX_DECODE_WORKER_H
+#define GATRIX_DECODE_WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace gatrix {
+
+/**
+ * DecodeWorker - one background thread that inflates and parses response
+ * bodies off the cocos thread, shared by every FeaturesClient in the
+ * process.
+ *
+ * Tasks run one at a time in the order they were posted. The thread starts
+ * with the first task, so clients that never decode in the background never
+ * start it. A task must not touch its client: it hands the result back with
+ * performFunctionInCocosThread, where the client's alive token is checked.
+ *
+ * post() is thread-safe; acquire() is called on the cocos thread.
+ */
+class DecodeWorker {
+public:
+  using Task = std::function<void()>;
+
+  /** The process-wide worker. Created on first use, destroyed with its last user. */
+  static std::shared_ptr<DecodeWorker> acquire();
+
+  DecodeWorker() = default;
+  /** Drops tasks not started yet and waits for the running one */
+  ~DecodeWorker();
+
+  DecodeWorker(const DecodeWorker&) = delete;
+  DecodeWorker& operator=(const DecodeWorker&) = delete;
+
+  void post(Task task);
+
+private:
+  void run();
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::deque<Task> _tasks;
+  bool _stopping = false;
+  std::thread _thread;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_DECODE_WORKER_H
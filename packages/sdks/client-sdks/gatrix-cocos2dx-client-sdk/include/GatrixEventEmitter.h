@@ -68,6 +68,20 @@ public:
     return stats;
   }
 
+  static std::string nowISO() {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    char buf[64];
+    struct tm timeinfo;
+#ifdef _WIN32
+    gmtime_s(&timeinfo, &time_t);
+#else
+    gmtime_r(&time_t, &timeinfo);
+#endif
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
+    return std::string(buf);
+  }
+
 private:
   struct Listener {
     GatrixEventCallback callback;
@@ -91,20 +105,6 @@ private:
       return name;
     return "listener_" + std::to_string(++_autoNameCount);
   }
-
-  static std::string nowISO() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    char buf[64];
-    struct tm timeinfo;
-#ifdef _WIN32
-    gmtime_s(&timeinfo, &time_t);
-#else
-    gmtime_r(&time_t, &timeinfo);
-#endif
-    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
-    return std::string(buf);
-  }
 };
 
 } // namespace gatrix
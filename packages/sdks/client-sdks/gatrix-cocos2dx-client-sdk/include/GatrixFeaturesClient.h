@@ -1,14 +1,30 @@
 #ifndef GATRIX_FEATURES_CLIENT_H
 #define GATRIX_FEATURES_CLIENT_H
 
+#include "GatrixActivationSchedule.h"
+#include "GatrixDecodeWorker.h"
 #include "GatrixEventEmitter.h"
 #include "GatrixEvents.h"
+#include "GatrixFlagDiff.h"
 #include "GatrixFlagProxy.h"
+#include "GatrixInterestSet.h"
+#include "GatrixInvalidationCoalescer.h"
+#include "GatrixLocalEvaluator.h"
+#include "GatrixPollingScheduler.h"
+#include "GatrixSnapshotCache.h"
 #include "GatrixStreaming.h"
+#include "GatrixStreamingHub.h"
+#include "GatrixTransport.h"
 #include "GatrixTypes.h"
 #include "GatrixVariationProvider.h"
+#include "json/document.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -41,6 +57,36 @@ public:
   void updateContext(const GatrixContext& context,
                      std::function<void(bool, const std::string&)> onComplete);
 
+  /**
+   * Evaluate an anticipated context in the background (C++ only).
+   * The result is kept in a bounded side cache (prefetchCacheSize); a later
+   * updateContext to the same context publishes it and completes at once,
+   * without waiting for the network. Prefetches are low priority: one at a
+   * time, and only while no flag fetch is in flight.
+   */
+  void prefetchContext(const GatrixContext& context);
+
+  /**
+   * Set (or remove) one context field: userId, sessionId, remoteAddress,
+   * currentTime, or a custom property. Changes are staged: those made in the
+   * same frame are applied together on the next one (one context hash, one
+   * request body, one fetch), or at commitContextUpdate() inside a
+   * transaction.
+   */
+  void setContextField(const std::string& field, const std::string& value);
+  void removeContextField(const std::string& field);
+
+  /**
+   * Transaction around context changes: setContextField, removeContextField
+   * and updateContext calls until the matching commitContextUpdate() are
+   * applied at once when it runs. Transactions nest; the outermost commit
+   * applies. An updateContext inside one merges into the staged context:
+   * only the fields it sets override, so earlier staged fields are kept.
+   * onComplete is called like updateContext's.
+   */
+  void beginContextUpdate();
+  void commitContextUpdate(std::function<void(bool, const std::string&)> onComplete = nullptr);
+
   // ==================== Flag Access - Basic ====================
   bool isEnabled(const std::string& flagName, bool forceRealtime = true);
   const EvaluatedFlag* getFlag(const std::string& flagName, bool forceRealtime = true);
@@ -154,6 +200,25 @@ public:
   // ==================== FlagProxy Access ====================
   bool hasFlag(const std::string& flagName) const;
 
+  // ==================== Change Detection ====================
+  /**
+   * Snapshot generation: starts at 0 and advances every time the flags of the
+   * selected snapshot change (forceRealtime=false selects the synced one in
+   * explicitSyncMode). Cache values read from the client together with the
+   * generation and re-read them only when it differs.
+   */
+  uint64_t getGeneration(bool forceRealtime = true) const;
+
+  /**
+   * Per-flag version: changes whenever the flag does (it holds the generation
+   * of the flag's last change, or the one current when the slot was created).
+   * The slot is created on first request and stays valid for the client's
+   * lifetime, so a caller keeps the reference and re-validates with a single
+   * atomic load, from any thread. Only requested flags are tracked.
+   */
+  const std::atomic<uint64_t>& getFlagGeneration(const std::string& flagName,
+                                                 bool forceRealtime = true);
+
   // ==================== Explicit Sync Mode ====================
   bool isExplicitSync() const;
   bool hasPendingSyncFlags() const;
@@ -201,6 +266,13 @@ public:
    */
   void fetchFlags(std::function<void(bool, const std::string&)> onComplete);
 
+  /**
+   * Replace the HTTP backend (C++ only). The transport is not owned and must
+   * outlive the client; set it before start(). By default the configured
+   * backend is shared with the other instances configured the same way.
+   */
+  void setTransport(ITransport* transport);
+
   // ==================== Statistics ====================
   GatrixSdkStats getStats() const;
   GatrixLightStats getLightStats() const;
@@ -211,10 +283,26 @@ private:
   GatrixContext _context;
   IStorageProvider* _storage = nullptr;
   InMemoryStorageProvider _defaultStorage;
+  ITransport* _transport = nullptr;              // fetches, partial fetches and the SSE stream
+  std::shared_ptr<ITransport> _defaultTransport; // backend selected by config.features.http
+  std::string _environment;                      // apiUrl|apiToken|appName: scope of sharing
+  std::shared_ptr<DecodeWorker> _decodeWorker;   // inflate + parse off the cocos thread
+  // Expires with the client: responses on a shared transport may outlive it
+  std::shared_ptr<bool> _alive = std::make_shared<bool>(true);
 
   // Flag storage (Repository pattern)
   std::map<std::string, EvaluatedFlag> _realtimeFlags;
   std::map<std::string, EvaluatedFlag> _synchronizedFlags;
+  FlagSetEtag _realtimeEtag; // edge ETag of _realtimeFlags, recomputed after partial merges
+
+  // Change detection: written on the cocos thread only, readable from any thread
+  std::atomic<uint64_t> _realtimeGeneration{0};
+  std::atomic<uint64_t> _syncedGeneration{0};
+  // Per-flag versions, created on request from any thread; map nodes never move or get
+  // erased, so a returned slot is read lock-free while the maps are walked under the mutex
+  std::mutex _flagGenerationsMutex;
+  std::map<std::string, std::atomic<uint64_t>> _realtimeFlagGenerations;
+  std::map<std::string, std::atomic<uint64_t>> _syncedFlagGenerations;
 
   // State
   SdkState _sdkState = SdkState::INITIALIZING;
@@ -229,10 +317,52 @@ private:
   int _consecutiveFailures = 0;
   bool _pollingStopped = false;
   bool _isFetchingFlags = false;
-  std::set<std::string> _pendingInvalidationKeys;
+  bool _partialFetchInFlight = false;
+  bool _fullFetchQueued = false; // fetchFlags() requested while a partial fetch was in flight
+  InvalidationCoalescer _invalidations;
+  PollingScheduler _polling; // picks the next poll delay from streaming health + server hints
+  bool _invalidationFlushScheduled = false;
+  int _spreadWindowMs = 0; // fetch spread window (config default, server hint overrides)
   std::string _fetchStartContextHash;
   std::string _lastContextHash;
   std::string _flagsContextHash;
+  long long _syncRevision = 0;          // server revision the realtime snapshot is based on
+  std::string _syncRevisionContextHash; // context the revision basis belongs to
+  bool _deltaRequested = false;         // in-flight fetch carried since=<revision>
+
+  // Context changes staged by setContextField / transactions, applied together
+  GatrixContext _stagedContext;
+  bool _hasStagedContext = false;
+  int _stagedChangeCount = 0;
+  int _contextUpdateDepth = 0;
+  bool _contextFlushScheduled = false;
+  std::vector<std::function<void(bool, const std::string&)>> _stagedContextCallbacks;
+
+  // Flags this client reads (interestKeys, plus observed keys with trackObservedKeys)
+  InterestSet _interest;
+
+  // Scheduled activations, and the server clock their deadlines are on: server time at a
+  // local steady instant (a user changing the device clock does not move it)
+  ActivationSchedule _activations;
+  bool _serverClockSynced = false;
+  long long _serverClockBaseMs = 0;
+  std::chrono::steady_clock::time_point _serverClockBaseAt;
+  long long _serverClockRttMs = 0; // round trip of the sample the base came from
+  std::chrono::steady_clock::time_point _fetchSentAt;
+
+  // enableLocalEvaluation: compiled definitions, evaluated against _context
+  std::shared_ptr<LocalEvaluator> _localEvaluator;
+
+  // Complete flag sets of recently used contexts (contextSnapshotCacheSize), shared with the
+  // other instances of the environment
+  std::shared_ptr<SnapshotCache> _snapshots;
+
+  // Speculative prefetch: results, and contexts waiting to be prefetched (hash, context)
+  SnapshotCache _prefetched;
+  std::vector<std::pair<std::string, GatrixContext>> _prefetchQueue;
+  bool _prefetchInFlight = false;
+  bool _prefetchDrainScheduled = false;
+  long long _prefetchUsedBytes = 0;
 
   // Stats
   GatrixSdkStats _stats;
@@ -262,31 +392,92 @@ private:
   void initFromStorage();
   void initFromBootstrap();
   void saveToStorage();
+  void rememberSnapshot();
+  void saveSnapshots();
+  void updateEtagSource(const FlagDiff& diff);
+  void loadSnapshots();
   void setFlags(const std::vector<EvaluatedFlag>& flags, bool forceSync = false);
   void onFetchResponse(int statusCode, const std::string& body, const std::string& etag);
+  // Parsed evaluate-all body: a full snapshot, or a since= delta (upserts + removals)
+  struct FetchPayload {
+    std::map<std::string, EvaluatedFlag> flags;
+    std::vector<std::string> removed;
+    bool isDelta = false;
+    long long revision = 0;
+    std::vector<ScheduledChange> scheduled;
+    bool hasSchedule = false; // the response carried a scheduled list (possibly empty)
+  };
+  static bool parseFlagsDocument(const rapidjson::Document& doc, FetchPayload& payload,
+                                 std::string& error);
+  static bool parseFlagsValue(const rapidjson::Value& doc, FetchPayload& payload,
+                              std::string& error);
+  static bool parseFlagRecord(const rapidjson::Value& fj, EvaluatedFlag& flag);
+  static void parseScheduledChanges(const rapidjson::Value& array, FetchPayload& payload);
+  void applyFetchedFlags(FetchPayload&& payload, const std::string& etag);
+  void replaceRealtimeFlags(std::map<std::string, EvaluatedFlag>&& newFlags);
+  static std::shared_ptr<LocalEvaluator> loadDefinitions(const rapidjson::Document& doc,
+                                                         std::string& error);
+  void applyDefinitions(std::shared_ptr<LocalEvaluator> evaluator, const std::string& etag);
+  void evaluateLocally();
+  void finishFetchSuccess();
+  bool canDeltaSync() const;
+  void resyncChangedKeys(const std::vector<std::string>& changedKeys);
+  void decodeFetchResponseAsync(int statusCode, std::vector<char> compressed,
+                                const std::string& etag);
+  void finishFetchCycle();
   void onFetchError(int statusCode, const std::string& error);
   void trackAccess(const std::string& flagName, bool enabled, const std::string& variantName,
                    const std::string& eventType);
   void trackImpression(const EvaluatedFlag& flag, const std::string& eventType);
+  void observeInterest(const std::string& flagName);
+  std::string withInterestQuery(std::string url) const;
   void scheduleNextRefresh();
   void unschedulePolling();
+  void applyPollingHints(const std::string& headers);
+  void emitFlagChanges(const FlagDiff& diff);
+  void advanceGeneration(const FlagDiff& diff, bool forceRealtime);
   void invokeWatchCallbacks(std::map<std::string, std::vector<WatchCallback>>& callbackMap,
-                            const std::map<std::string, EvaluatedFlag>& oldFlags,
-                            const std::map<std::string, EvaluatedFlag>& newFlags,
-                            bool forceRealtime, const std::string& oldContextHash,
-                            const std::string& newContextHash);
+                            const FlagDiff& diff, bool forceRealtime);
+  void invokeWatchCallbacksFor(std::map<std::string, std::vector<WatchCallback>>& callbackMap,
+                               const std::vector<std::string>& names, bool forceRealtime);
   static std::string computeContextHash(const GatrixContext& context);
+  static GatrixContext mergeContext(const GatrixContext& base, const GatrixContext& context);
+  /// Staged changes: only the fields context sets override; unset ones keep what is staged
+  static void stageContextFields(GatrixContext& staged, const GatrixContext& context);
+  void applyContext(GatrixContext merged,
+                    std::function<void(bool, const std::string&)> onComplete);
+  GatrixContext& stageContext();
+  void scheduleContextFlush();
+  void flushStagedContext();
+  bool takePrefetched(const std::string& contextHash, SnapshotCache::Entry& out);
+  void drainPrefetchQueue();
 
   // Streaming
   void connectStreaming();
   void disconnectStreaming();
-  void handleStreamingInvalidation(const std::vector<std::string>& changedKeys);
+  void onStreamingStateChanged(StreamingConnectionState state);
+  bool applyStreamingPayload(const rapidjson::Value& doc, long globalRevision, bool contiguous);
+  void handleStreamingInvalidation(const std::vector<std::string>& changedKeys,
+                                   const StreamingManager::InvalidationHint& hint);
+  void flushInvalidations();
+  static std::string buildEvalRequestBody(const GatrixContext& context,
+                                          const std::vector<std::string>& flagNames);
+  void encodeRequestBody(std::string& body, std::vector<std::string>& headers);
   void fetchPartialFlags(const std::vector<std::string>& changedKeys);
+  void recordTransportTiming(const TransportResponse& response);
+  void sendRequest(const TransportRequest& request, ITransport::ResponseCallback callback);
   void storePartialFlags(const std::vector<EvaluatedFlag>& flags,
                          const std::vector<std::string>& requestedKeys);
-  static std::string computeEtag(const std::map<std::string, EvaluatedFlag>& flags,
-                                 const std::string& contextHash);
-  StreamingManager* _streaming = nullptr;
+
+  // Scheduled activations
+  long long serverNowMs() const;
+  void sampleServerClock(const std::string& headers);
+  void enqueueScheduledChanges(std::vector<ScheduledChange>&& changes, bool replaceAll);
+  void scheduleActivationTimer();
+  void applyDueActivations();
+
+  std::shared_ptr<StreamingHub> _streaming; // shared connection of the environment
+  int _streamingSubscription = 0;
 };
 
 // ==================== WatchFlagGroup ====================
@@ -0,0 +1,34 @@
+#ifndef GATRIX_FLAG_DIFF_H
+#define GATRIX_FLAG_DIFF_H
+
+#include "GatrixTypes.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/**
+ * Compact result of comparing two flag snapshots.
+ * Only flags that differ are listed, each list in ascending name order.
+ */
+struct FlagDiff {
+  std::vector<std::string> added;
+  std::vector<std::string> changed;
+  std::vector<std::string> removed;
+
+  bool empty() const { return added.empty() && changed.empty() && removed.empty(); }
+  size_t size() const { return added.size() + changed.size() + removed.size(); }
+};
+
+/**
+ * Diff two snapshots by content hash.
+ * Both maps are name-ordered, so this is a single O(n + m) merge walk with one
+ * 128-bit compare per common flag — variant values are never compared.
+ */
+FlagDiff diffFlags(const std::map<std::string, EvaluatedFlag>& oldFlags,
+                   const std::map<std::string, EvaluatedFlag>& newFlags);
+
+} // namespace gatrix
+
+#endif // GATRIX_FLAG_DIFF_H
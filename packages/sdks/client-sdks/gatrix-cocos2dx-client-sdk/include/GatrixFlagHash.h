@@ -0,0 +1,96 @@
+#ifndef GATRIX_FLAG_HASH_H
+#define GATRIX_FLAG_HASH_H
+
+#include "GatrixSha256.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace gatrix {
+
+struct EvaluatedFlag;
+
+/**
+ * 128-bit content hash of a single flag record.
+ * Not cryptographic — used for change detection only.
+ */
+struct FlagHash {
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+
+  bool isZero() const { return hi == 0 && lo == 0; }
+  bool operator==(const FlagHash& other) const { return hi == other.hi && lo == other.lo; }
+  bool operator!=(const FlagHash& other) const { return !(*this == other); }
+};
+
+/**
+ * Streaming 128-bit hasher (two independent FNV-1a lanes with a murmur-style
+ * finalizer). Strings are length-prefixed so adjacent fields cannot collide.
+ */
+class FlagHasher {
+public:
+  FlagHasher& update(const void* data, size_t len);
+  FlagHasher& update(const std::string& value);
+  FlagHasher& update(uint64_t value);
+  FlagHasher& update(bool value) { return update(static_cast<uint64_t>(value ? 1 : 0)); }
+
+  FlagHash finish() const;
+
+private:
+  uint64_t _lo = 0xcbf29ce484222325ULL;
+  uint64_t _hi = 0x6c62272e07bb0142ULL;
+};
+
+/**
+ * Name order of the edge's flag list (String.prototype.localeCompare, root
+ * collation): case-insensitive first with lowercase ahead, punctuation before
+ * digits before letters. Exact for ASCII names; other bytes sort after ASCII.
+ */
+struct EdgeNameOrder {
+  bool operator()(const std::string& a, const std::string& b) const;
+};
+
+/**
+ * The edge's ETag for a flag set (EvaluationUtils.generateETag): quoted sha256
+ * of contextHash|name:version:enabled:variant|... in edge name order.
+ * Kept incrementally: each record's segment is rendered when it changes, and
+ * the hash state after every record is checkpointed, so a merge re-hashes only
+ * from the first touched name onward instead of sorting and re-rendering all.
+ */
+class FlagSetEtag {
+public:
+  /** Adds or replaces a record's segment */
+  void put(const EvaluatedFlag& flag);
+  void remove(const std::string& name);
+  void reset(const std::map<std::string, EvaluatedFlag>& flags);
+
+  size_t count() const { return _entries.size(); }
+
+  /** Validator for the set evaluated under contextHash, as the edge would send it */
+  std::string toEtag(const std::string& contextHash);
+
+private:
+  struct Entry {
+    std::string segment; // name:version:enabled:variant
+    Sha256 after;        // state once this segment is absorbed
+  };
+
+  void invalidateFrom(const std::string& name);
+
+  std::map<std::string, Entry, EdgeNameOrder> _entries;
+  std::string _contextHash;
+  Sha256 _prefix; // contextHash|
+  bool _primed = false;
+  bool _stale = true;
+  bool _staleFromStart = true;
+  std::string _staleFrom; // first name whose checkpoint is out of date
+  std::string _etag;
+};
+
+/** Hash every observable field of a flag record (name, state, variant, type, version). */
+FlagHash computeFlagContentHash(const EvaluatedFlag& flag);
+
+} // namespace gatrix
+
+#endif // GATRIX_FLAG_HASH_H
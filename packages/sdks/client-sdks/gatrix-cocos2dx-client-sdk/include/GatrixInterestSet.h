@@ -0,0 +1,68 @@
+#ifndef GATRIX_INTEREST_SET_H
+#define GATRIX_INTEREST_SET_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/**
+ * The flags a client cares about. Declared entries are exact keys or, with a
+ * trailing '*', prefixes; with observation on, every key read at runtime is
+ * added as well. Fetches send the set so the server can evaluate only those
+ * flags, and streaming invalidations of other keys are dropped before any
+ * request is made.
+ *
+ * On the wire (query parameters):
+ *   interest=<key>,<prefix>*,...  prefixes always, exact keys while there are
+ *                                 at most bloomThreshold of them
+ *   interestBloom=<k>.<base64>    otherwise, exact keys as a bloom filter: bit
+ *                                 (h1 + i * h2) mod m for i < k, where h1 is the
+ *                                 64-bit FNV-1a of the UTF-8 key, h2 = h1 >> 32 | 1
+ *                                 and m is 8 * the byte count; bit j is
+ *                                 byte j / 8, mask 1 << (j % 8)
+ *
+ * Not thread-safe; owned and driven by FeaturesClient on the cocos thread.
+ */
+class InterestSet {
+public:
+  static const int BLOOM_HASH_COUNT = 7;    // bloom filter hashes per key
+  static const int BLOOM_BITS_PER_KEY = 10; // about 1% false positives
+
+  void configure(const std::vector<std::string>& declaredKeys, bool trackObserved,
+                 int bloomThreshold);
+
+  /** Off when nothing was declared and observation is off: every flag is of interest */
+  bool enabled() const { return _enabled; }
+
+  /** The set only changes by declaration (can be sent once, e.g. on the stream) */
+  bool isStatic() const { return _enabled && !_trackObserved; }
+
+  bool contains(const std::string& key) const;
+
+  /** Record a key read at runtime; true if it was not in the set (never fetched) */
+  bool observe(const std::string& key);
+
+  /**
+   * Keys of a change that are in the set. Empty changedKeys ("everything")
+   * are returned as is; otherwise an empty result means nothing of interest changed.
+   */
+  std::vector<std::string> intersect(const std::vector<std::string>& changedKeys) const;
+
+  /** Query parameters for the set (without leading '&'); empty when disabled */
+  std::string toQueryString() const;
+
+  int size() const { return static_cast<int>(_keys.size() + _prefixes.size()); }
+
+private:
+  std::set<std::string> _keys;        // declared and observed exact keys
+  std::vector<std::string> _prefixes; // declared prefixes, without the '*'
+  bool _enabled = false;
+  bool _trackObserved = false;
+  int _bloomThreshold = 64;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_INTEREST_SET_H
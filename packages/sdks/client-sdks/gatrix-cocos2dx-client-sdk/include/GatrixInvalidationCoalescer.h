@@ -0,0 +1,63 @@
+#ifndef GATRIX_INVALIDATION_COALESCER_H
+#define GATRIX_INVALIDATION_COALESCER_H
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/**
+ * Gathers streaming invalidations into one batch per debounce window.
+ *
+ * The window adapts to the event rate: isolated events flush after
+ * minWindowMs, while a dense burst (events closer together than minWindowMs)
+ * stretches the window up to maxWindowMs so the burst becomes a single fetch.
+ * The rate is an exponentially weighted average of inter-arrival gaps.
+ *
+ * Not thread-safe; owned and driven by FeaturesClient on the cocos thread.
+ */
+class InvalidationCoalescer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  InvalidationCoalescer(int minWindowMs, int maxWindowMs);
+
+  /** Merge changed keys. Empty keys or "*" mean "everything changed". */
+  void add(const std::vector<std::string>& keys, Clock::time_point now = Clock::now());
+
+  /** Debounce window for the next flush, derived from the recent event rate. */
+  int windowMs() const;
+
+  bool hasPending() const { return _full || !_keys.empty(); }
+
+  /** Drain the batch. A full invalidation is returned as {"*"}. */
+  std::vector<std::string> take();
+
+  void clear();
+
+  int eventCount() const { return _eventCount; }
+
+  /**
+   * Per-client offset in [0, windowMs) for the follow-up fetch, derived from a
+   * stable seed (session ID). Every client receives the same event at the same
+   * moment; hashing the seed spreads their fetches evenly across the window
+   * while keeping each client's offset the same from one event to the next.
+   */
+  static int spreadDelayMs(const std::string& seed, int windowMs);
+
+private:
+  int _minWindowMs;
+  int _maxWindowMs;
+  double _avgGapMs;
+  bool _hasLastEvent = false;
+  Clock::time_point _lastEvent;
+  std::set<std::string> _keys;
+  bool _full = false;
+  int _eventCount = 0;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_INVALIDATION_COALESCER_H
@@ -0,0 +1,83 @@
+#ifndef GATRIX_LOCAL_EVALUATOR_H
+#define GATRIX_LOCAL_EVALUATOR_H
+
+#include "GatrixTypes.h"
+#include "json/document.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace gatrix {
+
+/** MurmurHash3 (x86, 32-bit) of the key's bytes; the server buckets rollouts with seed 0. */
+uint32_t murmurHash3(const std::string& key, uint32_t seed = 0);
+
+/**
+ * LocalEvaluator - evaluates flags on the device from downloaded definitions.
+ *
+ * Experimental: FeaturesClient downloads the definitions from
+ * /client/features/definitions (FeaturesConfig::enableLocalEvaluation), an
+ * endpoint the Gatrix server does not provide yet.
+ *
+ * load() compiles the definitions document (flags with their strategies,
+ * constraints and variants, plus segments) into a program: context field
+ * names are interned to attribute indices, constraint operands are parsed
+ * once (case folding, numbers, dates, versions, CIDR ranges, regexes),
+ * segment references are resolved to indices and each flag's default values
+ * are converted to their client representation up front.
+ *
+ * evaluateAll() resolves the context into an attribute table once, then runs
+ * every flag against it. A segment shared by several strategies is evaluated
+ * at most once per call; its outcome is kept in a bitset.
+ *
+ * Results match what the server evaluator (packages/evaluator) returns for
+ * the context this SDK sends with evaluation requests: userId, sessionId and
+ * the properties, flattened, all as strings (checked against recorded server
+ * results by test_stubs/local_evaluator_test.cpp). Rollouts use the same murmur3
+ * bucketing, so a user lands in the same bucket on the device and on the
+ * server. Two cases depend on the server itself and cannot be reproduced:
+ * applicationHostname strategies (never match locally) and date constraints
+ * on currentTime (never sent, so never present on either side).
+ *
+ * Definitions do not depend on the context, so the client instances of an
+ * environment share one compiled program (share() / findShared()).
+ *
+ * Not thread-safe; owned and driven by FeaturesClient on the cocos thread.
+ */
+class LocalEvaluator {
+public:
+  LocalEvaluator();
+  ~LocalEvaluator();
+
+  LocalEvaluator(const LocalEvaluator&) = delete;
+  LocalEvaluator& operator=(const LocalEvaluator&) = delete;
+
+  /**
+   * Compile a definitions document: { flags, segments }, optionally wrapped
+   * in { data: ... }. The current program is kept if the document is invalid.
+   */
+  bool load(const rapidjson::Value& doc, std::string& error);
+
+  bool isLoaded() const { return _program != nullptr; }
+  int flagCount() const;
+
+  /** Evaluate every flag for the context, keyed by flag name (contentHash set). */
+  std::map<std::string, EvaluatedFlag> evaluateAll(const GatrixContext& context) const;
+
+  /** Offer a loaded program, served with etag, to the other instances of environment. */
+  static void share(const std::string& environment,
+                    const std::shared_ptr<LocalEvaluator>& evaluator, const std::string& etag);
+
+  /** Program another instance of environment loaded (and its ETag); nullptr if none. */
+  static std::shared_ptr<LocalEvaluator> findShared(const std::string& environment,
+                                                    std::string& etag);
+
+private:
+  struct Program; // compiled definitions
+  std::unique_ptr<Program> _program;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_LOCAL_EVALUATOR_H
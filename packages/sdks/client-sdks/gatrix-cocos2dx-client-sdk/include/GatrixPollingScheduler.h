@@ -0,0 +1,87 @@
+#ifndef GATRIX_POLLING_SCHEDULER_H
+#define GATRIX_POLLING_SCHEDULER_H
+
+#include <chrono>
+#include <deque>
+#include <random>
+
+namespace gatrix {
+
+enum class PollingMode {
+  NORMAL,    // no streaming: poll every refreshInterval
+  HEALTHY,   // streaming connected: long safety poll only
+  DEGRADED,  // streaming down: short poll until it recovers
+  FLAPPING,  // streaming keeps dropping: back off exponentially with jitter
+};
+
+/**
+ * Picks the delay of the next background poll.
+ *
+ * The mode follows the streaming connection: while invalidations arrive over
+ * SSE/WebSocket the poll is only a safety net, so it runs rarely; when the
+ * stream is down the poll takes over at the regular interval; when the stream
+ * drops repeatedly within flapWindowSec the poll backs off so reconnect storms
+ * and polling do not pile up on the edge.
+ *
+ * The server can steer the base interval (X-Poll-Interval) and push the next
+ * poll out (Retry-After). A hint also replaces the healthy-mode safety
+ * interval, even when it is shorter: the server knows what its invalidation
+ * path misses. Fetch failures keep their own exponential backoff.
+ *
+ * Not thread-safe; owned and driven by FeaturesClient on the cocos thread.
+ */
+class PollingScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  PollingScheduler(int refreshIntervalSec, int safetyIntervalSec, int flapThreshold,
+                   int flapWindowSec);
+
+  /** Streaming enabled/disabled. Disabled means NORMAL mode. */
+  void setStreamingEnabled(bool enabled);
+
+  /** Record a streaming state change; disconnects feed flap detection. */
+  void onStreamingState(bool connected, Clock::time_point now = Clock::now());
+
+  /** Server interval hint in seconds (X-Poll-Interval). 0 clears the hint. */
+  void setServerInterval(int seconds) { _serverIntervalSec = seconds > 0 ? seconds : 0; }
+
+  /** Retry-After in seconds: the next poll is not scheduled earlier than this. */
+  void setRetryAfter(int seconds, Clock::time_point now = Clock::now());
+
+  PollingMode mode(Clock::time_point now = Clock::now()) const;
+
+  /**
+   * Delay in seconds for the next poll. consecutiveFailures > 0 uses the
+   * failure backoff (initialBackoff * 2^(n-1), capped at maxBackoff).
+   */
+  float nextDelay(int consecutiveFailures, float initialBackoff, float maxBackoff,
+                  Clock::time_point now = Clock::now());
+
+  float lastDelay() const { return _lastDelay; }
+  int serverInterval() const { return _serverIntervalSec; }
+
+  static const char* modeName(PollingMode mode);
+
+private:
+  int recentFlaps(Clock::time_point now) const;
+  float jitter(float seconds, float ratio);
+
+  int _refreshIntervalSec;
+  int _safetyIntervalSec;
+  int _flapThreshold;
+  std::chrono::seconds _flapWindow;
+
+  bool _streamingEnabled = false;
+  bool _connected = false;
+  std::deque<Clock::time_point> _disconnects; // within the flap window
+  int _serverIntervalSec = 0;
+  bool _hasRetryAfter = false;
+  Clock::time_point _retryAfterUntil;
+  float _lastDelay = 0.0f;
+  std::mt19937 _rng;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_POLLING_SCHEDULER_H
@@ -0,0 +1,35 @@
+#ifndef GATRIX_SHA256_H
+#define GATRIX_SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gatrix {
+
+/**
+ * Streaming SHA-256 (simple public domain version).
+ * Copyable: a copy is a checkpoint that later input can resume from.
+ */
+class Sha256 {
+public:
+  Sha256();
+
+  Sha256& update(const void* data, size_t len);
+  Sha256& update(const std::string& value) { return update(value.data(), value.size()); }
+
+  /** Lowercase hex digest of everything absorbed so far; the state itself is left as is */
+  std::string hexDigest() const;
+
+private:
+  void processBlock(const uint8_t* data);
+
+  uint32_t _state[8];
+  uint8_t _buffer[64];
+  size_t _bufferLen = 0;
+  uint64_t _totalLen = 0;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_SHA256_H
@@ -0,0 +1,87 @@
+#ifndef GATRIX_SNAPSHOT_CACHE_H
+#define GATRIX_SNAPSHOT_CACHE_H
+
+#include "GatrixTypes.h"
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace gatrix {
+
+/**
+ * Complete flag sets of recently used contexts, keyed by context hash.
+ *
+ * Switching back to a context evaluated a few minutes ago (character select,
+ * another save slot, the lobby) can publish its flags at once instead of
+ * waiting for a fetch; the stored ETag then turns the revalidation into a 304
+ * in the common case. Bounded by entry count and by the approximate bytes the
+ * records hold; the least recently used entries go first, but the most recent
+ * one is always kept. FeaturesClient also keeps its prefetched evaluations
+ * (prefetchContext) in a second instance.
+ *
+ * Client instances of the same environment share one cache (shared()), so a
+ * context several of them use (split-screen players in the same lobby) is
+ * stored once.
+ *
+ * Not thread-safe; owned and driven by FeaturesClient on the cocos thread.
+ */
+class SnapshotCache {
+public:
+  struct Entry {
+    std::string contextHash;
+    std::string etag;
+    std::map<std::string, EvaluatedFlag> flags;
+    size_t bytes = 0;         // approximate memory held by the records
+    size_t responseBytes = 0; // wire size of the response it came from, if known
+    std::chrono::steady_clock::time_point storedAt;
+  };
+
+  SnapshotCache(int maxEntries, size_t maxBytes);
+
+  /**
+   * Cache shared by the instances of an environment (API URL, token, app)
+   * configured with the same bounds; a private one when disabled.
+   */
+  static std::shared_ptr<SnapshotCache> shared(const std::string& environment, int maxEntries,
+                                               size_t maxBytes);
+
+  bool enabled() const { return _maxEntries > 0; }
+
+  /** Snapshot of a context, marked most recently used; nullptr if not cached. */
+  const Entry* find(const std::string& contextHash);
+
+  bool contains(const std::string& contextHash) const { return _index.count(contextHash) > 0; }
+
+  /** Remove a context's snapshot into out; false if not cached. */
+  bool take(const std::string& contextHash, Entry& out);
+
+  /** Store (or replace) a context's snapshot as the most recently used entry. */
+  void put(const std::string& contextHash, const std::map<std::string, EvaluatedFlag>& flags,
+           const std::string& etag, size_t responseBytes = 0);
+
+  void clear();
+
+  int size() const { return static_cast<int>(_entries.size()); }
+  size_t bytes() const { return _bytes; }
+
+  /** Least recently used first, so re-putting them in order restores the cache. */
+  std::list<Entry>::const_reverse_iterator begin() const { return _entries.rbegin(); }
+  std::list<Entry>::const_reverse_iterator end() const { return _entries.rend(); }
+
+private:
+  void evict();
+
+  int _maxEntries;
+  size_t _maxBytes;
+  size_t _bytes = 0;
+  std::list<Entry> _entries; // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_SNAPSHOT_CACHE_H
@@ -0,0 +1,89 @@
+#ifndef GATRIX_SSE_PARSER_H
+#define GATRIX_SSE_PARSER_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace gatrix {
+
+/**
+ * Non-owning view of bytes inside a parser buffer or an incoming chunk
+ * (a minimal std::string_view; the SDK does not require C++17).
+ */
+struct SseView {
+  const char* data = "";
+  size_t size = 0;
+
+  SseView() = default;
+  SseView(const char* d, size_t n) : data(d), size(n) {}
+  explicit SseView(const std::string& s) : data(s.data()), size(s.size()) {}
+
+  bool empty() const { return size == 0; }
+  std::string str() const { return std::string(data, size); }
+  bool equals(const char* lit, size_t litLen) const {
+    return size == litLen && std::memcmp(data, lit, litLen) == 0;
+  }
+};
+
+/**
+ * Incremental text/event-stream parser over raw UTF-8 bytes.
+ *
+ * Lines are located with memchr and handed around as SseViews: a line
+ * that lies entirely inside the chunk being fed is never copied. Only a line
+ * split across chunks is carried over, and only the data of the event being
+ * assembled is buffered. Both buffers are reused for the lifetime of the
+ * parser and bounded by maxEventBytes; an event (or a single line) larger
+ * than that is dropped whole and the parser resynchronizes on the next blank
+ * line, so a misbehaving server cannot grow memory without limit.
+ *
+ * Lines end in LF or CRLF. Not thread-safe; fed from the streaming thread.
+ */
+class SseParser {
+public:
+  /** Views are only valid for the duration of the callback. */
+  using EventCallback = std::function<void(SseView type, SseView data)>;
+
+  static const size_t DEFAULT_MAX_EVENT_BYTES = 1024 * 1024;
+
+  explicit SseParser(size_t maxEventBytes = DEFAULT_MAX_EVENT_BYTES);
+
+  /** Parse the next chunk; complete events are dispatched in order. */
+  void feed(const char* data, size_t len, const EventCallback& onEvent);
+
+  /** Forget any partial line/event (new connection). lastEventId survives. */
+  void reset();
+
+  /** id of the most recent event that carried one (for Last-Event-ID). */
+  const std::string& lastEventId() const { return _lastEventId; }
+
+  /** Server-requested reconnect delay (retry: field), -1 if none. */
+  int retryMs() const { return _retryMs; }
+
+  /** Events dropped for exceeding maxEventBytes. */
+  size_t droppedEventCount() const { return _droppedEvents; }
+
+  /** Bytes currently held for partial lines and the pending event. */
+  size_t bufferedBytes() const { return _carry.size() + _data.size() + _type.size(); }
+
+private:
+  void processLine(SseView line, const EventCallback& onEvent);
+  void dispatch(const EventCallback& onEvent);
+
+  size_t _maxEventBytes;
+  std::string _carry; // partial line spanning chunk boundaries
+  std::string _type;  // event: field of the pending event
+  std::string _data;  // data: lines of the pending event, LF-joined
+  bool _hasData = false;
+  bool _discarding = false;   // pending event exceeded the limit; skip until blank line
+  bool _skippingLine = false; // inside a line that alone exceeded the limit
+  bool _atStreamStart = true;
+  std::string _lastEventId;
+  int _retryMs = -1;
+  size_t _droppedEvents = 0;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_SSE_PARSER_H
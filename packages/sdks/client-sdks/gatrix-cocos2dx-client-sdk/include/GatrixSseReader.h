@@ -0,0 +1,46 @@
+#ifndef GATRIX_SSE_READER_H
+#define GATRIX_SSE_READER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/**
+ * Blocking, incremental HTTP reader for text/event-stream responses.
+ *
+ * cocos2d::network::HttpClient only calls back once a response completes,
+ * which turns an SSE stream into long polling. SseReader drives libcurl (the
+ * same library HttpClient is built on) directly and hands every received
+ * chunk to onData as soon as the socket delivers it.
+ *
+ * run() blocks the calling thread (the streaming thread) until the server
+ * closes the stream, the transfer fails, the stream stays silent longer than
+ * idleTimeoutSec, or isCancelled() returns true (polled at least once a second).
+ * A libcurl share handle (CURLSH*) lets the stream reuse another transport's
+ * DNS cache, TLS sessions and connections.
+ */
+class SseReader {
+public:
+  using OpenCallback = std::function<void()>;
+  using DataCallback = std::function<void(const char* data, size_t len)>;
+  using CancelCheck = std::function<bool()>;
+
+  struct Result {
+    int statusCode = 0;  // final HTTP status, 0 if no response was received
+    bool opened = false; // a 200 response started streaming
+    bool cancelled = false;
+    std::string error; // transport or HTTP error, empty when the server closed cleanly
+  };
+
+  static Result run(const std::string& url, const std::vector<std::string>& headers,
+                    const OpenCallback& onOpen, const DataCallback& onData,
+                    const CancelCheck& isCancelled, int idleTimeoutSec,
+                    void* curlShare = nullptr);
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_SSE_READER_H
@@ -0,0 +1,51 @@
+#ifndef GATRIX_STREAM_CODEC_H
+#define GATRIX_STREAM_CODEC_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/**
+ * One decoded binary streaming frame. body points into the frame buffer.
+ */
+struct BinaryStreamFrame {
+  std::string type;
+  long long globalRevision = 0;
+  std::vector<std::string> changedKeys;
+  bool urgent = false;
+  bool resumed = false;       // connected: missed events are replayed next
+  int spreadWindowMs = -1;    // -1: not sent
+  const char* body = nullptr; // JSON object text with any remaining fields, if sent
+  size_t bodyLength = 0;
+};
+
+/**
+ * Compact binary encoding of WebSocket streaming events, negotiated through
+ * the WebSocket subprotocol. Text JSON frames stay valid on every connection,
+ * so a server that does not pick BINARY_PROTOCOL keeps working unchanged.
+ *
+ *   frame   := version:u8(=1) type:u8 flags:u8 [name:str if type==0]
+ *              globalRevision:uvarint keyCount:uvarint key:str*
+ *              [spreadWindowMs:uvarint if flags&2] [body:str if flags&4]
+ *   str     := byteLength:uvarint utf8
+ *   type    := 0 named | 1 connected | 2 flags_changed | 3 heartbeat | 4 pong
+ *   flags   := 1 urgent | 2 spreadWindowMs present | 4 body present | 8 resumed
+ *   uvarint := unsigned LEB128
+ *
+ * body carries whatever has no field of its own (push-payload flags/removed,
+ * contextHash, timestamp) as a JSON object.
+ */
+class StreamCodec {
+public:
+  static const char* const BINARY_PROTOCOL;
+  static const char* const TEXT_PROTOCOL;
+
+  /** Decode a binary frame. Returns false on a truncated or unknown frame. */
+  static bool decode(const char* data, size_t len, BinaryStreamFrame& out);
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_STREAM_CODEC_H
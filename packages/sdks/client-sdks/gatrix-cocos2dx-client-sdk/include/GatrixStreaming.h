@@ -2,9 +2,14 @@
 #define GATRIX_STREAMING_H
 
 #include "GatrixEventEmitter.h"
+#include "GatrixSseParser.h"
+#include "GatrixTransport.h"
 #include "GatrixTypes.h"
+#include "json/document.h"
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <set>
@@ -31,10 +36,25 @@ class FeaturesClient;
  */
 class StreamingManager {
 public:
-  using InvalidationCallback = std::function<void(const std::vector<std::string>&)>;
+  /// Server hints carried by a flags_changed event
+  struct InvalidationHint {
+    int spreadWindowMs = -1; // -1: not sent, keep the current spread window
+    bool urgent = false;     // apply now, skipping the spread delay
+    long globalRevision = 0; // revision the event brings the stream to
+  };
+
+  using InvalidationCallback =
+      std::function<void(const std::vector<std::string>&, const InvalidationHint&)>;
   using FetchCallback = std::function<void()>;
-
-  StreamingManager(const GatrixClientConfig& config, GatrixEventEmitter& emitter);
+  using StateCallback = std::function<void(StreamingConnectionState)>;
+  /// Applies an inline flags_changed payload of globalRevision; returns false to fall back to a
+  /// fetch. contiguous is false when revisions were skipped (the records alone are not enough).
+  using PayloadCallback =
+      std::function<bool(const rapidjson::Value&, long globalRevision, bool contiguous)>;
+
+  /// The SSE stream is read through transport (shares its connections when it can)
+  StreamingManager(const GatrixClientConfig& config, GatrixEventEmitter& emitter,
+                   ITransport& transport);
   ~StreamingManager();
 
   // No copy/move
@@ -50,12 +70,21 @@ public:
   /// Get current connection state
   StreamingConnectionState getState() const { return _state; }
 
+  /// Last global revision seen on the stream (0 before the first connected event)
+  long getGlobalRevision() const { return _localGlobalRevision; }
+
   /// Set callback for when flags are invalidated
   void setInvalidationCallback(InvalidationCallback cb) { _onInvalidation = std::move(cb); }
 
   /// Set callback for full fetch request (gap recovery)
   void setFetchCallback(FetchCallback cb) { _onFetchRequest = std::move(cb); }
 
+  /// Set callback for connection state changes (drives the polling mode)
+  void setStateCallback(StateCallback cb) { _onStateChange = std::move(cb); }
+
+  /// Set callback for inline flag payloads (streaming.pushPayload)
+  void setPayloadCallback(PayloadCallback cb) { _onPayload = std::move(cb); }
+
   /// Set connection ID for API headers
   void setConnectionId(const std::string& connectionId) { _connectionId = connectionId; }
 
@@ -74,19 +103,41 @@ public:
 private:
   // SSE connection
   void connectSse();
-  void runSseLoop();
-  void parseSseChunk(const std::string& chunk);
+  void runSseLoop(long resumeRevision);
+  void parseSseChunk(const char* data, size_t len);
 
   // WebSocket connection
   void connectWebSocket();
 
-  // Common event processing
-  void processStreamingEvent(const std::string& eventType, const std::string& eventData);
+  /// A streaming event after its one parse (JSON text or binary frame). type and
+  /// body point into buffers that live only for the processStreamingEvent call.
+  struct EventView {
+    const char* type = "";
+    bool hasData = false;                   // the event carried a (parsable) body
+    const rapidjson::Value* body = nullptr; // JSON fields, if any (push payload)
+    long globalRevision = 0;
+    std::vector<std::string> changedKeys;
+    InvalidationHint hint;
+    bool resumed = false; // connected: the server replays missed events next
+  };
+
+  // Common event processing. Text frames/data are parsed in place.
+  void handleSseEvent(const std::string& eventType, std::string& eventData);
+  void handleWsMessage(std::string& message, bool binary);
+  void handleWsBinaryMessage(const std::string& message);
+  static void readEventBody(const rapidjson::Value& body, EventView& view);
+  void processStreamingEvent(const EventView& event);
+
+  // State transitions (notifies the state callback)
+  void setState(StreamingConnectionState state);
 
   // Reconnection
   void scheduleReconnect();
   int calculateReconnectDelay();
 
+  // Ping and reconnect timers run on the cocos scheduler (keyed, cancelled together)
+  void unscheduleTimers();
+
   // Error/recovery tracking
   void trackError(const std::string& errorMessage);
   void trackRecovery();
@@ -99,16 +150,21 @@ private:
   // Config
   const GatrixClientConfig& _config;
   GatrixEventEmitter& _emitter;
+  ITransport& _transport;
   std::string _connectionId;
 
   // State
   StreamingConnectionState _state = StreamingConnectionState::DISCONNECTED;
   long _localGlobalRevision = 0;
-  bool _stopRequested = false;
+  std::atomic<bool> _stopRequested{false};
+  // Expires with the manager: work posted to the cocos thread and timers may outlive it
+  std::shared_ptr<bool> _alive = std::make_shared<bool>(true);
 
   // Callbacks
   InvalidationCallback _onInvalidation;
   FetchCallback _onFetchRequest;
+  StateCallback _onStateChange;
+  PayloadCallback _onPayload;
 
   // Reconnection state
   int _reconnectAttempt = 0;
@@ -120,13 +176,6 @@ private:
   // WebSocket
   cocos2d::network::WebSocket* _ws = nullptr;
 
-  // Reconnect timer thread
-  std::thread _reconnectThread;
-
-  // WebSocket ping thread
-  std::thread _pingThread;
-  bool _pingStopRequested = false;
-
   // Statistics
   int _eventCount = 0;
   int _errorCount = 0;
@@ -136,10 +185,9 @@ private:
   std::chrono::system_clock::time_point _lastErrorTime;
   std::chrono::system_clock::time_point _lastRecoveryTime;
 
-  // SSE parser state
-  std::string _sseCurrentEventType;
-  std::string _sseDataBuffer;
-  std::string _sseLineBuffer;
+  // SSE parser (streaming thread only)
+  SseParser _sseParser;
+  size_t _sseDroppedReported = 0;
 
   // Thread safety
   mutable std::mutex _mutex;
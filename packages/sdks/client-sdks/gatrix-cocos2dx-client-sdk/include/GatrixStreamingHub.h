@@ -0,0 +1,97 @@
+#ifndef GATRIX_STREAMING_HUB_H
+#define GATRIX_STREAMING_HUB_H
+
+#include "GatrixEventEmitter.h"
+#include "GatrixStreaming.h"
+#include "GatrixTransport.h"
+#include "GatrixTypes.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/**
+ * StreamingHub - one streaming connection per environment, shared by every
+ * FeaturesClient in the process that talks to it.
+ *
+ * Instances with the same API URL, token, application, streaming settings
+ * and transport acquire the same hub. It connects with the first subscriber
+ * and disconnects when the last one leaves. Connection events
+ * (FLAGS_STREAMING_*, FLAGS_INVALIDATED) are re-emitted on every subscriber's
+ * emitter; invalidations, resync requests and state changes go to each
+ * subscriber's own callbacks. A pushed payload is offered to every
+ * subscriber (each checks the context it was evaluated for); only those that
+ * could not apply it get the invalidation.
+ *
+ * Contiguity is judged per subscriber. One that joins a connection already
+ * past its first revision missed the connected event and its gap check: it
+ * is asked to resync, and its first pushed payload falls back to a fetch.
+ *
+ * Not thread-safe; used on the cocos thread.
+ */
+class StreamingHub {
+public:
+  struct Subscriber {
+    GatrixEventEmitter* emitter = nullptr;
+    StreamingManager::InvalidationCallback onInvalidation;
+    StreamingManager::FetchCallback onFetchRequest;
+    StreamingManager::StateCallback onStateChange;
+    StreamingManager::PayloadCallback onPayload;
+  };
+
+  /**
+   * Hub for config's environment, created if there is none. The first
+   * acquirer's connection ID identifies the shared connection.
+   */
+  static std::shared_ptr<StreamingHub> acquire(const GatrixClientConfig& config,
+                                               std::shared_ptr<ITransport> transport,
+                                               const std::string& connectionId);
+
+  ~StreamingHub();
+
+  StreamingHub(const StreamingHub&) = delete;
+  StreamingHub& operator=(const StreamingHub&) = delete;
+
+  /// Add a subscriber, connecting with the first; returns its id
+  int subscribe(Subscriber subscriber);
+
+  /// Remove a subscriber, disconnecting with the last
+  void unsubscribe(int id);
+
+  /// The shared connection (stats)
+  const StreamingManager& connection() const { return *_manager; }
+
+  int subscriberCount() const { return static_cast<int>(_subscribers.size()); }
+
+private:
+  StreamingHub(const GatrixClientConfig& config, std::shared_ptr<ITransport> transport,
+               const std::string& connectionId);
+
+  static constexpr long FOLLOWS_STREAM = -1;
+
+  /// Ids of the current subscribers (callbacks may unsubscribe while dispatching)
+  std::vector<int> subscriberIds() const;
+
+  /// Whether globalRevision directly follows what subscriber id has accounted for
+  bool contiguousFor(int id, long globalRevision, bool streamContiguous) const;
+
+  /// Every subscriber has now accounted for globalRevision (applied or refetched)
+  void advanceRevisions(long globalRevision);
+
+  GatrixClientConfig _config; // copied: the hub may outlive the instance that created it
+  GatrixEventEmitter _emitter;
+  std::shared_ptr<ITransport> _transport;
+  std::unique_ptr<StreamingManager> _manager;
+  std::map<int, Subscriber> _subscribers;
+  // Stream revision each subscriber's flags account for; FOLLOWS_STREAM for those that
+  // joined before the connection had one, 0 for a late joiner until its next event
+  std::map<int, long> _revisions;
+  int _nextSubscriberId = 1;
+  std::vector<int> _payloadApplied; // subscribers that applied the current event's payload
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_STREAMING_HUB_H
@@ -0,0 +1,85 @@
+#ifndef GATRIX_TRANSPORT_H
+#define GATRIX_TRANSPORT_H
+
+#include "GatrixSseReader.h"
+#include "GatrixTypes.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+
+/// What a request is for; selects its timeout (HttpConfig) and priority
+enum class RequestClass { FETCH, PARTIAL_FETCH, PREFETCH };
+
+struct TransportRequest {
+  RequestClass requestClass = RequestClass::FETCH;
+  std::string url;
+  bool post = true;
+  std::vector<std::string> headers; // "Name: value"
+  std::string body;
+  bool immediate = false; // HTTP_CLIENT: bypass HttpClient's request queue
+};
+
+struct TransportResponse {
+  int statusCode = 0;  // 0 if no response was received
+  std::string headers; // raw response header block
+  std::vector<char> body;
+  std::string error; // transport error, empty when a response arrived
+
+  // Connection setup, when the backend can measure it
+  bool timed = false;
+  bool reusedConnection = false; // sent on a kept-alive connection
+  double connectTimeMs = 0.0;    // TCP + TLS setup, 0 when reused
+};
+
+/**
+ * ITransport - how the SDK talks HTTP.
+ *
+ * Fetches and partial fetches go through send(); the SSE streaming
+ * thread reads its event stream through stream(), so a backend can share
+ * connections and TLS sessions between the two.
+ */
+class ITransport {
+public:
+  /// Runs on the cocos thread; the response may be moved from
+  using ResponseCallback = std::function<void(TransportResponse& response)>;
+
+  virtual ~ITransport() = default;
+
+  /**
+   * Backend for config, shared by every client in the process configured the
+   * same way, so instances use one connection pool. Created on first use and
+   * destroyed with its last user.
+   */
+  static std::shared_ptr<ITransport> shared(const HttpConfig& config);
+
+  /// Backend name for stats
+  virtual const char* name() const = 0;
+
+  virtual void send(const TransportRequest& request, ResponseCallback callback) = 0;
+
+  /// Blocking event-stream read on the calling thread (see SseReader::run)
+  virtual SseReader::Result stream(const std::string& url, const std::vector<std::string>& headers,
+                                   const SseReader::OpenCallback& onOpen,
+                                   const SseReader::DataCallback& onData,
+                                   const SseReader::CancelCheck& isCancelled,
+                                   int idleTimeoutSec) {
+    return SseReader::run(url, headers, onOpen, onData, isCancelled, idleTimeoutSec);
+  }
+};
+
+/**
+ * Default backend: cocos2d::network::HttpClient. Connection reuse, HTTP
+ * version and timeouts are whatever the shared HttpClient does.
+ */
+class HttpClientTransport : public ITransport {
+public:
+  const char* name() const override { return "httpclient"; }
+  void send(const TransportRequest& request, ResponseCallback callback) override;
+};
+
+} // namespace gatrix
+
+#endif // GATRIX_TRANSPORT_H
@@ -1,6 +1,7 @@
 #ifndef GATRIX_TYPES_H
 #define GATRIX_TYPES_H
 
+#include "GatrixFlagHash.h"
 #include "GatrixVariantSource.h"
 #include <chrono>
 #include <functional>
@@ -18,6 +19,8 @@ enum class SdkState { INITIALIZING, READY, HEALTHY, ERROR, STOPPED };
 
 enum class StreamingTransport { SSE, WEBSOCKET };
 
+enum class HttpBackend { HTTP_CLIENT, CURL_MULTI };
+
 enum class StreamingConnectionState { DISCONNECTED, CONNECTING, CONNECTED, RECONNECTING, DEGRADED };
 
 // ==================== Data Structures ====================
@@ -36,6 +39,7 @@ struct EvaluatedFlag {
   int version = 0;
   std::string reason;
   bool impressionData = false;
+  FlagHash contentHash; // computed once when the record is parsed
 };
 
 template <typename T> struct VariationResult {
@@ -87,6 +91,7 @@ struct GatrixSdkStats {
   int recoveryCount = 0;
   int impressionCount = 0;
   int contextChangeCount = 0;
+  int contextCoalescedCount = 0; // staged context changes applied together with others
   int syncFlagsCount = 0;
   int metricsSentCount = 0;
   int metricsErrorCount = 0;
@@ -123,6 +128,70 @@ struct GatrixSdkStats {
   std::string lastStreamingErrorTime;
   std::string lastStreamingRecoveryTime;
 
+  // Compression stats
+  long long compressedBytesReceived = 0; // wire bytes of compressed responses
+  long long decompressedBytes = 0;       // bytes after inflation
+  long long requestBytesRaw = 0;         // request bodies before gzip
+  long long requestBytesSent = 0;        // request bodies after gzip
+  double compressionRatio = 0.0;         // decompressedBytes / compressedBytesReceived
+  double lastDecodeTimeMs = 0.0;         // inflate + parse time of the last response
+
+  // Delta sync stats
+  int deltaFetchCount = 0;    // responses applied as a since= patch
+  int deltaFallbackCount = 0; // since= requests answered with a full snapshot
+  long long syncRevision = 0; // revision the realtime snapshot is based on
+
+  // Invalidation coalescing stats
+  int invalidationEventCount = 0;  // streaming invalidations received
+  int invalidationFlushCount = 0;  // batched fetches issued for them
+  int lastCoalesceWindowMs = 0;    // debounce window of the most recent batch
+  int lastSpreadDelayMs = 0;       // spread offset added to the most recent batch
+  int urgentInvalidationCount = 0; // invalidations applied without the spread delay
+
+  // Interest set stats
+  int interestKeyCount = 0;      // declared and observed keys and prefixes (0: disabled)
+  int interestObservedCount = 0; // keys added by a first read at runtime
+  int interestDroppedCount = 0;  // invalidations with no key of interest, dropped
+
+  // Scheduled activation stats
+  int scheduledActivationPending = 0; // changes waiting for their deadline
+  int scheduledActivationCount = 0;   // changes applied locally at their deadline
+  long long serverClockOffsetMs = 0;  // server time - local wall clock
+
+  // Push-with-payload stats
+  int pushPayloadAppliedCount = 0;  // flags_changed records applied without a fetch
+  int pushPayloadFallbackCount = 0; // payload events that fell back to a fetch
+  long long lastPushLatencyMs = 0;  // server publish -> local apply of the last payload
+
+  // Context snapshot cache stats
+  int snapshotCacheHitCount = 0;  // context switches that published a cached snapshot
+  int snapshotCacheMissCount = 0; // context switches that had to wait for a fetch
+  int snapshotCacheEntries = 0;
+  long long snapshotCacheBytes = 0; // approximate
+
+  // Speculative prefetch stats
+  int prefetchCount = 0;             // prefetched evaluations received
+  int prefetchHitCount = 0;          // updateContext calls completed from a prefetch
+  double prefetchHitRate = 0.0;      // prefetchHitCount / prefetchCount
+  long long prefetchBytes = 0;       // response bytes of the prefetched evaluations
+  long long prefetchWastedBytes = 0; // of those, evicted or expired without being used
+
+  // Local evaluation stats
+  int localEvaluationCount = 0;       // evaluateAll runs against downloaded definitions
+  double lastLocalEvaluationMs = 0.0; // duration of the most recent run
+
+  // HTTP transport stats (connection setup is only measured by the CURL_MULTI backend)
+  std::string httpBackend;         // httpclient / curl-multi
+  int connectionsOpened = 0;       // requests that had to set up a connection
+  int connectionsReused = 0;       // requests sent on a kept-alive connection
+  double lastConnectTimeMs = 0.0;  // TCP + TLS setup time of the most recent new connection
+  double totalConnectTimeMs = 0.0; // summed over connectionsOpened
+
+  // Polling stats
+  std::string pollingMode;    // normal / healthy / degraded / flapping
+  float pollingInterval = 0;  // delay of the most recently scheduled poll, seconds
+  int serverPollInterval = 0; // X-Poll-Interval hint from the server, 0 if none
+
   // Event handler stats
   std::map<std::string, std::vector<EventHandlerStats>> eventHandlerStats;
 };
@@ -162,6 +231,21 @@ struct GatrixLightStats {
   std::string streamingState;
   int streamingReconnectCount = 0;
   std::string lastStreamingEventTime;
+
+  // Compression
+  double compressionRatio = 0.0;
+  double lastDecodeTimeMs = 0.0;
+
+  // Delta sync
+  int deltaFetchCount = 0;
+  long long syncRevision = 0;
+
+  // Invalidation coalescing
+  int invalidationEventCount = 0;
+  int invalidationFlushCount = 0;
+
+  // Polling
+  std::string pollingMode;
 };
 
 // ==================== Streaming Config ====================
@@ -171,22 +255,40 @@ struct SseStreamingConfig {
   int reconnectBase = 1; // Base reconnect delay in seconds
   int reconnectMax = 30; // Max reconnect delay in seconds
   int pollingJitter = 5; // Jitter range in seconds
+  int idleTimeout = 90; // Reconnect after this many seconds without bytes (heartbeats included)
+  size_t maxEventSize = 1024 * 1024; // Larger SSE events are dropped (bounds parser memory)
 };
 
 struct WebSocketStreamingConfig {
-  std::string url;       // Override WebSocket endpoint URL (optional)
-  int reconnectBase = 1; // Base reconnect delay in seconds
-  int reconnectMax = 30; // Max reconnect delay in seconds
-  int pingInterval = 30; // Ping interval in seconds
+  std::string url;           // Override WebSocket endpoint URL (optional)
+  int reconnectBase = 1;     // Base reconnect delay in seconds
+  int reconnectMax = 30;     // Max reconnect delay in seconds
+  int pingInterval = 30;     // Ping interval in seconds
+  bool binaryFrames = false; // Offer compact binary event frames (text JSON stays the fallback)
 };
 
 struct StreamingConfig {
   bool enabled = false;
   StreamingTransport transport = StreamingTransport::SSE;
+  // Opt-in: flags_changed carries the evaluated records, applied without a follow-up fetch
+  // (a revision gap still falls back to fetching)
+  bool pushPayload = false;
   SseStreamingConfig sse;
   WebSocketStreamingConfig ws;
 };
 
+// ==================== HTTP Config ====================
+
+// Timeouts are per request class; the HTTP_CLIENT backend only has HttpClient's global ones
+struct HttpConfig {
+  HttpBackend backend = HttpBackend::HTTP_CLIENT;
+  int connectTimeoutMs = 10000;
+  int fetchTimeoutMs = 30000;        // evaluate-all
+  int partialFetchTimeoutMs = 10000; // streaming-triggered partial fetches
+  bool http2 = true;          // CURL_MULTI: multiplex requests over one HTTP/2 connection
+  int maxHostConnections = 4; // CURL_MULTI: connections kept per host (HTTP/1.1)
+};
+
 // ==================== Config ====================
 
 struct FetchRetryOptions {
@@ -208,6 +310,14 @@ struct FeaturesConfig {
   int refreshInterval = 30; // seconds
   bool disableRefresh = false;
 
+  // Adaptive polling: while streaming is connected the poll is only a safety net and runs
+  // every streamingSafetyPollInterval (or the server's X-Poll-Interval, when sent); a stream
+  // that drops streamingFlapThreshold times within streamingFlapWindow is treated as
+  // flapping and polling backs off
+  int streamingSafetyPollInterval = 300; // seconds
+  int streamingFlapThreshold = 3;
+  int streamingFlapWindow = 60; // seconds
+
   // Sync Mode
   bool explicitSyncMode = true;
 
@@ -224,6 +334,54 @@ struct FeaturesConfig {
 
   // Request
   bool usePOSTRequests = false;
+  HttpConfig http; // backend for fetches, partial fetches and the SSE stream
+
+  // Compression (opt-in): advertise gzip/deflate responses and gzip request bodies
+  bool enableCompression = false;
+  int compressionMinBytes = 1024; // request bodies below this size are sent uncompressed
+
+  // Delta sync (opt-in): send since=<revision> so the server can answer with a patch
+  bool enableDeltaSync = false;
+
+  // Local evaluation (opt-in, experimental): download flag definitions once and evaluate on
+  // the device, so a context change re-evaluates without a network round trip.
+  // Requires GET /client/features/definitions, which the Gatrix server does not provide yet;
+  // leave this off unless your deployment serves it
+  bool enableLocalEvaluation = false;
+
+  // Context snapshot cache (opt-in): complete flag sets of recently used contexts, so
+  // switching back to one publishes it at once and revalidates it with its stored ETag
+  int contextSnapshotCacheSize = 0; // entries, 0 disables
+  size_t contextSnapshotCacheMaxBytes = 512 * 1024;
+  bool persistContextSnapshots = false; // keep the snapshots in storage across restarts
+
+  // Speculative prefetch (prefetchContext): evaluations of anticipated contexts, kept for a
+  // later updateContext to the same context
+  int prefetchCacheSize = 4;
+  size_t prefetchCacheMaxBytes = 512 * 1024;
+  int prefetchMaxAge = 120; // seconds; an older prefetched evaluation is not used
+
+  // Invalidation coalescing: streaming bursts are batched over an adaptive debounce
+  // window between these bounds (short for isolated events, long for dense bursts)
+  int invalidationCoalesceMinMs = 50;
+  int invalidationCoalesceMaxMs = 500;
+
+  // Fleet-wide spread of the follow-up fetch: each client waits a stable, session-derived
+  // offset within this window so a published change does not hit the edge all at once.
+  // 0 disables; a spreadWindowMs hint on flags_changed overrides it. Urgent events skip it.
+  int invalidationSpreadWindowMs = 0;
+
+  // Interest set: fetches evaluate, and streaming invalidations refresh, only these flags.
+  // Exact keys or prefixes ending in '*'; with trackObservedKeys every flag read at runtime
+  // joins the set (its first read fetches it). Empty and off: every flag is of interest.
+  std::vector<std::string> interestKeys;
+  bool trackObservedKeys = false;
+  int interestBloomThreshold = 64; // more exact keys than this are sent as a bloom filter
+
+  // Scheduled activations (opt-in): accept changes published ahead of their activation time
+  // and apply them locally at the deadline, on server-corrected time plus a stable
+  // per-client jitter when the server asks for one, so an event start needs no fetch
+  bool enableScheduledActivations = false;
 
   // Retry
   FetchRetryOptions fetchRetryOptions;
@@ -0,0 +1,43 @@
+// GatrixActivationSchedule.cpp - Scheduled flag changes waiting for their activation time
+
+#include "GatrixActivationSchedule.h"
+
+namespace gatrix {
+
+void ActivationSchedule::put(ScheduledChange change) {
+  cancel(change.id);
+  _deadlines[change.id] = change.deadlineMs;
+  _queue.emplace(change.deadlineMs, std::move(change));
+}
+
+bool ActivationSchedule::cancel(const std::string& id) {
+  auto deadline = _deadlines.find(id);
+  if (deadline == _deadlines.end())
+    return false;
+  auto range = _queue.equal_range(deadline->second);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.id == id) {
+      _queue.erase(it);
+      break;
+    }
+  }
+  _deadlines.erase(deadline);
+  return true;
+}
+
+void ActivationSchedule::clear() {
+  _queue.clear();
+  _deadlines.clear();
+}
+
+std::vector<ScheduledChange> ActivationSchedule::takeDue(long long serverNowMs) {
+  std::vector<ScheduledChange> due;
+  while (!_queue.empty() && _queue.begin()->first <= serverNowMs) {
+    _deadlines.erase(_queue.begin()->second.id);
+    due.push_back(std::move(_queue.begin()->second));
+    _queue.erase(_queue.begin());
+  }
+  return due;
+}
+
+} // namespace gatrix
@@ -0,0 +1,110 @@
+// GatrixCompression.cpp - gzip request bodies and streaming response inflation
+
+#include "GatrixCompression.h"
+#include <cstring>
+#include <zlib.h>
+
+namespace gatrix {
+
+// ==================== GatrixCompression ====================
+
+bool GatrixCompression::isCompressed(const char* data, size_t len) {
+  if (!data || len < 2)
+    return false;
+  auto b0 = static_cast<unsigned char>(data[0]);
+  auto b1 = static_cast<unsigned char>(data[1]);
+  // gzip magic
+  if (b0 == 0x1f && b1 == 0x8b)
+    return true;
+  // zlib header: CM=8 (deflate) and header checksum
+  return (b0 & 0x0f) == 8 && ((b0 << 8) | b1) % 31 == 0;
+}
+
+bool GatrixCompression::gzip(const std::string& input, std::string& output) {
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  // windowBits 15 + 16 = gzip wrapper
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) !=
+      Z_OK)
+    return false;
+
+  output.resize(deflateBound(&zs, static_cast<uLong>(input.size())));
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  zs.avail_in = static_cast<uInt>(input.size());
+  zs.next_out = reinterpret_cast<Bytef*>(&output[0]);
+  zs.avail_out = static_cast<uInt>(output.size());
+
+  int ret = deflate(&zs, Z_FINISH);
+  output.resize(zs.total_out);
+  deflateEnd(&zs);
+  return ret == Z_STREAM_END;
+}
+
+// ==================== InflateStream ====================
+
+InflateStream::InflateStream(const char* data, size_t len) {
+  auto* zs = new z_stream();
+  std::memset(zs, 0, sizeof(z_stream));
+  zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  zs->avail_in = static_cast<uInt>(len);
+  // windowBits 15 + 32 = auto-detect gzip or zlib header
+  if (inflateInit2(zs, 15 + 32) != Z_OK) {
+    delete zs;
+    _error = true;
+    _finished = true;
+    return;
+  }
+  _zs = zs;
+  refill();
+}
+
+InflateStream::~InflateStream() {
+  if (_zs) {
+    inflateEnd(static_cast<z_stream*>(_zs));
+    delete static_cast<z_stream*>(_zs);
+  }
+}
+
+bool InflateStream::refill() const {
+  if (_finished)
+    return false;
+
+  auto* zs = static_cast<z_stream*>(_zs);
+  _consumed += _len;
+  _pos = 0;
+  _len = 0;
+
+  // Loop until we produce output or the stream ends (empty blocks produce nothing)
+  while (_len == 0) {
+    zs->next_out = reinterpret_cast<Bytef*>(_buffer);
+    zs->avail_out = static_cast<uInt>(CHUNK_SIZE);
+    int ret = inflate(zs, Z_NO_FLUSH);
+    _len = CHUNK_SIZE - zs->avail_out;
+
+    if (ret == Z_STREAM_END) {
+      _finished = true;
+      break;
+    }
+    if (ret != Z_OK || (zs->avail_in == 0 && _len == 0)) {
+      // Corrupt data or truncated input
+      _error = true;
+      _finished = true;
+      break;
+    }
+  }
+  return _len > 0;
+}
+
+InflateStream::Ch InflateStream::Peek() const {
+  if (_pos >= _len && !refill())
+    return '\0';
+  return _buffer[_pos];
+}
+
+InflateStream::Ch InflateStream::Take() {
+  if (_pos >= _len && !refill())
+    return '\0';
+  return _buffer[_pos++];
+}
+
+} // namespace gatrix
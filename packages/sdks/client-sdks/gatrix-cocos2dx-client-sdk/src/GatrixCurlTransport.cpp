@@ -0,0 +1,280 @@
+// GatrixCurlTransport.cpp - ITransport backend on a shared libcurl multi handle
+
+#include "GatrixCurlTransport.h"
+#include "cocos2d.h"
+#include "curl/curl.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace cocos2d;
+
+namespace gatrix {
+
+namespace {
+
+// Without curl_multi_wakeup (7.68) the worker polls for new requests this often
+const int IDLE_WAIT_MS = 50;
+
+struct Transfer {
+  CURL* easy = nullptr;
+  struct curl_slist* headerList = nullptr;
+  std::string body; // POSTFIELDS is not copied by libcurl
+  char errorBuffer[CURL_ERROR_SIZE] = {0};
+  TransportResponse response;
+  ITransport::ResponseCallback callback;
+};
+
+size_t onHeader(char* buffer, size_t size, size_t nitems, void* userdata) {
+  auto* transfer = static_cast<Transfer*>(userdata);
+  size_t len = size * nitems;
+  // Keep only the final response's block (redirects and 1xx responses come first)
+  if (len > 5 && std::strncmp(buffer, "HTTP/", 5) == 0)
+    transfer->response.headers.clear();
+  transfer->response.headers.append(buffer, len);
+  return len;
+}
+
+size_t onBody(char* ptr, size_t size, size_t nmemb, void* userdata) {
+  auto* transfer = static_cast<Transfer*>(userdata);
+  size_t len = size * nmemb;
+  transfer->response.body.insert(transfer->response.body.end(), ptr, ptr + len);
+  return len;
+}
+
+} // namespace
+
+struct CurlMultiTransport::Impl {
+  HttpConfig config;
+  CURLM* multi = nullptr;
+  CURLSH* share = nullptr;
+  std::mutex shareLocks[CURL_LOCK_DATA_LAST];
+
+  std::thread worker;
+  std::atomic<bool> stopRequested{false};
+  std::mutex queueMutex;
+  std::condition_variable queueReady; // idle worker waits here when nothing is in flight
+  std::deque<Transfer*> queue;
+  std::unordered_map<CURL*, Transfer*> active; // worker thread only
+
+  static void lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<Impl*>(userptr)->shareLocks[data].lock();
+  }
+
+  static void unlockShare(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<Impl*>(userptr)->shareLocks[data].unlock();
+  }
+
+  void wake() {
+    queueReady.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(multi);
+#endif
+  }
+
+  // Builds the easy handle on the caller's thread; the worker adds it to the multi handle
+  void prepare(Transfer* transfer, const TransportRequest& request) {
+    CURL* easy = curl_easy_init();
+    transfer->easy = easy;
+    for (const auto& header : request.headers) {
+      transfer->headerList = curl_slist_append(transfer->headerList, header.c_str());
+    }
+    int timeoutMs = request.requestClass == RequestClass::PARTIAL_FETCH
+                        ? config.partialFetchTimeoutMs
+                        : config.fetchTimeoutMs;
+
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headerList);
+    if (request.post) {
+      curl_easy_setopt(easy, CURLOPT_POST, 1L);
+      curl_easy_setopt(easy, CURLOPT_POSTFIELDS, transfer->body.data());
+      curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE,
+                       static_cast<curl_off_t>(transfer->body.size()));
+    } else {
+      curl_easy_setopt(easy, CURLOPT_HTTPGET, 1L);
+    }
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(config.connectTimeoutMs));
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(timeoutMs));
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_SHARE, share);
+    curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, transfer->errorBuffer);
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, onHeader);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, transfer);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, onBody);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer);
+    // Accept-Encoding is sent as a header by the caller, which also decodes the body
+    if (config.http2) {
+      curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+      // Wait for an existing connection to multiplex on rather than opening another
+      curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+#if LIBCURL_VERSION_NUM >= 0x072e00
+      // Speculative: lowest stream weight, so it yields bandwidth to fetches on the connection
+      if (request.requestClass == RequestClass::PREFETCH)
+        curl_easy_setopt(easy, CURLOPT_STREAM_WEIGHT, 1L);
+#endif
+    }
+  }
+
+  void finish(CURL* easy, CURLcode code) {
+    auto it = active.find(easy);
+    if (it == active.end())
+      return;
+    Transfer* transfer = it->second;
+    active.erase(it);
+
+    TransportResponse& response = transfer->response;
+    if (code == CURLE_OK) {
+      long status = 0;
+      curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+      response.statusCode = static_cast<int>(status);
+    } else {
+      response.statusCode = 0;
+      response.error = transfer->errorBuffer[0] ? transfer->errorBuffer : curl_easy_strerror(code);
+    }
+
+    // NUM_CONNECTS is 0 when the request went out on a kept-alive connection
+    long connects = 0;
+    double nameLookup = 0, connect = 0, appConnect = 0;
+    curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(easy, CURLINFO_NAMELOOKUP_TIME, &nameLookup);
+    curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(easy, CURLINFO_APPCONNECT_TIME, &appConnect);
+    response.timed = true;
+    response.reusedConnection = connects == 0;
+    if (connects > 0) {
+      double setupEnd = appConnect > 0 ? appConnect : connect;
+      response.connectTimeMs = (setupEnd - nameLookup) * 1000.0;
+    }
+
+    curl_multi_remove_handle(multi, easy);
+    curl_easy_cleanup(easy);
+    curl_slist_free_all(transfer->headerList);
+
+    // Hand the response to the cocos thread
+    std::shared_ptr<Transfer> done(transfer);
+    done->easy = nullptr;
+    done->headerList = nullptr;
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread(
+        [done]() { done->callback(done->response); });
+  }
+
+  void run() {
+    while (!stopRequested) {
+      {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (active.empty() && queue.empty()) {
+          queueReady.wait(lock, [this]() { return stopRequested || !queue.empty(); });
+        }
+        // Requests queued by send(), already set up
+        while (!queue.empty()) {
+          Transfer* transfer = queue.front();
+          queue.pop_front();
+          active[transfer->easy] = transfer;
+          curl_multi_add_handle(multi, transfer->easy);
+        }
+      }
+      if (stopRequested)
+        break;
+
+      int running = 0;
+      curl_multi_perform(multi, &running);
+
+      int pending = 0;
+      while (CURLMsg* msg = curl_multi_info_read(multi, &pending)) {
+        if (msg->msg == CURLMSG_DONE)
+          finish(msg->easy_handle, msg->data.result);
+      }
+
+      if (running > 0 || !active.empty()) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+#else
+        curl_multi_wait(multi, nullptr, 0, IDLE_WAIT_MS, nullptr);
+#endif
+      }
+    }
+  }
+};
+
+CurlMultiTransport::CurlMultiTransport(const HttpConfig& config) : _impl(new Impl()) {
+  // Reference-counted by libcurl; HttpClient may already have initialized it
+  static std::once_flag initOnce;
+  std::call_once(initOnce, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+  Impl& impl = *_impl;
+  impl.config = config;
+
+  impl.share = curl_share_init();
+  curl_share_setopt(impl.share, CURLSHOPT_LOCKFUNC, &Impl::lockShare);
+  curl_share_setopt(impl.share, CURLSHOPT_UNLOCKFUNC, &Impl::unlockShare);
+  curl_share_setopt(impl.share, CURLSHOPT_USERDATA, _impl.get());
+  curl_share_setopt(impl.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(impl.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+  curl_share_setopt(impl.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+
+  impl.multi = curl_multi_init();
+  curl_multi_setopt(impl.multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+                    static_cast<long>(config.maxHostConnections));
+  if (config.http2)
+    curl_multi_setopt(impl.multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+  impl.worker = std::thread([this]() { _impl->run(); });
+}
+
+CurlMultiTransport::~CurlMultiTransport() {
+  Impl& impl = *_impl;
+  {
+    std::lock_guard<std::mutex> lock(impl.queueMutex);
+    impl.stopRequested = true;
+  }
+  impl.wake();
+  if (impl.worker.joinable())
+    impl.worker.join();
+
+  // Abandoned requests: no callback
+  for (auto& entry : impl.active) {
+    curl_multi_remove_handle(impl.multi, entry.first);
+    curl_easy_cleanup(entry.first);
+    curl_slist_free_all(entry.second->headerList);
+    delete entry.second;
+  }
+  for (Transfer* transfer : impl.queue) {
+    curl_easy_cleanup(transfer->easy);
+    curl_slist_free_all(transfer->headerList);
+    delete transfer;
+  }
+  curl_multi_cleanup(impl.multi);
+  // The streaming thread has been joined by now, so no easy handle still uses the share
+  curl_share_cleanup(impl.share);
+}
+
+void CurlMultiTransport::send(const TransportRequest& request, ResponseCallback callback) {
+  auto* transfer = new Transfer();
+  transfer->body = request.body;
+  transfer->callback = std::move(callback);
+  _impl->prepare(transfer, request);
+  {
+    std::lock_guard<std::mutex> lock(_impl->queueMutex);
+    _impl->queue.push_back(transfer);
+  }
+  _impl->wake();
+}
+
+SseReader::Result CurlMultiTransport::stream(const std::string& url,
+                                             const std::vector<std::string>& headers,
+                                             const SseReader::OpenCallback& onOpen,
+                                             const SseReader::DataCallback& onData,
+                                             const SseReader::CancelCheck& isCancelled,
+                                             int idleTimeoutSec) {
+  return SseReader::run(url, headers, onOpen, onData, isCancelled, idleTimeoutSec, _impl->share);
+}
+
+} // namespace gatrix
@@ -0,0 +1,55 @@
+// GatrixDecodeWorker.cpp - Shared background thread for response decoding
+
+#include "GatrixDecodeWorker.h"
+
+namespace gatrix {
+
+std::shared_ptr<DecodeWorker> DecodeWorker::acquire() {
+  static std::weak_ptr<DecodeWorker> instance;
+  std::shared_ptr<DecodeWorker> worker = instance.lock();
+  if (!worker) {
+    worker = std::make_shared<DecodeWorker>();
+    instance = worker;
+  }
+  return worker;
+}
+
+DecodeWorker::~DecodeWorker() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+    _tasks.clear();
+  }
+  _wake.notify_one();
+  if (_thread.joinable())
+    _thread.join();
+}
+
+void DecodeWorker::post(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopping)
+      return;
+    _tasks.push_back(std::move(task));
+    if (!_thread.joinable())
+      _thread = std::thread([this]() { run(); });
+  }
+  _wake.notify_one();
+}
+
+void DecodeWorker::run() {
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _wake.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+      if (_stopping)
+        return;
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace gatrix
@@ -1,102 +1,53 @@
 #include "GatrixFeaturesClient.h"
 #include "GatrixClient.h"
+#include "GatrixCompression.h"
+#include "GatrixSha256.h"
 #include "cocos2d.h"
-#include "network/HttpClient.h"
 #include "json/document.h"
 #include "json/stringbuffer.h"
 #include "json/writer.h"
 #include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cmath>
-#include <iomanip>
+#include <cstdlib>
+#include <memory>
 #include <sstream>
 
 using namespace cocos2d;
-using namespace cocos2d::network;
 
 namespace gatrix {
 
 namespace {
-// SHA-256 implementation (simple public domain version)
-typedef unsigned int uint32;
-typedef unsigned char uint8;
-
-class SHA256 {
-public:
-  void update(const uint8* data, size_t len) {
-    for (size_t i = 0; i < len; ++i) {
-      m_buffer[m_bufferLen++] = data[i];
-      if (m_bufferLen == 64) {
-        processBlock(m_buffer);
-        m_totalLen += 64;
-        m_bufferLen = 0;
-      }
+// Value of a response header (case-insensitive name), empty if absent
+std::string findResponseHeader(const std::string& headers, const std::string& name) {
+  auto lower = [](std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+  };
+  std::string haystack = lower(headers);
+  std::string needle = lower(name) + ":";
+  size_t pos = 0;
+  while ((pos = haystack.find(needle, pos)) != std::string::npos) {
+    // Must start a line, not match the tail of another header name
+    if (pos == 0 || haystack[pos - 1] == '\n') {
+      auto start = headers.find_first_not_of(" \t", pos + needle.size());
+      if (start == std::string::npos)
+        return "";
+      auto end = headers.find_first_of("\r\n", start);
+      return headers.substr(start, end == std::string::npos ? std::string::npos : end - start);
     }
+    pos += needle.size();
   }
+  return "";
+}
 
-  std::string final() {
-    uint64 totalLen = (m_totalLen + m_bufferLen) * 8;
-    update((const uint8*)"\x80", 1);
-    while (m_bufferLen != 56)
-      update((const uint8*)"\x00", 1);
-    for (int i = 7; i >= 0; --i) {
-      uint8 b = (uint8)(totalLen >> (i * 8));
-      update(&b, 1);
-    }
-
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (int i = 0; i < 8; ++i)
-      ss << std::setw(8) << m_state[i];
-    return ss.str();
-  }
-
-  SHA256() {
-    m_state[0] = 0x6a09e667; m_state[1] = 0xbb67ae85; m_state[2] = 0x3c6ef372; m_state[3] = 0xa54ff53a;
-    m_state[4] = 0x510e527f; m_state[5] = 0x9b05688c; m_state[6] = 0x1f83d9ab; m_state[7] = 0x5be0cd19;
-    m_bufferLen = 0; m_totalLen = 0;
-  }
-
-private:
-  typedef unsigned long long uint64;
-  uint32 m_state[8];
-  uint8 m_buffer[64];
-  size_t m_bufferLen;
-  uint64 m_totalLen;
-
-  static uint32 rotr(uint32 x, uint32 n) { return (x >> n) | (x << (32 - n)); }
-  static uint32 ch(uint32 x, uint32 y, uint32 z) { return (x & y) ^ (~x & z); }
-  static uint32 maj(uint32 x, uint32 y, uint32 z) { return (x & y) ^ (x & z) ^ (y & z); }
-  static uint32 ep0(uint32 x) { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
-  static uint32 ep1(uint32 x) { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
-  static uint32 sig0(uint32 x) { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3); }
-  static uint32 sig1(uint32 x) { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10); }
-
-  void processBlock(const uint8* data) {
-    uint32 w[64];
-    for (int i = 0; i < 16; i++)
-      w[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | (data[i * 4 + 2] << 8) | (data[i * 4 + 3]);
-    for (int i = 16; i < 64; i++)
-      w[i] = sig1(w[i - 2]) + w[i - 7] + sig0(w[i - 15]) + w[i - 16];
-    uint32 a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3],
-           e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
-    static const uint32 k[] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
-    for (int i = 0; i < 64; i++) {
-      uint32 t1 = h + ep1(e) + ch(e, f, g) + k[i] + w[i];
-      uint32 t2 = ep0(a) + maj(a, b, c);
-      h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
-    }
-    m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
-    m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
-  }
-};
+// Header value in whole seconds (Retry-After / X-Poll-Interval), 0 if absent or not numeric
+int parseHeaderSeconds(const std::string& value) {
+  if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])))
+    return 0;
+  return std::atoi(value.c_str());
+}
 } // namespace
 
 std::string FeaturesClient::computeContextHash(const GatrixContext& context) {
@@ -106,15 +57,21 @@ std::string FeaturesClient::computeContextHash(const GatrixContext& context) {
     ss << key << "=" << val << ";";
   }
   std::string input = ss.str();
-  SHA256 sha;
-  sha.update((const uint8*)input.c_str(), input.length());
-  return sha.final();
+  return Sha256().update(input).hexDigest();
 }
 
 // ==================== FeaturesClient ====================
 
 FeaturesClient::FeaturesClient(const GatrixClientConfig& config, GatrixEventEmitter& emitter)
-    : _config(config), _emitter(emitter), _context(config.features.context) {
+    : _config(config), _emitter(emitter), _context(config.features.context),
+      _environment(config.apiUrl + "|" + config.apiToken + "|" + config.appName),
+      _invalidations(config.features.invalidationCoalesceMinMs,
+                     config.features.invalidationCoalesceMaxMs),
+      _polling(config.features.refreshInterval, config.features.streamingSafetyPollInterval,
+               config.features.streamingFlapThreshold, config.features.streamingFlapWindow),
+      _snapshots(SnapshotCache::shared(_environment, config.features.contextSnapshotCacheSize,
+                                       config.features.contextSnapshotCacheMaxBytes)),
+      _prefetched(config.features.prefetchCacheSize, config.features.prefetchCacheMaxBytes) {
   // Generate connection ID
   auto genHex = [](int len) {
     static const char chars[] = "0123456789abcdef";
@@ -129,14 +86,24 @@ FeaturesClient::FeaturesClient(const GatrixClientConfig& config, GatrixEventEmit
 
   // Set system context
   _context.properties["appName"] = _config.appName;
+  _lastContextHash = computeContextHash(_context);
 
   // Storage
   _storage = &_defaultStorage;
+
+  // HTTP backend (one per configuration in the process)
+  _defaultTransport = ITransport::shared(_config.features.http);
+  _transport = _defaultTransport.get();
+  _decodeWorker = DecodeWorker::acquire();
   _explicitSyncMode = _config.features.explicitSyncMode;
+  _spreadWindowMs = _config.features.invalidationSpreadWindowMs;
+  _interest.configure(_config.features.interestKeys, _config.features.trackObservedKeys,
+                      _config.features.interestBloomThreshold);
 }
 
 FeaturesClient::~FeaturesClient() {
   stop();
+  *_alive = false;
   for (auto* group : _watchGroups) {
     delete group;
   }
@@ -168,6 +135,10 @@ void FeaturesClient::start(std::function<void(bool, const std::string&)> onCompl
           _config.features.offlineMode ? "True" : "False", _config.features.refreshInterval,
           _explicitSyncMode ? "True" : "False");
   }
+  if (_config.features.enableLocalEvaluation && !_config.features.offlineMode) {
+    CCLOG("[GatrixSDK] enableLocalEvaluation is experimental: it needs a server that serves "
+          "/client/features/definitions");
+  }
   _stats.startTime = GatrixEventEmitter::nowISO();
 
   if (!_config.features.bootstrap.empty()) {
@@ -175,6 +146,16 @@ void FeaturesClient::start(std::function<void(bool, const std::string&)> onCompl
   }
 
   initFromStorage();
+  loadSnapshots();
+
+  // Another instance of the environment already compiled the definitions: start from them
+  // (the fetch below revalidates them with their ETag)
+  std::string sharedEtag;
+  std::shared_ptr<LocalEvaluator> sharedDefinitions;
+  if (_config.features.enableLocalEvaluation && !_config.features.offlineMode &&
+      (sharedDefinitions = LocalEvaluator::findShared(_environment, sharedEtag))) {
+    applyDefinitions(std::move(sharedDefinitions), sharedEtag);
+  }
 
   if (_config.features.offlineMode) {
     // No fetch in offline mode — resolve start callbacks immediately
@@ -202,7 +183,20 @@ void FeaturesClient::stop() {
   }
   disconnectStreaming();
   unschedulePolling();
+  if (Director::getInstance()) {
+    Director::getInstance()->getScheduler()->unschedule("GatrixInvalidationFlush", this);
+    Director::getInstance()->getScheduler()->unschedule("GatrixPrefetch", this);
+    Director::getInstance()->getScheduler()->unschedule("GatrixActivation", this);
+  }
+  _invalidationFlushScheduled = false;
+  _prefetchDrainScheduled = false;
+  _prefetchQueue.clear();
+  _invalidations.clear();
   _started = false;
+
+  // Staged context changes still apply (without a fetch) before the flush timer goes
+  if (_contextFlushScheduled && Director::getInstance())
+    flushStagedContext();
   _sdkState = SdkState::STOPPED;
   _pollingStopped = true;
   _consecutiveFailures = 0;
@@ -220,8 +214,130 @@ void FeaturesClient::updateContext(const GatrixContext& context) {
 
 void FeaturesClient::updateContext(const GatrixContext& context,
                                    std::function<void(bool, const std::string&)> onComplete) {
-  // Compute hash of new context to detect actual changes
-  std::string newHash = computeContextHash(context);
+  // Inside a transaction the update joins the staged changes and completes with the commit
+  if (_contextUpdateDepth > 0) {
+    stageContextFields(stageContext(), context);
+    if (onComplete)
+      _stagedContextCallbacks.push_back(std::move(onComplete));
+    return;
+  }
+
+  // Fields staged earlier this frame are applied along with it
+  if (_hasStagedContext) {
+    stageContextFields(stageContext(), context);
+    if (onComplete)
+      _stagedContextCallbacks.push_back(std::move(onComplete));
+    flushStagedContext();
+    return;
+  }
+  applyContext(mergeContext(_context, context), std::move(onComplete));
+}
+
+void FeaturesClient::setContextField(const std::string& field, const std::string& value) {
+  GatrixContext& staged = stageContext();
+  if (field == "userId")
+    staged.userId = value;
+  else if (field == "sessionId")
+    staged.sessionId = value;
+  else if (field == "remoteAddress")
+    staged.remoteAddress = value;
+  else if (field == "currentTime")
+    staged.currentTime = value;
+  else if (field != "appName") // system field
+    staged.properties[field] = value;
+  scheduleContextFlush();
+}
+
+void FeaturesClient::removeContextField(const std::string& field) {
+  GatrixContext& staged = stageContext();
+  if (field == "userId")
+    staged.userId.clear();
+  else if (field == "sessionId")
+    staged.sessionId.clear();
+  else if (field == "remoteAddress")
+    staged.remoteAddress.clear();
+  else if (field == "currentTime")
+    staged.currentTime.clear();
+  else if (field != "appName")
+    staged.properties.erase(field);
+  scheduleContextFlush();
+}
+
+void FeaturesClient::beginContextUpdate() {
+  _contextUpdateDepth++;
+}
+
+void FeaturesClient::commitContextUpdate(
+    std::function<void(bool, const std::string&)> onComplete) {
+  if (_contextUpdateDepth == 0) {
+    CCLOG("[GatrixSDK] commitContextUpdate() without beginContextUpdate()");
+  } else {
+    _contextUpdateDepth--;
+  }
+  if (onComplete)
+    _stagedContextCallbacks.push_back(std::move(onComplete));
+  if (_contextUpdateDepth == 0)
+    flushStagedContext();
+}
+
+GatrixContext& FeaturesClient::stageContext() {
+  if (!_hasStagedContext) {
+    _stagedContext = _context;
+    _hasStagedContext = true;
+  }
+  _stagedChangeCount++;
+  return _stagedContext;
+}
+
+void FeaturesClient::scheduleContextFlush() {
+  // Inside a transaction the commit applies; outside one, everything staged this frame is
+  // applied on the next
+  if (_contextUpdateDepth > 0 || _contextFlushScheduled)
+    return;
+  _contextFlushScheduled = true;
+  Director::getInstance()->getScheduler()->schedule(
+      [this](float) {
+        _contextFlushScheduled = false;
+        flushStagedContext();
+      },
+      this, 0.0f, 0, 0, false, "GatrixContextFlush");
+}
+
+void FeaturesClient::flushStagedContext() {
+  if (_contextUpdateDepth > 0)
+    return;
+  if (_contextFlushScheduled) {
+    Director::getInstance()->getScheduler()->unschedule("GatrixContextFlush", this);
+    _contextFlushScheduled = false;
+  }
+
+  // One completion for everyone who waited on the staged changes
+  std::function<void(bool, const std::string&)> onComplete;
+  if (!_stagedContextCallbacks.empty()) {
+    onComplete = [callbacks = std::move(_stagedContextCallbacks)](bool success,
+                                                                  const std::string& error) {
+      for (const auto& callback : callbacks)
+        callback(success, error);
+    };
+    _stagedContextCallbacks.clear();
+  }
+
+  if (!_hasStagedContext) {
+    if (onComplete)
+      onComplete(true, "");
+    return;
+  }
+  _hasStagedContext = false;
+  _stats.contextCoalescedCount += _stagedChangeCount - 1;
+  _stagedChangeCount = 0;
+  applyContext(std::move(_stagedContext), std::move(onComplete));
+}
+
+void FeaturesClient::applyContext(GatrixContext merged,
+                                  std::function<void(bool, const std::string&)> onComplete) {
+  // Hash the merged context (the one fetches send and snapshots are keyed by) to detect
+  // actual changes
+  std::string newHash = computeContextHash(merged);
   if (newHash == _lastContextHash) {
     // No change — notify immediately without fetching
     if (onComplete)
@@ -229,17 +345,52 @@ void FeaturesClient::updateContext(const GatrixContext& context,
     return;
   }
 
-  _context.userId = context.userId;
-  _context.sessionId = context.sessionId;
-  if (!context.currentTime.empty())
-    _context.currentTime = context.currentTime;
+  _context = std::move(merged);
+  _lastContextHash = newHash;
+  _stats.contextChangeCount++;
 
-  for (const auto& [key, val] : context.properties) {
-    _context.properties[key] = val;
+  if (_localEvaluator) {
+    // Definitions are on the device: re-evaluate, no request
+    evaluateLocally();
+    if (onComplete)
+      onComplete(true, "");
+    return;
   }
 
-  _lastContextHash = newHash;
-  _stats.contextChangeCount++;
+  // The ETag describes the previous context's flags
+  _etag.clear();
+
+  SnapshotCache::Entry prefetched;
+  if (takePrefetched(newHash, prefetched)) {
+    // Evaluated ahead of time: publish it and complete without a request
+    _stats.prefetchHitCount++;
+    _prefetchUsedBytes += static_cast<long long>(prefetched.responseBytes);
+    _etag = prefetched.etag;
+    replaceRealtimeFlags(std::move(prefetched.flags));
+    if (_snapshots->enabled()) {
+      _snapshots->put(newHash, _realtimeFlags, _etag);
+      saveSnapshots();
+    }
+    if (onComplete)
+      onComplete(true, "");
+    return;
+  }
+
+  if (_snapshots->enabled()) {
+    if (const SnapshotCache::Entry* snapshot = _snapshots->find(newHash)) {
+      // Seen recently: publish its flags now; the fetch below revalidates them with its ETag
+      _stats.snapshotCacheHitCount++;
+      _etag = snapshot->etag;
+      auto flags = snapshot->flags;
+      replaceRealtimeFlags(std::move(flags));
+      if (onComplete) {
+        onComplete(true, "");
+        onComplete = nullptr;
+      }
+    } else {
+      _stats.snapshotCacheMissCount++;
+    }
+  }
 
   if (!_started || _config.features.offlineMode) {
     // No fetch — notify caller immediately
@@ -254,18 +405,163 @@ void FeaturesClient::updateContext(const GatrixContext& context,
   fetchFlags();
 }
 
-std::string FeaturesClient::computeContextHash(const GatrixContext& context) {
-  // Build a deterministic string from context fields
-  std::string input = context.userId + "|" + context.sessionId + "|" + context.currentTime;
+GatrixContext FeaturesClient::mergeContext(const GatrixContext& base,
+                                           const GatrixContext& context) {
+  GatrixContext merged = base;
+  merged.userId = context.userId;
+  merged.sessionId = context.sessionId;
+  if (!context.currentTime.empty())
+    merged.currentTime = context.currentTime;
 
-  // Properties are already in a sorted std::map
   for (const auto& [key, val] : context.properties) {
-    input += "|" + key + "=" + val;
+    merged.properties[key] = val;
+  }
+  return merged;
+}
+
+void FeaturesClient::stageContextFields(GatrixContext& staged, const GatrixContext& context) {
+  // Unlike mergeContext, an empty userId/sessionId does not clear one staged earlier in the
+  // transaction; removeContextField does that
+  if (!context.userId.empty())
+    staged.userId = context.userId;
+  if (!context.sessionId.empty())
+    staged.sessionId = context.sessionId;
+  if (!context.remoteAddress.empty())
+    staged.remoteAddress = context.remoteAddress;
+  if (!context.currentTime.empty())
+    staged.currentTime = context.currentTime;
+
+  for (const auto& [key, val] : context.properties) {
+    staged.properties[key] = val;
+  }
+}
+
+void FeaturesClient::prefetchContext(const GatrixContext& context) {
+  // Nothing to fetch offline; local evaluation switches contexts without a request anyway
+  if (_config.features.offlineMode || _config.features.enableLocalEvaluation ||
+      !_prefetched.enabled())
+    return;
+
+  GatrixContext merged = mergeContext(_context, context);
+  std::string hash = computeContextHash(merged);
+  if (hash == _lastContextHash || _prefetched.contains(hash))
+    return;
+  for (const auto& queued : _prefetchQueue) {
+    if (queued.first == hash)
+      return;
   }
 
-  // Simple hash using std::hash (fast, sufficient for change detection)
-  std::hash<std::string> hasher;
-  return std::to_string(hasher(input));
+  // Only the most recent guesses are worth a request
+  _prefetchQueue.emplace_back(std::move(hash), std::move(merged));
+  if (static_cast<int>(_prefetchQueue.size()) > _config.features.prefetchCacheSize)
+    _prefetchQueue.erase(_prefetchQueue.begin());
+  drainPrefetchQueue();
+}
+
+bool FeaturesClient::takePrefetched(const std::string& contextHash, SnapshotCache::Entry& out) {
+  if (!_prefetched.take(contextHash, out))
+    return false;
+  auto age = std::chrono::steady_clock::now() - out.storedAt;
+  if (age > std::chrono::seconds(_config.features.prefetchMaxAge)) {
+    // Too old to publish without revalidating; counted as wasted
+    return false;
+  }
+  return true;
+}
+
+void FeaturesClient::drainPrefetchQueue() {
+  if (_prefetchInFlight || _prefetchQueue.empty() || !_started)
+    return;
+
+  if (_isFetchingFlags) {
+    // Low priority: never compete with a fetch of the current context
+    if (!_prefetchDrainScheduled) {
+      _prefetchDrainScheduled = true;
+      Director::getInstance()->getScheduler()->schedule(
+          [this](float) {
+            _prefetchDrainScheduled = false;
+            drainPrefetchQueue();
+          },
+          this, 0.25f, 0, 0, false, "GatrixPrefetch");
+    }
+    return;
+  }
+
+  std::string hash = std::move(_prefetchQueue.front().first);
+  GatrixContext context = std::move(_prefetchQueue.front().second);
+  _prefetchQueue.erase(_prefetchQueue.begin());
+  _prefetchInFlight = true;
+
+  TransportRequest request;
+  request.requestClass = RequestClass::PREFETCH;
+  request.url = withInterestQuery(_config.apiUrl + "/evaluate-all");
+  request.post = true;
+
+  std::vector<std::string>& headers = request.headers;
+  headers.push_back("Content-Type: application/json");
+  headers.push_back("X-API-Token: " + _config.apiToken);
+  headers.push_back("X-Application-Name: " + _config.appName);
+  headers.push_back("X-Connection-Id: " + _connectionId);
+  headers.push_back("X-SDK-Version: " + std::string(SDK_NAME) + "/" + std::string(SDK_VERSION));
+  headers.push_back("X-Gatrix-Context-Hash: " + hash);
+  if (_config.features.enableCompression)
+    headers.push_back("Accept-Encoding: gzip, deflate");
+  for (const auto& [key, val] : _config.customHeaders) {
+    headers.push_back(key + ": " + val);
+  }
+  request.body = buildEvalRequestBody(context, {});
+  encodeRequestBody(request.body, headers);
+
+  sendRequest(request, [this, hash](TransportResponse& response) {
+    recordTransportTiming(response);
+    if (response.statusCode != 200) {
+      if (_config.enableDevMode) {
+        CCLOG("[GatrixSDK][DEV] Prefetch failed (status %d)", response.statusCode);
+      }
+      _prefetchInFlight = false;
+      drainPrefetchQueue();
+      return;
+    }
+
+    // Parse on the shared worker; only the result is handed back, and only to a live client
+    std::string etag = findResponseHeader(response.headers, "ETag");
+    bool compressed = _config.features.enableCompression &&
+                      GatrixCompression::isCompressed(response.body.data(), response.body.size());
+    std::weak_ptr<bool> alive = _alive;
+    _decodeWorker->post([this, alive, hash, etag, compressed,
+                         data = std::move(response.body)]() {
+      if (alive.expired())
+        return;
+      auto decoded = std::make_shared<FetchPayload>();
+      std::string error;
+      rapidjson::Document doc;
+      if (compressed) {
+        InflateStream stream(data.data(), data.size());
+        doc.ParseStream(stream);
+        if (stream.hasError())
+          error = "Decompression error";
+      } else {
+        std::string body(data.begin(), data.end());
+        doc.Parse(body.c_str());
+      }
+      bool parsed = error.empty() && parseFlagsDocument(doc, *decoded, error);
+      size_t wireBytes = data.size();
+
+      Director::getInstance()->getScheduler()->performFunctionInCocosThread(
+          [this, alive, hash, etag, decoded, parsed, wireBytes]() {
+            if (alive.expired())
+              return;
+            _prefetchInFlight = false;
+            // A context switched to meanwhile is fetched normally; keep the cache to guesses
+            if (parsed && hash != _lastContextHash) {
+              _prefetched.put(hash, decoded->flags, etag, wireBytes);
+              _stats.prefetchCount++;
+              _stats.prefetchBytes += static_cast<long long>(wireBytes);
+            }
+            drainPrefetchQueue();
+          });
+    });
+  });
 }
 
 // ==================== Flag Access ====================
@@ -281,6 +577,7 @@ const EvaluatedFlag* FeaturesClient::lookupFlag(const std::string& flagName,
                                                 const std::string& eventType, bool forceRealtime) {
   const auto& flags = selectFlags(forceRealtime);
   auto it = flags.find(flagName);
+  observeInterest(flagName);
   if (it == flags.end()) {
     _stats.missingFlags[flagName]++;
     return nullptr;
@@ -319,6 +616,7 @@ FlagProxy FeaturesClient::createProxyForWatch(const std::string& flagName, bool
   const auto& flags = selectFlags(forceRealtime);
   auto it = flags.find(flagName);
   const EvaluatedFlag* flag = (it != flags.end()) ? &it->second : nullptr;
+  observeInterest(flagName);
 
   if (flag) {
     trackAccess(flagName, flag->enabled, flag->variant.name, "watch");
@@ -336,6 +634,24 @@ bool FeaturesClient::hasFlag(const std::string& flagName) const {
   return flags.find(flagName) != flags.end();
 }
 
+// ==================== Change Detection ====================
+
+uint64_t FeaturesClient::getGeneration(bool forceRealtime) const {
+  bool realtime = forceRealtime || !_explicitSyncMode;
+  return (realtime ? _realtimeGeneration : _syncedGeneration).load(std::memory_order_acquire);
+}
+
+const std::atomic<uint64_t>& FeaturesClient::getFlagGeneration(const std::string& flagName,
+                                                               bool forceRealtime) {
+  bool realtime = forceRealtime || !_explicitSyncMode;
+  auto& slots = realtime ? _realtimeFlagGenerations : _syncedFlagGenerations;
+  std::lock_guard<std::mutex> lock(_flagGenerationsMutex);
+  auto it = slots.find(flagName);
+  if (it == slots.end())
+    it = slots.try_emplace(flagName, getGeneration(realtime)).first;
+  return it->second;
+}
+
 // ==================== Variations ====================
 
 std::string FeaturesClient::variation(const std::string& flagName, const std::string& fallbackValue,
@@ -453,7 +769,13 @@ void FeaturesClient::setExplicitSyncMode(bool enabled) {
   if (_explicitSyncMode == enabled)
     return;
   _explicitSyncMode = enabled;
+  FlagDiff diff = diffFlags(_synchronizedFlags, _realtimeFlags);
   _synchronizedFlags = _realtimeFlags;
+  advanceGeneration(diff, /*forceRealtime=*/false);
+  // Reads switch snapshots: both hold the same flags now and share the larger generation
+  uint64_t generation = std::max(_realtimeGeneration.load(), _syncedGeneration.load());
+  _realtimeGeneration.store(generation, std::memory_order_release);
+  _syncedGeneration.store(generation, std::memory_order_release);
   _pendingSync = false;
 }
 
@@ -469,15 +791,13 @@ void FeaturesClient::syncFlags(bool fetchNow,
     return;
   }
 
-  auto oldSynchronizedFlags = _synchronizedFlags;
-  std::string oldHash = _flagsContextHash;
-  std::string newHash = _lastContextHash;
+  FlagDiff diff = diffFlags(_synchronizedFlags, _realtimeFlags);
 
   _synchronizedFlags = _realtimeFlags;
-  _flagsContextHash = newHash;
+  _flagsContextHash = _lastContextHash;
+  advanceGeneration(diff, /*forceRealtime=*/false);
 
-  invokeWatchCallbacks(_syncedWatchCallbacks, oldSynchronizedFlags, _synchronizedFlags,
-                       /*forceRealtime=*/false, oldHash, newHash);
+  invokeWatchCallbacks(_syncedWatchCallbacks, diff, /*forceRealtime=*/false);
   _pendingSync = false;
   _stats.syncFlagsCount++;
   _emitter.emit(EVENTS::FLAGS_SYNC);
@@ -496,6 +816,7 @@ void FeaturesClient::syncFlags(bool fetchNow,
 std::function<void()> FeaturesClient::watchRealtimeFlag(const std::string& flagName,
                                                         WatchCallback callback,
                                                         const std::string& name) {
+  observeInterest(flagName);
   _watchCallbacks[flagName].push_back(callback);
 
   // Capture a copy of the callback for removal
@@ -529,6 +850,7 @@ std::function<void()> FeaturesClient::watchRealtimeFlagWithInitialState(const st
 std::function<void()> FeaturesClient::watchSyncedFlag(const std::string& flagName,
                                                       WatchCallback callback,
                                                       const std::string& name) {
+  observeInterest(flagName);
   _syncedWatchCallbacks[flagName].push_back(callback);
 
   auto cbPtr = &_syncedWatchCallbacks[flagName].back();
@@ -566,6 +888,11 @@ WatchFlagGroup* FeaturesClient::createWatchFlagGroup(const std::string& name) {
 
 // ==================== Network ====================
 
+void FeaturesClient::setTransport(ITransport* transport) {
+  // nullptr restores the configured backend
+  _transport = transport ? transport : _defaultTransport.get();
+}
+
 void FeaturesClient::fetchFlags() {
   fetchFlags(nullptr);
 }
@@ -575,8 +902,14 @@ void FeaturesClient::fetchFlags(std::function<void(bool, const std::string&)> on
     _pendingFetchCallbacks.push_back(std::move(onComplete));
   }
 
-  if (_isFetchingFlags) return;
+  if (_isFetchingFlags) {
+    // Single-flight: join an in-flight full fetch; run after an in-flight partial one
+    if (_partialFetchInFlight)
+      _fullFetchQueued = true;
+    return;
+  }
   _isFetchingFlags = true;
+  _fullFetchQueued = false;
   _fetchStartContextHash = _lastContextHash;
 
   if (_config.enableDevMode) {
@@ -586,143 +919,87 @@ void FeaturesClient::fetchFlags(std::function<void(bool, const std::string&)> on
   _stats.fetchFlagsCount++;
   _lastContextHash = computeContextHash(_context);
 
-  auto request = new HttpRequest();
-  request->setUrl((_config.apiUrl + "/evaluate-all").c_str());
-  request->setRequestType(HttpRequest::Type::POST);
+  // Delta basis: the server answers with only added/changed/removed flags since this revision
+  std::string url = _config.apiUrl + "/evaluate-all";
+  _deltaRequested = canDeltaSync();
+  if (_config.features.enableLocalEvaluation) {
+    // Definitions do not depend on the context; they are evaluated here
+    url = _config.apiUrl + "/client/features/definitions";
+    _deltaRequested = false;
+  } else {
+    if (_deltaRequested)
+      url += "?since=" + std::to_string(_syncRevision);
+    url = withInterestQuery(url);
+  }
+
+  TransportRequest request;
+  request.requestClass = RequestClass::FETCH;
+  request.url = url;
+  request.post = !_config.features.enableLocalEvaluation;
 
   // Headers
-  std::vector<std::string> headers;
+  std::vector<std::string>& headers = request.headers;
   headers.push_back("Content-Type: application/json");
   headers.push_back("X-API-Token: " + _config.apiToken);
   headers.push_back("X-Application-Name: " + _config.appName);
   headers.push_back("X-Connection-Id: " + _connectionId);
   headers.push_back("X-SDK-Version: " + std::string(SDK_NAME) + "/" + std::string(SDK_VERSION));
   headers.push_back("X-Gatrix-Context-Hash: " + _lastContextHash);
-  if (!_etag.empty())
+  // A stored ETag cannot revalidate definitions that were not kept across restarts
+  bool haveDefinitions = !_config.features.enableLocalEvaluation || _localEvaluator;
+  if (!_etag.empty() && haveDefinitions)
     headers.push_back("If-None-Match: " + _etag);
+  if (_config.features.enableScheduledActivations)
+    headers.push_back("X-Gatrix-Accept-Scheduled: true");
+  if (_config.features.enableCompression)
+    headers.push_back("Accept-Encoding: gzip, deflate");
   for (const auto& [key, val] : _config.customHeaders) {
     headers.push_back(key + ": " + val);
   }
-  request->setHeaders(headers);
 
   // Body - serialize context
-  rapidjson::Document doc;
-  doc.SetObject();
-  auto& alloc = doc.GetAllocator();
-
-  rapidjson::Value ctxObj(rapidjson::kObjectType);
-  if (!_context.userId.empty())
-    ctxObj.AddMember("userId", rapidjson::Value(_context.userId.c_str(), alloc), alloc);
-  if (!_context.sessionId.empty())
-    ctxObj.AddMember("sessionId", rapidjson::Value(_context.sessionId.c_str(), alloc), alloc);
-
-  for (const auto& [key, val] : _context.properties) {
-    ctxObj.AddMember(rapidjson::Value(key.c_str(), alloc), rapidjson::Value(val.c_str(), alloc),
-                     alloc);
+  if (request.post) {
+    request.body = buildEvalRequestBody(_context, {});
+    encodeRequestBody(request.body, headers);
   }
-  doc.AddMember("context", ctxObj, alloc);
 
-  rapidjson::StringBuffer buffer;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-  doc.Accept(writer);
-  request->setRequestData(buffer.GetString(), buffer.GetSize());
-
-  // Response callback
-  request->setResponseCallback([this](HttpClient* client, HttpResponse* response) {
-    if (!response) {
-      onFetchError(-1, "No response");
+  // Response callback (cocos thread)
+  _fetchSentAt = std::chrono::steady_clock::now();
+  sendRequest(request, [this](TransportResponse& response) {
+    recordTransportTiming(response);
+    if (response.statusCode <= 0) {
+      onFetchError(-1, response.error.empty() ? "No response" : response.error);
       // Network error: schedule with backoff
       _consecutiveFailures++;
       scheduleNextRefresh();
       return;
     }
 
-    int statusCode = static_cast<int>(response->getResponseCode());
-    if (response->isSucceed() && statusCode == 200) {
-      auto* data = response->getResponseData();
-      std::string body(data->begin(), data->end());
-
-      // Extract etag from response headers
-      std::string newEtag;
-      auto* responseHeaders = response->getResponseHeader();
-      if (responseHeaders) {
-        std::string headerStr(responseHeaders->begin(), responseHeaders->end());
-        auto pos = headerStr.find("etag:");
-        if (pos == std::string::npos)
-          pos = headerStr.find("ETag:");
-        if (pos != std::string::npos) {
-          auto start = headerStr.find_first_not_of(" ", pos + 5);
-          auto end = headerStr.find("\r\n", start);
-          if (start != std::string::npos) {
-            newEtag = headerStr.substr(start, end - start);
-          }
-        }
-      }
-      onFetchResponse(statusCode, body, newEtag);
+    int statusCode = response.statusCode;
+    applyPollingHints(response.headers);
+    sampleServerClock(response.headers);
+    if (_config.features.enableLocalEvaluation) {
+      // Context changes while definitions were in flight are picked up when they are evaluated
+      _fetchStartContextHash = _lastContextHash;
+    }
 
-      // Success: reset failure counter and schedule at normal interval
-      _consecutiveFailures = 0;
+    if (statusCode == 200) {
+      const std::vector<char>& data = response.body;
+      std::string newEtag = findResponseHeader(response.headers, "ETag");
 
-      // Check context change / pending invalidation before scheduling
-      _isFetchingFlags = false;
-      if (_lastContextHash != _fetchStartContextHash) {
-        if (_config.enableDevMode) {
-          CCLOG("[GatrixSDK][DEV] Context changed during fetch, triggering re-fetch");
-        }
-        _etag.clear();
-        _pendingInvalidationKeys.clear();
-        fetchFlags();
-      } else if (!_pendingInvalidationKeys.empty()) {
-        auto pendingKeys = _pendingInvalidationKeys;
-        _pendingInvalidationKeys.clear();
-        if (pendingKeys.count("*") > 0) {
-          _etag.clear();
-          fetchFlags();
-        } else {
-          auto totalFlags = static_cast<int>(_realtimeFlags.size());
-          auto pendingCount = static_cast<int>(pendingKeys.size());
-          if (totalFlags == 0 || pendingCount >= totalFlags / 2) {
-            _etag.clear();
-            fetchFlags();
-          } else {
-            std::vector<std::string> keysVec(pendingKeys.begin(), pendingKeys.end());
-            fetchPartialFlags(keysVec);
-          }
-        }
-      } else {
-        scheduleNextRefresh();
+      // Compressed body the platform did not decode: inflate + parse off the cocos thread
+      if (_config.features.enableCompression &&
+          GatrixCompression::isCompressed(data.data(), data.size())) {
+        decodeFetchResponseAsync(statusCode, std::move(response.body), newEtag);
+        return;
       }
+
+      std::string body(data.begin(), data.end());
+      onFetchResponse(statusCode, body, newEtag);
+      finishFetchCycle();
     } else if (statusCode == 304) {
       _stats.notModifiedCount++;
-
-      // 304 Not Modified: reset failure counter
-      _consecutiveFailures = 0;
-
-      _isFetchingFlags = false;
-      if (_lastContextHash != _fetchStartContextHash) {
-        _etag.clear();
-        _pendingInvalidationKeys.clear();
-        fetchFlags();
-      } else if (!_pendingInvalidationKeys.empty()) {
-        auto pendingKeys = _pendingInvalidationKeys;
-        _pendingInvalidationKeys.clear();
-        if (pendingKeys.count("*") > 0) {
-          _etag.clear();
-          fetchFlags();
-        } else {
-          auto totalFlags = static_cast<int>(_realtimeFlags.size());
-          auto pendingCount = static_cast<int>(pendingKeys.size());
-          if (totalFlags == 0 || pendingCount >= totalFlags / 2) {
-            _etag.clear();
-            fetchFlags();
-          } else {
-            std::vector<std::string> keysVec(pendingKeys.begin(), pendingKeys.end());
-            fetchPartialFlags(keysVec);
-          }
-        }
-      } else {
-        scheduleNextRefresh();
-      }
+      finishFetchCycle();
       _emitter.emit(EVENTS::FLAGS_FETCH_END);
     } else {
       // Check for non-retryable status codes
@@ -730,8 +1007,9 @@ void FeaturesClient::fetchFlags(std::function<void(bool, const std::string&)> on
       bool isNonRetryable =
           std::find(nonRetryable.begin(), nonRetryable.end(), statusCode) != nonRetryable.end();
 
-      auto* data = response->getResponseData();
-      std::string errBody = data ? std::string(data->begin(), data->end()) : "unknown error";
+      std::string errBody = response.body.empty()
+                                ? std::string("unknown error")
+                                : std::string(response.body.begin(), response.body.end());
       onFetchError(statusCode, errBody);
 
       _isFetchingFlags = false;
@@ -743,8 +1021,7 @@ void FeaturesClient::fetchFlags(std::function<void(bool, const std::string&)> on
         _consecutiveFailures++;
         // Still check context change even on error
         if (_lastContextHash != _fetchStartContextHash) {
-          _etag.clear();
-          _pendingInvalidationKeys.clear();
+          _invalidations.clear();
           fetchFlags();
         } else {
           scheduleNextRefresh();
@@ -752,9 +1029,86 @@ void FeaturesClient::fetchFlags(std::function<void(bool, const std::string&)> on
       }
     }
   });
+}
+
+void FeaturesClient::finishFetchCycle() {
+  // Success or 304: reset failure counter
+  _consecutiveFailures = 0;
+
+  // Check context change / pending invalidation before scheduling
+  _isFetchingFlags = false;
+  if (_lastContextHash != _fetchStartContextHash) {
+    if (_config.enableDevMode) {
+      CCLOG("[GatrixSDK][DEV] Context changed during fetch, triggering re-fetch");
+    }
+    _invalidations.clear();
+    fetchFlags();
+  } else if (_invalidations.hasPending()) {
+    // Merged while in flight; an open debounce window flushes on its own timer
+    if (!_invalidationFlushScheduled)
+      flushInvalidations();
+  } else {
+    scheduleNextRefresh();
+  }
+}
+
+void FeaturesClient::decodeFetchResponseAsync(int statusCode, std::vector<char> compressed,
+                                              const std::string& newEtag) {
+  // _isFetchingFlags stays set until the decoded flags are applied on the cocos thread.
+  // The client may be destroyed meanwhile: the worker only reads what is captured here,
+  // and both sides check the alive token before doing anything for the client
+  std::weak_ptr<bool> alive = _alive;
+  bool localEvaluation = _config.features.enableLocalEvaluation;
+  _decodeWorker->post([this, alive, localEvaluation, statusCode,
+                       compressed = std::move(compressed), newEtag]() {
+    if (alive.expired())
+      return;
+    auto started = std::chrono::steady_clock::now();
+
+    auto decoded = std::make_shared<FetchPayload>();
+    std::shared_ptr<LocalEvaluator> definitions; // enableLocalEvaluation: compiled here too
+    std::string error;
+    rapidjson::Document doc;
+    InflateStream stream(compressed.data(), compressed.size());
+    doc.ParseStream(stream);
+    if (stream.hasError()) {
+      error = "Decompression error";
+    } else if (localEvaluation) {
+      definitions = loadDefinitions(doc, error);
+    } else {
+      parseFlagsDocument(doc, *decoded, error);
+    }
 
-  HttpClient::getInstance()->send(request);
-  request->release();
+    double decodeMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started)
+            .count();
+    auto wireBytes = static_cast<long long>(compressed.size());
+    auto inflatedBytes = static_cast<long long>(stream.totalOut());
+
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread(
+        [this, alive, statusCode, decoded, definitions, error, newEtag, decodeMs, wireBytes,
+         inflatedBytes]() {
+          if (alive.expired())
+            return;
+          _stats.compressedBytesReceived += wireBytes;
+          _stats.decompressedBytes += inflatedBytes;
+          _stats.compressionRatio =
+              _stats.compressedBytesReceived > 0
+                  ? static_cast<double>(_stats.decompressedBytes) /
+                        static_cast<double>(_stats.compressedBytesReceived)
+                  : 0.0;
+          _stats.lastDecodeTimeMs = decodeMs;
+
+          if (!error.empty()) {
+            onFetchError(statusCode, error);
+          } else if (definitions) {
+            applyDefinitions(definitions, newEtag);
+          } else {
+            applyFetchedFlags(std::move(*decoded), newEtag);
+          }
+          finishFetchCycle();
+        });
+  });
 }
 
 void FeaturesClient::onFetchResponse(int statusCode, const std::string& body,
@@ -762,114 +1116,270 @@ void FeaturesClient::onFetchResponse(int statusCode, const std::string& body,
   rapidjson::Document doc;
   doc.Parse(body.c_str());
 
-  if (doc.HasParseError()) {
-    onFetchError(statusCode, "JSON parse error");
+  if (_config.features.enableLocalEvaluation) {
+    std::string error;
+    auto definitions = loadDefinitions(doc, error);
+    if (!definitions) {
+      onFetchError(statusCode, error);
+      return;
+    }
+    applyDefinitions(std::move(definitions), newEtag);
+    return;
+  }
+
+  FetchPayload payload;
+  std::string error;
+  if (!parseFlagsDocument(doc, payload, error)) {
+    onFetchError(statusCode, error);
     return;
   }
+  applyFetchedFlags(std::move(payload), newEtag);
+}
+
+bool FeaturesClient::parseFlagsDocument(const rapidjson::Document& doc, FetchPayload& payload,
+                                        std::string& error) {
+  if (doc.HasParseError()) {
+    error = "JSON parse error";
+    return false;
+  }
+  return parseFlagsValue(doc, payload, error);
+}
 
-  // Navigate to data.flags
+bool FeaturesClient::parseFlagsValue(const rapidjson::Value& doc, FetchPayload& payload,
+                                     std::string& error) {
+  if (!doc.IsObject()) {
+    error = "JSON parse error";
+    return false;
+  }
+
+  // Navigate to data.flags (or a bare top-level flags array)
+  const rapidjson::Value* root = &doc;
+  if (doc.HasMember("data") && doc["data"].IsObject()) {
+    root = &doc["data"];
+  }
   const rapidjson::Value* flagsArray = nullptr;
-  if (doc.HasMember("data") && doc["data"].HasMember("flags") && doc["data"]["flags"].IsArray()) {
-    flagsArray = &doc["data"]["flags"];
+  if (root->HasMember("flags") && (*root)["flags"].IsArray()) {
+    flagsArray = &(*root)["flags"];
   } else if (doc.HasMember("flags") && doc["flags"].IsArray()) {
     flagsArray = &doc["flags"];
   }
 
   if (!flagsArray) {
-    onFetchError(statusCode, "No flags array in response");
-    return;
+    error = "No flags array in response";
+    return false;
   }
 
-  if (!newEtag.empty())
-    _etag = newEtag;
-  _stats.etag = _etag;
-
-  bool changed = false;
-  std::map<std::string, EvaluatedFlag> newFlags;
+  // Delta envelope: { delta: true, revision, flags: [upserts], removed: [names] }
+  if (root->HasMember("revision") && (*root)["revision"].IsNumber()) {
+    payload.revision = (*root)["revision"].IsInt64()
+                           ? (*root)["revision"].GetInt64()
+                           : static_cast<long long>((*root)["revision"].GetDouble());
+  }
+  if (root->HasMember("delta") && (*root)["delta"].IsBool()) {
+    payload.isDelta = (*root)["delta"].GetBool();
+  }
+  if (payload.isDelta && root->HasMember("removed") && (*root)["removed"].IsArray()) {
+    for (const auto& name : (*root)["removed"].GetArray()) {
+      if (name.IsString())
+        payload.removed.push_back(name.GetString());
+    }
+  }
 
-  for (rapidjson::SizeType i = 0; i < flagsArray->Size(); i++) {
-    const auto& fj = (*flagsArray)[i];
+  auto& newFlags = payload.flags;
+  for (const auto& fj : flagsArray->GetArray()) {
     EvaluatedFlag flag;
-    flag.name = fj["name"].GetString();
-    flag.enabled = fj["enabled"].GetBool();
-    flag.version = fj.HasMember("version") ? fj["version"].GetInt() : 0;
-    flag.impressionData = fj.HasMember("impressionData") ? fj["impressionData"].GetBool() : false;
-    if (fj.HasMember("reason") && fj["reason"].IsString())
-      flag.reason = fj["reason"].GetString();
+    if (!parseFlagRecord(fj, flag)) {
+      error = "Invalid flag record";
+      return false;
+    }
+    newFlags[flag.name] = std::move(flag);
+  }
 
-    if (fj.HasMember("variant") && fj["variant"].IsObject()) {
-      const auto& vj = fj["variant"];
-      flag.variant.name = vj["name"].GetString();
-      flag.variant.enabled = vj["enabled"].GetBool();
-      if (vj.HasMember("value")) {
-        if (vj["value"].IsString()) {
-          flag.variant.value = vj["value"].GetString();
-        } else if (vj["value"].IsNumber()) {
-          flag.variant.value = std::to_string(vj["value"].GetDouble());
-        } else if (vj["value"].IsObject() || vj["value"].IsArray()) {
-          rapidjson::StringBuffer sb;
-          rapidjson::Writer<rapidjson::StringBuffer> w(sb);
-          vj["value"].Accept(w);
-          flag.variant.value = sb.GetString();
-        }
+  // Changes published ahead of their activation time (enableScheduledActivations)
+  if (root->HasMember("scheduled") && (*root)["scheduled"].IsArray()) {
+    parseScheduledChanges((*root)["scheduled"], payload);
+  }
+  return true;
+}
+
+bool FeaturesClient::parseFlagRecord(const rapidjson::Value& fj, EvaluatedFlag& flag) {
+  // Required members of the wrong type reject the record (and so the response or payload)
+  if (!fj.IsObject() || !fj.HasMember("name") || !fj["name"].IsString() ||
+      !fj.HasMember("enabled") || !fj["enabled"].IsBool())
+    return false;
+  if ((fj.HasMember("version") && !fj["version"].IsInt()) ||
+      (fj.HasMember("impressionData") && !fj["impressionData"].IsBool()))
+    return false;
+  flag.name = fj["name"].GetString();
+  flag.enabled = fj["enabled"].GetBool();
+  flag.version = fj.HasMember("version") ? fj["version"].GetInt() : 0;
+  flag.impressionData = fj.HasMember("impressionData") ? fj["impressionData"].GetBool() : false;
+  if (fj.HasMember("reason") && fj["reason"].IsString())
+    flag.reason = fj["reason"].GetString();
+
+  if (fj.HasMember("variant") && fj["variant"].IsObject()) {
+    const auto& vj = fj["variant"];
+    if (!vj.HasMember("name") || !vj["name"].IsString() || !vj.HasMember("enabled") ||
+        !vj["enabled"].IsBool())
+      return false;
+    flag.variant.name = vj["name"].GetString();
+    flag.variant.enabled = vj["enabled"].GetBool();
+    if (vj.HasMember("value")) {
+      if (vj["value"].IsString()) {
+        flag.variant.value = vj["value"].GetString();
+      } else if (vj["value"].IsNumber()) {
+        flag.variant.value = std::to_string(vj["value"].GetDouble());
+      } else if (vj["value"].IsBool()) {
+        flag.variant.value = vj["value"].GetBool() ? "true" : "false";
+      } else if (vj["value"].IsObject() || vj["value"].IsArray()) {
+        rapidjson::StringBuffer sb;
+        rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+        vj["value"].Accept(w);
+        flag.variant.value = sb.GetString();
       }
     }
+  }
 
-    if (fj.HasMember("valueType") && fj["valueType"].IsString()) {
-      std::string vt = fj["valueType"].GetString();
-      if (vt == "string")
-        flag.valueType = ValueType::STRING;
-      else if (vt == "number")
-        flag.valueType = ValueType::NUMBER;
-      else if (vt == "json")
-        flag.valueType = ValueType::JSON;
+  if (fj.HasMember("valueType") && fj["valueType"].IsString()) {
+    std::string vt = fj["valueType"].GetString();
+    if (vt == "string")
+      flag.valueType = ValueType::STRING;
+    else if (vt == "number")
+      flag.valueType = ValueType::NUMBER;
+    else if (vt == "boolean")
+      flag.valueType = ValueType::BOOLEAN;
+    else if (vt == "json")
+      flag.valueType = ValueType::JSON;
+  }
+  flag.contentHash = computeFlagContentHash(flag);
+  return true;
+}
+
+void FeaturesClient::parseScheduledChanges(const rapidjson::Value& array, FetchPayload& payload) {
+  // [{ id, activateAt (epoch ms), jitterMs?, cancelled?, flags: [records], removed: [names] }]
+  payload.hasSchedule = true;
+  for (const auto& sj : array.GetArray()) {
+    if (!sj.IsObject() || !sj.HasMember("id") || !sj["id"].IsString() ||
+        !sj.HasMember("activateAt") || !sj["activateAt"].IsNumber())
+      continue;
+    ScheduledChange change;
+    change.id = sj["id"].GetString();
+    change.activateAtMs = static_cast<long long>(sj["activateAt"].GetDouble());
+    if (sj.HasMember("jitterMs") && sj["jitterMs"].IsInt())
+      change.jitterMs = sj["jitterMs"].GetInt();
+    if (sj.HasMember("cancelled") && sj["cancelled"].IsBool())
+      change.cancelled = sj["cancelled"].GetBool();
+    bool recordsValid = true;
+    if (sj.HasMember("flags") && sj["flags"].IsArray()) {
+      for (const auto& fj : sj["flags"].GetArray()) {
+        EvaluatedFlag flag;
+        if (!parseFlagRecord(fj, flag)) {
+          recordsValid = false;
+          break;
+        }
+        change.flags.push_back(std::move(flag));
+      }
+    }
+    if (!recordsValid)
+      continue;
+    if (sj.HasMember("removed") && sj["removed"].IsArray()) {
+      for (const auto& name : sj["removed"].GetArray()) {
+        if (name.IsString())
+          change.removed.push_back(name.GetString());
+      }
     }
+    payload.scheduled.push_back(std::move(change));
+  }
+}
 
-    newFlags[flag.name] = flag;
+void FeaturesClient::applyFetchedFlags(FetchPayload&& payload, const std::string& newEtag) {
+  // The response belongs to the context the request was sent for
+  bool contextSwitched = _fetchStartContextHash != _lastContextHash;
+  if (payload.revision > 0 && !contextSwitched) {
+    _syncRevision = payload.revision;
+    _syncRevisionContextHash = _fetchStartContextHash;
+    _stats.syncRevision = _syncRevision;
+  }
 
-    // Per-flag change detection
-    auto oldIt = _realtimeFlags.find(flag.name);
-    if (oldIt == _realtimeFlags.end() || oldIt->second.version != flag.version) {
-      changed = true;
-      std::string changeType = (oldIt == _realtimeFlags.end()) ? "created" : "updated";
-      _stats.flagLastChangedTimes[flag.name] = "now"; // simplified
-      _emitter.emit(EVENTS::flagChange(flag.name));
+  if (payload.isDelta) {
+    if (contextSwitched) {
+      // Patches the previous context's flags: dropped, the follow-up fetch brings the
+      // current context's (finishFetchCycle)
+      finishFetchSuccess();
+      return;
     }
-  }
 
-  // Detect removed flags - emit bulk event
-  std::vector<std::string> removedNames;
-  for (const auto& pair : _realtimeFlags) {
-    if (newFlags.find(pair.first) == newFlags.end()) {
-      removedNames.push_back(pair.first);
-      changed = true;
+    // Patch the realtime snapshot in place; storePartialFlags handles the diff, watch
+    // callbacks and persistence for the touched records only
+    std::vector<EvaluatedFlag> upserts;
+    upserts.reserve(payload.flags.size());
+    for (auto& entry : payload.flags) {
+      upserts.push_back(std::move(entry.second));
     }
+    storePartialFlags(upserts, payload.removed);
+    enqueueScheduledChanges(std::move(payload.scheduled), false);
+    if (!newEtag.empty())
+      _etag = newEtag;
+    _stats.etag = _etag;
+    rememberSnapshot();
+    _stats.deltaFetchCount++;
+    _stats.updateCount++;
+    _stats.totalFlagCount = static_cast<int>(_realtimeFlags.size());
+    if (_config.enableDevMode) {
+      CCLOG("[GatrixSDK][DEV] Applied delta: %zu upserts, %zu removed, revision=%lld",
+            upserts.size(), payload.removed.size(), _syncRevision);
+    }
+    finishFetchSuccess();
+    return;
   }
-  if (!removedNames.empty()) {
-    _emitter.emit(EVENTS::FLAGS_REMOVED);
+  if (_deltaRequested) {
+    // Server could not serve a delta (log truncated or unsupported): full snapshot
+    _stats.deltaFallbackCount++;
   }
 
-  if (changed || _realtimeFlags.size() != newFlags.size()) {
-    auto oldRealtimeFlags = _realtimeFlags;
-    std::string oldHash = _flagsContextHash;
-    std::string newHash = _lastContextHash;
+  if (_fetchStartContextHash != _lastContextHash) {
+    // Evaluated for a context switched away from while in flight: not published (the
+    // follow-up fetch brings the current one), only kept for a switch back
+    _snapshots->put(_fetchStartContextHash, payload.flags, newEtag);
+    saveSnapshots();
+    finishFetchSuccess();
+    return;
+  }
 
-    _realtimeFlags = newFlags;
-    _flagsContextHash = newHash;
+  if (!newEtag.empty())
+    _etag = newEtag;
+  _stats.etag = _etag;
+  replaceRealtimeFlags(std::move(payload.flags));
+  // A full response lists every pending change; ones missing from it were withdrawn
+  if (payload.hasSchedule)
+    enqueueScheduledChanges(std::move(payload.scheduled), true);
+  rememberSnapshot();
+  finishFetchSuccess();
+}
+
+void FeaturesClient::replaceRealtimeFlags(std::map<std::string, EvaluatedFlag>&& newFlags) {
+  // Content-hash diff: one integer compare per flag, no variant value comparisons
+  FlagDiff diff = diffFlags(_realtimeFlags, newFlags);
+  emitFlagChanges(diff);
+
+  if (!diff.empty()) {
+    _realtimeFlags = std::move(newFlags);
+    updateEtagSource(diff);
+    advanceGeneration(diff, /*forceRealtime=*/true);
+    _flagsContextHash = _lastContextHash;
     _stats.updateCount++;
     _stats.lastUpdateTime = "now"; // simplified
     _stats.totalFlagCount = static_cast<int>(_realtimeFlags.size());
 
     // Always invoke realtime watch callbacks
-    invokeWatchCallbacks(_watchCallbacks, oldRealtimeFlags, _realtimeFlags,
-                         /*forceRealtime=*/true, oldHash, newHash);
+    invokeWatchCallbacks(_watchCallbacks, diff, /*forceRealtime=*/true);
 
     if (!_explicitSyncMode) {
       _synchronizedFlags = _realtimeFlags;
+      advanceGeneration(diff, /*forceRealtime=*/false);
       _pendingSync = false;
       // In non-explicit mode, also invoke synced callbacks
-      invokeWatchCallbacks(_syncedWatchCallbacks, oldRealtimeFlags, _realtimeFlags,
-                           /*forceRealtime=*/false, oldHash, newHash);
+      invokeWatchCallbacks(_syncedWatchCallbacks, diff, /*forceRealtime=*/false);
       _emitter.emit(EVENTS::FLAGS_CHANGE);
     } else {
       if (!_pendingSync) {
@@ -879,7 +1389,51 @@ void FeaturesClient::onFetchResponse(int statusCode, const std::string& body,
     }
     saveToStorage();
   }
+}
+
+std::shared_ptr<LocalEvaluator> FeaturesClient::loadDefinitions(const rapidjson::Document& doc,
+                                                                std::string& error) {
+  if (doc.HasParseError()) {
+    error = "JSON parse error";
+    return nullptr;
+  }
+  auto evaluator = std::make_shared<LocalEvaluator>();
+  if (!evaluator->load(doc, error))
+    return nullptr;
+  return evaluator;
+}
 
+void FeaturesClient::applyDefinitions(std::shared_ptr<LocalEvaluator> evaluator,
+                                      const std::string& newEtag) {
+  // The same definitions as another instance's: keep one compiled program between them
+  std::string sharedEtag;
+  std::shared_ptr<LocalEvaluator> shared = LocalEvaluator::findShared(_environment, sharedEtag);
+  if (shared && !newEtag.empty() && sharedEtag == newEtag)
+    evaluator = std::move(shared);
+
+  _localEvaluator = std::move(evaluator);
+  if (!newEtag.empty())
+    _etag = newEtag;
+  LocalEvaluator::share(_environment, _localEvaluator, _etag);
+  _stats.etag = _etag;
+  if (_config.enableDevMode) {
+    CCLOG("[GatrixSDK][DEV] Loaded definitions for %d flags", _localEvaluator->flagCount());
+  }
+  evaluateLocally();
+  finishFetchSuccess();
+}
+
+void FeaturesClient::evaluateLocally() {
+  auto started = std::chrono::steady_clock::now();
+  std::map<std::string, EvaluatedFlag> flags = _localEvaluator->evaluateAll(_context);
+  _stats.localEvaluationCount++;
+  _stats.lastLocalEvaluationMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started)
+          .count();
+  replaceRealtimeFlags(std::move(flags));
+}
+
+void FeaturesClient::finishFetchSuccess() {
   _stats.lastFetchTime = "now"; // simplified
   _emitter.emit(EVENTS::FLAGS_FETCH_SUCCESS);
   _emitter.emit(EVENTS::FLAGS_FETCH_END);
@@ -982,6 +1536,25 @@ void FeaturesClient::trackAccess(const std::string& flagName, bool enabled,
   }
 }
 
+void FeaturesClient::observeInterest(const std::string& flagName) {
+  if (!_interest.observe(flagName))
+    return;
+  _stats.interestObservedCount++;
+
+  // Outside the set until now, so never fetched: fetch it alone (single-flight folds
+  // several first reads into one follow-up request)
+  if (_started && !_config.features.offlineMode)
+    fetchPartialFlags({flagName});
+}
+
+std::string FeaturesClient::withInterestQuery(std::string url) const {
+  // Sent in the query for both verbs: the server evaluates only the flags of interest
+  std::string query = _interest.toQueryString();
+  if (!query.empty())
+    url += (url.find('?') == std::string::npos ? "?" : "&") + query;
+  return url;
+}
+
 void FeaturesClient::trackImpression(const EvaluatedFlag& flag, const std::string& eventType) {
   if (_config.features.disableMetrics)
     return;
@@ -992,9 +1565,15 @@ void FeaturesClient::trackImpression(const EvaluatedFlag& flag, const std::strin
 
 void FeaturesClient::initFromBootstrap() {
   for (const auto& flag : _config.features.bootstrap) {
-    _realtimeFlags[flag.name] = flag;
+    auto& stored = _realtimeFlags[flag.name];
+    stored = flag;
+    stored.contentHash = computeFlagContentHash(stored);
   }
+  _realtimeEtag.reset(_realtimeFlags);
   _synchronizedFlags = _realtimeFlags;
+  FlagDiff loaded = diffFlags({}, _realtimeFlags);
+  advanceGeneration(loaded, /*forceRealtime=*/true);
+  advanceGeneration(loaded, /*forceRealtime=*/false);
   _stats.totalFlagCount = static_cast<int>(_realtimeFlags.size());
   _emitter.emit(EVENTS::FLAGS_INIT);
 }
@@ -1021,11 +1600,16 @@ void FeaturesClient::initFromStorage() {
       flag.variant.name = vj.HasMember("name") ? vj["name"].GetString() : "";
       flag.variant.enabled = vj.HasMember("enabled") ? vj["enabled"].GetBool() : false;
     }
+    flag.contentHash = computeFlagContentHash(flag);
     _realtimeFlags[flag.name] = flag;
   }
+  _realtimeEtag.reset(_realtimeFlags);
+  FlagDiff loaded = diffFlags({}, _realtimeFlags);
+  advanceGeneration(loaded, /*forceRealtime=*/true);
 
   if (!_config.features.bootstrapOverride || _config.features.bootstrap.empty()) {
     _synchronizedFlags = _realtimeFlags;
+    advanceGeneration(loaded, /*forceRealtime=*/false);
   }
 
   _stats.totalFlagCount = static_cast<int>(_realtimeFlags.size());
@@ -1060,6 +1644,94 @@ void FeaturesClient::saveToStorage() {
   _storage->save("gatrix_flags", sb.GetString());
   if (!_etag.empty())
     _storage->save("gatrix_etag", _etag);
+  else
+    _storage->remove("gatrix_etag");
+}
+
+void FeaturesClient::rememberSnapshot() {
+  // Only a response for the current context describes it
+  if (!_snapshots->enabled() || _fetchStartContextHash != _lastContextHash)
+    return;
+  _snapshots->put(_lastContextHash, _realtimeFlags, _etag);
+  saveSnapshots();
+}
+
+void FeaturesClient::saveSnapshots() {
+  _stats.snapshotCacheEntries = _snapshots->size();
+  _stats.snapshotCacheBytes = static_cast<long long>(_snapshots->bytes());
+  if (!_snapshots->enabled() || !_config.features.persistContextSnapshots)
+    return;
+
+  // [{ contextHash, etag, flags: [evaluate-all records] }], least recently used first
+  rapidjson::Document doc;
+  doc.SetArray();
+  auto& alloc = doc.GetAllocator();
+  for (const SnapshotCache::Entry& entry : *_snapshots) {
+    rapidjson::Value flags(rapidjson::kArrayType);
+    for (const auto& [name, flag] : entry.flags) {
+      rapidjson::Value flagObj(rapidjson::kObjectType);
+      flagObj.AddMember("name", rapidjson::Value(name.c_str(), alloc), alloc);
+      flagObj.AddMember("enabled", flag.enabled, alloc);
+      flagObj.AddMember("version", flag.version, alloc);
+      flagObj.AddMember("impressionData", flag.impressionData, alloc);
+      if (!flag.reason.empty())
+        flagObj.AddMember("reason", rapidjson::Value(flag.reason.c_str(), alloc), alloc);
+      const char* valueType = flag.valueType == ValueType::STRING    ? "string"
+                              : flag.valueType == ValueType::NUMBER  ? "number"
+                              : flag.valueType == ValueType::BOOLEAN ? "boolean"
+                              : flag.valueType == ValueType::JSON    ? "json"
+                                                                     : nullptr;
+      if (valueType)
+        flagObj.AddMember("valueType", rapidjson::StringRef(valueType), alloc);
+
+      rapidjson::Value varObj(rapidjson::kObjectType);
+      varObj.AddMember("name", rapidjson::Value(flag.variant.name.c_str(), alloc), alloc);
+      varObj.AddMember("enabled", flag.variant.enabled, alloc);
+      varObj.AddMember("value", rapidjson::Value(flag.variant.value.c_str(), alloc), alloc);
+      flagObj.AddMember("variant", varObj, alloc);
+      flags.PushBack(flagObj, alloc);
+    }
+
+    rapidjson::Value entryObj(rapidjson::kObjectType);
+    entryObj.AddMember("contextHash", rapidjson::Value(entry.contextHash.c_str(), alloc), alloc);
+    entryObj.AddMember("etag", rapidjson::Value(entry.etag.c_str(), alloc), alloc);
+    entryObj.AddMember("flags", flags, alloc);
+    doc.PushBack(entryObj, alloc);
+  }
+
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  doc.Accept(writer);
+  _storage->save("gatrix_snapshots", sb.GetString());
+}
+
+void FeaturesClient::loadSnapshots() {
+  if (!_snapshots->enabled() || !_config.features.persistContextSnapshots)
+    return;
+  std::string stored = _storage->get("gatrix_snapshots");
+  if (stored.empty())
+    return;
+
+  rapidjson::Document doc;
+  doc.Parse(stored.c_str());
+  if (doc.HasParseError() || !doc.IsArray())
+    return;
+
+  for (const auto& entry : doc.GetArray()) {
+    FetchPayload payload;
+    std::string error;
+    if (!entry.IsObject() || !entry.HasMember("contextHash") ||
+        !entry["contextHash"].IsString() || !parseFlagsValue(entry, payload, error))
+      continue;
+    // Shared with the other instances: what they hold already is newer
+    if (_snapshots->contains(entry["contextHash"].GetString()))
+      continue;
+    std::string etag =
+        entry.HasMember("etag") && entry["etag"].IsString() ? entry["etag"].GetString() : "";
+    _snapshots->put(entry["contextHash"].GetString(), payload.flags, etag);
+  }
+  _stats.snapshotCacheEntries = _snapshots->size();
+  _stats.snapshotCacheBytes = static_cast<long long>(_snapshots->bytes());
 }
 
 void FeaturesClient::scheduleNextRefresh() {
@@ -1070,21 +1742,16 @@ void FeaturesClient::scheduleNextRefresh() {
   // Cancel existing timer
   unschedulePolling();
 
-  float delay = static_cast<float>(_config.features.refreshInterval);
-
-  // Apply exponential backoff on consecutive failures
-  if (_consecutiveFailures > 0) {
-    float initialBackoff = _config.features.fetchRetryOptions.initialBackoff;
-    float maxBackoffVal = _config.features.fetchRetryOptions.maxBackoff;
-    float backoffSec = std::min(
-        initialBackoff * static_cast<float>(std::pow(2, _consecutiveFailures - 1)), maxBackoffVal);
-    delay = backoffSec;
-  }
+  // Mode-dependent interval (safety poll while streaming is healthy), failure backoff,
+  // server hints and Retry-After are all resolved by the polling scheduler
+  const auto& retry = _config.features.fetchRetryOptions;
+  float delay = _polling.nextDelay(_consecutiveFailures, retry.initialBackoff, retry.maxBackoff);
 
   if (_config.enableDevMode) {
-    CCLOG("[GatrixSDK][DEV] scheduleNextRefresh: delay=%.1fs, "
+    CCLOG("[GatrixSDK][DEV] scheduleNextRefresh: delay=%.1fs, mode=%s, "
           "consecutiveFailures=%d, pollingStopped=%s",
-          delay, _consecutiveFailures, _pollingStopped ? "True" : "False");
+          delay, PollingScheduler::modeName(_polling.mode()), _consecutiveFailures,
+          _pollingStopped ? "True" : "False");
   }
 
   Director::getInstance()->getScheduler()->schedule([this](float) { this->fetchFlags(); }, this,
@@ -1097,12 +1764,30 @@ void FeaturesClient::unschedulePolling() {
   }
 }
 
+void FeaturesClient::applyPollingHints(const std::string& headers) {
+  int pollInterval = parseHeaderSeconds(findResponseHeader(headers, "X-Poll-Interval"));
+  if (pollInterval > 0)
+    _polling.setServerInterval(pollInterval);
+  // HTTP-date form of Retry-After is not used by the edge; only delta-seconds is honoured
+  _polling.setRetryAfter(parseHeaderSeconds(findResponseHeader(headers, "Retry-After")));
+}
+
+void FeaturesClient::onStreamingStateChanged(StreamingConnectionState state) {
+  bool wasHealthy = _polling.mode() == PollingMode::HEALTHY;
+  _polling.onStreamingState(state == StreamingConnectionState::CONNECTED);
+
+  // Leaving the long safety interval: re-arm so polling takes over without waiting it out
+  if (wasHealthy && _polling.mode() != PollingMode::HEALTHY && !_isFetchingFlags)
+    scheduleNextRefresh();
+}
+
 GatrixSdkStats FeaturesClient::getStats() const {
   auto stats = _stats;
   stats.totalFlagCount = static_cast<int>(selectFlags(false).size());
   stats.sdkState = _sdkState;
   stats.etag = _etag;
   stats.offlineMode = _config.features.offlineMode;
+  stats.interestKeyCount = _interest.enabled() ? _interest.size() : 0;
   stats.missingFlags = stats.missingFlags;
   stats.flagEnabledCounts = stats.flagEnabledCounts;
   stats.flagVariantCounts = stats.flagVariantCounts;
@@ -1119,17 +1804,35 @@ GatrixSdkStats FeaturesClient::getStats() const {
 
   // Streaming stats
   if (_streaming) {
-    stats.streamingTransport = _streaming->getTransportName();
-    stats.streamingState = _streaming->getStateName();
-    stats.streamingReconnectCount = _streaming->getReconnectCount();
-    stats.streamingEventCount = _streaming->getEventCount();
-    stats.streamingErrorCount = _streaming->getErrorCount();
-    stats.streamingRecoveryCount = _streaming->getRecoveryCount();
-    stats.lastStreamingError = _streaming->getLastError();
-    stats.lastStreamingEventTime = _streaming->getLastEventTime();
-    stats.lastStreamingErrorTime = _streaming->getLastErrorTime();
-    stats.lastStreamingRecoveryTime = _streaming->getLastRecoveryTime();
-  }
+    stats.streamingTransport = _streaming->connection().getTransportName();
+    stats.streamingState = _streaming->connection().getStateName();
+    stats.streamingReconnectCount = _streaming->connection().getReconnectCount();
+    stats.streamingEventCount = _streaming->connection().getEventCount();
+    stats.streamingErrorCount = _streaming->connection().getErrorCount();
+    stats.streamingRecoveryCount = _streaming->connection().getRecoveryCount();
+    stats.lastStreamingError = _streaming->connection().getLastError();
+    stats.lastStreamingEventTime = _streaming->connection().getLastEventTime();
+    stats.lastStreamingErrorTime = _streaming->connection().getLastErrorTime();
+    stats.lastStreamingRecoveryTime = _streaming->connection().getLastRecoveryTime();
+  }
+
+  stats.httpBackend = _transport->name();
+
+  // Prefetched bytes not used yet are neither used nor wasted
+  long long pendingPrefetchBytes = 0;
+  for (const SnapshotCache::Entry& entry : _prefetched) {
+    pendingPrefetchBytes += static_cast<long long>(entry.responseBytes);
+  }
+  stats.prefetchWastedBytes = stats.prefetchBytes - _prefetchUsedBytes - pendingPrefetchBytes;
+  stats.prefetchHitRate =
+      stats.prefetchCount > 0
+          ? static_cast<double>(stats.prefetchHitCount) / static_cast<double>(stats.prefetchCount)
+          : 0.0;
+
+  // Polling stats
+  stats.pollingMode = PollingScheduler::modeName(_polling.mode());
+  stats.pollingInterval = _polling.lastDelay();
+  stats.serverPollInterval = _polling.serverInterval();
 
   return stats;
 }
@@ -1155,11 +1858,18 @@ GatrixLightStats FeaturesClient::getLightStats() const {
   light.syncFlagsCount = _stats.syncFlagsCount;
   light.metricsSentCount = _stats.metricsSentCount;
   light.metricsErrorCount = _stats.metricsErrorCount;
+  light.compressionRatio = _stats.compressionRatio;
+  light.lastDecodeTimeMs = _stats.lastDecodeTimeMs;
+  light.deltaFetchCount = _stats.deltaFetchCount;
+  light.invalidationEventCount = _stats.invalidationEventCount;
+  light.invalidationFlushCount = _stats.invalidationFlushCount;
+  light.syncRevision = _stats.syncRevision;
+  light.pollingMode = PollingScheduler::modeName(_polling.mode());
 
   if (_streaming) {
-    light.streamingState = _streaming->getStateName();
-    light.streamingReconnectCount = _streaming->getReconnectCount();
-    light.lastStreamingEventTime = _streaming->getLastEventTime();
+    light.streamingState = _streaming->connection().getStateName();
+    light.streamingReconnectCount = _streaming->connection().getReconnectCount();
+    light.lastStreamingEventTime = _streaming->connection().getLastEventTime();
   }
 
   return light;
@@ -1268,69 +1978,70 @@ const EvaluatedFlag* FeaturesClient::getRawFlagInternal(const std::string& flagN
   return &it->second;
 }
 
-// ==================== InvokeWatchCallbacks ====================
+// ==================== Change Notification ====================
 
-void FeaturesClient::invokeWatchCallbacks(
-    std::map<std::string, std::vector<WatchCallback>>& callbackMap,
-    const std::map<std::string, EvaluatedFlag>& oldFlags,
-    const std::map<std::string, EvaluatedFlag>& newFlags, bool forceRealtime,
-    const std::string& oldContextHash, const std::string& newContextHash) {
-  // Check for changed/new flags
-  for (const auto& [name, newFlag] : newFlags) {
-    auto oldIt = oldFlags.find(name);
-
-    bool isSame = false;
-    if (oldIt != oldFlags.end()) {
-      const auto& oldFlag = oldIt->second;
-      // Fast path: same context and version means same outcome
-      if (!oldContextHash.empty() && !newContextHash.empty() && oldContextHash == newContextHash &&
-          oldFlag.version == newFlag.version) {
-        isSame = true;
-      } else {
-        // Detailed comparison
-        if (oldFlag.enabled == newFlag.enabled && oldFlag.variant.name == newFlag.variant.name &&
-            oldFlag.variant.enabled == newFlag.variant.enabled &&
-            oldFlag.variant.value == newFlag.variant.value) {
-          isSame = true;
-        }
-      }
-    }
+void FeaturesClient::emitFlagChanges(const FlagDiff& diff) {
+  for (const auto& name : diff.added) {
+    _stats.flagLastChangedTimes[name] = "now"; // simplified
+    _emitter.emit(EVENTS::flagChange(name));
+  }
+  for (const auto& name : diff.changed) {
+    _stats.flagLastChangedTimes[name] = "now"; // simplified
+    _emitter.emit(EVENTS::flagChange(name));
+  }
+  // Removed flags - emit bulk event
+  if (!diff.removed.empty()) {
+    _emitter.emit(EVENTS::FLAGS_REMOVED);
+  }
+}
 
-    if (!isSame) {
-      _stats.flagLastChangedTimes[name] = "now";
-
-      auto cbIt = callbackMap.find(name);
-      if (cbIt != callbackMap.end() && !cbIt->second.empty()) {
-        auto proxy = createProxyForWatch(name, forceRealtime);
-        // Copy to avoid mutation during iteration
-        auto callbacks = cbIt->second;
-        for (const auto& cb : callbacks) {
-          try {
-            cb(proxy);
-          } catch (const std::exception& e) {
-            CCLOG("[GatrixSDK] Error in watch callback for %s: %s", name.c_str(), e.what());
-          }
-        }
+void FeaturesClient::advanceGeneration(const FlagDiff& diff, bool forceRealtime) {
+  if (diff.empty())
+    return;
+  auto& generation = forceRealtime ? _realtimeGeneration : _syncedGeneration;
+  auto& slots = forceRealtime ? _realtimeFlagGenerations : _syncedFlagGenerations;
+  uint64_t next = generation.load(std::memory_order_relaxed) + 1;
+
+  // Flag versions first: a reader that sees the new generation also sees them
+  std::lock_guard<std::mutex> lock(_flagGenerationsMutex);
+  if (!slots.empty()) {
+    for (const auto* names : {&diff.added, &diff.changed, &diff.removed}) {
+      for (const auto& name : *names) {
+        auto it = slots.find(name);
+        if (it != slots.end())
+          it->second.store(next, std::memory_order_release);
       }
     }
   }
+  generation.store(next, std::memory_order_release);
+}
 
-  // Check for removed flags
-  for (const auto& [name, oldFlag] : oldFlags) {
-    if (newFlags.find(name) == newFlags.end()) {
-      auto cbIt = callbackMap.find(name);
-      if (cbIt != callbackMap.end() && !cbIt->second.empty()) {
-        auto proxy = createProxyForWatch(name, forceRealtime);
-        auto callbacks = cbIt->second;
-        for (const auto& cb : callbacks) {
-          try {
-            cb(proxy);
-          } catch (const std::exception& e) {
-            CCLOG("[GatrixSDK] Error in watch callback for removed flag "
-                  "%s: %s",
-                  name.c_str(), e.what());
-          }
-        }
+void FeaturesClient::invokeWatchCallbacks(
+    std::map<std::string, std::vector<WatchCallback>>& callbackMap, const FlagDiff& diff,
+    bool forceRealtime) {
+  if (callbackMap.empty() || diff.empty())
+    return;
+  invokeWatchCallbacksFor(callbackMap, diff.added, forceRealtime);
+  invokeWatchCallbacksFor(callbackMap, diff.changed, forceRealtime);
+  invokeWatchCallbacksFor(callbackMap, diff.removed, forceRealtime);
+}
+
+void FeaturesClient::invokeWatchCallbacksFor(
+    std::map<std::string, std::vector<WatchCallback>>& callbackMap,
+    const std::vector<std::string>& names, bool forceRealtime) {
+  for (const auto& name : names) {
+    auto cbIt = callbackMap.find(name);
+    if (cbIt == callbackMap.end() || cbIt->second.empty())
+      continue;
+
+    auto proxy = createProxyForWatch(name, forceRealtime);
+    // Copy to avoid mutation during iteration
+    auto callbacks = cbIt->second;
+    for (const auto& cb : callbacks) {
+      try {
+        cb(proxy);
+      } catch (const std::exception& e) {
+        CCLOG("[GatrixSDK] Error in watch callback for %s: %s", name.c_str(), e.what());
       }
     }
   }
@@ -1342,48 +2053,192 @@ void FeaturesClient::connectStreaming() {
   if (_streaming)
     return;
 
-  _streaming = new StreamingManager(_config, _emitter);
-  _streaming->setConnectionId(_connectionId);
+  // One connection per environment: instances of the same one subscribe to it
+  std::shared_ptr<ITransport> transport =
+      _transport == _defaultTransport.get()
+          ? _defaultTransport
+          : std::shared_ptr<ITransport>(_transport, [](ITransport*) {});
+  _streaming = StreamingHub::acquire(_config, std::move(transport), _connectionId);
+  _polling.setStreamingEnabled(true);
 
-  // Set invalidation callback
-  _streaming->setInvalidationCallback([this](const std::vector<std::string>& changedKeys) {
-    handleStreamingInvalidation(changedKeys);
-  });
+  StreamingHub::Subscriber subscriber;
+  subscriber.emitter = &_emitter;
 
-  // Set fetch callback (for gap recovery)
-  _streaming->setFetchCallback([this]() {
-    _etag.clear();
+  // Streaming health selects the polling mode
+  subscriber.onStateChange = [this](StreamingConnectionState state) {
+    onStreamingStateChanged(state);
+  };
+
+  // Inline flag records (push-with-payload mode) skip the follow-up fetch
+  subscriber.onPayload = [this](const rapidjson::Value& doc, long globalRevision,
+                                bool contiguous) {
+    return applyStreamingPayload(doc, globalRevision, contiguous);
+  };
+
+  subscriber.onInvalidation = [this](const std::vector<std::string>& changedKeys,
+                                     const StreamingManager::InvalidationHint& hint) {
+    handleStreamingInvalidation(changedKeys, hint);
+  };
+
+  // Gap recovery
+  subscriber.onFetchRequest = [this]() {
+    // With a revision basis the gap is closed by a delta; otherwise refetch everything
+    if (!canDeltaSync())
+      _etag.clear();
     fetchFlags();
-  });
+  };
 
-  _streaming->connect();
+  _streamingSubscription = _streaming->subscribe(std::move(subscriber));
 }
 
 void FeaturesClient::disconnectStreaming() {
   if (!_streaming)
     return;
-  _streaming->disconnect();
-  delete _streaming;
-  _streaming = nullptr;
-}
+  // The connection closes with its last subscriber
+  _streaming->unsubscribe(_streamingSubscription);
+  _streaming.reset();
+  _streamingSubscription = 0;
+  _polling.setStreamingEnabled(false);
+}
+
+bool FeaturesClient::applyStreamingPayload(const rapidjson::Value& doc, long globalRevision,
+                                           bool contiguous) {
+  // Not applicable: skipped revisions, records evaluated for another context, or a fetch in
+  // flight whose response could land after (and overwrite) these newer records
+  bool contextMatches = !doc.HasMember("contextHash") || !doc["contextHash"].IsString() ||
+                        _lastContextHash == doc["contextHash"].GetString();
+  FetchPayload payload;
+  std::string error;
+  if (!contiguous || !contextMatches || _isFetchingFlags ||
+      _config.features.enableLocalEvaluation || !parseFlagsValue(doc, payload, error)) {
+    _stats.pushPayloadFallbackCount++;
+    return false;
+  }
 
-void FeaturesClient::handleStreamingInvalidation(const std::vector<std::string>& changedKeys) {
-  if (_isFetchingFlags) {
-    // Queue keys for processing after current fetch completes
-    for (const auto& key : changedKeys) {
-      _pendingInvalidationKeys.insert(key);
+  // Keys listed in removed (and not re-sent) are deleted by the partial merge
+  std::vector<std::string> removed;
+  if (doc.HasMember("removed") && doc["removed"].IsArray()) {
+    for (const auto& name : doc["removed"].GetArray()) {
+      if (name.IsString())
+        removed.push_back(name.GetString());
     }
-    if (_config.enableDevMode) {
-      CCLOG("[GatrixSDK][DEV] Fetch in progress, queued %zu pending keys", changedKeys.size());
+  }
+
+  std::vector<EvaluatedFlag> upserts;
+  upserts.reserve(payload.flags.size());
+  for (auto& entry : payload.flags) {
+    upserts.push_back(std::move(entry.second));
+  }
+  storePartialFlags(upserts, removed);
+  enqueueScheduledChanges(std::move(payload.scheduled), false);
+  _stats.pushPayloadAppliedCount++;
+
+  // The snapshot now includes this revision, so the next since= starts after it. Only when
+  // it directly follows the basis: a skipped revision still awaiting its fetch stays covered
+  if (_syncRevision > 0 && globalRevision == _syncRevision + 1 &&
+      _syncRevisionContextHash == _lastContextHash) {
+    _syncRevision = globalRevision;
+    _stats.syncRevision = _syncRevision;
+  }
+
+  // Publish -> apply latency, from the server's event timestamp (epoch ms)
+  if (doc.HasMember("timestamp") && doc["timestamp"].IsNumber()) {
+    auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+    _stats.lastPushLatencyMs = nowMs - static_cast<long long>(doc["timestamp"].GetDouble());
+  }
+  if (_config.enableDevMode) {
+    CCLOG("[GatrixSDK][DEV] Applied pushed payload: upserts=%zu, removed=%zu, latency=%lldms",
+          upserts.size(), removed.size(), _stats.lastPushLatencyMs);
+  }
+  return true;
+}
+
+void FeaturesClient::handleStreamingInvalidation(const std::vector<std::string>& changedKeys,
+                                                 const StreamingManager::InvalidationHint& hint) {
+  _stats.invalidationEventCount++;
+
+  // Keys outside the interest set were never fetched: nothing to refresh
+  std::vector<std::string> keys = _interest.intersect(changedKeys);
+  if (!changedKeys.empty() && keys.empty()) {
+    _stats.interestDroppedCount++;
+    return;
+  }
+
+  // Gather the burst; one fetch goes out when the debounce window closes
+  _invalidations.add(keys);
+  if (hint.spreadWindowMs >= 0)
+    _spreadWindowMs = hint.spreadWindowMs;
+
+  // Urgent: flush everything gathered so far without waiting out the window or spread
+  if (hint.urgent) {
+    _stats.urgentInvalidationCount++;
+    if (_invalidationFlushScheduled) {
+      Director::getInstance()->getScheduler()->unschedule("GatrixInvalidationFlush", this);
+      _invalidationFlushScheduled = false;
     }
+    flushInvalidations();
+    return;
+  }
+
+  if (_invalidationFlushScheduled)
+    return;
+
+  // Debounce window plus this session's stable offset within the spread window
+  int windowMs = _invalidations.windowMs();
+  const std::string& seed = _context.sessionId.empty() ? _connectionId : _context.sessionId;
+  int spreadMs = InvalidationCoalescer::spreadDelayMs(seed, _spreadWindowMs);
+  _stats.lastCoalesceWindowMs = windowMs;
+  _stats.lastSpreadDelayMs = spreadMs;
+  _invalidationFlushScheduled = true;
+  if (_config.enableDevMode) {
+    CCLOG("[GatrixSDK][DEV] Invalidation window opened: %dms (+%dms spread)", windowMs,
+          spreadMs);
+  }
+  Director::getInstance()->getScheduler()->schedule(
+      [this](float) {
+        _invalidationFlushScheduled = false;
+        flushInvalidations();
+      },
+      this, static_cast<float>(windowMs + spreadMs) / 1000.0f, 0, 0, false,
+      "GatrixInvalidationFlush");
+}
+
+void FeaturesClient::flushInvalidations() {
+  // Single-flight: an in-flight fetch flushes the batch when it completes
+  if (_isFetchingFlags || !_invalidations.hasPending())
+    return;
+
+  std::vector<std::string> batch = _invalidations.take();
+  _stats.invalidationFlushCount++;
+  // Flags changed on the server: evaluations prefetched before that are outdated
+  _prefetched.clear();
+  if (_config.enableDevMode) {
+    CCLOG("[GatrixSDK][DEV] Flushing %zu coalesced invalidation keys", batch.size());
+  }
+  resyncChangedKeys(batch);
+}
+
+bool FeaturesClient::canDeltaSync() const {
+  return _config.features.enableDeltaSync && _syncRevision > 0 &&
+         _syncRevisionContextHash == _lastContextHash;
+}
+
+void FeaturesClient::resyncChangedKeys(const std::vector<std::string>& changedKeys) {
+  // A since= delta covers any set of changes (including unknown or "*"), and so do the
+  // definitions (ETag-revalidated) in local evaluation mode
+  if (canDeltaSync() || _config.features.enableLocalEvaluation) {
+    fetchFlags();
     return;
   }
 
   // Threshold: if changed keys >= 50% of total flags, do full fetch
   auto totalFlags = static_cast<int>(_realtimeFlags.size());
   auto changedCount = static_cast<int>(changedKeys.size());
+  bool wildcard = std::find(changedKeys.begin(), changedKeys.end(), "*") != changedKeys.end();
 
-  if (changedCount == 0 || totalFlags == 0 || changedCount >= totalFlags / 2) {
+  if (wildcard || changedCount == 0 || totalFlags == 0 || changedCount >= totalFlags / 2) {
     // Full fetch: clear ETag so server returns fresh data
     _etag.clear();
     fetchFlags();
@@ -1397,49 +2252,44 @@ void FeaturesClient::fetchPartialFlags(const std::vector<std::string>& changedKe
   if (changedKeys.empty())
     return;
 
-  if (_isFetchingFlags) return;
+  // Single-flight: fold the keys into the follow-up of the in-flight request
+  if (_isFetchingFlags) {
+    _invalidations.add(changedKeys);
+    return;
+  }
   _isFetchingFlags = true;
+  _partialFetchInFlight = true;
   _fetchStartContextHash = _lastContextHash;
 
-  std::string keysStr;
-  for (size_t i = 0; i < changedKeys.size(); ++i) {
-    keysStr += changedKeys[i] + (i == changedKeys.size() - 1 ? "" : ",");
-  }
-
   if (_config.enableDevMode) {
-    CCLOG("[GatrixSDK][DEV] fetchPartialFlags: starting partial fetch for keys=[%s]",
-          keysStr.c_str());
+    CCLOG("[GatrixSDK][DEV] fetchPartialFlags: starting partial fetch for %zu keys",
+          changedKeys.size());
   }
 
   _emitter.emit(EVENTS::FLAGS_FETCH_START, {std::string("")});
 
-  auto* request = new HttpRequest();
-  request->setRequestType(HttpRequest::Type::GET);
-
-  // URL: apiUrl/client/features/eval?flagNames=...
-  std::string url = _config.apiUrl + "/client/features/eval";
+  // POST: the key batch travels in the body, so its size is not bounded by URL length
+  TransportRequest request;
+  request.requestClass = RequestClass::PARTIAL_FETCH;
+  request.url = _config.apiUrl + "/client/features/eval";
+  request.immediate = true;
 
-  // Build query params
-  std::stringstream ss;
-  ss << "?userId=" << _context.userId << "&sessionId=" << _context.sessionId
-     << "&flagNames=" << keysStr;
-  for (auto const& [key, val] : _context.properties) {
-    ss << "&" << key << "=" << val;
-  }
-  request->setUrl(url + ss.str());
-
-  std::vector<std::string> headers;
+  std::vector<std::string>& headers = request.headers;
   headers.push_back("Content-Type: application/json");
   headers.push_back("X-API-Token: " + _config.apiToken);
   headers.push_back("X-Application-Name: " + _config.appName);
   headers.push_back("X-Connection-Id: " + _connectionId);
-  headers.push_back("X-SDK-Version: " + std::string(GatrixVersion::SDK_NAME) + "/" +
-                    GatrixVersion::SDK_VERSION);
+  headers.push_back("X-SDK-Version: " + std::string(SDK_NAME) + "/" + std::string(SDK_VERSION));
   headers.push_back("X-Gatrix-Context-Hash: " + _lastContextHash);
-  request->setHeaders(headers);
 
-  request->setResponseCallback([this, changedKeys](HttpClient* client, HttpResponse* response) {
-    if (!response || !response->isSucceed()) {
+  request.body = buildEvalRequestBody(_context, changedKeys);
+  encodeRequestBody(request.body, headers);
+
+  sendRequest(request, [this, changedKeys](TransportResponse& response) {
+    recordTransportTiming(response);
+    _partialFetchInFlight = false;
+
+    if (response.statusCode <= 0) {
       CCLOG("[GatrixSDK] Partial fetch failed, falling back to full fetch");
       _etag.clear();
       _isFetchingFlags = false;
@@ -1447,58 +2297,29 @@ void FeaturesClient::fetchPartialFlags(const std::vector<std::string>& changedKe
       return;
     }
 
-    auto* buffer = response->getResponseData();
-    std::string body(buffer->begin(), buffer->end());
-    int statusCode = static_cast<int>(response->getResponseCode());
+    std::string body(response.body.begin(), response.body.end());
+    int statusCode = response.statusCode;
 
-    if (statusCode == 200) {
-      rapidjson::Document doc;
-      doc.Parse(body.c_str());
-      if (!doc.HasParseError() && doc.HasMember("data") && doc["data"].HasMember("flags")) {
-        const auto& flagsArray = doc["data"]["flags"];
-        std::vector<EvaluatedFlag> receivedFlags;
-        for (rapidjson::SizeType i = 0; i < flagsArray.Size(); i++) {
-          const auto& fj = flagsArray[i];
-          EvaluatedFlag flag;
-          flag.name = fj["name"].GetString();
-          flag.enabled = fj["enabled"].GetBool();
-          flag.version = fj.HasMember("version") ? fj["version"].GetInt() : 0;
-          flag.impressionData =
-              fj.HasMember("impressionData") ? fj["impressionData"].GetBool() : false;
-          if (fj.HasMember("variant") && fj["variant"].IsObject()) {
-            const auto& vj = fj["variant"];
-            flag.variant.name = vj["name"].GetString();
-            flag.variant.enabled = vj["enabled"].GetBool();
-            if (vj.HasMember("value") && vj["value"].IsString())
-              flag.variant.value = vj["value"].GetString();
-          }
-          if (fj.HasMember("valueType")) {
-            std::string vt = fj["valueType"].GetString();
-            if (vt == "string")
-              flag.valueType = ValueType::STRING;
-            else if (vt == "number")
-              flag.valueType = ValueType::NUMBER;
-            else if (vt == "json")
-              flag.valueType = ValueType::JSON;
-          }
-          receivedFlags.push_back(flag);
-        }
-        storePartialFlags(receivedFlags, changedKeys);
-        _consecutiveFailures = 0;
-        _emitter.emit(EVENTS::FLAGS_FETCH_SUCCESS);
-      } else {
-        _etag.clear();
-        _isFetchingFlags = false;
-        fetchFlags();
-        return;
-      }
-    } else {
+    FetchPayload payload;
+    std::string error;
+    rapidjson::Document doc;
+    doc.Parse(body.c_str());
+    if (statusCode != 200 || !parseFlagsDocument(doc, payload, error)) {
       _etag.clear();
       _isFetchingFlags = false;
       fetchFlags();
       return;
     }
 
+    std::vector<EvaluatedFlag> receivedFlags;
+    receivedFlags.reserve(payload.flags.size());
+    for (auto& entry : payload.flags) {
+      receivedFlags.push_back(std::move(entry.second));
+    }
+    storePartialFlags(receivedFlags, changedKeys);
+    _consecutiveFailures = 0;
+    _emitter.emit(EVENTS::FLAGS_FETCH_SUCCESS);
+
     _isFetchingFlags = false;
     _emitter.emit(EVENTS::FLAGS_FETCH_END);
 
@@ -1508,73 +2329,158 @@ void FeaturesClient::fetchPartialFlags(const std::vector<std::string>& changedKe
         CCLOG("[GatrixSDK][DEV] Context changed during partial fetch, triggering full re-fetch");
       }
       _etag.clear();
-      _pendingInvalidationKeys.clear();
+      _invalidations.clear();
       fetchFlags();
     }
-    // Priority 2: Pending invalidation keys
-    else if (!_pendingInvalidationKeys.empty()) {
-      auto pendingKeys = _pendingInvalidationKeys;
-      _pendingInvalidationKeys.clear();
-      if (pendingKeys.count("*") > 0) {
-        _etag.clear();
-        fetchFlags();
-      } else {
-        auto totalFlags = static_cast<int>(_realtimeFlags.size());
-        auto pendingCount = static_cast<int>(pendingKeys.size());
-        if (totalFlags == 0 || pendingCount >= totalFlags / 2) {
-          _etag.clear();
-          fetchFlags();
-        } else {
-          std::vector<std::string> keysVec(pendingKeys.begin(), pendingKeys.end());
-          fetchPartialFlags(keysVec);
-        }
-      }
+    // Priority 2: A full fetch was requested while this one was in flight
+    else if (_fullFetchQueued) {
+      fetchFlags();
+    }
+    // Priority 3: Invalidations merged while in flight (unless their window is still open)
+    else if (!_invalidationFlushScheduled) {
+      flushInvalidations();
     }
   });
+}
+
+void FeaturesClient::sendRequest(const TransportRequest& request,
+                                 ITransport::ResponseCallback callback) {
+  // The transport is shared and may deliver after this client is gone
+  std::weak_ptr<bool> alive = _alive;
+  _transport->send(request, [alive, callback](TransportResponse& response) {
+    if (!alive.expired())
+      callback(response);
+  });
+}
+
+void FeaturesClient::recordTransportTiming(const TransportResponse& response) {
+  if (!response.timed || response.statusCode <= 0)
+    return;
+  if (response.reusedConnection) {
+    _stats.connectionsReused++;
+  } else {
+    _stats.connectionsOpened++;
+    _stats.lastConnectTimeMs = response.connectTimeMs;
+    _stats.totalConnectTimeMs += response.connectTimeMs;
+  }
+}
+
+std::string FeaturesClient::buildEvalRequestBody(const GatrixContext& context,
+                                                const std::vector<std::string>& flagNames) {
+  rapidjson::Document doc;
+  doc.SetObject();
+  auto& alloc = doc.GetAllocator();
+
+  rapidjson::Value ctxObj(rapidjson::kObjectType);
+  if (!context.userId.empty())
+    ctxObj.AddMember("userId", rapidjson::Value(context.userId.c_str(), alloc), alloc);
+  if (!context.sessionId.empty())
+    ctxObj.AddMember("sessionId", rapidjson::Value(context.sessionId.c_str(), alloc), alloc);
+
+  for (const auto& [key, val] : context.properties) {
+    ctxObj.AddMember(rapidjson::Value(key.c_str(), alloc), rapidjson::Value(val.c_str(), alloc),
+                     alloc);
+  }
+  doc.AddMember("context", ctxObj, alloc);
+
+  if (!flagNames.empty()) {
+    rapidjson::Value namesArr(rapidjson::kArrayType);
+    for (const auto& name : flagNames) {
+      namesArr.PushBack(rapidjson::Value(name.c_str(), alloc), alloc);
+    }
+    doc.AddMember("flagNames", namesArr, alloc);
+  }
 
-  HttpClient::getInstance()->sendImmediate(request);
-  request->release();
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+void FeaturesClient::encodeRequestBody(std::string& body, std::vector<std::string>& headers) {
+  _stats.requestBytesRaw += static_cast<long long>(body.size());
+  std::string compressedBody;
+  if (_config.features.enableCompression &&
+      static_cast<int>(body.size()) >= _config.features.compressionMinBytes &&
+      GatrixCompression::gzip(body, compressedBody)) {
+    headers.push_back("Content-Encoding: gzip");
+    body.swap(compressedBody);
+  }
+  _stats.requestBytesSent += static_cast<long long>(body.size());
+}
+
+void FeaturesClient::updateEtagSource(const FlagDiff& diff) {
+  for (const auto* names : {&diff.added, &diff.changed}) {
+    for (const auto& name : *names)
+      _realtimeEtag.put(_realtimeFlags.at(name));
+  }
+  for (const auto& name : diff.removed)
+    _realtimeEtag.remove(name);
 }
 
 void FeaturesClient::storePartialFlags(const std::vector<EvaluatedFlag>& flags,
                                        const std::vector<std::string>& requestedKeys) {
-  auto oldFlags = _realtimeFlags;
-
-  // Update or add
+  // Update or add — only the touched records contribute to the diff
+  FlagDiff diff;
+  std::set<std::string> receivedNames;
   for (const auto& flag : flags) {
-    _realtimeFlags[flag.name] = flag;
+    receivedNames.insert(flag.name);
+    auto it = _realtimeFlags.find(flag.name);
+    if (it != _realtimeFlags.end()) {
+      if (it->second.contentHash != flag.contentHash) {
+        diff.changed.push_back(flag.name);
+        it->second = flag;
+      }
+    } else {
+      diff.added.push_back(flag.name);
+      _realtimeFlags.emplace(flag.name, flag);
+    }
   }
 
-  // Remove deleted
+  // Remove deleted (requested but not returned)
   for (const auto& key : requestedKeys) {
-    bool found = false;
-    for (const auto& f : flags) {
-      if (f.name == key) {
-        found = true;
-        break;
-      }
-    }
-    if (!found) {
-      _realtimeFlags.erase(key);
+    if (receivedNames.count(key) > 0)
+      continue;
+    auto it = _realtimeFlags.find(key);
+    if (it != _realtimeFlags.end()) {
+      diff.removed.push_back(key);
+      _realtimeFlags.erase(it);
     }
   }
 
-  // Recalculate ETag
-  _etag = computeEtag(_realtimeFlags, _lastContextHash);
+  // Nothing moved: no storage write, change event or pending sync
+  if (diff.empty()) {
+    _flagsContextHash = _lastContextHash;
+    return;
+  }
+
+  advanceGeneration(diff, /*forceRealtime=*/true);
+
+  // The edge's ETag for the merged set, so the next poll can still come back 304
+  updateEtagSource(diff);
+  _etag = _realtimeEtag.toEtag(_lastContextHash);
+  _stats.etag = _etag;
   if (_config.enableDevMode) {
     CCLOG("[GatrixSDK][DEV] Recalculated ETag after partial update: %s", _etag.c_str());
   }
 
   saveToStorage();
 
-  invokeWatchCallbacks(_watchCallbacks, oldFlags, _realtimeFlags, true, _flagsContextHash,
-                       _lastContextHash);
+  emitFlagChanges(diff);
+  invokeWatchCallbacks(_watchCallbacks, diff, /*forceRealtime=*/true);
   _flagsContextHash = _lastContextHash;
 
   if (!_explicitSyncMode) {
-    _synchronizedFlags = _realtimeFlags;
-    invokeWatchCallbacks(_syncedWatchCallbacks, oldFlags, _realtimeFlags, false, _flagsContextHash,
-                         _lastContextHash);
+    // Only the touched keys: outside explicit sync mode the synced map is not read, and
+    // setExplicitSyncMode copies the whole realtime map when it starts being
+    for (const auto* names : {&diff.added, &diff.changed}) {
+      for (const auto& name : *names)
+        _synchronizedFlags[name] = _realtimeFlags.at(name);
+    }
+    for (const auto& name : diff.removed)
+      _synchronizedFlags.erase(name);
+    advanceGeneration(diff, /*forceRealtime=*/false);
+    invokeWatchCallbacks(_syncedWatchCallbacks, diff, /*forceRealtime=*/false);
     _emitter.emit(EVENTS::FLAGS_CHANGE);
   } else {
     _pendingSync = true;
@@ -1582,29 +2488,115 @@ void FeaturesClient::storePartialFlags(const std::vector<EvaluatedFlag>& flags,
   }
 }
 
-std::string FeaturesClient::computeEtag(const std::map<std::string, EvaluatedFlag>& flags,
-                                        const std::string& contextHash) {
-  std::vector<EvaluatedFlag> flagArray;
-  for (const auto& pair : flags) {
-    flagArray.push_back(pair.second);
+// ==================== Scheduled Activations ====================
+
+long long FeaturesClient::serverNowMs() const {
+  if (!_serverClockSynced) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
   }
+  auto elapsed = std::chrono::steady_clock::now() - _serverClockBaseAt;
+  return _serverClockBaseMs +
+         std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
 
-  // Sort by name ascending
-  std::sort(flagArray.begin(), flagArray.end(),
-            [](const EvaluatedFlag& a, const EvaluatedFlag& b) { return a.name < b.name; });
+void FeaturesClient::sampleServerClock(const std::string& headers) {
+  // X-Server-Time: server epoch ms when the response was produced, taken to be the
+  // midpoint of the round trip (error at most half of it)
+  std::string value = findResponseHeader(headers, "X-Server-Time");
+  if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])))
+    return;
+  auto receivedAt = std::chrono::steady_clock::now();
+  long long rttMs =
+      std::chrono::duration_cast<std::chrono::milliseconds>(receivedAt - _fetchSentAt).count();
+
+  // The sample with the shortest round trip bounds the error best; a much older basis is
+  // replaced anyway so a long session follows the server's clock
+  bool stale = _serverClockSynced && receivedAt - _serverClockBaseAt > std::chrono::hours(1);
+  if (_serverClockSynced && rttMs > _serverClockRttMs && !stale)
+    return;
+  _serverClockSynced = true;
+  _serverClockRttMs = rttMs;
+  _serverClockBaseMs = std::atoll(value.c_str());
+  _serverClockBaseAt = _fetchSentAt + (receivedAt - _fetchSentAt) / 2;
+  _stats.serverClockOffsetMs =
+      serverNowMs() - std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+}
+
+void FeaturesClient::enqueueScheduledChanges(std::vector<ScheduledChange>&& changes,
+                                             bool replaceAll) {
+  if (!_config.features.enableScheduledActivations)
+    return;
+  if (replaceAll)
+    _activations.clear();
+
+  // Each client activates at a stable offset within the change's jitter window
+  const std::string& seed = _context.sessionId.empty() ? _connectionId : _context.sessionId;
+  for (auto& change : changes) {
+    if (change.cancelled) {
+      _activations.cancel(change.id);
+      continue;
+    }
+    change.deadlineMs = change.activateAtMs +
+                        InvalidationCoalescer::spreadDelayMs(seed + "|" + change.id,
+                                                             change.jitterMs);
+    change.contextHash = _lastContextHash;
+    _activations.put(std::move(change));
+  }
+  _stats.scheduledActivationPending = _activations.size();
+  scheduleActivationTimer();
+}
 
-  std::stringstream ss;
-  ss << contextHash;
+void FeaturesClient::scheduleActivationTimer() {
+  auto* scheduler = Director::getInstance()->getScheduler();
+  scheduler->unschedule("GatrixActivation", this);
+  if (_activations.empty() || !_started)
+    return;
 
-  for (const auto& f : flagArray) {
-    std::string variantPart = f.variant.name.empty() ? "no-variant" : f.variant.name + ":" + (f.variant.enabled ? "true" : "false");
-    ss << "|" << f.name << ":" << f.version << ":" << (f.enabled ? "true" : "false") << ":" << variantPart;
+  // Re-checked at least every minute: the scheduler's clock stops while the app is paused,
+  // the server clock does not
+  long long delayMs = std::max(0LL, _activations.nextDeadlineMs() - serverNowMs());
+  delayMs = std::min(delayMs, 60000LL);
+  scheduler->schedule([this](float) { applyDueActivations(); }, this,
+                      static_cast<float>(delayMs) / 1000.0f, 0, 0, false, "GatrixActivation");
+}
+
+void FeaturesClient::applyDueActivations() {
+  // Everything due is merged into one update (a later change overrides an earlier one)
+  std::map<std::string, EvaluatedFlag> upserts;
+  std::set<std::string> removed;
+  for (auto& change : _activations.takeDue(serverNowMs())) {
+    // Evaluated for a context switched away from; that context's fetch brings its own
+    if (change.contextHash != _lastContextHash)
+      continue;
+    for (const auto& name : change.removed) {
+      upserts.erase(name);
+      removed.insert(name);
+    }
+    for (auto& flag : change.flags) {
+      removed.erase(flag.name);
+      upserts[flag.name] = std::move(flag);
+    }
+    _stats.scheduledActivationCount++;
   }
 
-  SHA256 sha;
-  std::string input = ss.str();
-  sha.update((const uint8*)input.c_str(), input.length());
-  return "\"" + sha.final() + "\"";
+  if (!upserts.empty() || !removed.empty()) {
+    std::vector<EvaluatedFlag> flags;
+    flags.reserve(upserts.size());
+    for (auto& entry : upserts) {
+      flags.push_back(std::move(entry.second));
+    }
+    storePartialFlags(flags, std::vector<std::string>(removed.begin(), removed.end()));
+    if (_config.enableDevMode) {
+      CCLOG("[GatrixSDK][DEV] Applied scheduled activation: upserts=%zu, removed=%zu",
+            flags.size(), removed.size());
+    }
+  }
+  _stats.scheduledActivationPending = _activations.size();
+  scheduleActivationTimer();
 }
 
 } // namespace gatrix
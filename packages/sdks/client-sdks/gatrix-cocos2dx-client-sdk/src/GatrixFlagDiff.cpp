@@ -0,0 +1,32 @@
+// GatrixFlagDiff.cpp - Content-hash based flag snapshot diffing
+
+#include "GatrixFlagDiff.h"
+
+namespace gatrix {
+
+FlagDiff diffFlags(const std::map<std::string, EvaluatedFlag>& oldFlags,
+                   const std::map<std::string, EvaluatedFlag>& newFlags) {
+  FlagDiff diff;
+  auto oldIt = oldFlags.begin();
+  auto newIt = newFlags.begin();
+
+  while (oldIt != oldFlags.end() || newIt != newFlags.end()) {
+    if (newIt == newFlags.end() || (oldIt != oldFlags.end() && oldIt->first < newIt->first)) {
+      diff.removed.push_back(oldIt->first);
+      ++oldIt;
+    } else if (oldIt == oldFlags.end() || newIt->first < oldIt->first) {
+      diff.added.push_back(newIt->first);
+      ++newIt;
+    } else {
+      if (oldIt->second.contentHash != newIt->second.contentHash) {
+        diff.changed.push_back(newIt->first);
+      }
+      ++oldIt;
+      ++newIt;
+    }
+  }
+
+  return diff;
+}
+
+} // namespace gatrix
@@ -0,0 +1,192 @@
+// GatrixFlagHash.cpp - Per-flag content hashes and the edge-compatible set ETag
+
+#include "GatrixFlagHash.h"
+#include "GatrixTypes.h"
+#include <algorithm>
+#include <iterator>
+
+namespace gatrix {
+
+namespace {
+const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+uint64_t rotl64(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+// localeCompare (root collation) weights: controls, then the ASCII punctuation and
+// digits in this order, then letters; case only breaks ties (lowercase first)
+const char EDGE_ASCII_ORDER[] = " _-,;:!?.'\"()[]{}@*/\\&#%`^+<=>|~$0123456789";
+
+struct NameWeight {
+  uint16_t primary;
+  uint8_t tertiary;
+};
+
+const NameWeight* edgeNameWeights() {
+  static const NameWeight* table = [] {
+    static NameWeight weights[256];
+    for (int c = 0; c < 256; ++c)
+      weights[c] = {static_cast<uint16_t>(c < 0x20 ? c : 0x100 + c), 0};
+    uint16_t next = 0x20;
+    for (const char* p = EDGE_ASCII_ORDER; *p; ++p)
+      weights[static_cast<unsigned char>(*p)] = {next++, 0};
+    for (int c = 'a'; c <= 'z'; ++c) {
+      weights[c] = {static_cast<uint16_t>(next + (c - 'a')), 0};
+      weights[c - 'a' + 'A'] = {static_cast<uint16_t>(next + (c - 'a')), 1};
+    }
+    weights[0x7f] = {static_cast<uint16_t>(next + 26), 0};
+    return weights;
+  }();
+  return table;
+}
+
+// MurmurHash3 64-bit finalizer
+uint64_t fmix64(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+} // namespace
+
+// ==================== FlagHasher ====================
+
+FlagHasher& FlagHasher::update(const void* data, size_t len) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < len; ++i) {
+    _lo = (_lo ^ bytes[i]) * FNV_PRIME;
+    _hi = (_hi ^ bytes[i] ^ (_lo >> 56)) * FNV_PRIME;
+  }
+  return *this;
+}
+
+FlagHasher& FlagHasher::update(const std::string& value) {
+  update(static_cast<uint64_t>(value.size()));
+  return update(value.data(), value.size());
+}
+
+FlagHasher& FlagHasher::update(uint64_t value) {
+  unsigned char bytes[8];
+  for (int i = 0; i < 8; ++i)
+    bytes[i] = static_cast<unsigned char>(value >> (i * 8));
+  return update(bytes, sizeof(bytes));
+}
+
+FlagHash FlagHasher::finish() const {
+  FlagHash out;
+  out.lo = fmix64(_lo ^ rotl64(_hi, 31));
+  out.hi = fmix64(_hi + out.lo);
+  return out;
+}
+
+// ==================== Edge ETag ====================
+
+bool EdgeNameOrder::operator()(const std::string& a, const std::string& b) const {
+  const NameWeight* w = edgeNameWeights();
+  size_t n = std::min(a.size(), b.size());
+  for (size_t i = 0; i < n; ++i) {
+    uint16_t pa = w[static_cast<unsigned char>(a[i])].primary;
+    uint16_t pb = w[static_cast<unsigned char>(b[i])].primary;
+    if (pa != pb)
+      return pa < pb;
+  }
+  if (a.size() != b.size())
+    return a.size() < b.size();
+  for (size_t i = 0; i < n; ++i) {
+    uint8_t ta = w[static_cast<unsigned char>(a[i])].tertiary;
+    uint8_t tb = w[static_cast<unsigned char>(b[i])].tertiary;
+    if (ta != tb)
+      return ta < tb;
+  }
+  return false;
+}
+
+void FlagSetEtag::put(const EvaluatedFlag& flag) {
+  // Same rendering as the edge: `${name}:${version}:${enabled}:${variant ?? 'no-variant'}`
+  std::string segment = flag.name + ":" + std::to_string(flag.version) +
+                        (flag.enabled ? ":true:" : ":false:") +
+                        (flag.variant.name.empty()
+                             ? std::string("no-variant")
+                             : flag.variant.name + (flag.variant.enabled ? ":true" : ":false"));
+  auto it = _entries.find(flag.name);
+  if (it != _entries.end()) {
+    if (it->second.segment == segment)
+      return;
+    it->second.segment = std::move(segment);
+  } else {
+    _entries.emplace(flag.name, Entry{std::move(segment), Sha256()});
+  }
+  invalidateFrom(flag.name);
+}
+
+void FlagSetEtag::remove(const std::string& name) {
+  if (_entries.erase(name) > 0)
+    invalidateFrom(name);
+}
+
+void FlagSetEtag::reset(const std::map<std::string, EvaluatedFlag>& flags) {
+  _entries.clear();
+  for (const auto& entry : flags)
+    put(entry.second);
+  _stale = true;
+  _staleFromStart = true;
+}
+
+void FlagSetEtag::invalidateFrom(const std::string& name) {
+  if (!_stale) {
+    _stale = true;
+    _staleFrom = name;
+  } else if (!_staleFromStart && EdgeNameOrder()(name, _staleFrom)) {
+    _staleFrom = name;
+  }
+}
+
+std::string FlagSetEtag::toEtag(const std::string& contextHash) {
+  if (!_primed || contextHash != _contextHash) {
+    _primed = true;
+    _contextHash = contextHash;
+    _prefix = Sha256();
+    _prefix.update(contextHash).update("|", 1);
+    _stale = true;
+    _staleFromStart = true;
+  }
+  if (!_stale)
+    return _etag;
+
+  // Resume from the checkpoint before the first stale record; earlier ones are unchanged
+  auto it = _staleFromStart ? _entries.begin() : _entries.lower_bound(_staleFrom);
+  const Sha256* state = it == _entries.begin() ? &_prefix : &std::prev(it)->second.after;
+  for (; it != _entries.end(); ++it) {
+    Sha256 next = *state;
+    if (it != _entries.begin())
+      next.update("|", 1);
+    next.update(it->second.segment);
+    it->second.after = next;
+    state = &it->second.after;
+  }
+  _stale = false;
+  _staleFromStart = false;
+  _etag = "\"" + state->hexDigest() + "\"";
+  return _etag;
+}
+
+// ==================== Flag Content Hash ====================
+
+FlagHash computeFlagContentHash(const EvaluatedFlag& flag) {
+  FlagHasher hasher;
+  hasher.update(flag.name)
+      .update(static_cast<uint64_t>(static_cast<int64_t>(flag.version)))
+      .update(flag.enabled)
+      .update(static_cast<uint64_t>(flag.valueType))
+      .update(flag.variant.name)
+      .update(flag.variant.enabled)
+      .update(flag.variant.value)
+      .update(flag.reason)
+      .update(flag.impressionData);
+  return hasher.finish();
+}
+
+} // namespace gatrix
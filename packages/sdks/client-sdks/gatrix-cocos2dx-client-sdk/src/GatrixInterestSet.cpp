@@ -0,0 +1,141 @@
+// GatrixInterestSet.cpp - Declared and observed flag keys sent with fetches and the stream
+
+#include "GatrixInterestSet.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+
+namespace gatrix {
+
+namespace {
+// 64-bit FNV-1a over the key's bytes (UTF-8; the server hashes the same bytes)
+uint64_t fnv1a64(const std::string& key) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : key) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Percent-encoding of everything but RFC 3986 unreserved characters
+std::string urlEncode(const std::string& value) {
+  static const char hex[] = "0123456789ABCDEF";
+  std::string out;
+  out.reserve(value.size());
+  for (unsigned char c : value) {
+    if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+      out += static_cast<char>(c);
+    } else {
+      out += '%';
+      out += hex[c >> 4];
+      out += hex[c & 0x0F];
+    }
+  }
+  return out;
+}
+
+std::string base64Encode(const std::vector<unsigned char>& bytes) {
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((bytes.size() + 2) / 3 * 4);
+  for (size_t i = 0; i < bytes.size(); i += 3) {
+    uint32_t chunk = static_cast<uint32_t>(bytes[i]) << 16;
+    if (i + 1 < bytes.size())
+      chunk |= static_cast<uint32_t>(bytes[i + 1]) << 8;
+    if (i + 2 < bytes.size())
+      chunk |= bytes[i + 2];
+    out += table[(chunk >> 18) & 0x3F];
+    out += table[(chunk >> 12) & 0x3F];
+    out += i + 1 < bytes.size() ? table[(chunk >> 6) & 0x3F] : '=';
+    out += i + 2 < bytes.size() ? table[chunk & 0x3F] : '=';
+  }
+  return out;
+}
+} // namespace
+
+void InterestSet::configure(const std::vector<std::string>& declaredKeys, bool trackObserved,
+                            int bloomThreshold) {
+  _keys.clear();
+  _prefixes.clear();
+  for (const auto& key : declaredKeys) {
+    if (!key.empty() && key.back() == '*') {
+      _prefixes.push_back(key.substr(0, key.size() - 1));
+    } else if (!key.empty()) {
+      _keys.insert(key);
+    }
+  }
+  _trackObserved = trackObserved;
+  _enabled = trackObserved || !declaredKeys.empty();
+  _bloomThreshold = std::max(0, bloomThreshold);
+}
+
+bool InterestSet::contains(const std::string& key) const {
+  if (!_enabled || _keys.count(key))
+    return true;
+  for (const auto& prefix : _prefixes) {
+    if (key.compare(0, prefix.size(), prefix) == 0)
+      return true;
+  }
+  return false;
+}
+
+bool InterestSet::observe(const std::string& key) {
+  if (!_trackObserved || contains(key))
+    return false;
+  _keys.insert(key);
+  return true;
+}
+
+std::vector<std::string> InterestSet::intersect(
+    const std::vector<std::string>& changedKeys) const {
+  if (!_enabled || changedKeys.empty())
+    return changedKeys;
+  std::vector<std::string> result;
+  for (const auto& key : changedKeys) {
+    if (key == "*")
+      return changedKeys;
+    if (contains(key))
+      result.push_back(key);
+  }
+  return result;
+}
+
+std::string InterestSet::toQueryString() const {
+  if (!_enabled)
+    return "";
+
+  std::string listed;
+  auto append = [&listed](const std::string& entry) {
+    if (!listed.empty())
+      listed += ',';
+    listed += entry;
+  };
+  for (const auto& prefix : _prefixes)
+    append(prefix + "*");
+  bool bloom = static_cast<int>(_keys.size()) > _bloomThreshold;
+  if (!bloom) {
+    for (const auto& key : _keys)
+      append(key);
+  }
+  // An empty list is still sent: nothing is of interest yet
+  std::string query = "interest=" + urlEncode(listed);
+
+  if (bloom) {
+    size_t numBytes = std::max<size_t>(8, (_keys.size() * BLOOM_BITS_PER_KEY + 7) / 8);
+    uint64_t numBits = static_cast<uint64_t>(numBytes) * 8;
+    std::vector<unsigned char> bits(numBytes, 0);
+    for (const auto& key : _keys) {
+      uint64_t h1 = fnv1a64(key);
+      uint64_t h2 = (h1 >> 32) | 1;
+      for (int i = 0; i < BLOOM_HASH_COUNT; i++) {
+        uint64_t bit = (h1 + static_cast<uint64_t>(i) * h2) % numBits;
+        bits[bit / 8] |= static_cast<unsigned char>(1u << (bit % 8));
+      }
+    }
+    query += "&interestBloom=" + std::to_string(BLOOM_HASH_COUNT) + "." +
+             urlEncode(base64Encode(bits));
+  }
+  return query;
+}
+
+} // namespace gatrix
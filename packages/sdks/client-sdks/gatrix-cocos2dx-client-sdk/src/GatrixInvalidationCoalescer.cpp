@@ -0,0 +1,75 @@
+// GatrixInvalidationCoalescer.cpp - Adaptive debounce for streaming invalidations
+
+#include "GatrixInvalidationCoalescer.h"
+#include "GatrixFlagHash.h"
+#include <algorithm>
+
+namespace gatrix {
+
+namespace {
+// Weight of the newest inter-arrival gap in the moving average
+const double GAP_SMOOTHING = 0.3;
+} // namespace
+
+InvalidationCoalescer::InvalidationCoalescer(int minWindowMs, int maxWindowMs)
+    : _minWindowMs(std::max(0, minWindowMs)),
+      _maxWindowMs(std::max(std::max(0, minWindowMs), maxWindowMs)),
+      _avgGapMs(static_cast<double>(_maxWindowMs)) {}
+
+void InvalidationCoalescer::add(const std::vector<std::string>& keys, Clock::time_point now) {
+  if (_hasLastEvent) {
+    double gapMs = std::chrono::duration<double, std::milli>(now - _lastEvent).count();
+    _avgGapMs = GAP_SMOOTHING * gapMs + (1.0 - GAP_SMOOTHING) * _avgGapMs;
+  }
+  _hasLastEvent = true;
+  _lastEvent = now;
+  _eventCount++;
+
+  if (keys.empty()) {
+    _full = true;
+  }
+  for (const auto& key : keys) {
+    if (key == "*") {
+      _full = true;
+    } else if (!_full) {
+      _keys.insert(key);
+    }
+  }
+  if (_full) {
+    _keys.clear();
+  }
+}
+
+int InvalidationCoalescer::windowMs() const {
+  // Gap >= max -> isolated event, flush fast; gap <= min -> burst, wait the longest
+  double window = static_cast<double>(_maxWindowMs) - (_avgGapMs - _minWindowMs);
+  window = std::min(static_cast<double>(_maxWindowMs),
+                    std::max(static_cast<double>(_minWindowMs), window));
+  return static_cast<int>(window);
+}
+
+std::vector<std::string> InvalidationCoalescer::take() {
+  std::vector<std::string> batch;
+  if (_full) {
+    batch.push_back("*");
+  } else {
+    batch.assign(_keys.begin(), _keys.end());
+  }
+  _keys.clear();
+  _full = false;
+  return batch;
+}
+
+void InvalidationCoalescer::clear() {
+  _keys.clear();
+  _full = false;
+}
+
+int InvalidationCoalescer::spreadDelayMs(const std::string& seed, int windowMs) {
+  if (windowMs <= 0)
+    return 0;
+  FlagHash hash = FlagHasher().update(seed).finish();
+  return static_cast<int>(hash.lo % static_cast<uint64_t>(windowMs));
+}
+
+} // namespace gatrix
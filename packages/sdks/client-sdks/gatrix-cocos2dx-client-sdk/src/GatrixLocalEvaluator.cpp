@@ -0,0 +1,1377 @@
+// GatrixLocalEvaluator.cpp - On-device flag evaluation from downloaded definitions
+
+#include "GatrixLocalEvaluator.h"
+#include "GatrixFlagHash.h"
+#include "GatrixVariantSource.h"
+#include "json/stringbuffer.h"
+#include "json/writer.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <regex>
+#include <unordered_map>
+#include <vector>
+
+namespace gatrix {
+
+uint32_t murmurHash3(const std::string& key, uint32_t seed) {
+  auto rotl = [](uint32_t x, int r) { return (x << r) | (x >> (32 - r)); };
+  const uint32_t c1 = 0xcc9e2d51;
+  const uint32_t c2 = 0x1b873593;
+  const auto* data = reinterpret_cast<const uint8_t*>(key.data());
+  const size_t len = key.size();
+  const size_t blocks = len / 4;
+
+  uint32_t h = seed;
+  for (size_t i = 0; i < blocks; i++) {
+    const uint8_t* p = data + i * 4;
+    uint32_t k = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                 (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    k *= c1;
+    k = rotl(k, 15);
+    k *= c2;
+    h ^= k;
+    h = rotl(h, 13);
+    h = h * 5 + 0xe6546b64;
+  }
+
+  const uint8_t* tail = data + blocks * 4;
+  uint32_t k = 0;
+  switch (len & 3) {
+  case 3:
+    k ^= static_cast<uint32_t>(tail[2]) << 16;
+    // fallthrough
+  case 2:
+    k ^= static_cast<uint32_t>(tail[1]) << 8;
+    // fallthrough
+  case 1:
+    k ^= tail[0];
+    k *= c1;
+    k = rotl(k, 15);
+    k *= c2;
+    h ^= k;
+  }
+
+  h ^= static_cast<uint32_t>(len);
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+namespace {
+
+const double NOT_A_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+// Attributes every program has; custom fields are interned after them
+const int ATTR_USER_ID = 0;
+const int ATTR_SESSION_ID = 1;
+const int ATTR_REMOTE_ADDRESS = 2;
+const int ATTR_NONE = -1; // never present (currentTime, see header)
+
+// ==================== JavaScript conversions ====================
+// The server evaluator is TypeScript; these reproduce the coercions it relies on.
+
+bool isJsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+std::string jsTrim(const std::string& s) {
+  size_t start = 0;
+  size_t end = s.size();
+  while (start < end && isJsSpace(s[start]))
+    start++;
+  while (end > start && isJsSpace(s[end - 1]))
+    end--;
+  return s.substr(start, end - start);
+}
+
+std::string toLower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+  return s;
+}
+
+// Number(string)
+double jsNumber(const std::string& input) {
+  std::string s = jsTrim(input);
+  if (s.empty())
+    return 0.0;
+  if (s == "Infinity" || s == "+Infinity")
+    return std::numeric_limits<double>::infinity();
+  if (s == "-Infinity")
+    return -std::numeric_limits<double>::infinity();
+
+  // 0x / 0o / 0b literals (unsigned only)
+  if (s.size() > 2 && s[0] == '0' && std::isalpha(static_cast<unsigned char>(s[1]))) {
+    char prefix = static_cast<char>(std::tolower(static_cast<unsigned char>(s[1])));
+    int base = prefix == 'x' ? 16 : prefix == 'o' ? 8 : prefix == 'b' ? 2 : 0;
+    if (base == 0)
+      return NOT_A_NUMBER;
+    double value = 0.0;
+    for (size_t i = 2; i < s.size(); i++) {
+      int digit = std::isdigit(static_cast<unsigned char>(s[i]))
+                      ? s[i] - '0'
+                      : std::isalpha(static_cast<unsigned char>(s[i]))
+                            ? std::tolower(static_cast<unsigned char>(s[i])) - 'a' + 10
+                            : base;
+      if (digit >= base)
+        return NOT_A_NUMBER;
+      value = value * base + digit;
+    }
+    return value;
+  }
+
+  // Decimal literal: [sign] digits [. digits] [e [sign] digits], at least one mantissa digit
+  size_t i = 0;
+  if (s[i] == '+' || s[i] == '-')
+    i++;
+  size_t mantissaDigits = 0;
+  while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+    i++;
+    mantissaDigits++;
+  }
+  if (i < s.size() && s[i] == '.') {
+    i++;
+    while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+      i++;
+      mantissaDigits++;
+    }
+  }
+  if (mantissaDigits == 0)
+    return NOT_A_NUMBER;
+  if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+    i++;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+      i++;
+    size_t exponentDigits = 0;
+    while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+      i++;
+      exponentDigits++;
+    }
+    if (exponentDigits == 0)
+      return NOT_A_NUMBER;
+  }
+  if (i != s.size())
+    return NOT_A_NUMBER;
+  return std::strtod(s.c_str(), nullptr);
+}
+
+// parseInt(string, 10)
+double jsParseInt(const std::string& s) {
+  size_t i = 0;
+  while (i < s.size() && isJsSpace(s[i]))
+    i++;
+  bool negative = false;
+  if (i < s.size() && (s[i] == '+' || s[i] == '-')) {
+    negative = s[i] == '-';
+    i++;
+  }
+  size_t start = i;
+  double value = 0.0;
+  while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+    value = value * 10 + (s[i] - '0');
+    i++;
+  }
+  if (i == start)
+    return NOT_A_NUMBER;
+  return negative ? -value : value;
+}
+
+// String(number)
+std::string jsNumberToString(double value) {
+  if (std::isnan(value))
+    return "NaN";
+  if (std::isinf(value))
+    return value > 0 ? "Infinity" : "-Infinity";
+  char buffer[32];
+  if (value == std::floor(value) && std::fabs(value) < 1e21) {
+    std::snprintf(buffer, sizeof(buffer), "%.0f", value);
+    return buffer;
+  }
+  // Shortest representation that round-trips, as JavaScript prints it
+  for (int precision = 1; precision <= 17; precision++) {
+    std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+    if (std::strtod(buffer, nullptr) == value)
+      break;
+  }
+  return buffer;
+}
+
+// Number(value) for a member that may be missing (undefined) or of any JSON type
+double jsNumberOf(const rapidjson::Value* v) {
+  if (!v)
+    return NOT_A_NUMBER;
+  if (v->IsNumber())
+    return v->GetDouble();
+  if (v->IsString())
+    return jsNumber(v->GetString());
+  if (v->IsBool())
+    return v->GetBool() ? 1.0 : 0.0;
+  return v->IsNull() ? 0.0 : NOT_A_NUMBER;
+}
+
+bool jsTruthy(const rapidjson::Value& v) {
+  if (v.IsBool())
+    return v.GetBool();
+  if (v.IsNumber())
+    return v.GetDouble() != 0.0 && !std::isnan(v.GetDouble());
+  if (v.IsString())
+    return v.GetStringLength() > 0;
+  return !v.IsNull();
+}
+
+std::string writeJson(const rapidjson::Value& v) {
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+  v.Accept(w);
+  return std::string(sb.GetString(), sb.GetSize());
+}
+
+// String(value) for the scalar parameters and values of a definitions document
+std::string jsString(const rapidjson::Value& v) {
+  if (v.IsString())
+    return std::string(v.GetString(), v.GetStringLength());
+  if (v.IsNumber())
+    return jsNumberToString(v.GetDouble());
+  if (v.IsBool())
+    return v.GetBool() ? "true" : "false";
+  if (v.IsNull())
+    return "null";
+  return writeJson(v);
+}
+
+// How the fetch parser stores a variant value it received as JSON
+std::string clientValue(const rapidjson::Value& v) {
+  if (v.IsString())
+    return std::string(v.GetString(), v.GetStringLength());
+  if (v.IsNumber())
+    return std::to_string(v.GetDouble());
+  if (v.IsBool())
+    return v.GetBool() ? "true" : "false";
+  if (v.IsObject() || v.IsArray())
+    return writeJson(v);
+  return "";
+}
+
+// new Date(string).getTime() for the ISO 8601 forms; NaN for anything else.
+// A date-time without an offset is read as UTC (the server runs in UTC).
+double jsDateMs(const std::string& s) {
+  size_t i = 0;
+  auto digits = [&](size_t count, int& out) {
+    if (i + count > s.size())
+      return false;
+    int value = 0;
+    for (size_t j = 0; j < count; j++) {
+      char c = s[i + j];
+      if (!std::isdigit(static_cast<unsigned char>(c)))
+        return false;
+      value = value * 10 + (c - '0');
+    }
+    out = value;
+    i += count;
+    return true;
+  };
+  auto peek = [&](char c) { return i < s.size() && s[i] == c; };
+
+  int year = 0, month = 1, day = 1, hour = 0, minute = 0, second = 0, millis = 0;
+  if (peek('+') || peek('-')) {
+    bool negative = s[i] == '-';
+    i++;
+    if (!digits(6, year))
+      return NOT_A_NUMBER;
+    if (negative)
+      year = -year;
+  } else if (!digits(4, year)) {
+    return NOT_A_NUMBER;
+  }
+  if (peek('-')) {
+    i++;
+    if (!digits(2, month))
+      return NOT_A_NUMBER;
+    if (peek('-')) {
+      i++;
+      if (!digits(2, day))
+        return NOT_A_NUMBER;
+    }
+  }
+
+  int offsetMinutes = 0;
+  if (i < s.size() && (s[i] == 'T' || s[i] == 't' || s[i] == ' ')) {
+    i++;
+    if (!digits(2, hour) || !peek(':'))
+      return NOT_A_NUMBER;
+    i++;
+    if (!digits(2, minute))
+      return NOT_A_NUMBER;
+    if (peek(':')) {
+      i++;
+      if (!digits(2, second))
+        return NOT_A_NUMBER;
+      if (peek('.')) {
+        i++;
+        size_t start = i;
+        int scale = 100;
+        while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+          millis += (s[i] - '0') * scale; // sub-millisecond digits are dropped
+          scale /= 10;
+          i++;
+        }
+        if (i == start)
+          return NOT_A_NUMBER;
+      }
+    }
+    if (i < s.size() && (s[i] == 'Z' || s[i] == 'z')) {
+      i++;
+    } else if (peek('+') || peek('-')) {
+      int sign = s[i] == '-' ? -1 : 1;
+      int offsetHour = 0, offsetMinute = 0;
+      i++;
+      if (!digits(2, offsetHour) || !peek(':'))
+        return NOT_A_NUMBER;
+      i++;
+      if (!digits(2, offsetMinute) || offsetHour > 23 || offsetMinute > 59)
+        return NOT_A_NUMBER;
+      offsetMinutes = sign * (offsetHour * 60 + offsetMinute);
+    }
+  }
+  if (i != s.size())
+    return NOT_A_NUMBER;
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 24 || minute > 59 ||
+      second > 59 || (hour == 24 && (minute > 0 || second > 0 || millis > 0)))
+    return NOT_A_NUMBER;
+
+  // Days since the epoch for the proleptic Gregorian calendar (overflowing days roll over)
+  int y = year - (month <= 2 ? 1 : 0);
+  int era = (y >= 0 ? y : y - 399) / 400;
+  int yearOfEra = y - era * 400;
+  int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  double days = static_cast<double>(era) * 146097 + dayOfEra - 719468;
+  return ((days * 24 + hour) * 60 + minute - offsetMinutes) * 60000.0 + second * 1000.0 +
+         millis;
+}
+
+// compareSemver's parts: leading "v" stripped, split on ".", parseInt(part) || 0
+std::vector<double> parseVersion(const std::string& v) {
+  std::vector<double> parts;
+  size_t start = !v.empty() && v[0] == 'v' ? 1 : 0;
+  while (true) {
+    size_t dot = v.find('.', start);
+    double part = jsParseInt(v.substr(start, dot == std::string::npos ? std::string::npos
+                                                                      : dot - start));
+    parts.push_back(std::isnan(part) ? 0.0 : part);
+    if (dot == std::string::npos)
+      break;
+    start = dot + 1;
+  }
+  return parts;
+}
+
+int compareVersions(const std::vector<double>& a, const std::vector<double>& b) {
+  size_t count = std::max(a.size(), b.size());
+  for (size_t i = 0; i < count; i++) {
+    double av = i < a.size() ? a[i] : 0.0;
+    double bv = i < b.size() ? b[i] : 0.0;
+    if (av < bv)
+      return -1;
+    if (av > bv)
+      return 1;
+  }
+  return 0;
+}
+
+bool parseIpv4(const std::string& ip, uint32_t& out) {
+  std::string s = jsTrim(ip);
+  uint32_t result = 0;
+  int parts = 0;
+  size_t start = 0;
+  while (true) {
+    size_t dot = s.find('.', start);
+    double part =
+        jsParseInt(s.substr(start, dot == std::string::npos ? std::string::npos : dot - start));
+    if (std::isnan(part) || part < 0 || part > 255)
+      return false;
+    result = (result << 8) + static_cast<uint32_t>(part);
+    parts++;
+    if (dot == std::string::npos)
+      break;
+    start = dot + 1;
+  }
+  if (parts != 4)
+    return false;
+  out = result;
+  return true;
+}
+
+// Split on /\s*,\s*/ (whitespace is only dropped around the commas)
+std::vector<std::string> splitList(const std::string& s) {
+  std::vector<std::string> items;
+  size_t start = 0;
+  while (true) {
+    size_t comma = s.find(',', start);
+    size_t end = comma == std::string::npos ? s.size() : comma;
+    size_t itemStart = start;
+    size_t itemEnd = end;
+    if (start > 0) {
+      while (itemStart < itemEnd && isJsSpace(s[itemStart]))
+        itemStart++;
+    }
+    if (comma != std::string::npos) {
+      while (itemEnd > itemStart && isJsSpace(s[itemEnd - 1]))
+        itemEnd--;
+    }
+    items.push_back(s.substr(itemStart, itemEnd - itemStart));
+    if (comma == std::string::npos)
+      break;
+    start = comma + 1;
+  }
+  return items;
+}
+
+// Strategies bucket on murmur3(groupId:id) % 10001, variants on % 10000
+double normalizedStrategyValue(const std::string& id, const std::string& groupId) {
+  return static_cast<double>(murmurHash3(groupId + ":" + id) % 10001) / 100.0;
+}
+
+std::string randomStickiness() {
+  return std::to_string(static_cast<double>(rand()) / RAND_MAX);
+}
+
+const rapidjson::Value* member(const rapidjson::Value& obj, const char* name) {
+  if (!obj.IsObject())
+    return nullptr;
+  auto it = obj.FindMember(name);
+  if (it == obj.MemberEnd() || it->value.IsNull())
+    return nullptr;
+  return &it->value;
+}
+
+std::string stringMember(const rapidjson::Value& obj, const char* name) {
+  const rapidjson::Value* v = member(obj, name);
+  return v && v->IsString() ? std::string(v->GetString(), v->GetStringLength()) : "";
+}
+
+bool isDefaultVariantName(const std::string& name) {
+  return name.empty() || name == VariantSourceNames::FLAG_DEFAULT_ENABLED ||
+         name == VariantSourceNames::FLAG_DEFAULT_DISABLED ||
+         name == VariantSourceNames::ENV_DEFAULT_ENABLED ||
+         name == VariantSourceNames::ENV_DEFAULT_DISABLED;
+}
+
+} // namespace
+
+// ==================== Program ====================
+
+struct LocalEvaluator::Program {
+  enum class Op {
+    EXISTS,
+    NOT_EXISTS,
+    ARR_EMPTY,
+    ARR_ANY,
+    ARR_ALL,
+    STR_EQ,
+    STR_CONTAINS,
+    STR_STARTS_WITH,
+    STR_ENDS_WITH,
+    STR_IN,
+    STR_REGEX,
+    CIDR_MATCH,
+    NUM_EQ,
+    NUM_GT,
+    NUM_GTE,
+    NUM_LT,
+    NUM_LTE,
+    NUM_IN,
+    BOOL_IS,
+    DATE_EQ,
+    DATE_GT,
+    DATE_GTE,
+    DATE_LT,
+    DATE_LTE,
+    SEMVER_EQ,
+    SEMVER_GT,
+    SEMVER_GTE,
+    SEMVER_LT,
+    SEMVER_LTE,
+    SEMVER_IN,
+    UNKNOWN
+  };
+
+  struct Cidr {
+    std::string raw;
+    bool valid = false;
+    uint32_t network = 0;
+    uint32_t mask = 0xffffffff;
+  };
+
+  struct Constraint {
+    int attr = ATTR_NONE;
+    Op op = Op::UNKNOWN;
+    bool inverted = false;
+    bool caseInsensitive = false;
+    std::string target;                     // value, lowercased if caseInsensitive
+    std::vector<std::string> targets;       // values, lowercased if caseInsensitive
+    double number = NOT_A_NUMBER;           // Number(value)
+    std::vector<double> numbers;            // Number(values)
+    bool numbersHaveNaN = false;            // includes() treats NaN as equal to NaN
+    double date = NOT_A_NUMBER;             // target as epoch ms
+    std::vector<double> version;            // target as semver parts
+    std::vector<std::vector<double>> versions;
+    std::vector<Cidr> ranges;               // raw values (cidr_match)
+    std::shared_ptr<std::regex> regex;      // null if the pattern does not compile
+    bool boolTarget = false;                // value === "true"
+  };
+
+  enum class StrategyType {
+    DEFAULT,
+    FLEXIBLE_ROLLOUT,
+    USER_WITH_ID,
+    GRADUAL_ROLLOUT_USER_ID,
+    GRADUAL_ROLLOUT_SESSION_ID,
+    GRADUAL_ROLLOUT_RANDOM,
+    REMOTE_ADDRESS,
+    APPLICATION_HOSTNAME,
+    UNKNOWN
+  };
+
+  enum class Stickiness { DEFAULT, USER_ID, SESSION_ID, RANDOM, ATTRIBUTE };
+
+  struct Strategy {
+    StrategyType type = StrategyType::UNKNOWN;
+    std::vector<int> segments; // referenced segments that exist
+    std::vector<Constraint> constraints;
+    Stickiness stickiness = Stickiness::DEFAULT;
+    int stickinessAttr = ATTR_NONE; // Stickiness::ATTRIBUTE
+    std::string groupId;
+    double rollout = 100.0;
+    double percentage = 0.0;
+    std::vector<std::string> userIds; // empty list: parameter absent
+    std::vector<Cidr> ips;
+  };
+
+  struct Segment {
+    std::vector<Constraint> constraints;
+  };
+
+  struct FlagVariant {
+    std::string name;
+    double weight = 0.0;
+    std::string value; // client representation
+    bool isDefault = false;
+  };
+
+  struct Flag {
+    std::string name;
+    bool enabled = false;
+    std::vector<Strategy> strategies; // enabled ones, in order
+    std::vector<FlagVariant> variants;
+    double totalWeight = 0.0;
+    ValueType valueType = ValueType::STRING;
+    std::string enabledName;
+    std::string disabledName;
+    std::string enabledValue; // client representation of the default values
+    std::string disabledValue;
+    int version = 1;
+    bool impressionData = false;
+  };
+
+  std::vector<std::string> attributes; // interned context field names
+  std::unordered_map<std::string, int> attributeIds;
+  std::vector<Segment> segments;
+  std::vector<Flag> flags; // sorted by name
+
+  int intern(const std::string& name) {
+    auto it = attributeIds.find(name);
+    if (it != attributeIds.end())
+      return it->second;
+    int id = static_cast<int>(attributes.size());
+    attributes.push_back(name);
+    attributeIds.emplace(name, id);
+    return id;
+  }
+
+  // ==================== Compile ====================
+
+  static Op parseOp(const std::string& op) {
+    static const std::unordered_map<std::string, Op> ops = {
+        {"exists", Op::EXISTS},
+        {"not_exists", Op::NOT_EXISTS},
+        {"arr_empty", Op::ARR_EMPTY},
+        {"arr_any", Op::ARR_ANY},
+        {"arr_all", Op::ARR_ALL},
+        {"str_eq", Op::STR_EQ},
+        {"str_contains", Op::STR_CONTAINS},
+        {"str_starts_with", Op::STR_STARTS_WITH},
+        {"str_ends_with", Op::STR_ENDS_WITH},
+        {"str_in", Op::STR_IN},
+        {"str_regex", Op::STR_REGEX},
+        {"cidr_match", Op::CIDR_MATCH},
+        {"num_eq", Op::NUM_EQ},
+        {"num_gt", Op::NUM_GT},
+        {"num_gte", Op::NUM_GTE},
+        {"num_lt", Op::NUM_LT},
+        {"num_lte", Op::NUM_LTE},
+        {"num_in", Op::NUM_IN},
+        {"bool_is", Op::BOOL_IS},
+        {"date_eq", Op::DATE_EQ},
+        {"date_gt", Op::DATE_GT},
+        {"date_gte", Op::DATE_GTE},
+        {"date_lt", Op::DATE_LT},
+        {"date_lte", Op::DATE_LTE},
+        {"semver_eq", Op::SEMVER_EQ},
+        {"semver_gt", Op::SEMVER_GT},
+        {"semver_gte", Op::SEMVER_GTE},
+        {"semver_lt", Op::SEMVER_LT},
+        {"semver_lte", Op::SEMVER_LTE},
+        {"semver_in", Op::SEMVER_IN},
+    };
+    auto it = ops.find(op);
+    return it != ops.end() ? it->second : Op::UNKNOWN;
+  }
+
+  static Cidr compileCidr(const std::string& cidr) {
+    Cidr range;
+    range.raw = cidr;
+    size_t slash = cidr.find('/');
+    uint32_t network = 0;
+    if (!parseIpv4(cidr.substr(0, slash), network))
+      return range;
+    if (slash != std::string::npos) {
+      size_t next = cidr.find('/', slash + 1);
+      std::string prefixStr = cidr.substr(
+          slash + 1, next == std::string::npos ? std::string::npos : next - slash - 1);
+      if (!prefixStr.empty()) {
+        double prefix = jsParseInt(prefixStr);
+        if (std::isnan(prefix) || prefix < 0 || prefix > 32)
+          return range;
+        range.mask = prefix == 0 ? 0 : 0xffffffffu << (32 - static_cast<int>(prefix));
+      }
+    }
+    range.network = network & range.mask;
+    range.valid = true;
+    return range;
+  }
+
+  Constraint compileConstraint(const rapidjson::Value& cj) {
+    Constraint c;
+    if (!cj.IsObject())
+      return c;
+    std::string contextName = stringMember(cj, "contextName");
+    // currentTime is only read when it is a Date, which evaluation requests never carry
+    c.attr = contextName == "currentTime" ? ATTR_NONE : intern(contextName);
+    c.op = parseOp(stringMember(cj, "operator"));
+    const rapidjson::Value* inverted = member(cj, "inverted");
+    const rapidjson::Value* caseInsensitive = member(cj, "caseInsensitive");
+    c.inverted = inverted && jsTruthy(*inverted);
+    c.caseInsensitive = caseInsensitive && jsTruthy(*caseInsensitive);
+
+    // Kept even when null: Number(null) is 0, Number(undefined) is NaN
+    auto valueMember = cj.FindMember("value");
+    const rapidjson::Value* value = valueMember != cj.MemberEnd() ? &valueMember->value : nullptr;
+    std::string rawValue = value && jsTruthy(*value) ? jsString(*value) : "";
+    c.target = c.caseInsensitive ? toLower(rawValue) : rawValue;
+    c.number = jsNumberOf(value);
+    c.boolTarget = value && value->IsString() && rawValue == "true";
+
+    std::vector<std::string> rawValues;
+    const rapidjson::Value* values = member(cj, "values");
+    if (values && values->IsArray()) {
+      for (const auto& v : values->GetArray()) {
+        rawValues.push_back(jsString(v));
+      }
+    }
+    for (const auto& v : rawValues) {
+      c.targets.push_back(c.caseInsensitive ? toLower(v) : v);
+    }
+
+    // Operands each operator compares against, parsed once
+    switch (c.op) {
+    case Op::NUM_IN:
+      for (const auto& v : c.targets) {
+        double n = jsNumber(v);
+        c.numbersHaveNaN = c.numbersHaveNaN || std::isnan(n);
+        c.numbers.push_back(n);
+      }
+      break;
+    case Op::DATE_EQ:
+    case Op::DATE_GT:
+    case Op::DATE_GTE:
+    case Op::DATE_LT:
+    case Op::DATE_LTE:
+      c.date = jsDateMs(c.target);
+      break;
+    case Op::SEMVER_EQ:
+    case Op::SEMVER_GT:
+    case Op::SEMVER_GTE:
+    case Op::SEMVER_LT:
+    case Op::SEMVER_LTE:
+      c.version = parseVersion(c.target);
+      break;
+    case Op::SEMVER_IN:
+      for (const auto& v : c.targets) {
+        c.versions.push_back(parseVersion(v));
+      }
+      break;
+    case Op::CIDR_MATCH:
+      for (const auto& v : rawValues) {
+        c.ranges.push_back(compileCidr(v));
+      }
+      break;
+    case Op::STR_REGEX:
+      try {
+        auto flags = std::regex::ECMAScript;
+        if (c.caseInsensitive)
+          flags |= std::regex::icase;
+        c.regex = std::make_shared<std::regex>(rawValue, flags);
+      } catch (const std::regex_error&) {
+        c.regex.reset();
+      }
+      break;
+    default:
+      break;
+    }
+    return c;
+  }
+
+  std::vector<Constraint> compileConstraints(const rapidjson::Value& owner) {
+    std::vector<Constraint> constraints;
+    const rapidjson::Value* list = member(owner, "constraints");
+    if (list && list->IsArray()) {
+      for (const auto& cj : list->GetArray()) {
+        constraints.push_back(compileConstraint(cj));
+      }
+    }
+    return constraints;
+  }
+
+  Strategy compileStrategy(const rapidjson::Value& sj,
+                           const std::unordered_map<std::string, int>& segmentIds) {
+    static const std::unordered_map<std::string, StrategyType> types = {
+        {"default", StrategyType::DEFAULT},
+        {"flexibleRollout", StrategyType::FLEXIBLE_ROLLOUT},
+        {"userWithId", StrategyType::USER_WITH_ID},
+        {"gradualRolloutUserId", StrategyType::GRADUAL_ROLLOUT_USER_ID},
+        {"gradualRolloutSessionId", StrategyType::GRADUAL_ROLLOUT_SESSION_ID},
+        {"gradualRolloutRandom", StrategyType::GRADUAL_ROLLOUT_RANDOM},
+        {"remoteAddress", StrategyType::REMOTE_ADDRESS},
+        {"applicationHostname", StrategyType::APPLICATION_HOSTNAME}};
+
+    Strategy s;
+    auto type = types.find(stringMember(sj, "name"));
+    s.type = type != types.end() ? type->second : StrategyType::UNKNOWN;
+
+    // Segments that no longer exist are skipped, as on the server
+    const rapidjson::Value* segmentNames = member(sj, "segments");
+    if (segmentNames && segmentNames->IsArray()) {
+      for (const auto& name : segmentNames->GetArray()) {
+        if (!name.IsString())
+          continue;
+        auto it = segmentIds.find(name.GetString());
+        if (it != segmentIds.end())
+          s.segments.push_back(it->second);
+      }
+    }
+    s.constraints = compileConstraints(sj);
+
+    static const rapidjson::Value noParameters(rapidjson::kObjectType);
+    const rapidjson::Value* parameters = member(sj, "parameters");
+    const rapidjson::Value& p = parameters && parameters->IsObject() ? *parameters : noParameters;
+
+    const rapidjson::Value* stickiness = member(p, "stickiness");
+    std::string stickinessName = stickiness && jsTruthy(*stickiness) ? jsString(*stickiness)
+                                                                     : "default";
+    if (stickinessName == "default") {
+      s.stickiness = Stickiness::DEFAULT;
+    } else if (stickinessName == "userId") {
+      s.stickiness = Stickiness::USER_ID;
+    } else if (stickinessName == "sessionId") {
+      s.stickiness = Stickiness::SESSION_ID;
+    } else if (stickinessName == "random") {
+      s.stickiness = Stickiness::RANDOM;
+    } else {
+      s.stickiness = Stickiness::ATTRIBUTE;
+      s.stickinessAttr = stickinessName == "currentTime" ? ATTR_NONE : intern(stickinessName);
+    }
+
+    const rapidjson::Value* groupId = member(p, "groupId");
+    s.groupId = groupId && jsTruthy(*groupId) ? jsString(*groupId) : "";
+    const rapidjson::Value* rollout = member(p, "rollout");
+    s.rollout = rollout ? jsNumberOf(rollout) : 100.0;
+    const rapidjson::Value* percentage = member(p, "percentage");
+    s.percentage = percentage ? jsNumberOf(percentage) : 0.0;
+
+    std::string userIds = stringMember(p, "userIds");
+    if (!userIds.empty())
+      s.userIds = splitList(userIds);
+    std::string ips = stringMember(p, "IPs");
+    if (!ips.empty()) {
+      for (const auto& ip : splitList(ips)) {
+        s.ips.push_back(compileCidr(ip));
+      }
+    }
+    return s;
+  }
+
+  // getFallbackValue(value, valueType): the value of a variant picked by a strategy
+  static std::string coercedValue(const rapidjson::Value* value, const std::string& valueType) {
+    if (!value) {
+      if (valueType == "boolean")
+        return "false";
+      if (valueType == "number")
+        return std::to_string(0.0);
+      if (valueType == "json")
+        return "{}";
+      return "";
+    }
+    if (valueType == "string")
+      return jsString(*value);
+    if (valueType == "number") {
+      double n = jsNumberOf(value);
+      return std::to_string(std::isnan(n) ? 0.0 : n);
+    }
+    if (valueType == "boolean") {
+      if (value->IsString() && (std::string(value->GetString()) == "true" ||
+                                std::string(value->GetString()) == "false"))
+        return value->GetString();
+      return jsTruthy(*value) ? "true" : "false";
+    }
+    if (valueType == "json") {
+      if (value->IsObject() || value->IsArray())
+        return writeJson(*value);
+      rapidjson::Document parsed;
+      parsed.Parse(jsString(*value).c_str());
+      return parsed.HasParseError() ? "{}" : clientValue(parsed);
+    }
+    return clientValue(*value);
+  }
+
+  // formatResult for default variants: the raw enabledValue / disabledValue
+  static std::string defaultValue(const rapidjson::Value* value, const std::string& valueType) {
+    if (!value) {
+      if (valueType == "boolean")
+        return "false";
+      if (valueType == "number")
+        return std::to_string(0.0);
+      if (valueType == "json")
+        return "{}";
+      return "";
+    }
+    if (value->IsString()) {
+      std::string s = value->GetString();
+      if (valueType == "json" && !jsTrim(s).empty()) {
+        rapidjson::Document parsed;
+        parsed.Parse(s.c_str());
+        if (!parsed.HasParseError())
+          return clientValue(parsed);
+      } else if (valueType == "number") {
+        double n = jsNumber(s);
+        if (!std::isnan(n))
+          return std::to_string(n);
+      }
+    }
+    return clientValue(*value);
+  }
+
+  Flag compileFlag(const rapidjson::Value& fj,
+                   const std::unordered_map<std::string, int>& segmentIds) {
+    Flag f;
+    f.name = stringMember(fj, "name");
+    const rapidjson::Value* isEnabled = member(fj, "isEnabled");
+    f.enabled = isEnabled && jsTruthy(*isEnabled);
+
+    const rapidjson::Value* strategies = member(fj, "strategies");
+    if (strategies && strategies->IsArray()) {
+      for (const auto& sj : strategies->GetArray()) {
+        const rapidjson::Value* strategyEnabled = member(sj, "isEnabled");
+        if (strategyEnabled && jsTruthy(*strategyEnabled))
+          f.strategies.push_back(compileStrategy(sj, segmentIds));
+      }
+    }
+
+    std::string valueType = stringMember(fj, "valueType");
+    if (valueType.empty())
+      valueType = "string";
+    f.valueType = valueType == "string"    ? ValueType::STRING
+                  : valueType == "number"  ? ValueType::NUMBER
+                  : valueType == "boolean" ? ValueType::BOOLEAN
+                  : valueType == "json"    ? ValueType::JSON
+                                           : ValueType::NONE;
+
+    const rapidjson::Value* enabledValue = member(fj, "enabledValue");
+    const rapidjson::Value* disabledValue = member(fj, "disabledValue");
+    f.enabledValue = defaultValue(enabledValue, valueType);
+    f.disabledValue = defaultValue(disabledValue, valueType);
+    bool fromEnvironment = stringMember(fj, "valueSource") == "environment";
+    f.enabledName = fromEnvironment ? VariantSourceNames::ENV_DEFAULT_ENABLED
+                                    : VariantSourceNames::FLAG_DEFAULT_ENABLED;
+    f.disabledName = fromEnvironment ? VariantSourceNames::ENV_DEFAULT_DISABLED
+                                     : VariantSourceNames::FLAG_DEFAULT_DISABLED;
+
+    const rapidjson::Value* variants = member(fj, "variants");
+    if (variants && variants->IsArray()) {
+      for (const auto& vj : variants->GetArray()) {
+        FlagVariant v;
+        v.name = stringMember(vj, "name");
+        const rapidjson::Value* weight = member(vj, "weight");
+        v.weight = weight ? jsNumberOf(weight) : 0.0;
+        const rapidjson::Value* value = member(vj, "value");
+        v.value = coercedValue(value ? value : enabledValue, valueType);
+        v.isDefault = isDefaultVariantName(v.name);
+        f.totalWeight += v.weight;
+        f.variants.push_back(std::move(v));
+      }
+    }
+
+    const rapidjson::Value* version = member(fj, "version");
+    f.version = version && version->IsInt() && version->GetInt() != 0 ? version->GetInt() : 1;
+    const rapidjson::Value* impressionData = member(fj, "impressionDataEnabled");
+    f.impressionData = impressionData && jsTruthy(*impressionData);
+    return f;
+  }
+
+  // ==================== Evaluate ====================
+
+  struct State {
+    std::vector<const std::string*> values; // by attribute, null when absent
+    std::vector<uint64_t> segmentDone;      // bitsets over segments
+    std::vector<uint64_t> segmentPass;
+  };
+
+  static bool present(const std::string* v) { return v != nullptr; }
+  static bool truthy(const std::string* v) { return v != nullptr && !v->empty(); }
+
+  bool matchConstraint(const Constraint& c, const State& state) const {
+    const std::string* value = c.attr == ATTR_NONE ? nullptr : state.values[c.attr];
+
+    bool result = false;
+    switch (c.op) {
+    case Op::EXISTS:
+      result = present(value);
+      return c.inverted ? !result : result;
+    case Op::NOT_EXISTS:
+      result = !present(value);
+      return c.inverted ? !result : result;
+    case Op::ARR_EMPTY:
+      // Context values are strings, never arrays
+      return !c.inverted;
+    default:
+      break;
+    }
+    if (!value)
+      return c.inverted;
+
+    const std::string& stringValue = *value;
+    std::string lowered;
+    if (c.caseInsensitive)
+      lowered = toLower(stringValue);
+    const std::string& compareValue = c.caseInsensitive ? lowered : stringValue;
+
+    switch (c.op) {
+    case Op::ARR_ANY:
+    case Op::ARR_ALL:
+      result = false; // a string context value is compared as an empty array
+      break;
+    case Op::STR_EQ:
+      result = compareValue == c.target;
+      break;
+    case Op::STR_CONTAINS:
+      result = compareValue.find(c.target) != std::string::npos;
+      break;
+    case Op::STR_STARTS_WITH:
+      result = compareValue.compare(0, c.target.size(), c.target) == 0;
+      break;
+    case Op::STR_ENDS_WITH:
+      result = compareValue.size() >= c.target.size() &&
+               compareValue.compare(compareValue.size() - c.target.size(), c.target.size(),
+                                    c.target) == 0;
+      break;
+    case Op::STR_IN:
+      result = std::find(c.targets.begin(), c.targets.end(), compareValue) != c.targets.end();
+      break;
+    case Op::STR_REGEX:
+      try {
+        result = c.regex && std::regex_search(stringValue, *c.regex);
+      } catch (const std::regex_error&) {
+        result = false;
+      }
+      break;
+    case Op::CIDR_MATCH: {
+      uint32_t ip = 0;
+      bool parsed = parseIpv4(stringValue, ip);
+      for (const auto& range : c.ranges) {
+        if (stringValue == range.raw ||
+            (parsed && range.valid && (ip & range.mask) == range.network)) {
+          result = true;
+          break;
+        }
+      }
+      break;
+    }
+    case Op::NUM_EQ:
+      result = jsNumber(stringValue) == c.number;
+      break;
+    case Op::NUM_GT:
+      result = jsNumber(stringValue) > c.number;
+      break;
+    case Op::NUM_GTE:
+      result = jsNumber(stringValue) >= c.number;
+      break;
+    case Op::NUM_LT:
+      result = jsNumber(stringValue) < c.number;
+      break;
+    case Op::NUM_LTE:
+      result = jsNumber(stringValue) <= c.number;
+      break;
+    case Op::NUM_IN: {
+      double n = jsNumber(stringValue);
+      result = std::isnan(n) ? c.numbersHaveNaN
+                             : std::find(c.numbers.begin(), c.numbers.end(), n) != c.numbers.end();
+      break;
+    }
+    case Op::BOOL_IS:
+      result = !stringValue.empty() == c.boolTarget;
+      break;
+    case Op::DATE_EQ:
+      result = jsDateMs(stringValue) == c.date;
+      break;
+    case Op::DATE_GT:
+      result = jsDateMs(stringValue) > c.date;
+      break;
+    case Op::DATE_GTE:
+      result = jsDateMs(stringValue) >= c.date;
+      break;
+    case Op::DATE_LT:
+      result = jsDateMs(stringValue) < c.date;
+      break;
+    case Op::DATE_LTE:
+      result = jsDateMs(stringValue) <= c.date;
+      break;
+    case Op::SEMVER_EQ:
+      result = compareVersions(parseVersion(stringValue), c.version) == 0;
+      break;
+    case Op::SEMVER_GT:
+      result = compareVersions(parseVersion(stringValue), c.version) > 0;
+      break;
+    case Op::SEMVER_GTE:
+      result = compareVersions(parseVersion(stringValue), c.version) >= 0;
+      break;
+    case Op::SEMVER_LT:
+      result = compareVersions(parseVersion(stringValue), c.version) < 0;
+      break;
+    case Op::SEMVER_LTE:
+      result = compareVersions(parseVersion(stringValue), c.version) <= 0;
+      break;
+    case Op::SEMVER_IN: {
+      std::vector<double> version = parseVersion(stringValue);
+      for (const auto& v : c.versions) {
+        if (compareVersions(version, v) == 0) {
+          result = true;
+          break;
+        }
+      }
+      break;
+    }
+    default:
+      result = false;
+      break;
+    }
+    return c.inverted ? !result : result;
+  }
+
+  bool matchAll(const std::vector<Constraint>& constraints, const State& state) const {
+    for (const auto& c : constraints) {
+      if (!matchConstraint(c, state))
+        return false;
+    }
+    return true;
+  }
+
+  bool matchSegment(int index, State& state) const {
+    uint64_t bit = uint64_t(1) << (index % 64);
+    size_t word = static_cast<size_t>(index / 64);
+    if ((state.segmentDone[word] & bit) == 0) {
+      state.segmentDone[word] |= bit;
+      if (matchAll(segments[index].constraints, state))
+        state.segmentPass[word] |= bit;
+    }
+    return (state.segmentPass[word] & bit) != 0;
+  }
+
+  bool matchStrategy(const Strategy& s, State& state) const {
+    // Segments, then the strategy's own constraints, then the strategy type
+    for (int segment : s.segments) {
+      if (!matchSegment(segment, state))
+        return false;
+    }
+    if (!matchAll(s.constraints, state))
+      return false;
+
+    const std::string* userId = state.values[ATTR_USER_ID];
+    const std::string* sessionId = state.values[ATTR_SESSION_ID];
+    switch (s.type) {
+    case StrategyType::FLEXIBLE_ROLLOUT: {
+      std::string id;
+      switch (s.stickiness) {
+      case Stickiness::DEFAULT:
+        if (truthy(userId))
+          id = *userId;
+        else if (truthy(sessionId))
+          id = *sessionId;
+        break;
+      case Stickiness::USER_ID:
+        if (userId)
+          id = *userId;
+        break;
+      case Stickiness::SESSION_ID:
+        if (sessionId)
+          id = *sessionId;
+        break;
+      case Stickiness::RANDOM:
+        id = std::to_string(rand() % 10001 + 1);
+        break;
+      case Stickiness::ATTRIBUTE:
+        // Read from context.properties, which the flattened request context never fills
+        break;
+      }
+      if (id.empty())
+        return false;
+      return s.rollout > 0 && normalizedStrategyValue(id, s.groupId) <= s.rollout;
+    }
+    case StrategyType::USER_WITH_ID:
+      return truthy(userId) &&
+             std::find(s.userIds.begin(), s.userIds.end(), *userId) != s.userIds.end();
+    case StrategyType::GRADUAL_ROLLOUT_USER_ID:
+      return truthy(userId) && s.percentage > 0 &&
+             normalizedStrategyValue(*userId, s.groupId) <= s.percentage;
+    case StrategyType::GRADUAL_ROLLOUT_SESSION_ID:
+      return truthy(sessionId) && s.percentage > 0 &&
+             normalizedStrategyValue(*sessionId, s.groupId) <= s.percentage;
+    case StrategyType::GRADUAL_ROLLOUT_RANDOM:
+      return s.percentage >= rand() % 100 + 1;
+    case StrategyType::REMOTE_ADDRESS: {
+      const std::string* address = state.values[ATTR_REMOTE_ADDRESS];
+      if (s.ips.empty() || !truthy(address))
+        return false;
+      uint32_t ip = 0;
+      bool parsed = parseIpv4(*address, ip);
+      for (const auto& range : s.ips) {
+        if (*address == range.raw || (parsed && range.valid && (ip & range.mask) == range.network))
+          return true;
+      }
+      return false;
+    }
+    case StrategyType::APPLICATION_HOSTNAME:
+      return false;
+    case StrategyType::DEFAULT:
+    case StrategyType::UNKNOWN:
+      return true;
+    }
+    return true;
+  }
+
+  const FlagVariant* selectVariant(const Flag& f, const Strategy* matched,
+                                   const State& state) const {
+    if (f.variants.empty() || f.totalWeight <= 0)
+      return nullptr;
+
+    const std::string* userId = state.values[ATTR_USER_ID];
+    const std::string* sessionId = state.values[ATTR_SESSION_ID];
+    Stickiness stickiness = matched ? matched->stickiness : Stickiness::DEFAULT;
+    std::string id;
+    switch (stickiness) {
+    case Stickiness::DEFAULT:
+    case Stickiness::USER_ID:
+      id = truthy(userId) ? *userId : truthy(sessionId) ? *sessionId : randomStickiness();
+      break;
+    case Stickiness::SESSION_ID:
+      id = truthy(sessionId) ? *sessionId : randomStickiness();
+      break;
+    case Stickiness::RANDOM:
+      id = randomStickiness();
+      break;
+    case Stickiness::ATTRIBUTE: {
+      const std::string* value =
+          matched->stickinessAttr == ATTR_NONE ? nullptr : state.values[matched->stickinessAttr];
+      id = truthy(value) ? *value : randomStickiness();
+      break;
+    }
+    }
+
+    double percentage =
+        static_cast<double>(murmurHash3(f.name + "-variant:" + id) % 10000) / 100.0;
+    double target = percentage / 100.0 * f.totalWeight;
+    double cumulative = 0.0;
+    for (const auto& v : f.variants) {
+      cumulative += v.weight;
+      if (target <= cumulative)
+        return &v;
+    }
+    return &f.variants.back();
+  }
+
+  EvaluatedFlag evaluate(const Flag& f, State& state) const {
+    EvaluatedFlag out;
+    out.name = f.name;
+    out.valueType = f.valueType;
+    out.version = f.version;
+    out.impressionData = f.impressionData;
+
+    if (f.enabled) {
+      const Strategy* matched = nullptr;
+      bool match = f.strategies.empty();
+      for (const auto& s : f.strategies) {
+        if (matchStrategy(s, state)) {
+          matched = &s;
+          match = true;
+          break;
+        }
+      }
+      if (match) {
+        out.enabled = true;
+        out.reason = matched ? "strategy_match" : "default";
+        out.variant.enabled = true;
+        const FlagVariant* v = selectVariant(f, matched, state);
+        if (v && !v->isDefault) {
+          out.variant.name = v->name;
+          out.variant.value = v->value;
+        } else {
+          out.variant.name = f.enabledName;
+          out.variant.value = f.enabledValue;
+        }
+        return out;
+      }
+      out.reason = "default";
+    } else {
+      out.reason = "disabled";
+    }
+    out.variant.name = f.disabledName;
+    out.variant.value = f.disabledValue;
+    return out;
+  }
+};
+
+// ==================== LocalEvaluator ====================
+
+LocalEvaluator::LocalEvaluator() = default;
+
+LocalEvaluator::~LocalEvaluator() = default;
+
+bool LocalEvaluator::load(const rapidjson::Value& doc, std::string& error) {
+  const rapidjson::Value* root = &doc;
+  if (const rapidjson::Value* data = member(doc, "data"))
+    root = data;
+  const rapidjson::Value* flags = member(*root, "flags");
+  if (!flags || !flags->IsArray()) {
+    error = "No flags array in definitions";
+    return false;
+  }
+
+  std::unique_ptr<Program> program(new Program());
+  program->intern("userId");
+  program->intern("sessionId");
+  program->intern("remoteAddress");
+
+  std::unordered_map<std::string, int> segmentIds;
+  const rapidjson::Value* segments = member(*root, "segments");
+  if (segments && segments->IsArray()) {
+    for (const auto& sj : segments->GetArray()) {
+      std::string name = stringMember(sj, "name");
+      Program::Segment segment;
+      segment.constraints = program->compileConstraints(sj);
+      auto it = segmentIds.find(name);
+      if (it != segmentIds.end()) {
+        program->segments[it->second] = std::move(segment); // last one wins, as in a Map
+      } else {
+        segmentIds.emplace(name, static_cast<int>(program->segments.size()));
+        program->segments.push_back(std::move(segment));
+      }
+    }
+  }
+
+  for (const auto& fj : flags->GetArray()) {
+    if (!fj.IsObject() || stringMember(fj, "name").empty())
+      continue;
+    program->flags.push_back(program->compileFlag(fj, segmentIds));
+  }
+  std::sort(program->flags.begin(), program->flags.end(),
+            [](const Program::Flag& a, const Program::Flag& b) { return a.name < b.name; });
+
+  _program = std::move(program);
+  return true;
+}
+
+int LocalEvaluator::flagCount() const {
+  return _program ? static_cast<int>(_program->flags.size()) : 0;
+}
+
+namespace {
+struct SharedProgram {
+  std::weak_ptr<LocalEvaluator> evaluator;
+  std::string etag;
+};
+
+std::map<std::string, SharedProgram>& sharedPrograms() {
+  static std::map<std::string, SharedProgram> programs;
+  return programs;
+}
+} // namespace
+
+void LocalEvaluator::share(const std::string& environment,
+                           const std::shared_ptr<LocalEvaluator>& evaluator,
+                           const std::string& etag) {
+  SharedProgram& shared = sharedPrograms()[environment];
+  shared.evaluator = evaluator;
+  shared.etag = etag;
+}
+
+std::shared_ptr<LocalEvaluator> LocalEvaluator::findShared(const std::string& environment,
+                                                           std::string& etag) {
+  auto it = sharedPrograms().find(environment);
+  if (it == sharedPrograms().end())
+    return nullptr;
+  std::shared_ptr<LocalEvaluator> evaluator = it->second.evaluator.lock();
+  if (evaluator)
+    etag = it->second.etag;
+  return evaluator;
+}
+
+std::map<std::string, EvaluatedFlag> LocalEvaluator::evaluateAll(
+    const GatrixContext& context) const {
+  std::map<std::string, EvaluatedFlag> result;
+  if (!_program)
+    return result;
+  const Program& program = *_program;
+
+  // The context as the server receives it: userId and sessionId when set, then the
+  // properties flattened next to them (a property of the same name wins)
+  Program::State state;
+  state.values.resize(program.attributes.size(), nullptr);
+  for (size_t i = 0; i < program.attributes.size(); i++) {
+    auto it = context.properties.find(program.attributes[i]);
+    if (it != context.properties.end())
+      state.values[i] = &it->second;
+  }
+  if (!state.values[ATTR_USER_ID] && !context.userId.empty())
+    state.values[ATTR_USER_ID] = &context.userId;
+  if (!state.values[ATTR_SESSION_ID] && !context.sessionId.empty())
+    state.values[ATTR_SESSION_ID] = &context.sessionId;
+
+  size_t words = (program.segments.size() + 63) / 64;
+  state.segmentDone.assign(words, 0);
+  state.segmentPass.assign(words, 0);
+
+  for (const auto& flag : program.flags) {
+    EvaluatedFlag evaluated = program.evaluate(flag, state);
+    evaluated.contentHash = computeFlagContentHash(evaluated);
+    result.emplace_hint(result.end(), flag.name, std::move(evaluated));
+  }
+  return result;
+}
+
+} // namespace gatrix
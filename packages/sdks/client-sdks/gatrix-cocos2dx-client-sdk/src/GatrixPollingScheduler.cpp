@@ -0,0 +1,122 @@
+// GatrixPollingScheduler.cpp - Streaming-aware, server-hinted poll intervals
+
+#include "GatrixPollingScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace gatrix {
+
+namespace {
+// Spread of the healthy/degraded intervals so a fleet does not poll in lockstep
+const float INTERVAL_JITTER = 0.1f;
+// Cap on the flapping backoff exponent (base * 2^6)
+const int MAX_FLAP_EXPONENT = 6;
+} // namespace
+
+PollingScheduler::PollingScheduler(int refreshIntervalSec, int safetyIntervalSec,
+                                   int flapThreshold, int flapWindowSec)
+    : _refreshIntervalSec(std::max(1, refreshIntervalSec)),
+      _safetyIntervalSec(std::max(std::max(1, refreshIntervalSec), safetyIntervalSec)),
+      _flapThreshold(std::max(1, flapThreshold)), _flapWindow(std::max(1, flapWindowSec)),
+      _rng(std::random_device{}()) {}
+
+void PollingScheduler::setStreamingEnabled(bool enabled) {
+  _streamingEnabled = enabled;
+  _connected = false;
+  _disconnects.clear();
+}
+
+void PollingScheduler::onStreamingState(bool connected, Clock::time_point now) {
+  if (_connected && !connected) {
+    _disconnects.push_back(now);
+  }
+  _connected = connected;
+  while (!_disconnects.empty() && now - _disconnects.front() > _flapWindow) {
+    _disconnects.pop_front();
+  }
+}
+
+void PollingScheduler::setRetryAfter(int seconds, Clock::time_point now) {
+  if (seconds <= 0)
+    return;
+  _hasRetryAfter = true;
+  _retryAfterUntil = now + std::chrono::seconds(seconds);
+}
+
+int PollingScheduler::recentFlaps(Clock::time_point now) const {
+  auto inWindow = [&](Clock::time_point t) { return now - t <= _flapWindow; };
+  return static_cast<int>(std::count_if(_disconnects.begin(), _disconnects.end(), inWindow));
+}
+
+PollingMode PollingScheduler::mode(Clock::time_point now) const {
+  if (!_streamingEnabled)
+    return PollingMode::NORMAL;
+  if (recentFlaps(now) >= _flapThreshold)
+    return PollingMode::FLAPPING;
+  return _connected ? PollingMode::HEALTHY : PollingMode::DEGRADED;
+}
+
+float PollingScheduler::jitter(float seconds, float ratio) {
+  std::uniform_real_distribution<float> dist(-ratio, ratio);
+  return seconds * (1.0f + dist(_rng));
+}
+
+float PollingScheduler::nextDelay(int consecutiveFailures, float initialBackoff, float maxBackoff,
+                                  Clock::time_point now) {
+  int baseSec = _serverIntervalSec > 0 ? _serverIntervalSec : _refreshIntervalSec;
+  float base = static_cast<float>(baseSec);
+  float delay = base;
+
+  if (consecutiveFailures > 0) {
+    delay = std::min(initialBackoff * static_cast<float>(std::pow(2, consecutiveFailures - 1)),
+                     maxBackoff);
+  } else {
+    switch (mode(now)) {
+    case PollingMode::NORMAL:
+      break;
+    case PollingMode::HEALTHY:
+      // The safety interval stands in for the server; an explicit hint, smaller or not, wins
+      delay = jitter(_serverIntervalSec > 0 ? base : static_cast<float>(_safetyIntervalSec),
+                     INTERVAL_JITTER);
+      break;
+    case PollingMode::DEGRADED:
+      delay = jitter(base, INTERVAL_JITTER);
+      break;
+    case PollingMode::FLAPPING: {
+      // Full jitter in [cap/2, cap] decorrelates clients that dropped together
+      int exponent = std::min(MAX_FLAP_EXPONENT, recentFlaps(now) - _flapThreshold + 1);
+      float cap = std::min(base * static_cast<float>(1 << exponent),
+                           static_cast<float>(_safetyIntervalSec));
+      std::uniform_real_distribution<float> dist(cap * 0.5f, cap);
+      delay = dist(_rng);
+      break;
+    }
+    }
+  }
+
+  // Retry-After is a floor for the next poll only
+  if (_hasRetryAfter) {
+    float remaining = std::chrono::duration<float>(_retryAfterUntil - now).count();
+    delay = std::max(delay, remaining);
+    _hasRetryAfter = false;
+  }
+
+  _lastDelay = delay;
+  return delay;
+}
+
+const char* PollingScheduler::modeName(PollingMode mode) {
+  switch (mode) {
+  case PollingMode::NORMAL:
+    return "normal";
+  case PollingMode::HEALTHY:
+    return "healthy";
+  case PollingMode::DEGRADED:
+    return "degraded";
+  case PollingMode::FLAPPING:
+    return "flapping";
+  }
+  return "normal";
+}
+
+} // namespace gatrix
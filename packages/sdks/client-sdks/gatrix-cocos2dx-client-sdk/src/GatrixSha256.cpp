@@ -0,0 +1,101 @@
+// GatrixSha256.cpp - Streaming SHA-256 (context hashes and ETags)
+
+#include "GatrixSha256.h"
+#include <cstdio>
+
+namespace gatrix {
+
+namespace {
+uint32_t rotr(uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); }
+uint32_t ch(uint32_t x, uint32_t y, uint32_t z) { return (x & y) ^ (~x & z); }
+uint32_t maj(uint32_t x, uint32_t y, uint32_t z) { return (x & y) ^ (x & z) ^ (y & z); }
+uint32_t ep0(uint32_t x) { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
+uint32_t ep1(uint32_t x) { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
+uint32_t sig0(uint32_t x) { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3); }
+uint32_t sig1(uint32_t x) { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10); }
+
+const uint32_t K[] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+} // namespace
+
+Sha256::Sha256() {
+  _state[0] = 0x6a09e667;
+  _state[1] = 0xbb67ae85;
+  _state[2] = 0x3c6ef372;
+  _state[3] = 0xa54ff53a;
+  _state[4] = 0x510e527f;
+  _state[5] = 0x9b05688c;
+  _state[6] = 0x1f83d9ab;
+  _state[7] = 0x5be0cd19;
+}
+
+Sha256& Sha256::update(const void* data, size_t len) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < len; ++i) {
+    _buffer[_bufferLen++] = bytes[i];
+    if (_bufferLen == 64) {
+      processBlock(_buffer);
+      _totalLen += 64;
+      _bufferLen = 0;
+    }
+  }
+  return *this;
+}
+
+std::string Sha256::hexDigest() const {
+  Sha256 tail = *this;
+  uint64_t totalBits = (_totalLen + _bufferLen) * 8;
+  tail.update("\x80", 1);
+  while (tail._bufferLen != 56)
+    tail.update("\x00", 1);
+  for (int i = 7; i >= 0; --i) {
+    uint8_t b = static_cast<uint8_t>(totalBits >> (i * 8));
+    tail.update(&b, 1);
+  }
+
+  char hex[65];
+  for (int i = 0; i < 8; ++i)
+    snprintf(hex + i * 8, 9, "%08x", tail._state[i]);
+  return std::string(hex, 64);
+}
+
+void Sha256::processBlock(const uint8_t* data) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++)
+    w[i] = (static_cast<uint32_t>(data[i * 4]) << 24) |
+           (static_cast<uint32_t>(data[i * 4 + 1]) << 16) |
+           (static_cast<uint32_t>(data[i * 4 + 2]) << 8) | data[i * 4 + 3];
+  for (int i = 16; i < 64; i++)
+    w[i] = sig1(w[i - 2]) + w[i - 7] + sig0(w[i - 15]) + w[i - 16];
+  uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3], e = _state[4],
+           f = _state[5], g = _state[6], h = _state[7];
+  for (int i = 0; i < 64; i++) {
+    uint32_t t1 = h + ep1(e) + ch(e, f, g) + K[i] + w[i];
+    uint32_t t2 = ep0(a) + maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  _state[0] += a;
+  _state[1] += b;
+  _state[2] += c;
+  _state[3] += d;
+  _state[4] += e;
+  _state[5] += f;
+  _state[6] += g;
+  _state[7] += h;
+}
+
+} // namespace gatrix
@@ -0,0 +1,100 @@
+// GatrixSnapshotCache.cpp - LRU of complete flag sets keyed by context hash
+
+#include "GatrixSnapshotCache.h"
+
+namespace gatrix {
+
+namespace {
+// Approximate heap footprint of a snapshot: the record structs plus their strings
+size_t estimateBytes(const std::map<std::string, EvaluatedFlag>& flags) {
+  size_t bytes = 0;
+  for (const auto& entry : flags) {
+    const EvaluatedFlag& flag = entry.second;
+    bytes += sizeof(EvaluatedFlag) + entry.first.size() + flag.name.size() +
+             flag.variant.name.size() + flag.variant.value.size() + flag.reason.size();
+  }
+  return bytes;
+}
+} // namespace
+
+SnapshotCache::SnapshotCache(int maxEntries, size_t maxBytes)
+    : _maxEntries(maxEntries > 0 ? maxEntries : 0), _maxBytes(maxBytes) {}
+
+std::shared_ptr<SnapshotCache> SnapshotCache::shared(const std::string& environment,
+                                                     int maxEntries, size_t maxBytes) {
+  if (maxEntries <= 0)
+    return std::make_shared<SnapshotCache>(0, maxBytes);
+
+  static std::map<std::string, std::weak_ptr<SnapshotCache>> caches;
+  std::string key =
+      environment + "|" + std::to_string(maxEntries) + "|" + std::to_string(maxBytes);
+  std::shared_ptr<SnapshotCache> cache = caches[key].lock();
+  if (!cache) {
+    cache = std::make_shared<SnapshotCache>(maxEntries, maxBytes);
+    caches[key] = cache;
+  }
+  return cache;
+}
+
+const SnapshotCache::Entry* SnapshotCache::find(const std::string& contextHash) {
+  auto it = _index.find(contextHash);
+  if (it == _index.end())
+    return nullptr;
+  _entries.splice(_entries.begin(), _entries, it->second);
+  return &_entries.front();
+}
+
+bool SnapshotCache::take(const std::string& contextHash, Entry& out) {
+  auto it = _index.find(contextHash);
+  if (it == _index.end())
+    return false;
+  out = std::move(*it->second);
+  _bytes -= out.bytes;
+  _entries.erase(it->second);
+  _index.erase(it);
+  return true;
+}
+
+void SnapshotCache::put(const std::string& contextHash,
+                        const std::map<std::string, EvaluatedFlag>& flags,
+                        const std::string& etag, size_t responseBytes) {
+  if (!enabled())
+    return;
+
+  auto it = _index.find(contextHash);
+  if (it != _index.end()) {
+    _entries.splice(_entries.begin(), _entries, it->second);
+    _bytes -= _entries.front().bytes;
+  } else {
+    _entries.emplace_front();
+    _entries.front().contextHash = contextHash;
+    _index[contextHash] = _entries.begin();
+  }
+
+  Entry& entry = _entries.front();
+  entry.etag = etag;
+  entry.flags = flags;
+  entry.bytes = estimateBytes(flags);
+  entry.responseBytes = responseBytes;
+  entry.storedAt = std::chrono::steady_clock::now();
+  _bytes += entry.bytes;
+  evict();
+}
+
+void SnapshotCache::clear() {
+  _entries.clear();
+  _index.clear();
+  _bytes = 0;
+}
+
+void SnapshotCache::evict() {
+  while (_entries.size() > 1 &&
+         (static_cast<int>(_entries.size()) > _maxEntries || _bytes > _maxBytes)) {
+    const Entry& oldest = _entries.back();
+    _bytes -= oldest.bytes;
+    _index.erase(oldest.contextHash);
+    _entries.pop_back();
+  }
+}
+
+} // namespace gatrix
@@ -0,0 +1,142 @@
+// GatrixSseParser.cpp - Zero-copy, bounded text/event-stream parser
+
+#include "GatrixSseParser.h"
+
+namespace gatrix {
+
+SseParser::SseParser(size_t maxEventBytes) : _maxEventBytes(maxEventBytes) {}
+
+void SseParser::reset() {
+  _carry.clear();
+  _type.clear();
+  _data.clear();
+  _hasData = false;
+  _discarding = false;
+  _skippingLine = false;
+  _atStreamStart = true;
+}
+
+void SseParser::feed(const char* data, size_t len, const EventCallback& onEvent) {
+  const char* p = data;
+  const char* end = data + len;
+
+  while (p < end) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!nl) {
+      // Incomplete line: carry it to the next chunk, unless it alone breaks the limit
+      size_t rest = static_cast<size_t>(end - p);
+      if (_skippingLine || _carry.size() + rest > _maxEventBytes) {
+        _carry.clear();
+        _skippingLine = true;
+        _discarding = true;
+        _atStreamStart = false;
+      } else {
+        _carry.append(p, rest);
+      }
+      break;
+    }
+
+    if (_skippingLine) {
+      // Tail of an oversized line; the event it belonged to is already dropped
+      _skippingLine = false;
+      p = nl + 1;
+      continue;
+    }
+
+    if (_carry.size() + static_cast<size_t>(nl - p) > _maxEventBytes) {
+      // Oversized line that arrived whole: dropped exactly as if it had been split
+      _carry.clear();
+      _discarding = true;
+      _atStreamStart = false;
+      p = nl + 1;
+      continue;
+    }
+
+    SseView line;
+    if (_carry.empty()) {
+      line = SseView(p, static_cast<size_t>(nl - p));
+    } else {
+      _carry.append(p, static_cast<size_t>(nl - p));
+      line = SseView(_carry);
+    }
+    if (line.size > 0 && line.data[line.size - 1] == '\r')
+      line.size--;
+    if (_atStreamStart) {
+      // Optional UTF-8 BOM at the very start of the stream
+      if (line.size >= 3 && std::memcmp(line.data, "\xEF\xBB\xBF", 3) == 0)
+        line = SseView(line.data + 3, line.size - 3);
+      _atStreamStart = false;
+    }
+
+    processLine(line, onEvent);
+    _carry.clear();
+    p = nl + 1;
+  }
+}
+
+void SseParser::processLine(SseView line, const EventCallback& onEvent) {
+  if (line.empty()) {
+    dispatch(onEvent);
+    return;
+  }
+  if (_discarding || line.data[0] == ':')
+    return; // oversized event being skipped, or a comment
+
+  SseView field = line;
+  SseView value;
+  const char* colon = static_cast<const char*>(std::memchr(line.data, ':', line.size));
+  if (colon) {
+    field = SseView(line.data, static_cast<size_t>(colon - line.data));
+    value = SseView(colon + 1, line.size - field.size - 1);
+    if (!value.empty() && value.data[0] == ' ')
+      value = SseView(value.data + 1, value.size - 1);
+  }
+
+  if (field.equals("data", 4)) {
+    size_t needed = _data.size() + (_hasData ? 1 : 0) + value.size + _type.size();
+    if (needed > _maxEventBytes) {
+      _discarding = true;
+      _data.clear();
+      _type.clear();
+      _hasData = false;
+      return;
+    }
+    if (_hasData)
+      _data.push_back('\n');
+    _data.append(value.data, value.size);
+    _hasData = true;
+  } else if (field.equals("event", 5)) {
+    _type.assign(value.data, value.size);
+  } else if (field.equals("id", 2)) {
+    if (!std::memchr(value.data, '\0', value.size))
+      _lastEventId.assign(value.data, value.size);
+  } else if (field.equals("retry", 5)) {
+    if (value.size > 9)
+      return; // would overflow; no sane reconnect delay is this long
+    int ms = 0;
+    for (size_t i = 0; i < value.size; i++) {
+      char c = value.data[i];
+      if (c < '0' || c > '9')
+        return;
+      ms = ms * 10 + (c - '0');
+    }
+    if (!value.empty())
+      _retryMs = ms;
+  }
+  // Unknown fields are ignored
+}
+
+void SseParser::dispatch(const EventCallback& onEvent) {
+  if (_discarding) {
+    _droppedEvents++;
+  } else if ((_hasData || !_type.empty()) && onEvent) {
+    SseView type = _type.empty() ? SseView("message", 7) : SseView(_type);
+    onEvent(type, SseView(_data));
+  }
+  _type.clear();
+  _data.clear();
+  _hasData = false;
+  _discarding = false;
+}
+
+} // namespace gatrix
@@ -0,0 +1,123 @@
+// GatrixSseReader.cpp - libcurl-driven incremental reader for SSE responses
+
+#include "GatrixSseReader.h"
+#include "curl/curl.h"
+#include <mutex>
+
+namespace gatrix {
+
+namespace {
+
+const long CONNECT_TIMEOUT_SEC = 10;
+
+struct TransferState {
+  CURL* curl = nullptr;
+  const SseReader::OpenCallback* onOpen = nullptr;
+  const SseReader::DataCallback* onData = nullptr;
+  const SseReader::CancelCheck* isCancelled = nullptr;
+  SseReader::Result* result = nullptr;
+};
+
+size_t onHeader(char* buffer, size_t size, size_t nitems, void* userdata) {
+  auto* state = static_cast<TransferState*>(userdata);
+  size_t len = size * nitems;
+
+  // A bare CRLF ends a header block; redirects and 1xx responses produce several
+  if (len <= 2 && (len == 0 || buffer[0] == '\r' || buffer[0] == '\n')) {
+    long code = 0;
+    curl_easy_getinfo(state->curl, CURLINFO_RESPONSE_CODE, &code);
+    state->result->statusCode = static_cast<int>(code);
+    if (code == 200 && !state->result->opened) {
+      state->result->opened = true;
+      if (*state->onOpen)
+        (*state->onOpen)();
+    }
+  }
+  return len;
+}
+
+size_t onBody(char* ptr, size_t size, size_t nmemb, void* userdata) {
+  auto* state = static_cast<TransferState*>(userdata);
+  size_t len = size * nmemb;
+
+  // Error bodies are not event streams; returning short aborts the transfer
+  if (!state->result->opened)
+    return 0;
+  if (*state->onData)
+    (*state->onData)(ptr, len);
+  return len;
+}
+
+int onProgress(void* userdata, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+  auto* state = static_cast<TransferState*>(userdata);
+  if (*state->isCancelled && (*state->isCancelled)()) {
+    state->result->cancelled = true;
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
+SseReader::Result SseReader::run(const std::string& url, const std::vector<std::string>& headers,
+                                 const OpenCallback& onOpen, const DataCallback& onData,
+                                 const CancelCheck& isCancelled, int idleTimeoutSec,
+                                 void* curlShare) {
+  // Reference-counted by libcurl; HttpClient may already have initialized it
+  static std::once_flag initOnce;
+  std::call_once(initOnce, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+  Result result;
+  CURL* curl = curl_easy_init();
+  if (!curl) {
+    result.error = "curl_easy_init failed";
+    return result;
+  }
+
+  struct curl_slist* headerList = nullptr;
+  for (const auto& header : headers) {
+    headerList = curl_slist_append(headerList, header.c_str());
+  }
+
+  TransferState state;
+  state.curl = curl;
+  state.onOpen = &onOpen;
+  state.onData = &onData;
+  state.isCancelled = &isCancelled;
+  state.result = &result;
+
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT_SEC);
+  // No overall timeout: the stream is open-ended. A silent connection (no heartbeats)
+  // is dropped after idleTimeoutSec instead.
+  curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+  curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, static_cast<long>(idleTimeoutSec));
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  if (curlShare)
+    curl_easy_setopt(curl, CURLOPT_SHARE, curlShare);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, onHeader);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &state);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onBody);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state);
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, onProgress);
+  curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &state);
+
+  CURLcode code = curl_easy_perform(curl);
+  if (result.cancelled) {
+    // Requested by the caller: not an error
+  } else if (!result.opened && result.statusCode != 0) {
+    result.error = "SSE HTTP error: " + std::to_string(result.statusCode);
+  } else if (code != CURLE_OK) {
+    result.error = std::string("SSE connection failed: ") + curl_easy_strerror(code);
+  }
+
+  curl_slist_free_all(headerList);
+  curl_easy_cleanup(curl);
+  return result;
+}
+
+} // namespace gatrix
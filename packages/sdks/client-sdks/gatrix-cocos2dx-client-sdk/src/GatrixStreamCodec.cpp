@@ -0,0 +1,114 @@
+// GatrixStreamCodec.cpp - Binary WebSocket streaming frame decoding
+
+#include "GatrixStreamCodec.h"
+#include <climits>
+
+namespace gatrix {
+
+const char* const StreamCodec::BINARY_PROTOCOL = "gatrix.stream.bin.v1";
+const char* const StreamCodec::TEXT_PROTOCOL = "gatrix.stream.json.v1";
+
+namespace {
+
+const unsigned char FRAME_VERSION = 1;
+const unsigned char FLAG_URGENT = 0x01;
+const unsigned char FLAG_SPREAD = 0x02;
+const unsigned char FLAG_BODY = 0x04;
+const unsigned char FLAG_RESUMED = 0x08;
+
+const char* const TYPE_NAMES[] = {"", "connected", "flags_changed", "heartbeat", "pong"};
+const size_t TYPE_COUNT = sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]);
+
+struct Reader {
+  const unsigned char* p;
+  const unsigned char* end;
+
+  bool byte(unsigned char& out) {
+    if (p >= end)
+      return false;
+    out = *p++;
+    return true;
+  }
+
+  bool uvarint(unsigned long long& out) {
+    out = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      unsigned char b;
+      if (!byte(b))
+        return false;
+      out |= static_cast<unsigned long long>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0)
+        return true;
+    }
+    return false; // overlong
+  }
+
+  bool str(const char*& data, size_t& len) {
+    unsigned long long n;
+    if (!uvarint(n) || n > static_cast<unsigned long long>(end - p))
+      return false;
+    data = reinterpret_cast<const char*>(p);
+    len = static_cast<size_t>(n);
+    p += n;
+    return true;
+  }
+};
+
+} // namespace
+
+bool StreamCodec::decode(const char* data, size_t len, BinaryStreamFrame& out) {
+  Reader r{reinterpret_cast<const unsigned char*>(data),
+           reinterpret_cast<const unsigned char*>(data) + len};
+
+  unsigned char version, type, flags;
+  if (!r.byte(version) || version != FRAME_VERSION || !r.byte(type) || !r.byte(flags))
+    return false;
+
+  const char* s;
+  size_t n;
+  if (type == 0) {
+    if (!r.str(s, n))
+      return false;
+    out.type.assign(s, n);
+  } else if (type < TYPE_COUNT) {
+    out.type = TYPE_NAMES[type];
+  } else {
+    return false;
+  }
+
+  unsigned long long value;
+  if (!r.uvarint(value))
+    return false;
+  out.globalRevision = static_cast<long long>(value);
+
+  unsigned long long keyCount;
+  // Every key takes at least one byte, which bounds the reservation
+  if (!r.uvarint(keyCount) || keyCount > static_cast<unsigned long long>(r.end - r.p))
+    return false;
+  out.changedKeys.clear();
+  out.changedKeys.reserve(static_cast<size_t>(keyCount));
+  for (unsigned long long i = 0; i < keyCount; i++) {
+    if (!r.str(s, n))
+      return false;
+    out.changedKeys.emplace_back(s, n);
+  }
+
+  out.urgent = (flags & FLAG_URGENT) != 0;
+  out.resumed = (flags & FLAG_RESUMED) != 0;
+  out.spreadWindowMs = -1;
+  if (flags & FLAG_SPREAD) {
+    if (!r.uvarint(value))
+      return false;
+    out.spreadWindowMs = value > INT_MAX ? INT_MAX : static_cast<int>(value);
+  }
+
+  out.body = nullptr;
+  out.bodyLength = 0;
+  if (flags & FLAG_BODY) {
+    if (!r.str(out.body, out.bodyLength))
+      return false;
+  }
+  return true;
+}
+
+} // namespace gatrix
@@ -1,20 +1,21 @@
 // GatrixStreaming.cpp - SSE and WebSocket streaming for real-time flag updates
 //
-// SSE: Uses Cocos2d-x HttpClient for chunked streaming
+// SSE: Incremental libcurl reader (ITransport::stream) on a dedicated streaming thread
 // WebSocket: Uses Cocos2d-x WebSocket class (Delegate pattern)
 
 #include "GatrixStreaming.h"
 #include "GatrixEvents.h"
+#include "GatrixInterestSet.h"
+#include "GatrixSseReader.h"
+#include "GatrixStreamCodec.h"
 #include "GatrixVersion.h"
 #include "cocos2d.h"
 #include "json/document.h"
-#include "json/stringbuffer.h"
-#include "json/writer.h"
-#include "network/HttpClient.h"
 #include "network/WebSocket.h"
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 
 using namespace cocos2d;
@@ -28,7 +29,7 @@ class GatrixWsDelegate : public WebSocket::Delegate {
 public:
   GatrixWsDelegate(StreamingManager* owner) : _owner(owner) {}
 
-  void onOpen(WebSocket* ws) override {
+  void onOpen(WebSocket* /*ws*/) override {
     if (!_owner)
       return;
     Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]() {
@@ -37,17 +38,19 @@ public:
     });
   }
 
-  void onMessage(WebSocket* ws, const WebSocket::Data& data) override {
+  void onMessage(WebSocket* /*ws*/, const WebSocket::Data& data) override {
     if (!_owner)
       return;
     std::string msg(data.bytes, data.len);
-    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, msg]() {
-      if (_onMessage)
-        _onMessage(msg);
-    });
+    bool binary = data.isBinary;
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread(
+        [this, msg, binary]() mutable {
+          if (_onMessage)
+            _onMessage(msg, binary);
+        });
   }
 
-  void onClose(WebSocket* ws) override {
+  void onClose(WebSocket* /*ws*/) override {
     if (!_owner)
       return;
     Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]() {
@@ -56,7 +59,7 @@ public:
     });
   }
 
-  void onError(WebSocket* ws, const WebSocket::ErrorCode& error) override {
+  void onError(WebSocket* /*ws*/, const WebSocket::ErrorCode& error) override {
     if (!_owner)
       return;
     std::string errorMsg = "WebSocket error code: " + std::to_string(static_cast<int>(error));
@@ -69,7 +72,7 @@ public:
   void detach() { _owner = nullptr; }
 
   std::function<void()> _onOpen;
-  std::function<void(const std::string&)> _onMessage;
+  std::function<void(std::string&, bool)> _onMessage; // may parse the frame in place
   std::function<void()> _onClose;
   std::function<void(const std::string&)> _onError;
 
@@ -79,8 +82,9 @@ private:
 
 // ==================== StreamingManager ====================
 
-StreamingManager::StreamingManager(const GatrixClientConfig& config, GatrixEventEmitter& emitter)
-    : _config(config), _emitter(emitter) {
+StreamingManager::StreamingManager(const GatrixClientConfig& config, GatrixEventEmitter& emitter,
+                                   ITransport& transport)
+    : _config(config), _emitter(emitter), _transport(transport) {
   // Seed RNG for jitter
   std::random_device rd;
   _rng.seed(rd());
@@ -88,6 +92,7 @@ StreamingManager::StreamingManager(const GatrixClientConfig& config, GatrixEvent
 
 StreamingManager::~StreamingManager() {
   disconnect();
+  *_alive = false;
 }
 
 void StreamingManager::connect() {
@@ -98,7 +103,7 @@ void StreamingManager::connect() {
     return;
   }
 
-  _state = StreamingConnectionState::CONNECTING;
+  setState(StreamingConnectionState::CONNECTING);
   _stopRequested = false;
 
   if (_config.features.streaming.transport == StreamingTransport::WEBSOCKET) {
@@ -111,26 +116,18 @@ void StreamingManager::connect() {
 void StreamingManager::disconnect() {
   {
     std::lock_guard<std::mutex> lock(_mutex);
-    _state = StreamingConnectionState::DISCONNECTED;
+    setState(StreamingConnectionState::DISCONNECTED);
     _stopRequested = true;
-    _pingStopRequested = true;
   }
 
+  // Cancel pending ping/reconnect timers
+  unscheduleTimers();
+
   // Stop SSE thread
   if (_sseThread.joinable()) {
     _sseThread.join();
   }
 
-  // Stop reconnect thread
-  if (_reconnectThread.joinable()) {
-    _reconnectThread.join();
-  }
-
-  // Stop ping thread
-  if (_pingThread.joinable()) {
-    _pingThread.join();
-  }
-
   // Close WebSocket
   if (_ws) {
     auto delegate = dynamic_cast<GatrixWsDelegate*>(_ws->getDelegate());
@@ -172,8 +169,11 @@ std::string StreamingManager::buildWsUrl() const {
     baseUrl += "/client/features/stream/ws";
   }
 
-  // Add query params
+  // Add query params; cocos2d-x WebSocket cannot send Last-Event-ID, so the
+  // resume point travels in the query and reaches the server with the handshake
   auto params = buildQueryParams();
+  if (_localGlobalRevision > 0)
+    params += "&lastEventId=" + std::to_string(_localGlobalRevision);
   if (baseUrl.find('?') != std::string::npos) {
     baseUrl += "&" + params;
   } else {
@@ -188,6 +188,18 @@ std::string StreamingManager::buildQueryParams() const {
   params += "&appName=" + _config.appName;
   params += "&connectionId=" + _connectionId;
   params += "&sdkVersion=" + std::string(SDK_NAME) + "/" + std::string(SDK_VERSION);
+  if (_config.features.streaming.pushPayload)
+    params += "&payload=true";
+  if (_config.features.enableScheduledActivations)
+    params += "&scheduled=true";
+
+  // A declared-only interest set lets the server filter events; one that grows at runtime
+  // would go stale on the open stream, so observed sets are filtered by the client instead
+  InterestSet interest;
+  interest.configure(_config.features.interestKeys, _config.features.trackObservedKeys,
+                     _config.features.interestBloomThreshold);
+  if (interest.isStatic())
+    params += "&" + interest.toQueryString();
   return params;
 }
 
@@ -201,19 +213,16 @@ void StreamingManager::connectSse() {
   }
   _stopRequested = false;
 
-  _sseThread = std::thread([this]() { runSseLoop(); });
+  // The resume point is read here, on the cocos thread that owns it
+  long resumeRevision = _localGlobalRevision;
+  _sseThread = std::thread([this, resumeRevision]() { runSseLoop(resumeRevision); });
 }
 
-void StreamingManager::runSseLoop() {
+void StreamingManager::runSseLoop(long resumeRevision) {
   auto streamUrl = buildSseUrl();
   CCLOG("[Gatrix] SSE stream URL: %s", streamUrl.c_str());
 
-  // Use Cocos2d-x HttpClient for the SSE request
-  auto request = new HttpRequest();
-  request->setRequestType(HttpRequest::Type::GET);
-  request->setUrl(streamUrl);
-
-  // Set SSE headers
+  // SSE headers
   std::vector<std::string> headers;
   headers.push_back("Accept: text/event-stream");
   headers.push_back("Cache-Control: no-cache");
@@ -224,118 +233,75 @@ void StreamingManager::runSseLoop() {
   for (auto& kv : _config.customHeaders) {
     headers.push_back(kv.first + ": " + kv.second);
   }
-  request->setHeaders(headers);
+  // Event ids are global revisions: the server replays what was missed since this one
+  if (resumeRevision > 0) {
+    headers.push_back("Last-Event-ID: " + std::to_string(resumeRevision));
+  }
 
-  // Response callback (runs on main thread via Cocos2d-x scheduler)
-  request->setResponseCallback([this](HttpClient* client, HttpResponse* response) {
-    if (_stopRequested)
-      return;
+  // Parser state belongs to this thread for the lifetime of the connection
+  _sseParser = SseParser(_config.features.streaming.sse.maxEventSize);
+  _sseDroppedReported = 0;
+
+  // Read incrementally on this thread; events are parsed as bytes arrive and
+  // handed to the cocos thread one by one
+  std::weak_ptr<bool> alive = _alive;
+  auto result = _transport.stream(
+      streamUrl, headers,
+      [this, alive]() {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, alive]() {
+          if (alive.expired() || _stopRequested)
+            return;
+          // Track recovery if this was a reconnection
+          if (_reconnectCount > 0) {
+            trackRecovery();
+          }
+          setState(StreamingConnectionState::CONNECTED);
+          _reconnectAttempt = 0;
+          CCLOG("[Gatrix] SSE streaming connected");
+          _emitter.emit(EVENTS::FLAGS_STREAMING_CONNECTED);
+        });
+      },
+      [this](const char* data, size_t len) { parseSseChunk(data, len); },
+      [this]() { return _stopRequested.load(); },
+      _config.features.streaming.sse.idleTimeout);
 
-    if (!response || !response->isSucceed()) {
-      std::string errorMsg = "SSE connection failed";
-      if (response) {
-        errorMsg += ": HTTP " + std::to_string(response->getResponseCode());
-      }
-      trackError(errorMsg);
-      _state = StreamingConnectionState::RECONNECTING;
-      _emitter.emit(EVENTS::FLAGS_STREAMING_ERROR, {errorMsg});
-      _emitter.emit(EVENTS::FLAGS_STREAMING_DISCONNECTED);
-      scheduleReconnect();
-      return;
-    }
+  if (result.cancelled || _stopRequested)
+    return;
 
-    auto statusCode = response->getResponseCode();
-    if (statusCode != 200) {
-      std::string errorMsg = "SSE HTTP error: " + std::to_string(statusCode);
-      trackError(errorMsg);
-      _state = StreamingConnectionState::RECONNECTING;
-      _emitter.emit(EVENTS::FLAGS_STREAMING_ERROR, {errorMsg});
-      _emitter.emit(EVENTS::FLAGS_STREAMING_DISCONNECTED);
-      scheduleReconnect();
+  // Stream ended: failed to open, dropped, or closed by the server - schedule reconnect
+  Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, alive, result]() {
+    if (alive.expired() || _stopRequested || _state == StreamingConnectionState::DISCONNECTED)
       return;
-    }
-
-    // Track recovery if this was a reconnection
-    if (_reconnectCount > 0) {
-      trackRecovery();
-    }
-    _state = StreamingConnectionState::CONNECTED;
-    _reconnectAttempt = 0;
-    CCLOG("[Gatrix] SSE streaming connected");
-    _emitter.emit(EVENTS::FLAGS_STREAMING_CONNECTED);
-
-    // Parse SSE data from the response body
-    auto* data = response->getResponseData();
-    if (data && !data->empty()) {
-      std::string body(data->begin(), data->end());
-      parseSseChunk(body);
-    }
-
-    // SSE connection ended (server closed) - schedule reconnect
-    if (!_stopRequested && _state != StreamingConnectionState::DISCONNECTED) {
+    if (!result.error.empty()) {
+      trackError(result.error);
+      _emitter.emit(EVENTS::FLAGS_STREAMING_ERROR, {result.error});
+    } else {
       CCLOG("[Gatrix] SSE connection closed by server");
-      _state = StreamingConnectionState::RECONNECTING;
-      _emitter.emit(EVENTS::FLAGS_STREAMING_DISCONNECTED);
-      scheduleReconnect();
     }
+    setState(StreamingConnectionState::RECONNECTING);
+    _emitter.emit(EVENTS::FLAGS_STREAMING_DISCONNECTED);
+    scheduleReconnect();
   });
-
-  HttpClient::getInstance()->send(request);
-  request->release();
 }
 
-void StreamingManager::parseSseChunk(const std::string& chunk) {
-  _sseLineBuffer += chunk;
-
-  // Process complete lines
-  size_t pos = 0;
-  while (pos < _sseLineBuffer.size()) {
-    auto newlinePos = _sseLineBuffer.find('\n', pos);
-    if (newlinePos == std::string::npos)
-      break;
-
-    std::string line = _sseLineBuffer.substr(pos, newlinePos - pos);
-    pos = newlinePos + 1;
-
-    // Remove trailing \r
-    if (!line.empty() && line.back() == '\r') {
-      line.pop_back();
-    }
-
-    if (line.empty()) {
-      // Empty line = dispatch event
-      if (!_sseCurrentEventType.empty() || !_sseDataBuffer.empty()) {
-        auto eventType = _sseCurrentEventType.empty() ? "message" : _sseCurrentEventType;
-        auto eventData = _sseDataBuffer;
-        _sseCurrentEventType.clear();
-        _sseDataBuffer.clear();
-        processStreamingEvent(eventType, eventData);
-      }
-    } else if (line.find("event:") == 0) {
-      _sseCurrentEventType = line.substr(6);
-      // Trim leading whitespace
-      auto start = _sseCurrentEventType.find_first_not_of(' ');
-      if (start != std::string::npos) {
-        _sseCurrentEventType = _sseCurrentEventType.substr(start);
-      }
-    } else if (line.find("data:") == 0) {
-      auto data = line.substr(5);
-      auto start = data.find_first_not_of(' ');
-      if (start != std::string::npos) {
-        data = data.substr(start);
-      }
-      if (!_sseDataBuffer.empty())
-        _sseDataBuffer += "\n";
-      _sseDataBuffer += data;
-    }
-    // Ignore 'id:', 'retry:', and comment lines starting with ':'
-  }
+void StreamingManager::parseSseChunk(const char* data, size_t len) {
+  std::weak_ptr<bool> alive = _alive;
+  _sseParser.feed(data, len, [this, &alive](SseView type, SseView payload) {
+    // Parsed on the streaming thread, processed on the cocos thread
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread(
+        [this, alive, eventType = type.str(), eventData = payload.str()]() mutable {
+          if (!alive.expired() && !_stopRequested)
+            handleSseEvent(eventType, eventData);
+        });
+  });
 
-  // Keep remaining incomplete data
-  if (pos < _sseLineBuffer.size()) {
-    _sseLineBuffer = _sseLineBuffer.substr(pos);
-  } else {
-    _sseLineBuffer.clear();
+  size_t dropped = _sseParser.droppedEventCount();
+  if (dropped != _sseDroppedReported) {
+    _sseDroppedReported = dropped;
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, alive]() {
+      if (!alive.expired() && !_stopRequested)
+        trackError("SSE event exceeded maxEventSize and was dropped");
+    });
   }
 }
 
@@ -358,89 +324,56 @@ void StreamingManager::connectWebSocket() {
 
   auto delegate = new GatrixWsDelegate(this);
 
+  // The delegate posts these to the cocos thread, where the manager may already be gone
+  std::weak_ptr<bool> alive = _alive;
+
   // On open
-  delegate->_onOpen = [this]() {
-    if (_stopRequested)
+  delegate->_onOpen = [this, alive]() {
+    if (alive.expired() || _stopRequested)
       return;
 
     if (_reconnectCount > 0) {
       trackRecovery();
     }
-    _state = StreamingConnectionState::CONNECTED;
+    setState(StreamingConnectionState::CONNECTED);
     _reconnectAttempt = 0;
     CCLOG("[Gatrix] WebSocket streaming connected");
     _emitter.emit(EVENTS::FLAGS_STREAMING_CONNECTED);
 
-    // Start ping loop
-    _pingStopRequested = false;
-    if (_pingThread.joinable())
-      _pingThread.join();
-    _pingThread = std::thread([this]() {
-      int pingIntervalMs = _config.features.streaming.ws.pingInterval * 1000;
-      while (!_pingStopRequested) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(pingIntervalMs));
-        if (_pingStopRequested)
-          break;
-
-        // Send ping on main thread
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]() {
-          if (_ws && _state == StreamingConnectionState::CONNECTED) {
-            _ws->send("{\"type\":\"ping\"}");
-          }
-        });
-      }
-    });
+    // Ping on the cocos scheduler; no thread to wake up on disconnect
+    float pingInterval = static_cast<float>(_config.features.streaming.ws.pingInterval);
+    if (pingInterval > 0) {
+      Director::getInstance()->getScheduler()->schedule(
+          [this, alive](float) {
+            if (!alive.expired() && _ws && _state == StreamingConnectionState::CONNECTED) {
+              _ws->send("{\"type\":\"ping\"}");
+            }
+          },
+          this, pingInterval, CC_REPEAT_FOREVER, pingInterval, false, "GatrixWsPing");
+    }
   };
 
   // On message
-  delegate->_onMessage = [this](const std::string& msg) {
-    if (_stopRequested)
-      return;
-
-    // Parse JSON message
-    rapidjson::Document doc;
-    doc.Parse(msg.c_str());
-
-    if (doc.HasParseError() || !doc.IsObject()) {
-      CCLOG("[Gatrix] Failed to parse WebSocket message");
-      return;
-    }
-
-    if (!doc.HasMember("type") || !doc["type"].IsString())
-      return;
-
-    std::string eventType = doc["type"].GetString();
-
-    // Handle pong locally
-    if (eventType == "pong")
-      return;
-
-    std::string eventData;
-    if (doc.HasMember("data") && doc["data"].IsObject()) {
-      rapidjson::StringBuffer sb;
-      rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-      doc["data"].Accept(writer);
-      eventData = sb.GetString();
-    }
-
-    processStreamingEvent(eventType, eventData);
+  delegate->_onMessage = [this, alive](std::string& msg, bool binary) {
+    if (!alive.expired() && !_stopRequested)
+      handleWsMessage(msg, binary);
   };
 
   // On close
-  delegate->_onClose = [this]() {
-    if (_stopRequested || _state == StreamingConnectionState::DISCONNECTED)
+  delegate->_onClose = [this, alive]() {
+    if (alive.expired() || _stopRequested || _state == StreamingConnectionState::DISCONNECTED)
       return;
 
     CCLOG("[Gatrix] WebSocket connection closed by server");
-    _state = StreamingConnectionState::RECONNECTING;
+    setState(StreamingConnectionState::RECONNECTING);
     _emitter.emit(EVENTS::FLAGS_STREAMING_DISCONNECTED);
-    _pingStopRequested = true;
+    unscheduleTimers();
     scheduleReconnect();
   };
 
   // On error
-  delegate->_onError = [this](const std::string& errorMsg) {
-    if (_stopRequested)
+  delegate->_onError = [this, alive](const std::string& errorMsg) {
+    if (alive.expired() || _stopRequested)
       return;
 
     trackError(errorMsg);
@@ -448,46 +381,148 @@ void StreamingManager::connectWebSocket() {
     _emitter.emit(EVENTS::FLAGS_STREAMING_ERROR, {errorMsg});
 
     if (_state != StreamingConnectionState::RECONNECTING) {
-      _state = StreamingConnectionState::RECONNECTING;
+      setState(StreamingConnectionState::RECONNECTING);
       _emitter.emit(EVENTS::FLAGS_STREAMING_DISCONNECTED);
     }
-    _pingStopRequested = true;
+    unscheduleTimers();
     scheduleReconnect();
   };
 
   _ws = new WebSocket();
   // Custom headers via the protocols param is not supported in cocos2d-x
   // WebSocket. Query params are used instead (set in buildWsUrl).
-  _ws->init(*delegate, wsUrl);
+  if (_config.features.streaming.ws.binaryFrames) {
+    // Offer the compact encoding; the server may still answer with text frames
+    std::vector<std::string> protocols = {StreamCodec::BINARY_PROTOCOL,
+                                          StreamCodec::TEXT_PROTOCOL};
+    _ws->init(*delegate, wsUrl, &protocols);
+  } else {
+    _ws->init(*delegate, wsUrl);
+  }
 }
 
 // ==================== Event Processing ====================
 
-void StreamingManager::processStreamingEvent(const std::string& eventType,
-                                             const std::string& eventData) {
+static long readRevision(const rapidjson::Value& body) {
+  if (!body.HasMember("globalRevision"))
+    return 0;
+  const auto& rev = body["globalRevision"];
+  if (rev.IsInt64())
+    return static_cast<long>(rev.GetInt64());
+  if (rev.IsInt())
+    return rev.GetInt();
+  if (rev.IsDouble())
+    return static_cast<long>(rev.GetDouble());
+  return 0;
+}
+
+void StreamingManager::handleSseEvent(const std::string& eventType, std::string& eventData) {
+  // SSE carries the event body as the data field; parse it once, in place
+  rapidjson::Document doc;
+  EventView view;
+  view.type = eventType.c_str();
+  if (!eventData.empty()) {
+    doc.ParseInsitu(&eventData[0]);
+    if (!doc.HasParseError() && doc.IsObject())
+      readEventBody(doc, view);
+  }
+  processStreamingEvent(view);
+}
+
+void StreamingManager::handleWsMessage(std::string& message, bool binary) {
+  if (binary) {
+    handleWsBinaryMessage(message);
+    return;
+  }
+
+  // One in-place parse of the frame; the data member is used as-is, not re-serialized
+  rapidjson::Document doc;
+  doc.ParseInsitu(&message[0]);
+  if (doc.HasParseError() || !doc.IsObject()) {
+    CCLOG("[Gatrix] Failed to parse WebSocket message");
+    return;
+  }
+  if (!doc.HasMember("type") || !doc["type"].IsString())
+    return;
+
+  EventView view;
+  view.type = doc["type"].GetString();
+  // Handle pong locally
+  if (std::strcmp(view.type, "pong") == 0)
+    return;
+  if (doc.HasMember("data") && doc["data"].IsObject())
+    readEventBody(doc["data"], view);
+  processStreamingEvent(view);
+}
+
+void StreamingManager::handleWsBinaryMessage(const std::string& message) {
+  BinaryStreamFrame frame;
+  if (!StreamCodec::decode(message.data(), message.size(), frame)) {
+    CCLOG("[Gatrix] Failed to decode binary WebSocket frame (%zu bytes)", message.size());
+    return;
+  }
+  if (frame.type == "pong")
+    return;
+
+  EventView view;
+  view.type = frame.type.c_str();
+  view.hasData = true;
+  view.globalRevision = static_cast<long>(frame.globalRevision);
+  view.changedKeys = std::move(frame.changedKeys);
+  view.hint.urgent = frame.urgent;
+  view.hint.spreadWindowMs = frame.spreadWindowMs;
+  view.resumed = frame.resumed;
+
+  // Only fields without a binary encoding (push payload) travel as JSON
+  rapidjson::Document doc;
+  if (frame.body) {
+    doc.Parse(frame.body, frame.bodyLength);
+    if (!doc.HasParseError() && doc.IsObject())
+      view.body = &doc;
+  }
+  processStreamingEvent(view);
+}
+
+void StreamingManager::readEventBody(const rapidjson::Value& body, EventView& view) {
+  view.hasData = true;
+  view.body = &body;
+  view.globalRevision = readRevision(body);
+  if (body.HasMember("changedKeys") && body["changedKeys"].IsArray()) {
+    const auto& keys = body["changedKeys"];
+    view.changedKeys.reserve(keys.Size());
+    for (const auto& key : keys.GetArray()) {
+      if (key.IsString())
+        view.changedKeys.emplace_back(key.GetString(), key.GetStringLength());
+    }
+  }
+  if (body.HasMember("spreadWindowMs") && body["spreadWindowMs"].IsInt())
+    view.hint.spreadWindowMs = body["spreadWindowMs"].GetInt();
+  if (body.HasMember("urgent") && body["urgent"].IsBool())
+    view.hint.urgent = body["urgent"].GetBool();
+  if (body.HasMember("resumed") && body["resumed"].IsBool())
+    view.resumed = body["resumed"].GetBool();
+}
+
+void StreamingManager::processStreamingEvent(const EventView& event) {
   _lastEventTime = std::chrono::system_clock::now();
   _eventCount++;
 
-  if (eventType == "connected") {
-    rapidjson::Document doc;
-    doc.Parse(eventData.c_str());
-
-    if (!doc.HasParseError() && doc.IsObject()) {
-      long serverRevision = 0;
-      if (doc.HasMember("globalRevision")) {
-        if (doc["globalRevision"].IsInt64()) {
-          serverRevision = doc["globalRevision"].GetInt64();
-        } else if (doc["globalRevision"].IsInt()) {
-          serverRevision = doc["globalRevision"].GetInt();
-        } else if (doc["globalRevision"].IsDouble()) {
-          serverRevision = static_cast<long>(doc["globalRevision"].GetDouble());
-        }
-      }
+  const char* eventType = event.type;
+  if (std::strcmp(eventType, "connected") == 0) {
+    if (event.hasData) {
+      long serverRevision = event.globalRevision;
 
-      CCLOG("[Gatrix] Streaming 'connected' event: globalRevision=%ld", serverRevision);
+      CCLOG("[Gatrix] Streaming 'connected' event: globalRevision=%ld, resumed=%d",
+            serverRevision, event.resumed ? 1 : 0);
 
       // Gap recovery: check if we missed any changes
-      if (serverRevision > _localGlobalRevision && _localGlobalRevision > 0) {
+      if (serverRevision > _localGlobalRevision && _localGlobalRevision > 0 && event.resumed) {
+        // The server still holds every revision after ours and replays them as
+        // ordinary flags_changed events, which advance the local revision
+        CCLOG("[Gatrix] Resuming from revision %ld (server=%ld)", _localGlobalRevision,
+              serverRevision);
+      } else if (serverRevision > _localGlobalRevision && _localGlobalRevision > 0) {
+        // Replay log truncated past our revision (or not kept): refetch everything
         CCLOG("[Gatrix] Gap detected: server=%ld, local=%ld. Triggering "
               "recovery.",
               serverRevision, _localGlobalRevision);
@@ -498,51 +533,39 @@ void StreamingManager::processStreamingEvent(const std::string& eventType,
         _localGlobalRevision = serverRevision;
       }
     }
-  } else if (eventType == "flags_changed") {
-    rapidjson::Document doc;
-    doc.Parse(eventData.c_str());
-
-    if (!doc.HasParseError() && doc.IsObject()) {
-      long serverRevision = 0;
-      if (doc.HasMember("globalRevision")) {
-        if (doc["globalRevision"].IsInt64()) {
-          serverRevision = doc["globalRevision"].GetInt64();
-        } else if (doc["globalRevision"].IsInt()) {
-          serverRevision = doc["globalRevision"].GetInt();
-        } else if (doc["globalRevision"].IsDouble()) {
-          serverRevision = static_cast<long>(doc["globalRevision"].GetDouble());
-        }
-      }
-
-      std::vector<std::string> changedKeys;
-      if (doc.HasMember("changedKeys") && doc["changedKeys"].IsArray()) {
-        for (auto& key : doc["changedKeys"].GetArray()) {
-          if (key.IsString()) {
-            changedKeys.push_back(key.GetString());
-          }
-        }
-      }
+  } else if (std::strcmp(eventType, "flags_changed") == 0) {
+    if (event.hasData) {
+      long serverRevision = event.globalRevision;
 
       CCLOG("[Gatrix] Streaming 'flags_changed': globalRevision=%ld, "
-            "changedKeys=%zu",
-            serverRevision, changedKeys.size());
+            "changedKeys=%zu, urgent=%d",
+            serverRevision, event.changedKeys.size(), event.hint.urgent ? 1 : 0);
 
       // Only process if server revision is ahead
       if (serverRevision > _localGlobalRevision) {
+        // Inline records are only sufficient on the next revision; after a gap, fetch instead
+        bool hasPayload = _config.features.streaming.pushPayload && event.body &&
+                          event.body->HasMember("flags") && (*event.body)["flags"].IsArray();
+        bool contiguous = _localGlobalRevision > 0 && serverRevision == _localGlobalRevision + 1;
         _localGlobalRevision = serverRevision;
         _emitter.emit(EVENTS::FLAGS_INVALIDATED);
+        if (hasPayload && _onPayload && _onPayload(*event.body, serverRevision, contiguous)) {
+          return;
+        }
         if (_onInvalidation) {
-          _onInvalidation(changedKeys);
+          InvalidationHint hint = event.hint;
+          hint.globalRevision = serverRevision;
+          _onInvalidation(event.changedKeys, hint);
         }
       } else {
         CCLOG("[Gatrix] Ignoring stale event: server=%ld <= local=%ld", serverRevision,
               _localGlobalRevision);
       }
     }
-  } else if (eventType == "heartbeat") {
+  } else if (std::strcmp(eventType, "heartbeat") == 0) {
     CCLOG("[Gatrix] Streaming heartbeat received");
   } else {
-    CCLOG("[Gatrix] Unknown streaming event: %s", eventType.c_str());
+    CCLOG("[Gatrix] Unknown streaming event: %s", eventType);
   }
 }
 
@@ -570,6 +593,14 @@ int StreamingManager::calculateReconnectDelay() {
   return exponentialDelay + jitter;
 }
 
+void StreamingManager::setState(StreamingConnectionState state) {
+  if (_state == state)
+    return;
+  _state = state;
+  if (_onStateChange)
+    _onStateChange(state);
+}
+
 void StreamingManager::scheduleReconnect() {
   if (_state == StreamingConnectionState::DISCONNECTED || _stopRequested) {
     return;
@@ -587,26 +618,28 @@ void StreamingManager::scheduleReconnect() {
 
   // Transition to degraded after several failed attempts
   if (_reconnectAttempt >= 5 && _state != StreamingConnectionState::DEGRADED) {
-    _state = StreamingConnectionState::DEGRADED;
+    setState(StreamingConnectionState::DEGRADED);
     CCLOG("[Gatrix] Streaming degraded: falling back to polling-only mode");
   }
 
-  // Use a thread to wait before reconnecting on main thread
-  if (_reconnectThread.joinable()) {
-    // Detach old reconnect thread (it may still be sleeping)
-    _reconnectThread.detach();
-  }
-  _reconnectThread = std::thread([this, delayMs]() {
-    std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
-    if (_stopRequested)
-      return;
+  // One-shot timer on the cocos thread; rescheduling the key replaces a pending one
+  std::weak_ptr<bool> alive = _alive;
+  Director::getInstance()->getScheduler()->schedule(
+      [this, alive](float) {
+        if (!alive.expired() && !_stopRequested &&
+            _state != StreamingConnectionState::DISCONNECTED) {
+          connect();
+        }
+      },
+      this, static_cast<float>(delayMs) / 1000.0f, 0, 0, false, "GatrixReconnect");
+}
 
-    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]() {
-      if (!_stopRequested && _state != StreamingConnectionState::DISCONNECTED) {
-        connect();
-      }
-    });
-  });
+void StreamingManager::unscheduleTimers() {
+  if (Director::getInstance()) {
+    auto scheduler = Director::getInstance()->getScheduler();
+    scheduler->unschedule("GatrixWsPing", this);
+    scheduler->unschedule("GatrixReconnect", this);
+  }
 }
 
 // ==================== Stats ====================
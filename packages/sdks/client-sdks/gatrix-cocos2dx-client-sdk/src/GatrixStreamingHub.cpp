@@ -0,0 +1,178 @@
+// GatrixStreamingHub.cpp - One streaming connection per environment, fanned out to clients
+
+#include "GatrixStreamingHub.h"
+#include <algorithm>
+#include <sstream>
+
+namespace gatrix {
+
+namespace {
+// Everything that makes two connections differ; instances agreeing on it share one
+std::string hubKey(const GatrixClientConfig& config, const ITransport* transport) {
+  const StreamingConfig& streaming = config.features.streaming;
+  std::ostringstream key;
+  key << config.apiUrl << '|' << config.apiToken << '|' << config.appName << '|'
+      << static_cast<int>(streaming.transport) << '|' << streaming.pushPayload << '|'
+      << streaming.sse.url << '|' << streaming.ws.url << '|' << streaming.ws.binaryFrames << '|'
+      << config.features.enableScheduledActivations << '|' << transport;
+  for (const auto& [name, value] : config.customHeaders) {
+    key << '|' << name << '=' << value;
+  }
+  // A declared-only interest set is part of the stream URL
+  if (!config.features.trackObservedKeys) {
+    for (const auto& interest : config.features.interestKeys)
+      key << "|interest=" << interest;
+  }
+  return key.str();
+}
+} // namespace
+
+std::shared_ptr<StreamingHub> StreamingHub::acquire(const GatrixClientConfig& config,
+                                                    std::shared_ptr<ITransport> transport,
+                                                    const std::string& connectionId) {
+  static std::map<std::string, std::weak_ptr<StreamingHub>> hubs;
+  std::string key = hubKey(config, transport.get());
+  std::shared_ptr<StreamingHub> hub = hubs[key].lock();
+  if (!hub) {
+    hub.reset(new StreamingHub(config, std::move(transport), connectionId));
+    hubs[key] = hub;
+  }
+  return hub;
+}
+
+StreamingHub::StreamingHub(const GatrixClientConfig& config,
+                           std::shared_ptr<ITransport> transport,
+                           const std::string& connectionId)
+    : _config(config), _transport(std::move(transport)) {
+  _manager.reset(new StreamingManager(_config, _emitter, *_transport));
+  _manager->setConnectionId(connectionId);
+
+  // Connection events go to every instance's listeners
+  _emitter.onAny([this](const std::string& event, const std::vector<std::string>& args) {
+    for (int id : subscriberIds()) {
+      auto it = _subscribers.find(id);
+      if (it != _subscribers.end() && it->second.emitter)
+        it->second.emitter->emit(event, args);
+    }
+  });
+
+  _manager->setStateCallback([this](StreamingConnectionState state) {
+    for (int id : subscriberIds()) {
+      auto it = _subscribers.find(id);
+      if (it != _subscribers.end() && it->second.onStateChange)
+        it->second.onStateChange(state);
+    }
+  });
+
+  // Accepted only if every instance applied it; the rest get the invalidation that follows
+  _manager->setPayloadCallback([this](const rapidjson::Value& doc, long globalRevision,
+                                      bool contiguous) {
+    _payloadApplied.clear();
+    bool allApplied = true;
+    for (int id : subscriberIds()) {
+      auto it = _subscribers.find(id);
+      if (it == _subscribers.end())
+        continue;
+      if (it->second.onPayload &&
+          it->second.onPayload(doc, globalRevision, contiguousFor(id, globalRevision, contiguous)))
+        _payloadApplied.push_back(id);
+      else
+        allApplied = false;
+    }
+    if (allApplied) {
+      _payloadApplied.clear();
+      advanceRevisions(globalRevision);
+    }
+    return allApplied;
+  });
+
+  _manager->setInvalidationCallback(
+      [this](const std::vector<std::string>& changedKeys,
+             const StreamingManager::InvalidationHint& hint) {
+        std::vector<int> applied;
+        applied.swap(_payloadApplied);
+        advanceRevisions(hint.globalRevision);
+        for (int id : subscriberIds()) {
+          if (std::find(applied.begin(), applied.end(), id) != applied.end())
+            continue;
+          auto it = _subscribers.find(id);
+          if (it != _subscribers.end() && it->second.onInvalidation)
+            it->second.onInvalidation(changedKeys, hint);
+        }
+      });
+
+  _manager->setFetchCallback([this]() {
+    // Gap recovery: everyone refetches up to the revision the stream jumped to
+    advanceRevisions(_manager->getGlobalRevision());
+    for (int id : subscriberIds()) {
+      auto it = _subscribers.find(id);
+      if (it != _subscribers.end() && it->second.onFetchRequest)
+        it->second.onFetchRequest();
+    }
+  });
+}
+
+StreamingHub::~StreamingHub() {
+  _manager->setStateCallback(nullptr);
+  _manager->disconnect();
+}
+
+int StreamingHub::subscribe(Subscriber subscriber) {
+  int id = _nextSubscriberId++;
+  bool first = _subscribers.empty();
+  StreamingManager::StateCallback onStateChange = subscriber.onStateChange;
+  StreamingManager::FetchCallback onFetchRequest = subscriber.onFetchRequest;
+  _subscribers[id] = std::move(subscriber);
+
+  // Past the connected event, revisions so far say nothing about this subscriber's flags
+  bool late = !first && _manager->getGlobalRevision() > 0;
+  _revisions[id] = late ? 0 : FOLLOWS_STREAM;
+
+  if (first) {
+    _manager->connect();
+  } else if (onStateChange) {
+    // Joined an existing connection: start from its current state
+    onStateChange(_manager->getState());
+  }
+  if (late && onFetchRequest) {
+    // Its own resync, in place of the gap check it missed (joins a fetch already in flight)
+    onFetchRequest();
+  }
+  return id;
+}
+
+void StreamingHub::unsubscribe(int id) {
+  if (_subscribers.erase(id) == 0)
+    return;
+  _revisions.erase(id);
+  _payloadApplied.erase(std::remove(_payloadApplied.begin(), _payloadApplied.end(), id),
+                        _payloadApplied.end());
+  if (_subscribers.empty())
+    _manager->disconnect();
+}
+
+std::vector<int> StreamingHub::subscriberIds() const {
+  std::vector<int> ids;
+  ids.reserve(_subscribers.size());
+  for (const auto& entry : _subscribers) {
+    ids.push_back(entry.first);
+  }
+  return ids;
+}
+
+bool StreamingHub::contiguousFor(int id, long globalRevision, bool streamContiguous) const {
+  auto it = _revisions.find(id);
+  if (it == _revisions.end() || it->second == FOLLOWS_STREAM)
+    return streamContiguous;
+  return streamContiguous && it->second > 0 && globalRevision == it->second + 1;
+}
+
+void StreamingHub::advanceRevisions(long globalRevision) {
+  if (globalRevision <= 0)
+    return;
+  for (auto& entry : _revisions) {
+    entry.second = globalRevision;
+  }
+}
+
+} // namespace gatrix
@@ -0,0 +1,69 @@
+// GatrixTransport.cpp - ITransport adapter for cocos2d::network::HttpClient
+
+#include "GatrixTransport.h"
+#include "GatrixCurlTransport.h"
+#include "network/HttpClient.h"
+#include <map>
+
+using namespace cocos2d::network;
+
+namespace gatrix {
+
+std::shared_ptr<ITransport> ITransport::shared(const HttpConfig& config) {
+  // HttpClient is a process singleton already; curl backends pool per configuration
+  std::string key = "httpclient";
+  if (config.backend == HttpBackend::CURL_MULTI) {
+    key = "curl|" + std::to_string(config.connectTimeoutMs) + "|" +
+          std::to_string(config.fetchTimeoutMs) + "|" +
+          std::to_string(config.partialFetchTimeoutMs) + "|" + (config.http2 ? "h2" : "h1") +
+          "|" + std::to_string(config.maxHostConnections);
+  }
+
+  static std::map<std::string, std::weak_ptr<ITransport>> transports;
+  std::shared_ptr<ITransport> transport = transports[key].lock();
+  if (!transport) {
+    if (config.backend == HttpBackend::CURL_MULTI)
+      transport = std::make_shared<CurlMultiTransport>(config);
+    else
+      transport = std::make_shared<HttpClientTransport>();
+    transports[key] = transport;
+  }
+  return transport;
+}
+
+void HttpClientTransport::send(const TransportRequest& request, ResponseCallback callback) {
+  auto* httpRequest = new HttpRequest();
+  httpRequest->setUrl(request.url.c_str());
+  httpRequest->setRequestType(request.post ? HttpRequest::Type::POST : HttpRequest::Type::GET);
+  httpRequest->setHeaders(request.headers);
+  if (!request.body.empty())
+    httpRequest->setRequestData(request.body.data(), request.body.size());
+
+  // HttpClient calls back on the cocos thread
+  httpRequest->setResponseCallback([callback](HttpClient* /*client*/, HttpResponse* response) {
+    TransportResponse result;
+    if (!response) {
+      result.error = "No response";
+      callback(result);
+      return;
+    }
+    result.statusCode = static_cast<int>(response->getResponseCode());
+    if (auto* headers = response->getResponseHeader())
+      result.headers.assign(headers->begin(), headers->end());
+    if (auto* data = response->getResponseData())
+      result.body.swap(*data);
+    if (!response->isSucceed() && result.statusCode <= 0) {
+      result.statusCode = 0;
+      result.error = response->getErrorBuffer();
+    }
+    callback(result);
+  });
+
+  if (request.immediate)
+    HttpClient::getInstance()->sendImmediate(httpRequest);
+  else
+    HttpClient::getInstance()->send(httpRequest);
+  httpRequest->release();
+}
+
+} // namespace gatrix
@@ -1,9 +1,17 @@
-// Stub cocos2d.h for compilation testing only
+// Stub cocos2d.h for building and testing the SDK without Cocos2d-x
+//
+// The scheduler is functional: functions handed to performFunctionInCocosThread
+// and scheduled timers run when the test calls update(dt) on its "cocos thread",
+// with time advanced only by dt, so timer-driven behaviour is deterministic.
 #ifndef COCOS2D_H__
 #define COCOS2D_H__
 
 #include <functional>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #define CCLOG(...)
 #define CC_REPEAT_FOREVER (unsigned int)(-1)
@@ -12,10 +20,85 @@ namespace cocos2d {
 
 class Scheduler {
 public:
-  template <typename T>
-  void schedule(T callback, void *target, float interval, unsigned int repeat,
-                float delay, bool paused, const std::string &key) {}
-  void unschedule(const std::string &key, void *target) {}
+  /** cocos semantics: fires after delay (or interval when delay is 0), repeat + 1 times */
+  void schedule(std::function<void(float)> callback, void *target, float interval,
+                unsigned int repeat, float delay, bool paused, const std::string &key) {
+    (void)paused;
+    Timer timer;
+    timer.callback = std::move(callback);
+    timer.interval = interval;
+    timer.remaining = repeat;
+    timer.due = _now + (delay > 0 ? delay : interval);
+    _timers[std::make_pair(target, key)] = std::move(timer);
+  }
+
+  void unschedule(const std::string &key, void *target) {
+    _timers.erase(std::make_pair(target, key));
+  }
+
+  bool isScheduled(const std::string &key, void *target) const {
+    return _timers.count(std::make_pair(target, key)) != 0;
+  }
+
+  /** Thread-safe, like the real one */
+  void performFunctionInCocosThread(std::function<void()> function) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    _queue.push_back(std::move(function));
+  }
+
+  /** One frame: queued functions first, then every timer that is due by now + dt */
+  void update(float dt) {
+    std::vector<std::function<void()>> queue;
+    {
+      std::lock_guard<std::mutex> lock(_queueMutex);
+      queue.swap(_queue);
+    }
+    for (auto &function : queue)
+      function();
+
+    _now += dt;
+    // Timers due now fire once this frame; the callbacks may (un)schedule any timer
+    std::vector<std::pair<void *, std::string>> due;
+    for (auto &entry : _timers) {
+      if (entry.second.due <= _now)
+        due.push_back(entry.first);
+    }
+    for (auto &id : due) {
+      auto it = _timers.find(id);
+      if (it == _timers.end() || it->second.due > _now)
+        continue;
+      auto callback = it->second.callback;
+      if (it->second.remaining == 0) {
+        _timers.erase(it);
+      } else {
+        if (it->second.remaining != CC_REPEAT_FOREVER)
+          it->second.remaining--;
+        it->second.due = _now + it->second.interval;
+      }
+      callback(dt);
+    }
+  }
+
+  /** Functions queued from other threads that have not run yet */
+  size_t pendingFunctions() {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    return _queue.size();
+  }
+
+  float now() const { return _now; }
+
+private:
+  struct Timer {
+    std::function<void(float)> callback;
+    float interval = 0;
+    unsigned int remaining = 0;
+    float due = 0;
+  };
+
+  std::map<std::pair<void *, std::string>, Timer> _timers;
+  float _now = 0;
+  std::mutex _queueMutex;
+  std::vector<std::function<void()>> _queue;
 };
 
 class Director {
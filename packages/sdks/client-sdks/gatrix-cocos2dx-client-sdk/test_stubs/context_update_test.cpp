@@ -0,0 +1,177 @@
+// context_update_test.cpp - Staged context changes cost one fetch per frame or transaction
+//
+// FeaturesClient runs against TestServer (test_server.h), which records every
+// request and answers when the test says so. The test thread is the cocos
+// thread: a frame is one update() of the stub scheduler.
+#include "GatrixFeaturesClient.h"
+#include "cocos2d.h"
+#include "gatrix_test.h"
+#include "test_server.h"
+
+using namespace gatrix;
+using gatrix::test::TestServer;
+
+namespace {
+
+GatrixClientConfig makeConfig() {
+  GatrixClientConfig config;
+  config.apiUrl = "https://edge.test/api/v1";
+  config.apiToken = "token";
+  config.appName = "context-update-test";
+  return config;
+}
+
+void frame() {
+  cocos2d::Director::getInstance()->getScheduler()->update(1.0f / 60);
+}
+
+bool contains(const std::string& haystack, const std::string& needle) {
+  return haystack.find(needle) != std::string::npos;
+}
+
+/** A started client whose initial fetch has been answered */
+struct Fixture {
+  GatrixClientConfig config = makeConfig(); // the client keeps a reference, as GatrixClient's
+  GatrixEventEmitter emitter;
+  TestServer server;
+  FeaturesClient client;
+
+  Fixture() : client(config, emitter) {
+    client.setTransport(&server);
+    client.start();
+    server.respond();
+  }
+};
+
+} // namespace
+
+TEST(same_frame_field_changes_fetch_once) {
+  Fixture f;
+  CHECK_EQ(f.server.fetches(), 1);
+
+  const int n = 4;
+  f.client.setContextField("userId", "user-1");
+  f.client.setContextField("sessionId", "session-1");
+  f.client.setContextField("level", "12");
+  f.client.setContextField("country", "KR");
+  // Staged until the next frame
+  CHECK_EQ(f.server.fetches(), 1);
+
+  frame();
+  CHECK_EQ(f.server.fetches(), 2);
+  GatrixSdkStats stats = f.client.getStats();
+  CHECK_EQ(stats.contextCoalescedCount, n - 1);
+  CHECK_EQ(stats.contextChangeCount, 1);
+  // One request body carries every change
+  const std::string& body = f.server.last().body;
+  CHECK(contains(body, "\"userId\":\"user-1\""));
+  CHECK(contains(body, "\"sessionId\":\"session-1\""));
+  CHECK(contains(body, "\"level\":\"12\""));
+  CHECK(contains(body, "\"country\":\"KR\""));
+
+  f.server.respond();
+  frame();
+  frame();
+  CHECK_EQ(f.server.fetches(), 2);
+}
+
+TEST(transaction_changes_fetch_once) {
+  Fixture f;
+  int completions = 0;
+  auto onComplete = [&completions](bool success, const std::string&) {
+    if (success)
+      completions++;
+  };
+
+  GatrixContext context;
+  context.userId = "user-2";
+  context.properties["tier"] = "gold";
+
+  // Five changes, one of them in a nested transaction, across several frames
+  const int n = 5;
+  f.client.beginContextUpdate();
+  f.client.setContextField("level", "3");
+  f.client.setContextField("country", "JP");
+  frame();
+  f.client.removeContextField("country");
+  f.client.beginContextUpdate();
+  f.client.updateContext(context, onComplete);
+  f.client.commitContextUpdate();
+  frame();
+  f.client.setContextField("level", "4");
+  frame();
+  CHECK_EQ(f.server.fetches(), 1);
+
+  f.client.commitContextUpdate(onComplete);
+  CHECK_EQ(f.server.fetches(), 2);
+  GatrixSdkStats stats = f.client.getStats();
+  CHECK_EQ(stats.contextCoalescedCount, n - 1);
+  CHECK_EQ(stats.contextChangeCount, 1);
+  const std::string& body = f.server.last().body;
+  CHECK(contains(body, "\"userId\":\"user-2\""));
+  CHECK(contains(body, "\"tier\":\"gold\""));
+  CHECK(contains(body, "\"level\":\"4\""));
+  CHECK(!contains(body, "country"));
+
+  // Both waiters complete with the one fetch
+  CHECK_EQ(completions, 0);
+  f.server.respond();
+  CHECK_EQ(completions, 2);
+  frame();
+  CHECK_EQ(f.server.fetches(), 2);
+}
+
+TEST(context_updated_twice_in_a_transaction_merges) {
+  Fixture f;
+  GatrixContext identity;
+  identity.userId = "user-4";
+  identity.sessionId = "session-4";
+  identity.properties["tier"] = "gold";
+  GatrixContext progress;
+  progress.properties["level"] = "9";
+  progress.properties["tier"] = "platinum";
+
+  // The second update sets neither userId nor sessionId: the staged ones stay
+  f.client.beginContextUpdate();
+  f.client.setContextField("country", "KR");
+  f.client.updateContext(identity);
+  f.client.updateContext(progress);
+  f.client.commitContextUpdate();
+  CHECK_EQ(f.server.fetches(), 2);
+  GatrixContext applied = f.client.getContext();
+  CHECK_EQ(applied.userId, std::string("user-4"));
+  CHECK_EQ(applied.sessionId, std::string("session-4"));
+  CHECK_EQ(applied.properties["country"], std::string("KR"));
+  CHECK_EQ(applied.properties["level"], std::string("9"));
+  CHECK_EQ(applied.properties["tier"], std::string("platinum"));
+  CHECK(contains(f.server.last().body, "\"userId\":\"user-4\""));
+}
+
+TEST(update_context_joins_fields_staged_this_frame) {
+  Fixture f;
+  GatrixContext context;
+  context.userId = "user-3";
+
+  f.client.setContextField("level", "7");
+  f.client.setContextField("country", "US");
+  f.client.updateContext(context);
+  // Applied at once, with the fields staged before it
+  CHECK_EQ(f.server.fetches(), 2);
+  CHECK_EQ(f.client.getStats().contextCoalescedCount, 2);
+  CHECK(contains(f.server.last().body, "\"level\":\"7\""));
+
+  f.server.respond();
+  frame();
+  CHECK_EQ(f.server.fetches(), 2);
+}
+
+TEST(unchanged_staged_context_does_not_fetch) {
+  Fixture f;
+  f.client.setContextField("level", "1");
+  f.client.removeContextField("level");
+  frame();
+  CHECK_EQ(f.server.fetches(), 1);
+  CHECK_EQ(f.client.getStats().contextChangeCount, 0);
+}
+
+GATRIX_TEST_MAIN
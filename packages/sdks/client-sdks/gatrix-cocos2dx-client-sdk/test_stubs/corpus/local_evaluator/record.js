@@ -0,0 +1,170 @@
+// record.js - Records expected.json from the server evaluator (packages/evaluator)
+//
+// Usage (Node 22.13+, from this directory; no npm install needed):
+//   node record.js > expected.json
+//
+// Runs the TypeScript sources of packages/evaluator as they are: each context
+// in cases.json is posted through EvaluationUtils.extractFromRequest exactly
+// as FeaturesClient::buildEvalRequestBody sends it, evaluated with
+// FeatureFlagEvaluator.evaluate and shaped with EvaluationUtils.formatResult,
+// like the /client/features/eval route does. local_evaluator_test.cpp checks
+// LocalEvaluator against the result.
+//
+// The evaluator's only npm dependency, murmurhash, is replaced by MurmurHash3
+// x86_32 over the key's UTF-8 bytes (what murmurhash@2 computes); the
+// "murmur3" probes include the published reference vectors. All bucketing
+// keys in cases.json are ASCII.
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const Module = require('module');
+
+const packagesDir = path.resolve(__dirname, '../../../../../..');
+const evaluatorDir = path.join(packagesDir, 'evaluator/src');
+const sharedFeatures = path.join(packagesDir, 'shared/src/features/index.ts');
+
+function murmur3(key, seed = 0) {
+  const data = Buffer.from(String(key), 'utf8');
+  const c1 = 0xcc9e2d51;
+  const c2 = 0x1b873593;
+  let h = seed >>> 0;
+  const blocks = data.length >> 2;
+  for (let i = 0; i < blocks; i++) {
+    let k = data.readUInt32LE(i * 4);
+    k = Math.imul(k, c1);
+    k = (k << 15) | (k >>> 17);
+    k = Math.imul(k, c2);
+    h ^= k;
+    h = (h << 13) | (h >>> 19);
+    h = (Math.imul(h, 5) + 0xe6546b64) | 0;
+  }
+  let k = 0;
+  const tail = blocks * 4;
+  switch (data.length & 3) {
+    case 3:
+      k ^= data[tail + 2] << 16;
+    // falls through
+    case 2:
+      k ^= data[tail + 1] << 8;
+    // falls through
+    case 1:
+      k ^= data[tail];
+      k = Math.imul(k, c1);
+      k = (k << 15) | (k >>> 17);
+      k = Math.imul(k, c2);
+      h ^= k;
+  }
+  h ^= data.length;
+  h ^= h >>> 16;
+  h = Math.imul(h, 0x85ebca6b);
+  h ^= h >>> 13;
+  h = Math.imul(h, 0xc2b2ae35);
+  h ^= h >>> 16;
+  return h >>> 0;
+}
+
+// --- Load the TypeScript sources without a build step -----------------------
+
+// Type annotations are stripped by Node; module syntax is rewritten to CommonJS
+function toCommonJs(source) {
+  const exported = [];
+  source = source
+    .replace(/^import\s+(\w+)\s+from\s+('[^']+');/gm, 'const $1 = require($2);')
+    .replace(/^import\s+\{([^}]*)\}\s+from\s+('[^']+');/gm,
+      (m, names, mod) => `const {${names.replace(/\btype\s+/g, '')}} = require(${mod});`)
+    .replace(/^export\s+\*\s+from\s+('[^']+');/gm, 'Object.assign(exports, require($1));')
+    .replace(/^export\s+\{([^}]*)\}\s+from\s+('[^']+');/gm, (m, names, mod) =>
+      names.split(',').map((n) => n.trim()).filter(Boolean).map((n) => {
+        const [local, alias] = n.split(/\s+as\s+/);
+        return `exports.${alias || local} = require(${mod}).${local};`;
+      }).join('\n'))
+    .replace(/^export\s+(async\s+)?(class|function|const|let|var)\s+(\w+)/gm,
+      (m, async, keyword, name) => {
+        exported.push(name);
+        return `${async || ''}${keyword} ${name}`;
+      });
+  return source + '\n' + exported.map((n) => `exports.${n} = ${n};`).join('\n');
+}
+
+require.extensions['.ts'] = (module, filename) => {
+  const source = Module.stripTypeScriptTypes(fs.readFileSync(filename, 'utf8'), {
+    mode: 'transform',
+  });
+  module._compile(toCommonJs(source), filename);
+};
+
+const resolveFilename = Module._resolveFilename;
+Module._resolveFilename = function (request, parent, ...rest) {
+  if (request === '@gatrix/shared') return sharedFeatures;
+  if (request === 'murmurhash') return 'murmurhash-shim';
+  if (request.startsWith('.') && parent && parent.filename.endsWith('.ts')) {
+    const base = path.resolve(path.dirname(parent.filename), request);
+    for (const candidate of [base + '.ts', path.join(base, 'index.ts')]) {
+      if (fs.existsSync(candidate)) return candidate;
+    }
+  }
+  return resolveFilename.call(this, request, parent, ...rest);
+};
+const shim = new Module('murmurhash-shim');
+shim.exports = { v3: murmur3 };
+shim.exports.default = shim.exports;
+shim.loaded = true;
+require.cache['murmurhash-shim'] = shim;
+
+const { FeatureFlagEvaluator, EvaluationUtils, normalizedStrategyValue } = require(
+  path.join(evaluatorDir, 'index.ts')
+);
+
+// --- Record -----------------------------------------------------------------
+
+const cases = JSON.parse(fs.readFileSync(path.join(__dirname, 'cases.json'), 'utf8'));
+const definitions = cases.definitions.data || cases.definitions;
+const segments = new Map((definitions.segments || []).map((s) => [s.name, s]));
+
+// Rollouts without a usable stickiness value fall back to Math.random() on the
+// server; such results are recorded as "random" and only their flag state is compared
+const RUNS = 8;
+
+const recorded = [];
+for (const context of cases.contexts) {
+  const posted = {};
+  if (context.userId) posted.userId = context.userId;
+  if (context.sessionId) posted.sessionId = context.sessionId;
+  Object.assign(posted, context.properties || {});
+  const request = { method: 'POST', body: { context: posted }, headers: {}, query: {} };
+
+  const flags = [];
+  for (const flag of definitions.flags) {
+    const runs = [];
+    for (let i = 0; i < RUNS; i++) {
+      const { context: evalContext } = EvaluationUtils.extractFromRequest(request);
+      const result = FeatureFlagEvaluator.evaluate(flag, evalContext, segments);
+      runs.push(EvaluationUtils.formatResult(flag.name, result, flag));
+    }
+    const first = JSON.stringify(runs[0]);
+    const record = runs[0];
+    if (runs.some((r) => JSON.stringify(r) !== first)) record.random = true;
+    flags.push(record);
+  }
+  recorded.push({ context, flags });
+}
+
+const probes = ['', 'u1', 'U42', 'session-7', 'f-num:u0', 'f-var-variant:s3335',
+  'The quick brown fox jumps over the lazy dog'];
+const murmur = probes.map((key) => ({ key, hash: murmur3(key) }));
+const buckets = [];
+for (const groupId of ['', 'f-num', 'g', 's']) {
+  for (const id of ['u0', 'U1', 'x2', 's87858', 'user-123']) {
+    buckets.push({ groupId, id, value: normalizedStrategyValue(id, groupId) });
+  }
+}
+
+// One record per line keeps diffs of re-recordings readable
+const lines = (items) => items.map((item) => '  ' + JSON.stringify(item)).join(',\n');
+const casesOut = recorded.map(({ context, flags }) =>
+  ` {"context": ${JSON.stringify(context)}, "flags": [\n${lines(flags)}\n ]}`);
+process.stdout.write(
+  `{"cases": [\n${casesOut.join(',\n')}\n],\n` +
+    `"murmur3": [\n${lines(murmur)}\n],\n"buckets": [\n${lines(buckets)}\n]}\n`
+);
@@ -0,0 +1,187 @@
+// delta_sync_test.cpp - since= fetches patch the snapshot and cost a fraction of a full one
+//
+// DeltaEdge holds the server's flag set and a bounded revision log, and renders
+// the response the edge would give a fetch: a delta when the log reaches back
+// to the requested revision, the full set otherwise. Responses travel through
+// TestServer (test_server.h), which counts the bytes it answers with.
+#include "GatrixFeaturesClient.h"
+#include "cocos2d.h"
+#include "gatrix_test.h"
+#include "test_server.h"
+
+#include <map>
+#include <set>
+
+using namespace gatrix;
+using gatrix::test::TestServer;
+
+namespace {
+
+class DeltaEdge {
+public:
+  explicit DeltaEdge(size_t logCapacity) : _logCapacity(logCapacity) {}
+
+  void set(const std::string& name, bool enabled) { change(name, &enabled); }
+  void remove(const std::string& name) { change(name, nullptr); }
+
+  /** The response to a fetch of url: a delta after since=, if the log still covers it */
+  std::string answer(const std::string& url) const {
+    long since = 0;
+    size_t at = url.find("since=");
+    if (at != std::string::npos)
+      since = std::stol(url.substr(at + 6));
+    bool covered = since > 0 && since <= _revision &&
+                   (_log.empty() || _log.front().first <= since + 1);
+    if (!covered)
+      return full();
+
+    std::set<std::string> touched;
+    for (const auto& entry : _log) {
+      if (entry.first > since)
+        touched.insert(entry.second);
+    }
+    std::string upserts, removed;
+    for (const auto& name : touched) {
+      auto it = _flags.find(name);
+      if (it != _flags.end())
+        upserts += (upserts.empty() ? "" : ",") + record(it->first, it->second);
+      else
+        removed += (removed.empty() ? "\"" : ",\"") + name + "\"";
+    }
+    return "{\"success\":true,\"data\":{\"delta\":true,\"revision\":" +
+           std::to_string(_revision) + ",\"flags\":[" + upserts + "],\"removed\":[" + removed +
+           "]}}";
+  }
+
+  /** The full snapshot at the current revision */
+  std::string full() const {
+    std::string flags;
+    for (const auto& entry : _flags)
+      flags += (flags.empty() ? "" : ",") + record(entry.first, entry.second);
+    return "{\"success\":true,\"data\":{\"revision\":" + std::to_string(_revision) +
+           ",\"flags\":[" + flags + "]}}";
+  }
+
+  const std::map<std::string, bool>& flags() const { return _flags; }
+
+private:
+  void change(const std::string& name, const bool* enabled) {
+    if (enabled)
+      _flags[name] = *enabled;
+    else
+      _flags.erase(name);
+    _log.emplace_back(++_revision, name);
+    if (_log.size() > _logCapacity)
+      _log.erase(_log.begin());
+  }
+
+  static std::string record(const std::string& name, bool enabled) {
+    return "{\"name\":\"" + name + "\",\"enabled\":" + (enabled ? "true" : "false") +
+           ",\"version\":1,\"reason\":\"evaluated\"}";
+  }
+
+  size_t _logCapacity;
+  long _revision = 0;
+  std::map<std::string, bool> _flags;
+  std::vector<std::pair<long, std::string>> _log;
+};
+
+std::string flagName(int i) {
+  char name[16];
+  snprintf(name, sizeof(name), "flag-%03d", i);
+  return name;
+}
+
+/** The client's realtime flags, as name -> enabled */
+std::map<std::string, bool> state(const FeaturesClient& client) {
+  std::map<std::string, bool> out;
+  for (const auto& flag : client.getAllFlags())
+    out[flag.name] = flag.enabled;
+  return out;
+}
+
+bool contains(const std::string& haystack, const std::string& needle) {
+  return haystack.find(needle) != std::string::npos;
+}
+
+GatrixClientConfig makeConfig() {
+  GatrixClientConfig config;
+  config.apiUrl = "https://edge.test/api/v1";
+  config.apiToken = "token";
+  config.appName = "delta-sync-test";
+  config.features.explicitSyncMode = false; // reads see merges as they are applied
+  config.features.enableDeltaSync = true;
+  return config;
+}
+
+/** Started with delta sync against an edge holding 200 flags, the initial fetch answered */
+struct Fixture {
+  GatrixClientConfig config;
+  GatrixEventEmitter emitter;
+  TestServer server;
+  DeltaEdge edge;
+  FeaturesClient client;
+
+  explicit Fixture(size_t logCapacity)
+      : config(makeConfig()), edge(logCapacity), client(config, emitter) {
+    for (int i = 0; i < 200; i++)
+      edge.set(flagName(i), i % 3 == 0);
+    client.setTransport(&server);
+    client.start();
+    fetch();
+  }
+
+  /** Answers the fetch in flight the way the edge would */
+  void fetch() { server.respond(edge.answer(server.last().url)); }
+};
+
+} // namespace
+
+TEST(delta_fetch_patches_the_snapshot) {
+  Fixture f(100);
+  CHECK(!contains(f.server.last().url, "since="));
+  CHECK(state(f.client) == f.edge.flags());
+  CHECK_EQ(f.client.getStats().syncRevision, 200LL);
+
+  // One changed, one removed, one added
+  f.edge.set(flagName(1), true);
+  f.edge.remove(flagName(2));
+  f.edge.set("flag-new", true);
+  long long before = f.server.bytesServed();
+  f.client.fetchFlags();
+  CHECK(contains(f.server.last().url, "since=200"));
+  f.fetch();
+  long long deltaBytes = f.server.bytesServed() - before;
+
+  // The merged state is the edge's, for a small fraction of the full response
+  CHECK(state(f.client) == f.edge.flags());
+  CHECK_EQ(f.client.getStats().deltaFetchCount, 1);
+  CHECK_EQ(f.client.getStats().deltaFallbackCount, 0);
+  CHECK_EQ(f.client.getStats().syncRevision, 203LL);
+  long long fullBytes = static_cast<long long>(f.edge.full().size());
+  CHECK(deltaBytes * 20 < fullBytes);
+  printf("  delta %lld bytes vs full %lld bytes: %.1f%% saved\n", deltaBytes, fullBytes,
+         100.0 * static_cast<double>(fullBytes - deltaBytes) / static_cast<double>(fullBytes));
+
+  // The next fetch starts after the applied delta
+  f.client.fetchFlags();
+  CHECK(contains(f.server.last().url, "since=203"));
+}
+
+TEST(truncated_log_answers_with_the_full_set) {
+  Fixture f(4);
+
+  // Five changes: the log keeps only the last four, so since=200 cannot be served as a delta
+  for (int i = 0; i < 5; i++)
+    f.edge.set(flagName(i), i % 3 != 0);
+  f.client.fetchFlags();
+  CHECK(contains(f.server.last().url, "since=200"));
+  f.fetch();
+
+  CHECK(state(f.client) == f.edge.flags());
+  CHECK_EQ(f.client.getStats().deltaFetchCount, 0);
+  CHECK_EQ(f.client.getStats().deltaFallbackCount, 1);
+  CHECK_EQ(f.client.getStats().syncRevision, 205LL);
+}
+
+GATRIX_TEST_MAIN
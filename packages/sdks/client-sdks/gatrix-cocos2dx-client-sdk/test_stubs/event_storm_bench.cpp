@@ -0,0 +1,171 @@
+// event_storm_bench.cpp - StreamingManager cost per WebSocket message in a 1k msg/s storm
+//
+// Usage: event_storm_bench [seconds=5] [rate=1000]
+//
+// Plays the server through the stub WebSocket: every millisecond the frames
+// due at `rate` messages per second are delivered to the delegate and the
+// cocos scheduler runs once, so each frame takes the path it takes in a game.
+// Frames are flags_changed events with three changed keys and their inline
+// records (streaming.pushPayload). Only the time spent inside the delegate and
+// the scheduler is counted, not the idle part of each millisecond.
+//
+// For comparison the parse stage alone is timed both ways: the current single
+// in-place parse of the frame, and the former parse, re-serialize of `data` and
+// second parse. Exits non-zero when a frame is lost. Recorded results live in
+// BENCHMARKS.md.
+#include "GatrixStreaming.h"
+#include "cocos2d.h"
+#include "json/stringbuffer.h"
+#include "json/writer.h"
+#include "network/WebSocket.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gatrix;
+using cocos2d::network::WebSocket;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** The storm arrives over the WebSocket; nothing is fetched */
+class NoTransport : public ITransport {
+public:
+  const char* name() const override { return "none"; }
+  void send(const TransportRequest&, ResponseCallback callback) override {
+    TransportResponse response;
+    response.error = "not served";
+    callback(response);
+  }
+};
+
+std::string frameFor(long revision) {
+  std::string rev = std::to_string(revision);
+  std::string keys[] = {"checkout-v2", "banner-spring-sale", "price-test-" + rev};
+  std::string frame = "{\"type\":\"flags_changed\",\"data\":{\"environmentId\":\"env-production\","
+                      "\"globalRevision\":" +
+                      rev + ",\"changedKeys\":[";
+  std::string records;
+  for (int i = 0; i < 3; i++) {
+    frame += std::string(i ? "," : "") + "\"" + keys[i] + "\"";
+    records += std::string(i ? "," : "") + "{\"name\":\"" + keys[i] +
+               "\",\"enabled\":true,\"version\":" + rev +
+               ",\"variant\":{\"name\":\"on\",\"enabled\":true}}";
+  }
+  return frame + "],\"timestamp\":1760000000" + rev + ",\"flags\":[" + records + "]}}";
+}
+
+void deliver(WebSocket* ws, std::string frame) {
+  WebSocket::Data data;
+  data.bytes = &frame[0];
+  data.len = static_cast<ssize_t>(frame.size());
+  ws->getDelegate()->onMessage(ws, data);
+}
+
+/** Mean microseconds per frame of parse(frame) over all frames, best of 5 */
+template <typename Parse>
+double parseCost(const std::vector<std::string>& frames, Parse parse) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    long fields = 0;
+    auto start = Clock::now();
+    for (const auto& frame : frames)
+      fields += parse(frame);
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    double perFrame = elapsed.count() / frames.size();
+    if (r == 0 || perFrame < best)
+      best = perFrame;
+    if (fields == 0)
+      std::exit(1); // keeps the parse from being optimized away
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int seconds = argc > 1 ? std::atoi(argv[1]) : 5;
+  int rate = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+  GatrixClientConfig config;
+  config.apiUrl = "https://edge.test/api/v1";
+  config.apiToken = "token";
+  config.appName = "storm-bench";
+  config.features.streaming.enabled = true;
+  config.features.streaming.transport = StreamingTransport::WEBSOCKET;
+  config.features.streaming.pushPayload = true;
+  GatrixEventEmitter emitter;
+  NoTransport unused;
+  StreamingManager manager(config, emitter, unused);
+  long applied = 0;
+  manager.setPayloadCallback([&applied](const rapidjson::Value& body, long, bool) {
+    applied += body["flags"].Size() > 0 ? 1 : 0;
+    return true;
+  });
+
+  auto scheduler = cocos2d::Director::getInstance()->getScheduler();
+  manager.connect();
+  WebSocket* ws = WebSocket::latest();
+  ws->getDelegate()->onOpen(ws);
+  deliver(ws, "{\"type\":\"connected\",\"data\":{\"globalRevision\":1}}");
+  scheduler->update(0.0f);
+
+  // Frames are built ahead of time; the storm only delivers them
+  const long total = static_cast<long>(seconds) * rate;
+  std::vector<std::string> frames;
+  frames.reserve(total);
+  for (long i = 0; i < total; i++)
+    frames.push_back(frameFor(2 + i));
+
+  std::chrono::duration<double, std::micro> busy(0);
+  auto start = Clock::now();
+  long sent = 0;
+  for (long tick = 1; sent < total; tick++) {
+    auto tickStart = Clock::now();
+    for (long due = tick * rate / 1000; sent < due && sent < total; sent++)
+      deliver(ws, frames[sent]);
+    scheduler->update(0.001f);
+    busy += Clock::now() - tickStart;
+    std::this_thread::sleep_until(start + std::chrono::milliseconds(tick));
+  }
+  scheduler->update(0.0f);
+  std::chrono::duration<double> wall = Clock::now() - start;
+  manager.disconnect();
+
+  std::printf("storm: %ld frames of ~%zu B at %d msg/s over %.1f s\n", sent, frames[0].size(),
+              rate, wall.count());
+  std::printf("end to end: %8.2f us/msg  (%.2f%% of one core)\n", busy.count() / sent,
+              busy.count() / 1e4 / wall.count());
+
+  double single = parseCost(frames, [](const std::string& frame) {
+    std::string buffer = frame; // the delegate's copy, parsed in place
+    rapidjson::Document doc;
+    doc.ParseInsitu(&buffer[0]);
+    return doc["data"]["changedKeys"].Size();
+  });
+  double twice = parseCost(frames, [](const std::string& frame) {
+    rapidjson::Document doc;
+    doc.Parse(frame.c_str());
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+    doc["data"].Accept(writer);
+    std::string eventData = sb.GetString();
+    rapidjson::Document data;
+    data.Parse(eventData.c_str());
+    return data["changedKeys"].Size();
+  });
+  std::printf("parse stage: %8.2f us/msg single in-place parse, %8.2f us/msg parse + "
+              "serialize + parse\n",
+              single, twice);
+
+  if (applied != sent) {
+    std::fprintf(stderr, "lost frames: %ld sent, %ld applied\n", sent, applied);
+    return 1;
+  }
+  return 0;
+}
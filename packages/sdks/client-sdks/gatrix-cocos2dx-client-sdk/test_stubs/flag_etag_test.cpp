@@ -0,0 +1,135 @@
+// flag_etag_test.cpp - The locally maintained ETag equals the one the edge sends
+//
+// Expected values come from EvaluationUtils.generateETag over the edge's
+// localeCompare-sorted flag list (packages/evaluator, run under node), so a
+// merge that yields the server's set also yields the server's validator.
+#include "GatrixFlagHash.h"
+#include "GatrixTypes.h"
+#include "gatrix_test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+using namespace gatrix;
+
+namespace {
+
+EvaluatedFlag flag(const std::string& name, int version, bool enabled,
+                   const std::string& variant = "", bool variantEnabled = false) {
+  EvaluatedFlag f;
+  f.name = name;
+  f.version = version;
+  f.enabled = enabled;
+  f.variant.name = variant;
+  f.variant.enabled = variantEnabled;
+  return f;
+}
+
+std::map<std::string, EvaluatedFlag> fixture() {
+  std::map<std::string, EvaluatedFlag> flags;
+  for (const auto& f : {flag("b-flag", 3, true, "blue", true), flag("B_flag", 1, false),
+                        flag("a1", 2, true), flag("A", 7, true, "off", false), flag("a", 1, false),
+                        flag("a.b", 1, true), flag("Zeta", 0, true)}) {
+    flags[f.name] = f;
+  }
+  return flags;
+}
+
+const char* const FIXTURE_ETAG =
+    "\"84bae567248560798da28ccf75809ae5f53feb52829265bc1acd095809d23e2a\"";
+// Without a1, A at version 8, c added
+const char* const MERGED_ETAG =
+    "\"079659e78b1a2f94fd62a3e0b5b43630dc3775c3ab49d08b7d38b5668fe42d5f\"";
+const char* const MERGED_CTX2_ETAG =
+    "\"dc7d2be103716d6466191c23e73ac4c37d92c1793021eb7779064d04acff22f3\"";
+
+/** splitmix64, for the random merge sequence */
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+};
+
+} // namespace
+
+TEST(edge_name_order_matches_locale_compare) {
+  // node: [...].sort((a, b) => a.localeCompare(b))
+  std::vector<std::string> names = {"b-flag", "B_flag", "a1", "A", "a", "a.b", "Zeta"};
+  std::sort(names.begin(), names.end(), EdgeNameOrder());
+  const std::vector<std::string> expected = {"a", "A", "a.b", "a1", "B_flag", "b-flag", "Zeta"};
+  CHECK(names == expected);
+
+  EdgeNameOrder less;
+  CHECK(less("Aa", "ab"));    // case only breaks ties
+  CHECK(less("a_b", "a-b"));  // punctuation in collation order, not byte order
+  CHECK(less("a-", "a0"));    // punctuation before digits
+  CHECK(less("a", "a-"));     // prefix first
+  CHECK(!less("ab", "ab"));
+}
+
+TEST(full_set_matches_edge) {
+  FlagSetEtag etag;
+  etag.reset(fixture());
+  CHECK_EQ(etag.toEtag("ctx-1"), std::string(FIXTURE_ETAG));
+
+  FlagSetEtag empty;
+  CHECK_EQ(empty.toEtag("ctx-1"),
+           std::string("\"fab39fe7cd1790cbdb8d66afee0c6597f9009bd0843b89bbde5f15ed2e0b60a8\""));
+}
+
+TEST(merge_matches_edge_for_merged_set) {
+  FlagSetEtag etag;
+  etag.reset(fixture());
+  CHECK_EQ(etag.toEtag("ctx-1"), std::string(FIXTURE_ETAG));
+
+  etag.remove("a1");
+  etag.put(flag("A", 8, true, "off", false));
+  etag.put(flag("c", 1, true));
+  CHECK_EQ(etag.toEtag("ctx-1"), std::string(MERGED_ETAG));
+  // Unchanged since: the cached value
+  CHECK_EQ(etag.toEtag("ctx-1"), std::string(MERGED_ETAG));
+  CHECK_EQ(etag.toEtag("ctx-2"), std::string(MERGED_CTX2_ETAG));
+
+  // Re-putting an identical record changes nothing
+  etag.put(flag("c", 1, true));
+  CHECK_EQ(etag.toEtag("ctx-2"), std::string(MERGED_CTX2_ETAG));
+}
+
+TEST(incremental_equals_rebuilt) {
+  // Random upserts and removals: the checkpointed hash always equals a fresh build
+  Rng rng(42);
+  std::map<std::string, EvaluatedFlag> flags;
+  FlagSetEtag incremental;
+  for (int step = 0; step < 500; ++step) {
+    int ops = 1 + static_cast<int>(rng.next() % 4);
+    for (int i = 0; i < ops; ++i) {
+      std::string name = (rng.next() % 2 ? "F" : "f") + std::to_string(rng.next() % 60);
+      if (rng.next() % 4 == 0) {
+        flags.erase(name);
+        incremental.remove(name);
+      } else {
+        EvaluatedFlag f = flag(name, static_cast<int>(rng.next() % 5), rng.next() % 2 == 0,
+                               rng.next() % 3 == 0 ? "v" : "", rng.next() % 2 == 0);
+        flags[name] = f;
+        incremental.put(f);
+      }
+    }
+    FlagSetEtag rebuilt;
+    rebuilt.reset(flags);
+    std::string expected = rebuilt.toEtag("ctx");
+    if (incremental.toEtag("ctx") != expected) {
+      ::gatrix::test::fail(__FILE__, __LINE__, "diverged at step " + std::to_string(step));
+      break;
+    }
+  }
+  CHECK_EQ(incremental.count(), flags.size());
+}
+
+GATRIX_TEST_MAIN
@@ -0,0 +1,87 @@
+// Minimal test harness for the SDK unit tests in test_stubs/
+#ifndef GATRIX_TEST_H
+#define GATRIX_TEST_H
+
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+namespace test {
+
+struct Case {
+  std::string name;
+  std::function<void()> body;
+};
+
+inline std::vector<Case>& cases() {
+  static std::vector<Case> all;
+  return all;
+}
+
+inline int& failures() {
+  static int count = 0;
+  return count;
+}
+
+struct Registrar {
+  Registrar(const char* name, std::function<void()> body) {
+    cases().push_back(Case{name, std::move(body)});
+  }
+};
+
+inline void fail(const char* file, int line, const std::string& what) {
+  std::fprintf(stderr, "%s:%d: FAILED: %s\n", file, line, what.c_str());
+  failures()++;
+}
+
+template <typename A, typename B>
+std::string describe(const char* expr, const A& a, const B& b) {
+  std::ostringstream out;
+  out << expr << " (" << a << " vs " << b << ")";
+  return out.str();
+}
+
+/** Runs every registered case; the exit code is the number of failed checks (capped). */
+inline int runAll() {
+  for (const Case& c : cases()) {
+    int before = failures();
+    c.body();
+    std::printf("[%s] %s\n", failures() == before ? " OK " : "FAIL", c.name.c_str());
+  }
+  return failures() > 100 ? 100 : failures();
+}
+
+} // namespace test
+} // namespace gatrix
+
+#define GATRIX_TEST_CONCAT_(a, b) a##b
+#define GATRIX_TEST_CONCAT(a, b) GATRIX_TEST_CONCAT_(a, b)
+
+/** TEST(name) { ... } registers a case run by runAll() */
+#define TEST(name)                                                                  \
+  static void name();                                                               \
+  static ::gatrix::test::Registrar GATRIX_TEST_CONCAT(name, _registrar)(#name, name); \
+  static void name()
+
+#define CHECK(expr)                                                                 \
+  do {                                                                              \
+    if (!(expr))                                                                    \
+      ::gatrix::test::fail(__FILE__, __LINE__, #expr);                              \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                              \
+  do {                                                                              \
+    auto&& gatrixA_ = (a);                                                          \
+    auto&& gatrixB_ = (b);                                                          \
+    if (!(gatrixA_ == gatrixB_))                                                    \
+      ::gatrix::test::fail(__FILE__, __LINE__,                                      \
+                           ::gatrix::test::describe(#a " == " #b, gatrixA_, gatrixB_)); \
+  } while (0)
+
+#define GATRIX_TEST_MAIN                                                            \
+  int main() { return ::gatrix::test::runAll(); }
+
+#endif // GATRIX_TEST_H
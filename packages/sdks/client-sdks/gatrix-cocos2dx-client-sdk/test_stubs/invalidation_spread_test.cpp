@@ -0,0 +1,247 @@
+// invalidation_spread_test.cpp - Fleet spread of post-invalidation fetches and poll scheduling
+//
+// spreadDelayMs is a pure function of the session ID, so the distribution of a
+// simulated fleet is the same on every run: a failure here is a regression of
+// the hash or of the modulo, never noise.
+#include "GatrixInvalidationCoalescer.h"
+#include "GatrixPollingScheduler.h"
+#include "gatrix_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace gatrix;
+
+namespace {
+
+/** splitmix64, to derive UUID-like session IDs from a fixed seed */
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+};
+
+std::string uuid(Rng& rng) {
+  char buf[40];
+  uint64_t a = rng.next();
+  uint64_t b = rng.next();
+  std::snprintf(buf, sizeof(buf), "%08x-%04x-4%03x-%04x-%012llx",
+                static_cast<unsigned>(a >> 32), static_cast<unsigned>((a >> 16) & 0xffff),
+                static_cast<unsigned>(a & 0xfff), static_cast<unsigned>(0x8000 | (b >> 50)),
+                static_cast<unsigned long long>(b & 0xffffffffffffULL));
+  return buf;
+}
+
+/** Fetches per slot when every session receives the same event at t=0 */
+std::vector<int> fleetHistogram(const std::vector<std::string>& sessions, int windowMs,
+                                int slots) {
+  std::vector<int> perSlot(slots);
+  for (const auto& session : sessions) {
+    int delay = InvalidationCoalescer::spreadDelayMs(session, windowMs);
+    perSlot[static_cast<size_t>(delay) * slots / windowMs]++;
+  }
+  return perSlot;
+}
+
+/** Pearson's chi-squared statistic against a uniform distribution */
+double chiSquared(const std::vector<int>& observed, double total) {
+  double expected = total / observed.size();
+  double chi = 0.0;
+  for (int count : observed)
+    chi += (count - expected) * (count - expected) / expected;
+  return chi;
+}
+
+// Upper 0.1% point of chi-squared with 99 degrees of freedom
+const double CHI2_99_P001 = 148.23;
+
+std::vector<std::string> sequentialSessions(int count) {
+  std::vector<std::string> sessions;
+  for (int i = 0; i < count; i++)
+    sessions.push_back("session-" + std::to_string(i));
+  return sessions;
+}
+
+std::vector<std::string> uuidSessions(int count, uint64_t seed) {
+  Rng rng(seed);
+  std::vector<std::string> sessions;
+  for (int i = 0; i < count; i++)
+    sessions.push_back(uuid(rng));
+  return sessions;
+}
+
+} // namespace
+
+TEST(spread_delay_is_stable_and_in_range) {
+  CHECK_EQ(InvalidationCoalescer::spreadDelayMs("session-1", 0), 0);
+  CHECK_EQ(InvalidationCoalescer::spreadDelayMs("session-1", -5), 0);
+  CHECK_EQ(InvalidationCoalescer::spreadDelayMs("session-1", 1), 0);
+  for (const auto& session : uuidSessions(1000, 1)) {
+    int delay = InvalidationCoalescer::spreadDelayMs(session, 10000);
+    CHECK(delay >= 0 && delay < 10000);
+    // The same client keeps its offset from one event to the next
+    CHECK_EQ(InvalidationCoalescer::spreadDelayMs(session, 10000), delay);
+  }
+  CHECK_EQ(InvalidationCoalescer::spreadDelayMs("", 10000),
+           InvalidationCoalescer::spreadDelayMs("", 10000));
+}
+
+TEST(spread_is_uniform_over_sequential_session_ids) {
+  // Sequential IDs are the worst case for a weak hash: they differ in one or two bytes
+  const int fleet = 100000;
+  std::vector<int> perSecond = fleetHistogram(sequentialSessions(fleet), 10000, 10);
+  for (int count : perSecond)
+    CHECK(count >= 9500 && count <= 10500);
+  std::vector<int> fine = fleetHistogram(sequentialSessions(fleet), 10000, 100);
+  CHECK(chiSquared(fine, fleet) < CHI2_99_P001);
+}
+
+TEST(spread_is_uniform_over_uuid_session_ids) {
+  const int fleet = 100000;
+  for (int windowMs : {1000, 5000, 30000}) {
+    std::vector<int> perSlot = fleetHistogram(uuidSessions(fleet, 0x5eed), windowMs, 100);
+    CHECK(chiSquared(perSlot, fleet) < CHI2_99_P001);
+    // Peak load: no 1% slice of the window takes more than 1.2x its share
+    CHECK(*std::max_element(perSlot.begin(), perSlot.end()) <= fleet / 100 * 12 / 10);
+  }
+}
+
+TEST(spread_offsets_decorrelate_between_windows) {
+  // Clients that share a slot in one window are scattered again in another
+  const int fleet = 20000;
+  std::vector<std::string> sessions = uuidSessions(fleet, 42);
+  std::vector<int> sameSlot(10);
+  for (const auto& session : sessions) {
+    int a = InvalidationCoalescer::spreadDelayMs(session, 1000) / 100;
+    if (a != 0)
+      continue;
+    sameSlot[InvalidationCoalescer::spreadDelayMs(session, 7919) * 10 / 7919]++;
+  }
+  int total = 0;
+  for (int count : sameSlot)
+    total += count;
+  CHECK(total > 1500);
+  for (int count : sameSlot)
+    CHECK(count > total / 10 / 2 && count < total / 10 * 2);
+}
+
+TEST(coalescer_window_follows_event_rate) {
+  using Clock = InvalidationCoalescer::Clock;
+  Clock::time_point t;
+
+  InvalidationCoalescer isolated(50, 500);
+  isolated.add({"a"}, t);
+  isolated.add({"b"}, t + std::chrono::seconds(5));
+  CHECK_EQ(isolated.windowMs(), 50);
+
+  InvalidationCoalescer burst(50, 500);
+  for (int i = 0; i < 30; i++)
+    burst.add({"k" + std::to_string(i % 3)}, t + std::chrono::milliseconds(5 * i));
+  CHECK_EQ(burst.windowMs(), 500);
+  CHECK_EQ(burst.eventCount(), 30);
+  std::vector<std::string> batch = burst.take();
+  CHECK_EQ(batch.size(), static_cast<size_t>(3));
+  CHECK(!burst.hasPending());
+
+  burst.add({"x"}, t);
+  burst.add({"*"}, t);
+  burst.add({"y"}, t);
+  CHECK(burst.take() == std::vector<std::string>{"*"});
+}
+
+TEST(polling_scheduler_follows_streaming_health) {
+  using Clock = PollingScheduler::Clock;
+  Clock::time_point t;
+  PollingScheduler scheduler(30, 300, 3, 60);
+
+  CHECK(scheduler.mode(t) == PollingMode::NORMAL);
+  CHECK_EQ(scheduler.nextDelay(0, 1, 60, t), 30.0f);
+
+  scheduler.setStreamingEnabled(true);
+  CHECK(scheduler.mode(t) == PollingMode::DEGRADED);
+  for (int i = 0; i < 200; i++) {
+    float delay = scheduler.nextDelay(0, 1, 60, t);
+    CHECK(delay >= 27.0f && delay <= 33.0f);
+  }
+
+  scheduler.onStreamingState(true, t);
+  CHECK(scheduler.mode(t) == PollingMode::HEALTHY);
+  for (int i = 0; i < 200; i++) {
+    float delay = scheduler.nextDelay(0, 1, 60, t);
+    CHECK(delay >= 270.0f && delay <= 330.0f);
+  }
+
+  // Three drops within the flap window: back off from the base interval, capped at safety
+  for (int i = 0; i < 3; i++) {
+    scheduler.onStreamingState(false, t + std::chrono::seconds(i));
+    scheduler.onStreamingState(true, t + std::chrono::seconds(i));
+  }
+  Clock::time_point later = t + std::chrono::seconds(3);
+  CHECK(scheduler.mode(later) == PollingMode::FLAPPING);
+  for (int i = 0; i < 200; i++) {
+    float delay = scheduler.nextDelay(0, 1, 60, later);
+    CHECK(delay >= 30.0f && delay <= 60.0f);
+  }
+  for (int i = 3; i < 10; i++) {
+    scheduler.onStreamingState(false, t + std::chrono::seconds(i));
+    scheduler.onStreamingState(true, t + std::chrono::seconds(i));
+  }
+  later = t + std::chrono::seconds(10);
+  for (int i = 0; i < 200; i++) {
+    float delay = scheduler.nextDelay(0, 1, 60, later);
+    CHECK(delay >= 150.0f && delay <= 300.0f);
+  }
+
+  // The drops age out of the window and the stream counts as healthy again
+  CHECK(scheduler.mode(t + std::chrono::seconds(71)) == PollingMode::HEALTHY);
+}
+
+TEST(polling_scheduler_server_hints_and_failures) {
+  using Clock = PollingScheduler::Clock;
+  Clock::time_point t;
+  PollingScheduler scheduler(30, 300, 3, 60);
+
+  scheduler.setServerInterval(90);
+  CHECK_EQ(scheduler.nextDelay(0, 1, 60, t), 90.0f);
+  scheduler.setServerInterval(0);
+  CHECK_EQ(scheduler.nextDelay(0, 1, 60, t), 30.0f);
+
+  // With the stream healthy a hint replaces the safety interval, shorter or longer
+  scheduler.setStreamingEnabled(true);
+  scheduler.onStreamingState(true, t);
+  auto healthyDelays = [&](float low, float high) {
+    for (int i = 0; i < 200; i++) {
+      float delay = scheduler.nextDelay(0, 1, 60, t);
+      if (delay < low || delay > high)
+        return false;
+    }
+    return true;
+  };
+  scheduler.setServerInterval(60);
+  CHECK(healthyDelays(54.0f, 66.0f));
+  scheduler.setServerInterval(600);
+  CHECK(healthyDelays(540.0f, 660.0f));
+  scheduler.setServerInterval(0);
+  CHECK(healthyDelays(270.0f, 330.0f));
+  scheduler.setStreamingEnabled(false);
+
+  CHECK_EQ(scheduler.nextDelay(1, 2, 60, t), 2.0f);
+  CHECK_EQ(scheduler.nextDelay(4, 2, 60, t), 16.0f);
+  CHECK_EQ(scheduler.nextDelay(10, 2, 60, t), 60.0f);
+
+  // Retry-After is a floor for the next poll only
+  scheduler.setRetryAfter(900, t);
+  CHECK_EQ(scheduler.nextDelay(2, 1, 60, t + std::chrono::seconds(100)), 800.0f);
+  CHECK_EQ(scheduler.nextDelay(2, 1, 60, t + std::chrono::seconds(100)), 2.0f);
+  CHECK_EQ(scheduler.lastDelay(), 2.0f);
+}
+
+GATRIX_TEST_MAIN
@@ -1,12 +1,22 @@
-// Stub json/document.h - Minimal RapidJSON stubs for compilation testing
+// Stub json/document.h - Small working subset of RapidJSON for the SDK tests
+//
+// Implements the part of the RapidJSON API the SDK uses (DOM, Parse,
+// ParseStream, ParseInsitu, member/array access, AddMember/PushBack) with
+// std::string/std::vector storage. Values own their data; allocators are
+// accepted and ignored. Like RapidJSON, values move on assignment and
+// AddMember/PushBack, and cannot be copied implicitly.
 #ifndef RAPIDJSON_DOCUMENT_H_
 #define RAPIDJSON_DOCUMENT_H_
 
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-
 namespace rapidjson {
 
 typedef unsigned int SizeType;
@@ -39,6 +49,25 @@ public:
   static void Free(void *ptr) { std::free(ptr); }
 };
 
+template <typename CharType = char> struct UTF8 {
+  typedef CharType Ch;
+};
+
+template <typename CharType> struct GenericStringRef {
+  GenericStringRef(const CharType *str)
+      : s(str), length(static_cast<SizeType>(std::strlen(str))) {}
+  GenericStringRef(const CharType *str, SizeType len) : s(str), length(len) {}
+  const CharType *s;
+  SizeType length;
+};
+
+inline GenericStringRef<char> StringRef(const char *str) {
+  return GenericStringRef<char>(str);
+}
+inline GenericStringRef<char> StringRef(const char *str, size_t length) {
+  return GenericStringRef<char>(str, static_cast<SizeType>(length));
+}
+
 template <typename Encoding, typename Allocator> class GenericValue;
 
 template <typename Encoding, typename Allocator> class GenericMember {
@@ -47,127 +76,649 @@ public:
   GenericValue<Encoding, Allocator> value;
 };
 
-template <typename CharType = char> struct UTF8 {
-  typedef CharType Ch;
-};
-
 template <typename Encoding = UTF8<>,
           typename Allocator = MemoryPoolAllocator<>>
 class GenericValue {
 public:
   typedef Allocator AllocatorType;
+  typedef typename Encoding::Ch Ch;
   typedef GenericMember<Encoding, Allocator> Member;
-  typedef GenericValue *MemberIterator;
-  typedef const GenericValue *ConstMemberIterator;
+  typedef Member *MemberIterator;
+  typedef const Member *ConstMemberIterator;
+  typedef GenericValue *ValueIterator;
+  typedef const GenericValue *ConstValueIterator;
+
+  template <typename V> class ArrayRange {
+  public:
+    explicit ArrayRange(V *begin, V *end) : _begin(begin), _end(end) {}
+    V *begin() const { return _begin; }
+    V *end() const { return _end; }
+    SizeType Size() const { return static_cast<SizeType>(_end - _begin); }
 
-  GenericValue() : _type(kNullType), _strVal(""), _numVal(0), _boolVal(false) {}
-  GenericValue(Type type)
-      : _type(type), _strVal(""), _numVal(0), _boolVal(false) {}
-  GenericValue(const char *str, Allocator &)
-      : _type(kStringType), _strVal(str), _numVal(0), _boolVal(false) {}
+  private:
+    V *_begin;
+    V *_end;
+  };
+
+  GenericValue() : _type(kNullType) {}
+  explicit GenericValue(Type type) : _type(type) {}
+  explicit GenericValue(bool b) : _type(b ? kTrueType : kFalseType) {}
+  explicit GenericValue(int i) { SetInt64(i); }
+  explicit GenericValue(unsigned u) { SetInt64(u); }
+  explicit GenericValue(int64_t i) { SetInt64(i); }
+  explicit GenericValue(double d) : _type(kNumberType), _double(d) {}
+  explicit GenericValue(GenericStringRef<Ch> s)
+      : _type(kStringType), _string(s.s, s.length) {}
+  GenericValue(const Ch *s, Allocator &) : _type(kStringType), _string(s) {}
+  GenericValue(const Ch *s, SizeType length, Allocator &)
+      : _type(kStringType), _string(s, length) {}
+  GenericValue(const std::string &s, Allocator &)
+      : _type(kStringType), _string(s) {}
+
+  GenericValue(GenericValue &&rhs) noexcept { *this = std::move(rhs); }
+  GenericValue &operator=(GenericValue &&rhs) noexcept {
+    if (this != &rhs) {
+      _type = rhs._type;
+      _isInteger = rhs._isInteger;
+      _int = rhs._int;
+      _double = rhs._double;
+      _string = std::move(rhs._string);
+      _members = std::move(rhs._members);
+      _elements = std::move(rhs._elements);
+      rhs.SetNull();
+    }
+    return *this;
+  }
+  GenericValue(const GenericValue &) = delete;
+  GenericValue &operator=(const GenericValue &) = delete;
+
+  GenericValue &CopyFrom(const GenericValue &rhs, Allocator &alloc) {
+    GenericValue copy(rhs._type);
+    copy._isInteger = rhs._isInteger;
+    copy._int = rhs._int;
+    copy._double = rhs._double;
+    copy._string = rhs._string;
+    for (const Member &m : rhs._members) {
+      Member member;
+      member.name.CopyFrom(m.name, alloc);
+      member.value.CopyFrom(m.value, alloc);
+      copy._members.push_back(std::move(member));
+    }
+    for (const GenericValue &e : rhs._elements) {
+      GenericValue element;
+      element.CopyFrom(e, alloc);
+      copy._elements.push_back(std::move(element));
+    }
+    *this = std::move(copy);
+    return *this;
+  }
+
+  // --- Type ---------------------------------------------------------------
+
+  Type GetType() const { return _type; }
+  bool IsNull() const { return _type == kNullType; }
+  bool IsFalse() const { return _type == kFalseType; }
+  bool IsTrue() const { return _type == kTrueType; }
+  bool IsBool() const { return _type == kTrueType || _type == kFalseType; }
+  bool IsObject() const { return _type == kObjectType; }
+  bool IsArray() const { return _type == kArrayType; }
+  bool IsString() const { return _type == kStringType; }
+  bool IsNumber() const { return _type == kNumberType; }
+  bool IsInt() const {
+    return IsInt64() && _int >= INT32_MIN && _int <= INT32_MAX;
+  }
+  bool IsUint() const { return IsInt64() && _int >= 0 && _int <= UINT32_MAX; }
+  bool IsInt64() const { return _type == kNumberType && _isInteger; }
+  bool IsDouble() const { return _type == kNumberType && !_isInteger; }
 
   GenericValue &SetNull() {
     _type = kNullType;
+    _isInteger = false;
+    _string.clear();
+    _members.clear();
+    _elements.clear();
     return *this;
   }
   GenericValue &SetObject() {
+    SetNull();
     _type = kObjectType;
     return *this;
   }
   GenericValue &SetArray() {
+    SetNull();
     _type = kArrayType;
     return *this;
   }
+  GenericValue &SetBool(bool b) {
+    SetNull();
+    _type = b ? kTrueType : kFalseType;
+    return *this;
+  }
+  GenericValue &SetInt64(int64_t i) {
+    _type = kNumberType;
+    _isInteger = true;
+    _int = i;
+    _double = static_cast<double>(i);
+    return *this;
+  }
+  GenericValue &SetDouble(double d) {
+    _type = kNumberType;
+    _isInteger = false;
+    _double = d;
+    return *this;
+  }
+  GenericValue &SetString(const Ch *s, SizeType length, Allocator &) {
+    SetNull();
+    _type = kStringType;
+    _string.assign(s, length);
+    return *this;
+  }
 
-  bool IsNull() const { return _type == kNullType; }
-  bool IsObject() const { return _type == kObjectType; }
-  bool IsArray() const { return _type == kArrayType; }
-  bool IsString() const { return _type == kStringType; }
-  bool IsNumber() const { return _type == kNumberType; }
-  bool IsBool() const { return _type == kTrueType || _type == kFalseType; }
-  bool IsInt() const { return _type == kNumberType; }
-  bool IsDouble() const { return _type == kNumberType; }
+  // --- Scalars --------------------------------------------------------------
 
-  const char *GetString() const { return _strVal.c_str(); }
-  int GetInt() const { return static_cast<int>(_numVal); }
-  double GetDouble() const { return _numVal; }
-  bool GetBool() const { return _boolVal; }
-  SizeType Size() const { return static_cast<SizeType>(_children.size()); }
+  bool GetBool() const { return _type == kTrueType; }
+  int GetInt() const {
+    return _isInteger ? static_cast<int>(_int) : static_cast<int>(_double);
+  }
+  unsigned GetUint() const { return static_cast<unsigned>(GetInt64()); }
+  int64_t GetInt64() const {
+    return _isInteger ? _int : static_cast<int64_t>(_double);
+  }
+  double GetDouble() const { return _double; }
+  const Ch *GetString() const { return _string.c_str(); }
+  SizeType GetStringLength() const {
+    return static_cast<SizeType>(_string.size());
+  }
 
-  bool HasMember(const char *name) const { return false; }
+  // --- Object ---------------------------------------------------------------
 
-  GenericValue &operator[](const char *name) {
-    static GenericValue dummy;
-    return dummy;
+  SizeType MemberCount() const { return static_cast<SizeType>(_members.size()); }
+  MemberIterator MemberBegin() { return _members.data(); }
+  MemberIterator MemberEnd() { return _members.data() + _members.size(); }
+  ConstMemberIterator MemberBegin() const { return _members.data(); }
+  ConstMemberIterator MemberEnd() const {
+    return _members.data() + _members.size();
   }
-  const GenericValue &operator[](const char *name) const {
-    static GenericValue dummy;
-    return dummy;
+
+  MemberIterator FindMember(const Ch *name) {
+    for (Member &m : _members) {
+      if (m.name._string == name)
+        return &m;
+    }
+    return MemberEnd();
   }
-  const GenericValue &operator[](SizeType index) const {
-    return _children[index];
+  ConstMemberIterator FindMember(const Ch *name) const {
+    return const_cast<GenericValue *>(this)->FindMember(name);
   }
+  bool HasMember(const Ch *name) const { return FindMember(name) != MemberEnd(); }
 
-  bool HasParseError() const { return false; }
+  GenericValue &operator[](const Ch *name) {
+    MemberIterator it = FindMember(name);
+    if (it != MemberEnd())
+      return it->value;
+    static GenericValue missing;
+    missing.SetNull();
+    return missing;
+  }
+  const GenericValue &operator[](const Ch *name) const {
+    return const_cast<GenericValue &>(*this)[name];
+  }
+  GenericValue &operator[](const std::string &name) { return (*this)[name.c_str()]; }
+  const GenericValue &operator[](const std::string &name) const {
+    return (*this)[name.c_str()];
+  }
 
-  GenericValue &AddMember(GenericValue &name, GenericValue &value,
-                          Allocator &alloc) {
+  GenericValue &AddMember(GenericValue &name, GenericValue &value, Allocator &) {
+    Member member;
+    member.name = std::move(name);
+    member.value = std::move(value);
+    _members.push_back(std::move(member));
     return *this;
   }
-  GenericValue &AddMember(const char *name, GenericValue &value,
-                          Allocator &alloc) {
-    return *this;
+  GenericValue &AddMember(GenericValue &&name, GenericValue &&value, Allocator &alloc) {
+    return AddMember(name, value, alloc);
   }
-  GenericValue &AddMember(GenericValue &name, bool value, Allocator &alloc) {
-    return *this;
+  GenericValue &AddMember(GenericValue &&name, GenericValue &value, Allocator &alloc) {
+    return AddMember(name, value, alloc);
   }
-  GenericValue &AddMember(const char *name, bool value, Allocator &alloc) {
-    return *this;
+  GenericValue &AddMember(GenericValue &name, GenericValue &&value, Allocator &alloc) {
+    return AddMember(name, value, alloc);
   }
-  GenericValue &AddMember(const char *name, int value, Allocator &alloc) {
-    return *this;
+  GenericValue &AddMember(GenericStringRef<Ch> name, GenericValue &value, Allocator &alloc) {
+    GenericValue n(name);
+    return AddMember(n, value, alloc);
+  }
+  GenericValue &AddMember(GenericStringRef<Ch> name, GenericValue &&value, Allocator &alloc) {
+    GenericValue n(name);
+    return AddMember(n, value, alloc);
+  }
+  GenericValue &AddMember(GenericStringRef<Ch> name, GenericStringRef<Ch> value,
+                          Allocator &alloc) {
+    GenericValue n(name);
+    GenericValue v(value);
+    return AddMember(n, v, alloc);
+  }
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value, GenericValue &>::type
+  AddMember(GenericStringRef<Ch> name, T value, Allocator &alloc) {
+    GenericValue n(name);
+    GenericValue v = FromArithmetic(value);
+    return AddMember(n, v, alloc);
+  }
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value, GenericValue &>::type
+  AddMember(GenericValue &name, T value, Allocator &alloc) {
+    GenericValue v = FromArithmetic(value);
+    return AddMember(name, v, alloc);
   }
 
-  GenericValue &Parse(const char *) { return *this; }
+  // --- Array ----------------------------------------------------------------
 
-  template <typename Handler> bool Accept(Handler &handler) const {
-    return true;
+  SizeType Size() const { return static_cast<SizeType>(_elements.size()); }
+  bool Empty() const { return _elements.empty(); }
+  GenericValue &operator[](SizeType index) { return _elements[index]; }
+  const GenericValue &operator[](SizeType index) const { return _elements[index]; }
+  GenericValue &operator[](int index) { return _elements[static_cast<size_t>(index)]; }
+  const GenericValue &operator[](int index) const {
+    return _elements[static_cast<size_t>(index)];
+  }
+  ValueIterator Begin() { return _elements.data(); }
+  ValueIterator End() { return _elements.data() + _elements.size(); }
+  ConstValueIterator Begin() const { return _elements.data(); }
+  ConstValueIterator End() const { return _elements.data() + _elements.size(); }
+  ArrayRange<GenericValue> GetArray() { return ArrayRange<GenericValue>(Begin(), End()); }
+  ArrayRange<const GenericValue> GetArray() const {
+    return ArrayRange<const GenericValue>(Begin(), End());
   }
 
-  GenericValue &CopyFrom(const GenericValue &rhs, Allocator &alloc) {
+  GenericValue &PushBack(GenericValue &value, Allocator &) {
+    _elements.push_back(std::move(value));
     return *this;
   }
+  GenericValue &PushBack(GenericValue &&value, Allocator &alloc) {
+    return PushBack(value, alloc);
+  }
+  GenericValue &PushBack(GenericStringRef<Ch> value, Allocator &alloc) {
+    GenericValue v(value);
+    return PushBack(v, alloc);
+  }
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value, GenericValue &>::type
+  PushBack(T value, Allocator &alloc) {
+    GenericValue v = FromArithmetic(value);
+    return PushBack(v, alloc);
+  }
 
-  MemberIterator MemberBegin() { return nullptr; }
-  MemberIterator MemberEnd() { return nullptr; }
+  // --- Output ---------------------------------------------------------------
 
-  Allocator &GetAllocator() {
-    static Allocator alloc;
-    return alloc;
+  template <typename Handler> bool Accept(Handler &handler) const {
+    switch (_type) {
+    case kNullType:
+      return handler.Null();
+    case kFalseType:
+      return handler.Bool(false);
+    case kTrueType:
+      return handler.Bool(true);
+    case kStringType:
+      return handler.String(_string.data(), static_cast<SizeType>(_string.size()), false);
+    case kNumberType:
+      return _isInteger ? handler.Int64(_int) : handler.Double(_double);
+    case kObjectType:
+      if (!handler.StartObject())
+        return false;
+      for (const Member &m : _members) {
+        if (!handler.Key(m.name._string.data(),
+                         static_cast<SizeType>(m.name._string.size()), false) ||
+            !m.value.Accept(handler))
+          return false;
+      }
+      return handler.EndObject(static_cast<SizeType>(_members.size()));
+    case kArrayType:
+      if (!handler.StartArray())
+        return false;
+      for (const GenericValue &e : _elements) {
+        if (!e.Accept(handler))
+          return false;
+      }
+      return handler.EndArray(static_cast<SizeType>(_elements.size()));
+    }
+    return false;
   }
 
-private:
-  Type _type;
-  std::string _strVal;
-  double _numVal;
-  bool _boolVal;
-  std::vector<GenericValue> _children;
+protected:
+  template <typename T> static GenericValue FromArithmetic(T value) {
+    GenericValue v;
+    if (std::is_same<T, bool>::value)
+      v.SetBool(value != T());
+    else if (std::is_integral<T>::value)
+      v.SetInt64(static_cast<int64_t>(value));
+    else
+      v.SetDouble(static_cast<double>(value));
+    return v;
+  }
+
+  Type _type = kNullType;
+  bool _isInteger = false;
+  int64_t _int = 0;
+  double _double = 0;
+  std::string _string;
+  std::vector<Member> _members;
+  std::vector<GenericValue> _elements;
 };
 
 typedef GenericValue<UTF8<>> Value;
 
+/** Read-only stream over a NUL-terminated string (RapidJSON's Stream concept) */
+template <typename Encoding> struct GenericStringStream {
+  typedef typename Encoding::Ch Ch;
+  explicit GenericStringStream(const Ch *src) : src_(src), head_(src) {}
+  Ch Peek() const { return *src_; }
+  Ch Take() { return *src_++; }
+  size_t Tell() const { return static_cast<size_t>(src_ - head_); }
+  const Ch *src_;
+  const Ch *head_;
+};
+typedef GenericStringStream<UTF8<>> StringStream;
+
 template <typename Encoding = UTF8<>,
           typename Allocator = MemoryPoolAllocator<>>
 class GenericDocument : public GenericValue<Encoding, Allocator> {
 public:
-  typedef
-      typename GenericValue<Encoding, Allocator>::AllocatorType AllocatorType;
+  typedef GenericValue<Encoding, Allocator> ValueType;
+  typedef Allocator AllocatorType;
+  typedef typename Encoding::Ch Ch;
+
+  GenericDocument() = default;
+  explicit GenericDocument(Type type) : ValueType(type) {}
+
   AllocatorType &GetAllocator() { return _allocator; }
-  GenericDocument &Parse(const char *json) { return *this; }
-  bool HasParseError() const { return false; }
+
+  template <typename InputStream> GenericDocument &ParseStream(InputStream &is) {
+    ValueType root;
+    _error = false;
+    _errorOffset = 0;
+    Reader<InputStream> reader(is);
+    if (reader.ParseDocument(root)) {
+      static_cast<ValueType &>(*this) = std::move(root);
+    } else {
+      _error = true;
+      _errorOffset = is.Tell();
+      this->SetNull();
+    }
+    return *this;
+  }
+  GenericDocument &Parse(const Ch *json) {
+    GenericStringStream<Encoding> s(json);
+    return ParseStream(s);
+  }
+  GenericDocument &Parse(const Ch *json, size_t length) {
+    std::string copy(json, length);
+    return Parse(copy.c_str());
+  }
+  GenericDocument &ParseInsitu(Ch *json) { return Parse(json); }
+
+  bool HasParseError() const { return _error; }
+  size_t GetErrorOffset() const { return _errorOffset; }
 
 private:
+  template <typename InputStream> class Reader {
+  public:
+    explicit Reader(InputStream &is) : _is(is) {}
+
+    bool ParseDocument(ValueType &out) {
+      SkipWhitespace();
+      if (!ParseValue(out, 0))
+        return false;
+      SkipWhitespace();
+      return _is.Peek() == '\0';
+    }
+
+  private:
+    static const int kMaxDepth = 512;
+
+    void SkipWhitespace() {
+      for (;;) {
+        Ch c = _is.Peek();
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+          return;
+        _is.Take();
+      }
+    }
+
+    bool Consume(const char *literal) {
+      for (; *literal; literal++) {
+        if (_is.Peek() != *literal)
+          return false;
+        _is.Take();
+      }
+      return true;
+    }
+
+    bool ParseValue(ValueType &out, int depth) {
+      if (depth > kMaxDepth)
+        return false;
+      switch (_is.Peek()) {
+      case 'n':
+        out.SetNull();
+        return Consume("null");
+      case 't':
+        out.SetBool(true);
+        return Consume("true");
+      case 'f':
+        out.SetBool(false);
+        return Consume("false");
+      case '"': {
+        std::string s;
+        if (!ParseString(s))
+          return false;
+        out.SetString(s.data(), static_cast<SizeType>(s.size()), _alloc);
+        return true;
+      }
+      case '{':
+        return ParseObject(out, depth);
+      case '[':
+        return ParseArray(out, depth);
+      default:
+        return ParseNumber(out);
+      }
+    }
+
+    bool ParseObject(ValueType &out, int depth) {
+      _is.Take();
+      out.SetObject();
+      SkipWhitespace();
+      if (_is.Peek() == '}') {
+        _is.Take();
+        return true;
+      }
+      for (;;) {
+        if (_is.Peek() != '"')
+          return false;
+        std::string key;
+        if (!ParseString(key))
+          return false;
+        SkipWhitespace();
+        if (_is.Peek() != ':')
+          return false;
+        _is.Take();
+        SkipWhitespace();
+        ValueType name(key, _alloc);
+        ValueType value;
+        if (!ParseValue(value, depth + 1))
+          return false;
+        out.AddMember(name, value, _alloc);
+        SkipWhitespace();
+        Ch c = _is.Take();
+        if (c == '}')
+          return true;
+        if (c != ',')
+          return false;
+        SkipWhitespace();
+      }
+    }
+
+    bool ParseArray(ValueType &out, int depth) {
+      _is.Take();
+      out.SetArray();
+      SkipWhitespace();
+      if (_is.Peek() == ']') {
+        _is.Take();
+        return true;
+      }
+      for (;;) {
+        ValueType element;
+        if (!ParseValue(element, depth + 1))
+          return false;
+        out.PushBack(element, _alloc);
+        SkipWhitespace();
+        Ch c = _is.Take();
+        if (c == ']')
+          return true;
+        if (c != ',')
+          return false;
+        SkipWhitespace();
+      }
+    }
+
+    static int HexDigit(Ch c) {
+      if (c >= '0' && c <= '9')
+        return c - '0';
+      if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+      return -1;
+    }
+
+    bool ParseHex4(unsigned &code) {
+      code = 0;
+      for (int i = 0; i < 4; i++) {
+        int d = HexDigit(_is.Take());
+        if (d < 0)
+          return false;
+        code = (code << 4) | static_cast<unsigned>(d);
+      }
+      return true;
+    }
+
+    static void AppendUtf8(std::string &s, unsigned code) {
+      if (code < 0x80) {
+        s += static_cast<char>(code);
+      } else if (code < 0x800) {
+        s += static_cast<char>(0xC0 | (code >> 6));
+        s += static_cast<char>(0x80 | (code & 0x3F));
+      } else if (code < 0x10000) {
+        s += static_cast<char>(0xE0 | (code >> 12));
+        s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (code & 0x3F));
+      } else {
+        s += static_cast<char>(0xF0 | (code >> 18));
+        s += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (code & 0x3F));
+      }
+    }
+
+    bool ParseString(std::string &out) {
+      _is.Take(); // opening quote
+      for (;;) {
+        Ch c = _is.Take();
+        if (c == '"')
+          return true;
+        if (c == '\0' || static_cast<unsigned char>(c) < 0x20)
+          return false;
+        if (c != '\\') {
+          out += c;
+          continue;
+        }
+        c = _is.Take();
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          out += c;
+          break;
+        case 'b':
+          out += '\b';
+          break;
+        case 'f':
+          out += '\f';
+          break;
+        case 'n':
+          out += '\n';
+          break;
+        case 'r':
+          out += '\r';
+          break;
+        case 't':
+          out += '\t';
+          break;
+        case 'u': {
+          unsigned code;
+          if (!ParseHex4(code))
+            return false;
+          if (code >= 0xD800 && code <= 0xDBFF) {
+            unsigned low;
+            if (_is.Take() != '\\' || _is.Take() != 'u' || !ParseHex4(low) || low < 0xDC00 ||
+                low > 0xDFFF)
+              return false;
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          AppendUtf8(out, code);
+          break;
+        }
+        default:
+          return false;
+        }
+      }
+    }
+
+    bool ParseNumber(ValueType &out) {
+      std::string literal;
+      bool integer = true;
+      if (_is.Peek() == '-')
+        literal += _is.Take();
+      if (_is.Peek() < '0' || _is.Peek() > '9')
+        return false;
+      if (_is.Peek() == '0') {
+        literal += _is.Take();
+      } else {
+        while (_is.Peek() >= '0' && _is.Peek() <= '9')
+          literal += _is.Take();
+      }
+      if (_is.Peek() == '.') {
+        integer = false;
+        literal += _is.Take();
+        if (_is.Peek() < '0' || _is.Peek() > '9')
+          return false;
+        while (_is.Peek() >= '0' && _is.Peek() <= '9')
+          literal += _is.Take();
+      }
+      if (_is.Peek() == 'e' || _is.Peek() == 'E') {
+        integer = false;
+        literal += _is.Take();
+        if (_is.Peek() == '+' || _is.Peek() == '-')
+          literal += _is.Take();
+        if (_is.Peek() < '0' || _is.Peek() > '9')
+          return false;
+        while (_is.Peek() >= '0' && _is.Peek() <= '9')
+          literal += _is.Take();
+      }
+      if (integer && literal.size() < 19) {
+        out.SetInt64(std::strtoll(literal.c_str(), nullptr, 10));
+      } else {
+        out.SetDouble(std::strtod(literal.c_str(), nullptr));
+      }
+      return true;
+    }
+
+    InputStream &_is;
+    AllocatorType _alloc;
+  };
+
   AllocatorType _allocator;
+  bool _error = false;
+  size_t _errorOffset = 0;
 };
 
 typedef GenericDocument<UTF8<>> Document;
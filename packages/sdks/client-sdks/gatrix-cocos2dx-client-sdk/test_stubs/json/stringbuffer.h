@@ -1,4 +1,4 @@
-// Stub json/stringbuffer.h for compilation testing
+// Stub json/stringbuffer.h - Growable output buffer for the Writer stub
 #ifndef RAPIDJSON_STRINGBUFFER_H_
 #define RAPIDJSON_STRINGBUFFER_H_
 
@@ -8,9 +8,14 @@ namespace rapidjson {
 
 class StringBuffer {
 public:
+  typedef char Ch;
+
   const char *GetString() const { return _str.c_str(); }
   size_t GetSize() const { return _str.size(); }
+  size_t GetLength() const { return _str.size(); }
   void Put(char c) { _str += c; }
+  void Flush() {}
+  void Clear() { _str.clear(); }
 
 private:
   std::string _str;
@@ -1,27 +1,160 @@
-// Stub json/writer.h for compilation testing
+// Stub json/writer.h - Compact JSON writer matching RapidJSON's output
 #ifndef RAPIDJSON_WRITER_H_
 #define RAPIDJSON_WRITER_H_
 
 #include "stringbuffer.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
 namespace rapidjson {
 
 template <typename OutputStream> class Writer {
 public:
-  Writer(OutputStream &) {}
-  bool Null() { return true; }
-  bool Bool(bool) { return true; }
-  bool Int(int) { return true; }
-  bool Uint(unsigned) { return true; }
-  bool Int64(long long) { return true; }
-  bool Uint64(unsigned long long) { return true; }
-  bool Double(double) { return true; }
-  bool String(const char *, size_t = 0, bool = false) { return true; }
-  bool StartObject() { return true; }
-  bool Key(const char *) { return true; }
-  bool EndObject(size_t = 0) { return true; }
-  bool StartArray() { return true; }
-  bool EndArray(size_t = 0) { return true; }
+  explicit Writer(OutputStream &os) : _os(os) {}
+
+  bool Null() { return Raw("null", 4); }
+  bool Bool(bool b) { return b ? Raw("true", 4) : Raw("false", 5); }
+  bool Int(int i) { return Int64(i); }
+  bool Uint(unsigned u) { return Uint64(u); }
+  bool Int64(long long i) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%lld", i);
+    return Raw(buf, static_cast<size_t>(n));
+  }
+  bool Uint64(unsigned long long u) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%llu", u);
+    return Raw(buf, static_cast<size_t>(n));
+  }
+  bool Double(double d) {
+    // Shortest representation that reads back as d; integral values keep ".0"
+    char buf[40];
+    for (int precision = 1; precision <= 17; precision++) {
+      std::snprintf(buf, sizeof(buf), "%.*g", precision, d);
+      if (std::strtod(buf, nullptr) == d)
+        break;
+    }
+    std::string s(buf);
+    size_t e = s.find('e');
+    if (e != std::string::npos) {
+      std::string mantissa = s.substr(0, e);
+      std::string exponent = s.substr(e + 1);
+      bool negative = exponent[0] == '-';
+      size_t digits = exponent.find_first_not_of("+-0");
+      s = mantissa + "e" + (negative ? "-" : "") +
+          (digits == std::string::npos ? "0" : exponent.substr(digits));
+    } else if (s.find('.') == std::string::npos) {
+      s += ".0";
+    }
+    return Raw(s.data(), s.size());
+  }
+  bool String(const char *str, size_t length, bool = false) {
+    Prefix();
+    _os.Put('"');
+    for (size_t i = 0; i < length; i++) {
+      unsigned char c = static_cast<unsigned char>(str[i]);
+      switch (c) {
+      case '"':
+        PutRaw("\\\"");
+        break;
+      case '\\':
+        PutRaw("\\\\");
+        break;
+      case '\b':
+        PutRaw("\\b");
+        break;
+      case '\f':
+        PutRaw("\\f");
+        break;
+      case '\n':
+        PutRaw("\\n");
+        break;
+      case '\r':
+        PutRaw("\\r");
+        break;
+      case '\t':
+        PutRaw("\\t");
+        break;
+      default:
+        if (c < 0x20) {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04X", c);
+          PutRaw(buf);
+        } else {
+          _os.Put(static_cast<char>(c));
+        }
+      }
+    }
+    _os.Put('"');
+    return true;
+  }
+  bool String(const char *str) { return String(str, std::strlen(str)); }
+  bool Key(const char *str, size_t length, bool copy = false) {
+    bool ok = String(str, length, copy);
+    _levels.back().expectValue = true;
+    return ok;
+  }
+  bool Key(const char *str) { return Key(str, std::strlen(str)); }
+  bool StartObject() {
+    Prefix();
+    _os.Put('{');
+    _levels.push_back(Level{true, 0, false});
+    return true;
+  }
+  bool EndObject(size_t = 0) {
+    _levels.pop_back();
+    _os.Put('}');
+    return true;
+  }
+  bool StartArray() {
+    Prefix();
+    _os.Put('[');
+    _levels.push_back(Level{false, 0, false});
+    return true;
+  }
+  bool EndArray(size_t = 0) {
+    _levels.pop_back();
+    _os.Put(']');
+    return true;
+  }
+
+private:
+  struct Level {
+    bool inObject;
+    size_t count;
+    bool expectValue; // a key was written, its value comes next
+  };
+
+  // Separator before a key, an array element or (after a key) a value
+  void Prefix() {
+    if (_levels.empty())
+      return;
+    Level &level = _levels.back();
+    if (level.expectValue) {
+      _os.Put(':');
+      level.expectValue = false;
+      return;
+    }
+    if (level.count++ > 0)
+      _os.Put(',');
+  }
+
+  bool Raw(const char *s, size_t n) {
+    Prefix();
+    for (size_t i = 0; i < n; i++)
+      _os.Put(s[i]);
+    return true;
+  }
+  void PutRaw(const char *s) {
+    for (; *s; s++)
+      _os.Put(*s);
+  }
+
+  OutputStream &_os;
+  std::vector<Level> _levels;
 };
 
 } // namespace rapidjson
@@ -0,0 +1,151 @@
+// local_evaluator_test.cpp - LocalEvaluator against results recorded from packages/evaluator
+//
+// Usage: local_evaluator_test corpus/local_evaluator
+//
+// cases.json holds definitions and contexts; expected.json is what the server
+// evaluator returns for each context (see record.js there). Every flag must
+// come out with the same state, variant and value, and the murmur3 rollout
+// buckets must be the server's.
+#include "GatrixLocalEvaluator.h"
+#include "gatrix_test.h"
+#include "json/stringbuffer.h"
+#include "json/writer.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace gatrix;
+
+namespace {
+
+std::string corpusDir;
+
+bool loadJson(const std::string& name, rapidjson::Document& doc) {
+  std::ifstream in(corpusDir + "/" + name, std::ios::binary);
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  doc.Parse(text.c_str());
+  if (text.empty() || doc.HasParseError()) {
+    ::gatrix::test::fail(__FILE__, __LINE__, "cannot parse " + corpusDir + "/" + name);
+    return false;
+  }
+  return true;
+}
+
+/** The value as FeaturesClient stores it when the same record arrives from the server */
+std::string clientValue(const rapidjson::Value& value) {
+  if (value.IsString())
+    return value.GetString();
+  if (value.IsNumber())
+    return std::to_string(value.GetDouble());
+  if (value.IsBool())
+    return value.GetBool() ? "true" : "false";
+  if (value.IsObject() || value.IsArray()) {
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+    value.Accept(w);
+    return sb.GetString();
+  }
+  return "";
+}
+
+GatrixContext toContext(const rapidjson::Value& json) {
+  GatrixContext context;
+  if (json.HasMember("userId"))
+    context.userId = json["userId"].GetString();
+  if (json.HasMember("sessionId"))
+    context.sessionId = json["sessionId"].GetString();
+  if (json.HasMember("properties")) {
+    for (auto it = json["properties"].MemberBegin(); it != json["properties"].MemberEnd(); ++it)
+      context.properties[it->name.GetString()] = it->value.GetString();
+  }
+  return context;
+}
+
+std::string describe(const rapidjson::Value& json) {
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+  json.Accept(w);
+  return sb.GetString();
+}
+
+} // namespace
+
+TEST(matches_recorded_server_evaluations) {
+  rapidjson::Document cases;
+  rapidjson::Document expected;
+  if (!loadJson("cases.json", cases) || !loadJson("expected.json", expected))
+    return;
+
+  LocalEvaluator evaluator;
+  std::string error;
+  CHECK(evaluator.load(cases["definitions"], error));
+  CHECK_EQ(error, std::string());
+
+  size_t compared = 0;
+  for (const auto& recorded : expected["cases"].GetArray()) {
+    std::map<std::string, EvaluatedFlag> local =
+        evaluator.evaluateAll(toContext(recorded["context"]));
+    std::string where = describe(recorded["context"]);
+    CHECK_EQ(local.size(), static_cast<size_t>(recorded["flags"].Size()));
+
+    for (const auto& server : recorded["flags"].GetArray()) {
+      std::string name = server["name"].GetString();
+      auto it = local.find(name);
+      if (it == local.end()) {
+        ::gatrix::test::fail(__FILE__, __LINE__, name + " missing for " + where);
+        continue;
+      }
+      const EvaluatedFlag& flag = it->second;
+      const rapidjson::Value& variant = server["variant"];
+
+      bool same = flag.enabled == server["enabled"].GetBool() &&
+                  flag.version == server["version"].GetInt() &&
+                  flag.impressionData == server.HasMember("impressionData");
+      // A "random" record: the server rolled Math.random(), so only the flag state is comparable
+      if (!server.HasMember("random")) {
+        same = same && flag.variant.name == variant["name"].GetString() &&
+               flag.variant.enabled == variant["enabled"].GetBool() &&
+               flag.variant.value == clientValue(variant["value"]);
+      }
+      if (!same) {
+        ::gatrix::test::fail(__FILE__, __LINE__,
+                             name + " for " + where + ": local " +
+                                 (flag.enabled ? "on " : "off ") + flag.variant.name + "=" +
+                                 flag.variant.value + ", server " + describe(server));
+      }
+      compared++;
+    }
+  }
+  CHECK(compared > 1000);
+}
+
+TEST(murmur3_matches_server_hash) {
+  rapidjson::Document expected;
+  if (!loadJson("expected.json", expected))
+    return;
+  // Published MurmurHash3 x86_32 reference vectors
+  CHECK_EQ(murmurHash3(""), 0u);
+  CHECK_EQ(murmurHash3("The quick brown fox jumps over the lazy dog"), 0x2e4ff723u);
+  for (const auto& probe : expected["murmur3"].GetArray()) {
+    CHECK_EQ(murmurHash3(probe["key"].GetString()),
+             static_cast<uint32_t>(probe["hash"].GetInt64()));
+  }
+}
+
+TEST(rollout_buckets_match_server) {
+  rapidjson::Document expected;
+  if (!loadJson("expected.json", expected))
+    return;
+  for (const auto& bucket : expected["buckets"].GetArray()) {
+    // normalizedStrategyValue(id, groupId): (murmur3("groupId:id") % 10001) / 100
+    std::string key =
+        std::string(bucket["groupId"].GetString()) + ":" + bucket["id"].GetString();
+    double local = (murmurHash3(key) % 10001) / 100.0;
+    CHECK_EQ(local, bucket["value"].GetDouble());
+  }
+}
+
+int main(int argc, char** argv) {
+  corpusDir = argc > 1 ? argv[1] : "corpus/local_evaluator";
+  return ::gatrix::test::runAll();
+}
@@ -10,6 +10,7 @@
 namespace cocos2d {
 namespace network {
 
+class HttpClient;
 class HttpResponse;
 
 class HttpRequest {
@@ -19,7 +20,7 @@ public:
   void setRequestType(Type) {}
   void setHeaders(const std::vector<std::string> &) {}
   void setRequestData(const char *, size_t) {}
-  void setResponseCallback(std::function<void(void *, HttpResponse *)>) {}
+  void setResponseCallback(std::function<void(HttpClient *, HttpResponse *)>) {}
   void release() {}
 };
 
@@ -29,6 +30,7 @@ public:
   long getResponseCode() const { return 200; }
   std::vector<char> *getResponseData() { return &_data; }
   std::vector<char> *getResponseHeader() { return &_header; }
+  const char *getErrorBuffer() const { return ""; }
 
 private:
   std::vector<char> _data;
@@ -42,6 +44,7 @@ public:
     return &instance;
   }
   void send(HttpRequest *) {}
+  void sendImmediate(HttpRequest *) {}
 };
 
 } // namespace network
@@ -0,0 +1,75 @@
+// Stub network/WebSocket.h for building and testing the SDK without Cocos2d-x
+//
+// No connection is made: init() records the URL and protocols, and a test plays
+// the server by calling the delegate (as the network thread would) through
+// WebSocket::latest().
+#ifndef CC_WEBSOCKET_H
+#define CC_WEBSOCKET_H
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace cocos2d {
+namespace network {
+
+class WebSocket {
+public:
+  struct Data {
+    char *bytes = nullptr;
+    ssize_t len = 0;
+    ssize_t issued = 0;
+    bool isBinary = false;
+  };
+
+  enum class ErrorCode { TIME_OUT, CONNECTION_FAILURE, UNKNOWN };
+
+  class Delegate {
+  public:
+    virtual ~Delegate() {}
+    virtual void onOpen(WebSocket *ws) = 0;
+    virtual void onMessage(WebSocket *ws, const Data &data) = 0;
+    virtual void onClose(WebSocket *ws) = 0;
+    virtual void onError(WebSocket *ws, const ErrorCode &error) = 0;
+  };
+
+  WebSocket() { latest() = this; }
+
+  bool init(Delegate &delegate, const std::string &url,
+            const std::vector<std::string> *protocols = nullptr) {
+    _delegate = &delegate;
+    _url = url;
+    if (protocols)
+      _protocols = *protocols;
+    return true;
+  }
+
+  void send(const std::string &message) { _sent.push_back(message); }
+
+  /** The real close() deletes the socket once the connection is down; the stub keeps it */
+  void close() { _closed = true; }
+
+  Delegate *getDelegate() const { return _delegate; }
+
+  // Test access
+  static WebSocket *&latest() {
+    static WebSocket *socket = nullptr;
+    return socket;
+  }
+  const std::string &url() const { return _url; }
+  const std::vector<std::string> &protocols() const { return _protocols; }
+  const std::vector<std::string> &sent() const { return _sent; }
+  bool closed() const { return _closed; }
+
+private:
+  Delegate *_delegate = nullptr;
+  std::string _url;
+  std::vector<std::string> _protocols;
+  std::vector<std::string> _sent;
+  bool _closed = false;
+};
+
+} // namespace network
+} // namespace cocos2d
+
+#endif
@@ -0,0 +1,255 @@
+// push_payload_test.cpp - Pushed flag records: malformed ones fall back, applied ones move since=
+//
+// FeaturesClient runs with streaming.pushPayload and delta sync against
+// TestServer (test_server.h), which answers fetches when the test says so and
+// serves an SSE stream the test writes to. The stream is read on the
+// streaming thread; the test thread is the cocos thread.
+#include "GatrixFeaturesClient.h"
+#include "GatrixSha256.h"
+#include "cocos2d.h"
+#include "gatrix_test.h"
+#include "test_server.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace gatrix;
+using gatrix::test::TestServer;
+
+namespace {
+
+GatrixClientConfig makeConfig(const std::string& appName) {
+  GatrixClientConfig config;
+  config.apiUrl = "https://edge.test/api/v1";
+  config.apiToken = "token";
+  config.appName = appName;
+  config.features.explicitSyncMode = false; // reads see pushes as they are applied
+  config.features.enableDeltaSync = true;
+  config.features.streaming.enabled = true;
+  config.features.streaming.pushPayload = true;
+  return config;
+}
+
+/** Runs cocos frames until done() holds; false after 10s of wall time */
+template <typename Pred> bool pumpUntil(Pred done) {
+  auto scheduler = cocos2d::Director::getInstance()->getScheduler();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    scheduler->update(0.05f);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+std::string flagsChanged(long revision, const std::string& records) {
+  return "{\"globalRevision\":" + std::to_string(revision) +
+         ",\"changedKeys\":[\"a\"],\"flags\":[" + records + "]}";
+}
+
+bool enabled(const FeaturesClient& client, const std::string& name) {
+  for (const auto& flag : client.getAllFlags()) {
+    if (flag.name == name)
+      return flag.enabled;
+  }
+  return false;
+}
+
+bool contains(const std::string& haystack, const std::string& needle) {
+  return haystack.find(needle) != std::string::npos;
+}
+
+/** Value of a request header, empty if absent */
+std::string header(const TransportRequest& request, const std::string& name) {
+  const std::string prefix = name + ": ";
+  for (const auto& line : request.headers) {
+    if (line.compare(0, prefix.size(), prefix) == 0)
+      return line.substr(prefix.size());
+  }
+  return "";
+}
+
+/** Started, with the initial fetch answered at revision 5 and the stream connected at basis */
+struct Fixture {
+  GatrixClientConfig config;
+  GatrixEventEmitter emitter;
+  TestServer server;
+  FeaturesClient client;
+
+  Fixture(const std::string& appName, long streamRevision)
+      : config(makeConfig(appName)), client(config, emitter) {
+    client.setTransport(&server);
+    client.start();
+    server.respond("{\"success\":true,\"data\":{\"revision\":5,"
+                   "\"flags\":[{\"name\":\"a\",\"enabled\":false}]}}",
+                   "HTTP/1.1 200 OK\r\nETag: \"server-5\"\r\n");
+    server.event("connected", "{\"globalRevision\":" + std::to_string(streamRevision) + "}");
+  }
+};
+
+} // namespace
+
+TEST(contiguous_push_advances_delta_basis) {
+  Fixture f("push-advance", 5);
+  CHECK_EQ(f.client.getStats().syncRevision, 5LL);
+
+  f.server.event("flags_changed", flagsChanged(6, "{\"name\":\"a\",\"enabled\":true}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 1; }));
+  CHECK(enabled(f.client, "a"));
+  CHECK_EQ(f.client.getStats().syncRevision, 6LL);
+
+  // Revision 6 is in the snapshot: the next delta starts after it
+  int before = f.server.fetches();
+  f.client.fetchFlags();
+  CHECK_EQ(f.server.fetches(), before + 1);
+  CHECK(contains(f.server.last().url, "since=6"));
+}
+
+TEST(push_reports_publish_to_apply_latency) {
+  Fixture f("push-latency", 5);
+  auto epochMs = [] {
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::system_clock::now().time_since_epoch())
+                                      .count());
+  };
+
+  // Published 250ms ago by the server's clock
+  long long sentAt = epochMs();
+  f.server.event("flags_changed",
+                 "{\"globalRevision\":6,\"changedKeys\":[\"a\"],\"timestamp\":" +
+                     std::to_string(sentAt - 250) +
+                     ",\"flags\":[{\"name\":\"a\",\"enabled\":true}]}");
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 1; }));
+  long long appliedBy = epochMs();
+
+  long long latency = f.client.getStats().lastPushLatencyMs;
+  CHECK(latency >= 250);
+  CHECK(latency <= appliedBy - sentAt + 250);
+}
+
+TEST(push_after_unfetched_revision_keeps_basis) {
+  // The stream starts at 6, which the snapshot (revision 5) does not include
+  Fixture f("push-keep", 6);
+  f.server.event("flags_changed", flagsChanged(7, "{\"name\":\"a\",\"enabled\":true}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 1; }));
+  CHECK_EQ(f.client.getStats().syncRevision, 5LL);
+
+  f.client.fetchFlags();
+  CHECK(contains(f.server.last().url, "since=5"));
+}
+
+TEST(unchanged_push_emits_nothing) {
+  Fixture f("push-unchanged", 5);
+  int changes = 0;
+  f.emitter.on(EVENTS::FLAGS_CHANGE, [&changes](const std::vector<std::string>&) { changes++; });
+
+  // The same record the snapshot already holds
+  f.server.event("flags_changed", flagsChanged(6, "{\"name\":\"a\",\"enabled\":false}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 1; }));
+  CHECK_EQ(changes, 0);
+
+  f.server.event("flags_changed", flagsChanged(7, "{\"name\":\"a\",\"enabled\":true}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 2; }));
+  CHECK_EQ(changes, 1);
+}
+
+TEST(flag_generation_slots_created_while_pushes_apply) {
+  Fixture f("push-generation", 5);
+  const std::atomic<uint64_t>& a = f.client.getFlagGeneration("a");
+
+  // Another thread keeps creating slots while each push walks them on the cocos thread
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    for (int i = 0; !done.load(); i++)
+      f.client.getFlagGeneration("flag-" + std::to_string(i % 512));
+  });
+  for (int i = 0; i < 20; i++) {
+    std::string record = std::string("{\"name\":\"a\",\"enabled\":") +
+                         (i % 2 == 0 ? "true" : "false") + "}";
+    f.server.event("flags_changed", flagsChanged(6 + i, record));
+    CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == i + 1; }));
+  }
+  done = true;
+  reader.join();
+  CHECK_EQ(a.load(), f.client.getGeneration());
+}
+
+TEST(push_recomputes_edge_etag) {
+  Fixture f("push-etag", 5);
+  CHECK_EQ(f.client.getStats().etag, std::string("\"server-5\""));
+
+  // An unchanged record keeps the server's ETag: it still names the cached state
+  f.server.event("flags_changed", flagsChanged(6, "{\"name\":\"a\",\"enabled\":false}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 1; }));
+  CHECK_EQ(f.client.getStats().etag, std::string("\"server-5\""));
+
+  // A merge yields the edge's ETag for the merged set, and polling stays conditional
+  f.server.event("flags_changed", flagsChanged(7, "{\"name\":\"a\",\"enabled\":true}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 2; }));
+  f.client.fetchFlags();
+  std::string contextHash = header(f.server.last(), "X-Gatrix-Context-Hash");
+  std::string expected =
+      "\"" + Sha256().update(contextHash + "|a:0:true:no-variant").hexDigest() + "\"";
+  CHECK_EQ(f.client.getStats().etag, expected);
+  CHECK_EQ(header(f.server.last(), "If-None-Match"), expected);
+}
+
+TEST(late_joiner_checks_its_own_revision) {
+  Fixture f("push-late", 5);
+  f.server.event("flags_changed", flagsChanged(6, "{\"name\":\"a\",\"enabled\":true}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 1; }));
+
+  // A second instance joins the shared stream at revision 6; its start fetch doubles as the
+  // resync it is asked for, and answers from a replica still at revision 5
+  GatrixClientConfig config = makeConfig("push-late");
+  GatrixEventEmitter emitter;
+  FeaturesClient late(config, emitter);
+  late.setTransport(&f.server);
+  int before = f.server.fetches();
+  late.start();
+  CHECK_EQ(f.server.fetches(), before + 1);
+  f.server.respond("{\"success\":true,\"data\":{\"revision\":5,"
+                   "\"flags\":[{\"name\":\"a\",\"enabled\":false}]}}");
+
+  // Revision 7 follows the stream's 6 but not the snapshot: only the first instance applies it
+  f.server.event("flags_changed", flagsChanged(7, "{\"name\":\"b\",\"enabled\":true}"));
+  CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadAppliedCount == 2; }));
+  CHECK_EQ(late.getStats().pushPayloadAppliedCount, 0);
+  CHECK_EQ(late.getStats().pushPayloadFallbackCount, 1);
+
+  // It fetches from its own basis, which brings in revision 6 as well
+  CHECK(pumpUntil([&] { return f.server.fetches() == before + 2; }));
+  CHECK(contains(f.server.last().url, "since=5"));
+}
+
+TEST(malformed_pushed_record_falls_back_to_fetch) {
+  Fixture f("push-malformed", 5);
+  int before = f.server.fetches();
+
+  // Wrongly typed members; each is rejected without touching the flags
+  const char* records[] = {
+      "{\"name\":1,\"enabled\":true}",
+      "{\"name\":\"a\",\"enabled\":\"yes\"}",
+      "{\"name\":\"a\",\"enabled\":true,\"version\":\"2\"}",
+      "{\"name\":\"a\",\"enabled\":true,\"variant\":{\"name\":3,\"enabled\":true}}",
+      "\"a\"",
+  };
+  int fallbacks = 0;
+  long revision = 6;
+  for (const char* record : records) {
+    f.server.event("flags_changed", flagsChanged(revision++, record));
+    CHECK(pumpUntil([&] { return f.client.getStats().pushPayloadFallbackCount == fallbacks + 1; }));
+    fallbacks++;
+  }
+  CHECK_EQ(f.client.getStats().pushPayloadAppliedCount, 0);
+  CHECK(!enabled(f.client, "a"));
+  CHECK_EQ(f.client.getStats().syncRevision, 5LL);
+
+  // The invalidation path fetches instead, from the unchanged basis
+  CHECK(pumpUntil([&] { return f.server.fetches() == before + 1; }));
+  CHECK(contains(f.server.last().url, "since=5"));
+}
+
+GATRIX_TEST_MAIN
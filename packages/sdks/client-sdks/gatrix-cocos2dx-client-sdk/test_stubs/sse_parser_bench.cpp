@@ -0,0 +1,73 @@
+// sse_parser_bench.cpp - SseParser throughput on a synthetic flags_changed stream
+//
+// Usage: sse_parser_bench [streamMiB=64] [repeats=5]
+//
+// Builds a stream of realistic flags_changed events (id, event, one JSON data
+// line, an occasional heartbeat comment) and feeds it in chunks of several
+// sizes, as the socket would deliver it. Prints the best of `repeats` runs.
+// Recorded results live in BENCHMARKS.md.
+#include "GatrixSseParser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using gatrix::SseParser;
+using gatrix::SseView;
+
+namespace {
+
+std::string buildStream(size_t targetBytes) {
+  std::string stream;
+  stream.reserve(targetBytes + 512);
+  for (unsigned revision = 1; stream.size() < targetBytes; revision++) {
+    std::string rev = std::to_string(revision);
+    stream += "id: " + rev + "\n";
+    stream += "event: flags_changed\n";
+    stream += "data: {\"environmentId\":\"env-production\",\"revision\":" + rev +
+              ",\"changedKeys\":[\"checkout-v2\",\"banner-spring-sale\",\"price-test-" + rev +
+              "\"],\"timestamp\":1760000000" + rev + "}\n\n";
+    if (revision % 16 == 0)
+      stream += ": heartbeat\n\n";
+  }
+  return stream;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  size_t mib = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 64;
+  int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+  std::string stream = buildStream(mib * 1024 * 1024);
+
+  const size_t chunkSizes[] = {16 * 1024, 1460, 64};
+  std::printf("stream: %.1f MiB\n", stream.size() / (1024.0 * 1024.0));
+  for (size_t chunk : chunkSizes) {
+    double best = 0;
+    size_t events = 0;
+    for (int r = 0; r < repeats; r++) {
+      SseParser parser;
+      events = 0;
+      size_t bytes = 0;
+      auto onEvent = [&events, &bytes](SseView, SseView data) {
+        events++;
+        bytes += data.size;
+      };
+      auto start = std::chrono::steady_clock::now();
+      for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+        size_t n = stream.size() - pos < chunk ? stream.size() - pos : chunk;
+        parser.feed(stream.data() + pos, n, onEvent);
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      double mibPerSec = stream.size() / (1024.0 * 1024.0) / elapsed.count();
+      if (mibPerSec > best)
+        best = mibPerSec;
+      if (bytes == 0)
+        return 1; // keeps the callback from being optimized away
+    }
+    std::printf("chunk %6zu B: %8.1f MiB/s  %8.2f M events/s\n", chunk, best,
+                best * 1024 * 1024 / stream.size() * events / 1e6);
+  }
+  return 0;
+}
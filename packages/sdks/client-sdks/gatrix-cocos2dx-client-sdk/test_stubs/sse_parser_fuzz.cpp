@@ -0,0 +1,107 @@
+// sse_parser_fuzz.cpp - SseParser fuzz target
+//
+// With -DGATRIX_LIBFUZZER=ON (clang) this is a libFuzzer target; seed it with
+// corpus/sse. Otherwise main() replays the given files plus every truncation
+// and a fixed set of byte mutations of each, so the checks run under ctest.
+//
+// Checks: the events seen do not depend on how the input is chunked, and the
+// parser never holds more than carry + event data + event type, each capped
+// at maxEventBytes.
+#include "GatrixSseParser.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using gatrix::SseParser;
+using gatrix::SseView;
+
+namespace {
+
+struct Outcome {
+  std::string events;
+  std::string lastEventId;
+  int retryMs;
+  size_t dropped;
+};
+
+Outcome parse(const uint8_t* data, size_t size, size_t maxEventBytes, size_t chunk) {
+  SseParser parser(maxEventBytes);
+  Outcome outcome;
+  auto onEvent = [&outcome](SseView type, SseView payload) {
+    outcome.events.append(type.data, type.size);
+    outcome.events.push_back('\0');
+    outcome.events.append(payload.data, payload.size);
+    outcome.events.push_back('\0');
+  };
+  for (size_t pos = 0; pos < size; pos += chunk) {
+    size_t n = size - pos < chunk ? size - pos : chunk;
+    parser.feed(reinterpret_cast<const char*>(data) + pos, n, onEvent);
+    if (parser.bufferedBytes() > 3 * maxEventBytes) {
+      std::fprintf(stderr, "buffered %zu bytes with maxEventBytes %zu\n", parser.bufferedBytes(),
+                   maxEventBytes);
+      std::abort();
+    }
+  }
+  outcome.lastEventId = parser.lastEventId();
+  outcome.retryMs = parser.retryMs();
+  outcome.dropped = parser.droppedEventCount();
+  return outcome;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size < 2)
+    return 0;
+  // The first two bytes pick the event limit and the chunk size
+  size_t maxEventBytes = 1 + data[0] % 64;
+  size_t chunk = 1 + data[1] % 32;
+  data += 2;
+  size -= 2;
+
+  Outcome whole = parse(data, size, maxEventBytes, size ? size : 1);
+  Outcome chunked = parse(data, size, maxEventBytes, chunk);
+  if (whole.events != chunked.events || whole.lastEventId != chunked.lastEventId ||
+      whole.retryMs != chunked.retryMs || whole.dropped != chunked.dropped) {
+    std::fprintf(stderr, "chunk size %zu changed the outcome\n", chunk);
+    std::abort();
+  }
+  return 0;
+}
+
+#ifndef GATRIX_LIBFUZZER
+int main(int argc, char** argv) {
+  size_t runs = 0;
+  for (int i = 1; i < argc; i++) {
+    std::ifstream in(argv[i], std::ios::binary);
+    if (!in) {
+      std::fprintf(stderr, "cannot read %s\n", argv[i]);
+      return 1;
+    }
+    std::string seed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    for (unsigned limit = 0; limit < 64; limit += 7) {
+      for (unsigned chunk = 0; chunk < 32; chunk += 3) {
+        std::string input = std::string(1, static_cast<char>(limit)) +
+                            std::string(1, static_cast<char>(chunk)) + seed;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(input.data());
+        for (size_t cut = 2; cut <= input.size(); cut++, runs++)
+          LLVMFuzzerTestOneInput(bytes, cut);
+        // Flip each byte to a structural character in turn
+        for (size_t at = 2; at < input.size(); at++) {
+          std::string mutated = input;
+          mutated[at] = "\n\r: "[at % 4];
+          LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(mutated.data()),
+                                 mutated.size());
+          runs++;
+        }
+      }
+    }
+  }
+  std::printf("%zu inputs, no failures\n", runs);
+  return 0;
+}
+#endif
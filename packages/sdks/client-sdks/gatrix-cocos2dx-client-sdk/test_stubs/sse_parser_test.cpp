@@ -0,0 +1,265 @@
+// sse_parser_test.cpp - SseParser corpus replay and chunking properties
+//
+// Usage: sse_parser_test [corpus/sse/NAME.sse ...]
+//
+// Every NAME.sse is replayed whole, byte by byte and in seeded random chunks,
+// and the transcript must equal NAME.events. The transcript lists one
+// "event <type>\t<data>" line per dispatched event (data escaped), followed by
+// "state id|retry|dropped" lines; an optional leading "max <n>" line sets
+// maxEventBytes.
+#include "GatrixSseParser.h"
+#include "gatrix_test.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+using gatrix::SseParser;
+using gatrix::SseView;
+
+namespace {
+
+/** splitmix64: the same sequence on every platform, unlike <random> distributions */
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  size_t below(size_t n) { return n == 0 ? 0 : static_cast<size_t>(next() % n); }
+};
+
+std::string escape(const std::string& s) {
+  static const char* hex = "0123456789abcdef";
+  std::string out;
+  for (unsigned char c : s) {
+    if (c == '\\')
+      out += "\\\\";
+    else if (c == '\n')
+      out += "\\n";
+    else if (c == '\r')
+      out += "\\r";
+    else if (c == '\t')
+      out += "\\t";
+    else if (c < 0x20 || c == 0x7F) {
+      out += "\\x";
+      out += hex[c >> 4];
+      out += hex[c & 0xF];
+    } else
+      out += static_cast<char>(c);
+  }
+  return out;
+}
+
+/** Feeds input in the given chunk sizes (the last chunk takes the rest) */
+std::string transcript(const std::string& input, size_t maxEventBytes,
+                       const std::vector<size_t>& chunks, size_t* peakBuffered = nullptr) {
+  SseParser parser(maxEventBytes);
+  std::string out;
+  auto onEvent = [&out](SseView type, SseView data) {
+    out += "event " + type.str() + "\t" + escape(data.str()) + "\n";
+  };
+  size_t pos = 0;
+  size_t peak = 0;
+  for (size_t i = 0; pos < input.size(); i++) {
+    size_t n = i < chunks.size() ? chunks[i] : input.size() - pos;
+    if (n > input.size() - pos)
+      n = input.size() - pos;
+    parser.feed(input.data() + pos, n, onEvent);
+    pos += n;
+    if (parser.bufferedBytes() > peak)
+      peak = parser.bufferedBytes();
+  }
+  if (peakBuffered)
+    *peakBuffered = peak;
+  out += "state id " + escape(parser.lastEventId()) + "\n";
+  out += "state retry " + std::to_string(parser.retryMs()) + "\n";
+  out += "state dropped " + std::to_string(parser.droppedEventCount()) + "\n";
+  return out;
+}
+
+std::vector<size_t> bytewise(const std::string& input) {
+  return std::vector<size_t>(input.size(), 1);
+}
+
+std::vector<size_t> randomChunks(const std::string& input, Rng& rng, size_t maxChunk) {
+  std::vector<size_t> chunks;
+  for (size_t total = 0; total < input.size();) {
+    size_t n = 1 + rng.below(maxChunk);
+    chunks.push_back(n);
+    total += n;
+  }
+  return chunks;
+}
+
+bool readFile(const std::string& path, std::string& out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return true;
+}
+
+void replayCorpusFile(const std::string& ssePath) {
+  std::string input;
+  std::string expected;
+  std::string eventsPath = ssePath.substr(0, ssePath.size() - 4) + ".events";
+  if (!readFile(ssePath, input) || !readFile(eventsPath, expected)) {
+    ::gatrix::test::fail(__FILE__, __LINE__, "cannot read " + ssePath + " / " + eventsPath);
+    return;
+  }
+  size_t maxEventBytes = SseParser::DEFAULT_MAX_EVENT_BYTES;
+  if (expected.compare(0, 4, "max ") == 0) {
+    size_t eol = expected.find('\n');
+    maxEventBytes = std::stoul(expected.substr(4, eol - 4));
+    expected.erase(0, eol + 1);
+  }
+
+  CHECK_EQ(transcript(input, maxEventBytes, {}), expected);
+  CHECK_EQ(transcript(input, maxEventBytes, bytewise(input)), expected);
+  Rng rng(0x55E);
+  for (int round = 0; round < 200; round++) {
+    CHECK_EQ(transcript(input, maxEventBytes, randomChunks(input, rng, 16)), expected);
+  }
+}
+
+// --- Generated streams ---------------------------------------------------
+
+struct ModelEvent {
+  std::string type; // empty: "message"
+  std::string data;
+};
+
+/** A valid stream plus the transcript a conforming parser must produce for it */
+void generateStream(Rng& rng, std::string& stream, std::string& expected) {
+  static const char* types[] = {"", "flags_changed", "connected", "heartbeat"};
+  static const char dataChars[] = "abcXYZ019 {}[]\":,\\/\t\xC3\xA9";
+  std::vector<ModelEvent> events;
+  std::string lastId;
+  int retry = -1;
+  const char* eol = rng.below(2) ? "\r\n" : "\n";
+
+  size_t count = 1 + rng.below(12);
+  for (size_t e = 0; e < count; e++) {
+    if (rng.below(4) == 0)
+      stream += std::string(": keep-alive") + eol;
+    if (rng.below(6) == 0) {
+      retry = static_cast<int>(rng.below(60000));
+      stream += "retry: " + std::to_string(retry) + eol;
+    }
+    ModelEvent event;
+    event.type = types[rng.below(4)];
+    if (!event.type.empty())
+      stream += "event: " + event.type + eol;
+    if (rng.below(3) == 0) {
+      lastId = std::to_string(rng.below(1000000));
+      stream += "id: " + lastId + eol;
+    }
+    size_t lines = 1 + rng.below(4);
+    for (size_t l = 0; l < lines; l++) {
+      std::string line;
+      size_t len = rng.below(40);
+      for (size_t i = 0; i < len; i++)
+        line += dataChars[rng.below(sizeof(dataChars) - 1)];
+      bool spaced = rng.below(2) == 0;
+      stream += (spaced ? "data: " : "data:") + line + eol;
+      if (!spaced && !line.empty() && line[0] == ' ')
+        line.erase(0, 1); // the one space after the colon is not part of the value
+      if (l > 0)
+        event.data += "\n";
+      event.data += line;
+    }
+    stream += eol;
+    events.push_back(event);
+  }
+
+  expected.clear();
+  for (const auto& event : events) {
+    expected += "event " + (event.type.empty() ? std::string("message") : event.type) + "\t" +
+                escape(event.data) + "\n";
+  }
+  expected += "state id " + escape(lastId) + "\n";
+  expected += "state retry " + std::to_string(retry) + "\n";
+  expected += "state dropped 0\n";
+}
+
+/** Bytes biased towards SSE syntax so that random input reaches every branch */
+std::string noise(Rng& rng, size_t len) {
+  static const char* pieces[] = {"data", "event", "id", "retry", ":", ": ", " ", "\n",
+                                 "\r\n", "\r", "\n\n", "x", "123", "\xEF\xBB\xBF", "yy"};
+  std::string out;
+  while (out.size() < len)
+    out += pieces[rng.below(sizeof(pieces) / sizeof(pieces[0]))];
+  return out;
+}
+
+} // namespace
+
+TEST(generated_streams_parse_identically_under_any_chunking) {
+  Rng rng(2024);
+  for (int round = 0; round < 500; round++) {
+    std::string stream;
+    std::string expected;
+    generateStream(rng, stream, expected);
+    CHECK_EQ(transcript(stream, SseParser::DEFAULT_MAX_EVENT_BYTES, {}), expected);
+    CHECK_EQ(transcript(stream, SseParser::DEFAULT_MAX_EVENT_BYTES, bytewise(stream)),
+             expected);
+    CHECK_EQ(transcript(stream, SseParser::DEFAULT_MAX_EVENT_BYTES,
+                        randomChunks(stream, rng, 64)),
+             expected);
+  }
+}
+
+TEST(noise_is_chunking_independent_and_bounded) {
+  Rng rng(7);
+  for (int round = 0; round < 2000; round++) {
+    size_t maxEventBytes = 1 + rng.below(48);
+    std::string input = noise(rng, rng.below(400));
+    std::string whole = transcript(input, maxEventBytes, {});
+    size_t peak = 0;
+    CHECK_EQ(transcript(input, maxEventBytes, randomChunks(input, rng, 24), &peak), whole);
+    // carry, pending data and event type are each capped at maxEventBytes
+    CHECK(peak <= 3 * maxEventBytes);
+    CHECK_EQ(transcript(input, maxEventBytes, bytewise(input), &peak), whole);
+    CHECK(peak <= 3 * maxEventBytes);
+  }
+}
+
+TEST(oversized_line_split_anywhere_drops_only_its_event) {
+  std::string input = "data: a\n\ndata: " + std::string(100, 'z') + "\n\ndata: b\n\n";
+  std::string expected = "event message\ta\nevent message\tb\n"
+                         "state id \nstate retry -1\nstate dropped 1\n";
+  for (size_t split = 1; split < input.size(); split++) {
+    CHECK_EQ(transcript(input, 32, {split}), expected);
+  }
+}
+
+TEST(reset_drops_partial_event_and_keeps_last_event_id) {
+  SseParser parser;
+  std::vector<std::string> seen;
+  auto onEvent = [&seen](SseView, SseView data) { seen.push_back(data.str()); };
+  std::string first = "id: 7\ndata: one\n\ndata: partial";
+  parser.feed(first.data(), first.size(), onEvent);
+  CHECK(parser.bufferedBytes() > 0);
+  parser.reset();
+  CHECK_EQ(parser.bufferedBytes(), 0u);
+  CHECK_EQ(parser.lastEventId(), std::string("7"));
+  // The BOM check applies again after a reconnect
+  std::string second = "\xEF\xBB\xBF" "data: two\n\n";
+  parser.feed(second.data(), second.size(), onEvent);
+  CHECK_EQ(seen.size(), 2u);
+  CHECK_EQ(seen.back(), std::string("two"));
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    std::string path = argv[i];
+    std::string name = "corpus:" + path.substr(path.find_last_of("/\\") + 1);
+    ::gatrix::test::cases().push_back(
+        ::gatrix::test::Case{name, [path]() { replayCorpusFile(path); }});
+  }
+  return ::gatrix::test::runAll();
+}
@@ -0,0 +1,195 @@
+// sse_reader_test.cpp - SseReader against a loopback HTTP server
+#include "GatrixSseReader.h"
+#include "gatrix_test.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using gatrix::SseReader;
+
+namespace {
+
+/** Serves exactly one connection: reads the request, then runs the script on the socket */
+class LoopbackServer {
+public:
+  using Script = std::function<void(int fd)>;
+
+  explicit LoopbackServer(Script script) {
+    _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(_listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+    _port = ntohs(addr.sin_port);
+    listen(_listenFd, 1);
+    _thread = std::thread([this, script]() {
+      int fd = accept(_listenFd, nullptr, nullptr);
+      if (fd < 0)
+        return;
+      char buf[1024];
+      while (_request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0)
+          break;
+        _request.append(buf, static_cast<size_t>(n));
+      }
+      script(fd);
+      close(fd);
+    });
+  }
+
+  ~LoopbackServer() {
+    shutdown(_listenFd, SHUT_RDWR);
+    _thread.join();
+    close(_listenFd);
+  }
+
+  std::string url() const { return "http://127.0.0.1:" + std::to_string(_port) + "/stream"; }
+  /** Valid once run() has returned */
+  const std::string& request() const { return _request; }
+
+private:
+  int _listenFd = -1;
+  int _port = 0;
+  std::string _request;
+  std::thread _thread;
+};
+
+void sendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0)
+      return;
+    sent += static_cast<size_t>(n);
+  }
+}
+
+const char* STREAM_HEADERS = "HTTP/1.1 200 OK\r\n"
+                             "Content-Type: text/event-stream\r\n"
+                             "Connection: close\r\n\r\n";
+
+/** One-shot signal between the server script and the reader callbacks */
+struct Latch {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool set = false;
+  void signal() {
+    std::lock_guard<std::mutex> lock(mutex);
+    set = true;
+    cv.notify_all();
+  }
+  bool wait(int seconds) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(seconds), [this]() { return set; });
+  }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TEST(delivers_chunks_while_the_stream_is_open) {
+  Latch firstEventSeen;
+  std::atomic<bool> serverStillOpen(false);
+  LoopbackServer server([&](int fd) {
+    sendAll(fd, STREAM_HEADERS);
+    sendAll(fd, "event: connected\ndata: {}\n\n");
+    // The second event is only sent once the first one reached the reader
+    serverStillOpen = firstEventSeen.wait(5);
+    sendAll(fd, "id: 1\nevent: flags_changed\ndata: {\"revision\":1}\n\n");
+  });
+
+  bool opened = false;
+  std::string received;
+  SseReader::Result result = SseReader::run(
+      server.url(), {"Accept: text/event-stream", "Last-Event-ID: 41"},
+      [&]() { opened = true; },
+      [&](const char* data, size_t len) {
+        received.append(data, len);
+        if (received.find("\n\n") != std::string::npos)
+          firstEventSeen.signal();
+      },
+      []() { return false; }, 10);
+
+  CHECK(opened);
+  CHECK(serverStillOpen);
+  CHECK(result.opened);
+  CHECK_EQ(result.statusCode, 200);
+  CHECK(!result.cancelled);
+  CHECK_EQ(result.error, std::string());
+  CHECK_EQ(received, std::string("event: connected\ndata: {}\n\n"
+                                 "id: 1\nevent: flags_changed\ndata: {\"revision\":1}\n\n"));
+  CHECK(server.request().find("Last-Event-ID: 41\r\n") != std::string::npos);
+}
+
+TEST(http_error_is_reported_without_body_delivery) {
+  LoopbackServer server([](int fd) {
+    sendAll(fd, "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 11\r\n"
+                "Connection: close\r\n\r\nunavailable");
+  });
+
+  bool opened = false;
+  size_t delivered = 0;
+  SseReader::Result result = SseReader::run(
+      server.url(), {}, [&]() { opened = true; },
+      [&](const char*, size_t len) { delivered += len; }, []() { return false; }, 10);
+
+  CHECK(!opened);
+  CHECK_EQ(delivered, 0u);
+  CHECK_EQ(result.statusCode, 503);
+  CHECK_EQ(result.error, std::string("SSE HTTP error: 503"));
+}
+
+TEST(cancel_stops_an_open_stream_without_error) {
+  Latch done;
+  LoopbackServer server([&](int fd) {
+    sendAll(fd, STREAM_HEADERS);
+    sendAll(fd, ": hello\n\n");
+    done.wait(10); // keep the connection open until the reader gives up
+  });
+
+  std::atomic<bool> cancel(false);
+  auto start = std::chrono::steady_clock::now();
+  SseReader::Result result = SseReader::run(
+      server.url(), {}, nullptr, [&](const char*, size_t) { cancel = true; },
+      [&]() { return cancel.load(); }, 30);
+  done.signal();
+
+  CHECK(result.opened);
+  CHECK(result.cancelled);
+  CHECK_EQ(result.error, std::string());
+  CHECK(secondsSince(start) < 5);
+}
+
+TEST(silent_stream_times_out) {
+  Latch done;
+  LoopbackServer server([&](int fd) {
+    sendAll(fd, STREAM_HEADERS);
+    done.wait(10);
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  SseReader::Result result =
+      SseReader::run(server.url(), {}, nullptr, nullptr, []() { return false; }, 1);
+  done.signal();
+
+  CHECK(result.opened);
+  CHECK(!result.cancelled);
+  CHECK(!result.error.empty());
+  CHECK(secondsSince(start) < 5);
+}
+
+GATRIX_TEST_MAIN
@@ -0,0 +1,287 @@
+// stream_codec_test.cpp - Binary streaming frames: round trips, wire vectors, malformed input
+//
+// The encoder below follows the frame grammar in GatrixStreamCodec.h; the
+// wire vectors are spelled out byte by byte so that a change on either side of
+// the grammar shows up here.
+#include "GatrixStreamCodec.h"
+#include "gatrix_test.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+using namespace gatrix;
+
+namespace {
+
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  size_t below(size_t n) { return n == 0 ? 0 : static_cast<size_t>(next() % n); }
+};
+
+/** What a server puts on the wire; type 0 carries the name */
+struct Frame {
+  int type = 2;
+  std::string name;
+  unsigned long long globalRevision = 0;
+  std::vector<std::string> changedKeys;
+  bool urgent = false;
+  bool resumed = false;
+  long long spreadWindowMs = -1;
+  bool hasBody = false;
+  std::string body;
+};
+
+void putUvarint(std::string& out, unsigned long long value) {
+  do {
+    unsigned char b = value & 0x7f;
+    value >>= 7;
+    out += static_cast<char>(value ? (b | 0x80) : b);
+  } while (value);
+}
+
+void putStr(std::string& out, const std::string& s) {
+  putUvarint(out, s.size());
+  out += s;
+}
+
+std::string encode(const Frame& f) {
+  std::string out;
+  out += static_cast<char>(1);
+  out += static_cast<char>(f.type);
+  out += static_cast<char>((f.urgent ? 1 : 0) | (f.spreadWindowMs >= 0 ? 2 : 0) |
+                           (f.hasBody ? 4 : 0) | (f.resumed ? 8 : 0));
+  if (f.type == 0)
+    putStr(out, f.name);
+  putUvarint(out, f.globalRevision);
+  putUvarint(out, f.changedKeys.size());
+  for (const auto& key : f.changedKeys)
+    putStr(out, key);
+  if (f.spreadWindowMs >= 0)
+    putUvarint(out, static_cast<unsigned long long>(f.spreadWindowMs));
+  if (f.hasBody)
+    putStr(out, f.body);
+  return out;
+}
+
+const char* const TYPE_NAMES[] = {"", "connected", "flags_changed", "heartbeat", "pong"};
+
+bool decode(const std::string& wire, BinaryStreamFrame& out) {
+  return StreamCodec::decode(wire.data(), wire.size(), out);
+}
+
+/** Checks that the decoded frame says what the encoded one did */
+void checkSame(const Frame& f, const BinaryStreamFrame& d) {
+  CHECK_EQ(d.type, std::string(f.type == 0 ? f.name : TYPE_NAMES[f.type]));
+  CHECK_EQ(d.globalRevision, static_cast<long long>(f.globalRevision));
+  CHECK(d.changedKeys == f.changedKeys);
+  CHECK_EQ(d.urgent, f.urgent);
+  CHECK_EQ(d.resumed, f.resumed);
+  CHECK_EQ(d.spreadWindowMs,
+           f.spreadWindowMs > INT_MAX ? INT_MAX : static_cast<int>(f.spreadWindowMs));
+  CHECK_EQ(d.body != nullptr, f.hasBody);
+  if (f.hasBody)
+    CHECK_EQ(std::string(d.body, d.bodyLength), f.body);
+}
+
+std::string randomString(Rng& rng, size_t maxLen) {
+  std::string s(rng.below(maxLen + 1), '\0');
+  for (auto& c : s)
+    c = static_cast<char>(rng.next() & 0xff);
+  return s;
+}
+
+/** Values that sit on LEB128 byte boundaries, plus anything in between */
+unsigned long long randomVarint(Rng& rng) {
+  static const unsigned long long edges[] = {0,       1,        127,        128,
+                                             16383,   16384,    2097151,    2097152,
+                                             INT_MAX, 1ULL << 35, LLONG_MAX};
+  if (rng.below(2))
+    return edges[rng.below(sizeof(edges) / sizeof(edges[0]))];
+  return rng.next() >> rng.below(64) & LLONG_MAX;
+}
+
+Frame randomFrame(Rng& rng) {
+  Frame f;
+  f.type = static_cast<int>(rng.below(5));
+  if (f.type == 0)
+    f.name = randomString(rng, 20);
+  f.globalRevision = randomVarint(rng);
+  size_t keys = rng.below(4) == 0 ? rng.below(300) : rng.below(5);
+  for (size_t i = 0; i < keys; i++)
+    f.changedKeys.push_back(randomString(rng, rng.below(10) == 0 ? 200 : 12));
+  f.urgent = rng.below(2) != 0;
+  f.resumed = rng.below(2) != 0;
+  if (rng.below(2))
+    f.spreadWindowMs = static_cast<long long>(randomVarint(rng));
+  f.hasBody = rng.below(2) != 0;
+  if (f.hasBody)
+    f.body = rng.below(4) == 0 ? std::string() : "{\"flags\":[" + randomString(rng, 300) + "]}";
+  return f;
+}
+
+std::string bytes(std::initializer_list<int> list) {
+  std::string out;
+  for (int b : list)
+    out += static_cast<char>(b);
+  return out;
+}
+
+} // namespace
+
+TEST(decodes_wire_vectors) {
+  BinaryStreamFrame d;
+
+  // flags_changed, revision 300 (0xAC 0x02), keys "a" and "bc", urgent
+  CHECK(decode(bytes({1, 2, 1, 0xAC, 0x02, 2, 1, 'a', 2, 'b', 'c'}), d));
+  CHECK_EQ(d.type, std::string("flags_changed"));
+  CHECK_EQ(d.globalRevision, 300LL);
+  CHECK(d.changedKeys == (std::vector<std::string>{"a", "bc"}));
+  CHECK(d.urgent && !d.resumed);
+  CHECK_EQ(d.spreadWindowMs, -1);
+  CHECK(d.body == nullptr);
+
+  // Named event "x", revision 0, no keys, spreadWindowMs 5000 (0x88 0x27), body "{}", resumed
+  std::string wire = bytes({1, 0, 2 | 4 | 8, 1, 'x', 0, 0, 0x88, 0x27, 2, '{', '}'});
+  CHECK(decode(wire, d));
+  CHECK_EQ(d.type, std::string("x"));
+  CHECK_EQ(d.globalRevision, 0LL);
+  CHECK(d.changedKeys.empty());
+  CHECK(!d.urgent && d.resumed);
+  CHECK_EQ(d.spreadWindowMs, 5000);
+  CHECK_EQ(std::string(d.body, d.bodyLength), std::string("{}"));
+  // The body is a view into the frame, not a copy
+  CHECK(d.body == wire.data() + wire.size() - 2);
+
+  // Heartbeat with the largest revision a signed 64-bit counter holds
+  CHECK(decode(bytes({1, 3, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0}), d));
+  CHECK_EQ(d.type, std::string("heartbeat"));
+  CHECK_EQ(d.globalRevision, LLONG_MAX);
+
+  // A redundant zero continuation is still a valid LEB128 encoding of 1
+  CHECK(decode(bytes({1, 4, 0, 0x81, 0x00, 0}), d));
+  CHECK_EQ(d.type, std::string("pong"));
+  CHECK_EQ(d.globalRevision, 1LL);
+}
+
+TEST(round_trips_random_frames) {
+  Rng rng(0xC0DEC);
+  for (int i = 0; i < 20000; i++) {
+    Frame f = randomFrame(rng);
+    std::string wire = encode(f); // outlives d, whose body points into it
+    BinaryStreamFrame d;
+    if (!decode(wire, d)) {
+      ::gatrix::test::fail(__FILE__, __LINE__, "round trip " + std::to_string(i));
+      continue;
+    }
+    checkSame(f, d);
+  }
+}
+
+TEST(reuses_output_frame) {
+  // A frame decoded into a used BinaryStreamFrame keeps nothing from the previous one
+  Frame full;
+  full.changedKeys = {"a", "b"};
+  full.urgent = full.resumed = true;
+  full.spreadWindowMs = 10;
+  full.hasBody = true;
+  full.body = "{}";
+  Frame empty;
+  empty.type = 3;
+
+  std::string fullWire = encode(full);
+  std::string emptyWire = encode(empty);
+  BinaryStreamFrame d;
+  CHECK(decode(fullWire, d));
+  CHECK(decode(emptyWire, d));
+  checkSame(empty, d);
+}
+
+TEST(clamps_spread_window) {
+  Frame f;
+  f.spreadWindowMs = static_cast<long long>(INT_MAX) + 1;
+  std::string wire = encode(f);
+  BinaryStreamFrame d;
+  CHECK(decode(wire, d));
+  CHECK_EQ(d.spreadWindowMs, INT_MAX);
+}
+
+TEST(rejects_every_truncation) {
+  Rng rng(7);
+  for (int i = 0; i < 2000; i++) {
+    std::string wire = encode(randomFrame(rng));
+    for (size_t len = 0; len < wire.size(); len++) {
+      // Copied, so that ASan sees any read past the shortened frame
+      std::vector<char> prefix(wire.begin(), wire.begin() + len);
+      BinaryStreamFrame d;
+      if (StreamCodec::decode(prefix.data(), prefix.size(), d)) {
+        ::gatrix::test::fail(__FILE__, __LINE__,
+                             "accepted " + std::to_string(len) + " of " +
+                                 std::to_string(wire.size()) + " bytes");
+        break;
+      }
+    }
+  }
+}
+
+TEST(rejects_malformed_frames) {
+  BinaryStreamFrame d;
+  CHECK(!decode(std::string(), d));
+  // Version
+  CHECK(!decode(bytes({0, 2, 0, 0, 0}), d));
+  CHECK(!decode(bytes({2, 2, 0, 0, 0}), d));
+  // Unknown type
+  CHECK(!decode(bytes({1, 5, 0, 0, 0}), d));
+  CHECK(!decode(bytes({1, 0xFF, 0, 0, 0}), d));
+  // Varint that never ends within 64 bits
+  std::string overlong = bytes({1, 2, 0});
+  overlong.append(10, static_cast<char>(0x80));
+  overlong += bytes({0x01, 0});
+  CHECK(!decode(overlong, d));
+  // More keys announced than bytes left
+  CHECK(!decode(bytes({1, 2, 0, 0, 3, 0, 0}), d));
+  CHECK(!decode(bytes({1, 2, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F}), d));
+  // String longer than the frame, including lengths that would wrap a pointer
+  CHECK(!decode(bytes({1, 2, 0, 0, 1, 5, 'a', 'b'}), d));
+  CHECK(!decode(bytes({1, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01}), d));
+  // Flags announce a spread window or body that is missing
+  CHECK(!decode(bytes({1, 2, 2, 0, 0}), d));
+  CHECK(!decode(bytes({1, 2, 4, 0, 0}), d));
+  CHECK(!decode(bytes({1, 2, 4, 0, 0, 3, '{', '}'}), d));
+}
+
+TEST(survives_random_mutations) {
+  // Flipped, dropped and inserted bytes either decode to something self-consistent or fail
+  Rng rng(0xBAD);
+  for (int i = 0; i < 20000; i++) {
+    std::string wire = encode(randomFrame(rng));
+    int edits = 1 + static_cast<int>(rng.below(4));
+    for (int e = 0; e < edits && !wire.empty(); e++) {
+      size_t at = rng.below(wire.size());
+      switch (rng.below(3)) {
+      case 0:
+        wire[at] = static_cast<char>(rng.next() & 0xff);
+        break;
+      case 1:
+        wire.erase(at, 1);
+        break;
+      default:
+        wire.insert(at, 1, static_cast<char>(rng.next() & 0xff));
+      }
+    }
+    std::vector<char> copy(wire.begin(), wire.end());
+    BinaryStreamFrame d;
+    if (StreamCodec::decode(copy.data(), copy.size(), d) && d.body) {
+      CHECK(d.body >= copy.data() && d.body + d.bodyLength <= copy.data() + copy.size());
+    }
+  }
+}
+
+GATRIX_TEST_MAIN
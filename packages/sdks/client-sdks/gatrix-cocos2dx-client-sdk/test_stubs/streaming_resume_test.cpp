@@ -0,0 +1,413 @@
+// streaming_resume_test.cpp - StreamingManager reconnects resume from the last event id
+//
+// ReplayServer stands in for the edge: it keeps a bounded log of revisions,
+// answers a reconnect carrying Last-Event-ID with connected(resumed) and the
+// missed revisions, and reports a plain gap when the log no longer reaches
+// back that far. The SSE stream is served through ITransport::stream on the
+// manager's own streaming thread; the test thread is the cocos thread and
+// drives the stub scheduler.
+#include "GatrixStreaming.h"
+#include "cocos2d.h"
+#include "gatrix_test.h"
+#include "network/WebSocket.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace gatrix;
+
+namespace {
+
+class ReplayServer : public ITransport {
+public:
+  explicit ReplayServer(size_t logCapacity) : _logCapacity(logCapacity) {}
+
+  const char* name() const override { return "replay"; }
+
+  void send(const TransportRequest&, ResponseCallback callback) override {
+    TransportResponse response;
+    response.error = "not served";
+    callback(response);
+  }
+
+  SseReader::Result stream(const std::string&, const std::vector<std::string>& headers,
+                           const SseReader::OpenCallback& onOpen,
+                           const SseReader::DataCallback& onData,
+                           const SseReader::CancelCheck& isCancelled, int) override {
+    std::unique_lock<std::mutex> lock(_mutex);
+    long lastEventId = 0;
+    for (const auto& header : headers) {
+      if (header.compare(0, 15, "Last-Event-ID: ") == 0)
+        lastEventId = std::stol(header.substr(15));
+    }
+    _requests.push_back(lastEventId);
+    _live = true;
+    _dropRequested = false;
+    onOpen();
+
+    std::string out = "event: connected\ndata: {\"globalRevision\":" + std::to_string(_revision);
+    bool resumed = lastEventId > 0 && lastEventId < _revision && canReplayFrom(lastEventId);
+    out += resumed ? ",\"resumed\":true}\n\n" : "}\n\n";
+    if (resumed) {
+      // At-least-once: the last revision the client saw may be sent again
+      long from = replayInclusive ? lastEventId : lastEventId + 1;
+      for (long revision = from; revision <= _revision; revision++)
+        out += eventFor(revision);
+    }
+    _outbox.push_back(out);
+
+    while (true) {
+      while (!_outbox.empty()) {
+        std::string chunk = std::move(_outbox.front());
+        _outbox.pop_front();
+        lock.unlock();
+        // Small chunks, as a network would split them
+        for (size_t i = 0; i < chunk.size(); i += 7)
+          onData(chunk.data() + i, std::min<size_t>(7, chunk.size() - i));
+        lock.lock();
+      }
+      if (_dropRequested || isCancelled()) {
+        _live = false;
+        SseReader::Result result;
+        result.statusCode = 200;
+        result.opened = true;
+        result.cancelled = isCancelled();
+        _cv.notify_all();
+        return result;
+      }
+      _cv.wait_for(lock, std::chrono::milliseconds(5));
+    }
+  }
+
+  /** A new revision changing one key; sent at once to a live connection */
+  void publish(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _revision++;
+    _log.push_back(std::make_pair(_revision, key));
+    if (_log.size() > _logCapacity)
+      _log.pop_front();
+    if (_live)
+      _outbox.push_back(eventFor(_revision));
+    _cv.notify_all();
+  }
+
+  /** Close the live stream cleanly, as a server restart or proxy timeout would */
+  void drop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _dropRequested = true;
+    _cv.notify_all();
+    _cv.wait(lock, [this] { return !_live; });
+  }
+
+  std::vector<long> requests() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requests;
+  }
+
+  bool replayInclusive = false;
+  bool withPayload = false;
+
+private:
+  bool canReplayFrom(long lastEventId) const {
+    return !_log.empty() && _log.front().first <= lastEventId + 1;
+  }
+
+  std::string eventFor(long revision) const {
+    std::string key;
+    for (const auto& entry : _log) {
+      if (entry.first == revision)
+        key = entry.second;
+    }
+    std::string data = "{\"globalRevision\":" + std::to_string(revision) +
+                       ",\"changedKeys\":[\"" + key + "\"]";
+    if (withPayload)
+      data += ",\"flags\":[{\"name\":\"" + key + "\",\"enabled\":true}]";
+    return "id: " + std::to_string(revision) + "\nevent: flags_changed\ndata: " + data + "}\n\n";
+  }
+
+  size_t _logCapacity;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  long _revision = 0;
+  std::deque<std::pair<long, std::string>> _log;
+  std::deque<std::string> _outbox;
+  std::vector<long> _requests;
+  bool _live = false;
+  bool _dropRequested = false;
+};
+
+/** What the manager reported to its owner */
+struct Observed {
+  std::vector<std::string> invalidated; // one changed key per event
+  std::vector<bool> payloads;           // contiguous flag of each applied payload
+  int fullFetches = 0;
+};
+
+GatrixClientConfig makeConfig(StreamingTransport transport) {
+  GatrixClientConfig config;
+  config.apiUrl = "http://replay.test/api/v1";
+  config.apiToken = "token";
+  config.appName = "resume-test";
+  config.features.streaming.enabled = true;
+  config.features.streaming.transport = transport;
+  return config;
+}
+
+void observe(StreamingManager& manager, Observed& observed) {
+  manager.setInvalidationCallback(
+      [&observed](const std::vector<std::string>& keys, const StreamingManager::InvalidationHint&) {
+        for (const auto& key : keys)
+          observed.invalidated.push_back(key);
+      });
+  manager.setFetchCallback([&observed]() { observed.fullFetches++; });
+  manager.setPayloadCallback([&observed](const rapidjson::Value&, long, bool contiguous) {
+    observed.payloads.push_back(contiguous);
+    return true;
+  });
+}
+
+/** Runs cocos frames of dt seconds until done() holds; false after 10s of wall time */
+template <typename Pred> bool pumpUntil(Pred done, float dt = 0.05f) {
+  auto scheduler = cocos2d::Director::getInstance()->getScheduler();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    scheduler->update(dt);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+/** Lets events already on their way reach the cocos thread */
+void settle() {
+  auto scheduler = cocos2d::Director::getInstance()->getScheduler();
+  for (int i = 0; i < 20; i++) {
+    scheduler->update(0.0f);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+}
+
+std::vector<std::string> keys(std::initializer_list<const char*> list) {
+  return std::vector<std::string>(list.begin(), list.end());
+}
+
+} // namespace
+
+TEST(sse_reconnect_replays_missed_revisions) {
+  ReplayServer server(100);
+  server.replayInclusive = true;
+  for (const char* key : {"f1", "f2", "f3", "f4", "f5"})
+    server.publish(key);
+
+  GatrixClientConfig config = makeConfig(StreamingTransport::SSE);
+  GatrixEventEmitter emitter;
+  StreamingManager manager(config, emitter, server);
+  Observed observed;
+  observe(manager, observed);
+
+  manager.connect();
+  CHECK(pumpUntil([&] { return manager.getEventCount() == 1; }));
+  CHECK(manager.getState() == StreamingConnectionState::CONNECTED);
+  server.publish("f6");
+  server.publish("f7");
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 2; }));
+
+  // Revisions 8-10 are published while the client is away
+  server.drop();
+  server.publish("f8");
+  server.publish("f9");
+  server.publish("f10");
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 5; }));
+  settle();
+
+  std::vector<long> requests = server.requests();
+  CHECK_EQ(requests.size(), static_cast<size_t>(2));
+  CHECK_EQ(requests[0], 0L); // first connection: no Last-Event-ID
+  CHECK_EQ(requests[1], 7L);
+  // Every missed revision arrives once and in order; the re-sent revision 7 is ignored
+  CHECK(observed.invalidated == keys({"f6", "f7", "f8", "f9", "f10"}));
+  CHECK_EQ(observed.fullFetches, 0);
+  CHECK_EQ(manager.getReconnectCount(), 1);
+  CHECK_EQ(manager.getRecoveryCount(), 1);
+
+  // Live events continue from the replayed revision
+  server.publish("f11");
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 6; }));
+  CHECK_EQ(observed.invalidated.back(), std::string("f11"));
+  manager.disconnect();
+}
+
+TEST(sse_truncated_log_falls_back_to_full_fetch) {
+  ReplayServer server(2);
+  for (const char* key : {"f1", "f2", "f3"})
+    server.publish(key);
+
+  GatrixClientConfig config = makeConfig(StreamingTransport::SSE);
+  GatrixEventEmitter emitter;
+  StreamingManager manager(config, emitter, server);
+  Observed observed;
+  observe(manager, observed);
+
+  manager.connect();
+  CHECK(pumpUntil([&] { return manager.getEventCount() == 1; }));
+  server.publish("f4");
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 1; }));
+
+  // Five revisions while away; the log keeps only 8 and 9, so 5-7 cannot be replayed
+  server.drop();
+  for (const char* key : {"f5", "f6", "f7", "f8", "f9"})
+    server.publish(key);
+  CHECK(pumpUntil([&] { return observed.fullFetches == 1; }));
+  settle();
+
+  std::vector<long> requests = server.requests();
+  CHECK(requests == std::vector<long>({0, 4}));
+  CHECK(observed.invalidated == keys({"f4"}));
+  CHECK_EQ(observed.fullFetches, 1);
+
+  // The full fetch covers revision 9; the next live revision applies normally
+  server.publish("f10");
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 2; }));
+  CHECK_EQ(observed.invalidated.back(), std::string("f10"));
+  CHECK_EQ(observed.fullFetches, 1);
+  manager.disconnect();
+}
+
+TEST(sse_replayed_payloads_apply_contiguously) {
+  ReplayServer server(100);
+  server.withPayload = true;
+  server.publish("f1");
+
+  GatrixClientConfig config = makeConfig(StreamingTransport::SSE);
+  config.features.streaming.pushPayload = true;
+  GatrixEventEmitter emitter;
+  StreamingManager manager(config, emitter, server);
+  Observed observed;
+  observe(manager, observed);
+
+  manager.connect();
+  CHECK(pumpUntil([&] { return manager.getEventCount() == 1; }));
+  server.drop();
+  server.publish("f2");
+  server.publish("f3");
+  server.publish("f4");
+  CHECK(pumpUntil([&] { return observed.payloads.size() == 3; }));
+  settle();
+
+  // Each replayed record follows the one before it, so none needs a fetch
+  CHECK(observed.payloads == std::vector<bool>({true, true, true}));
+  CHECK(observed.invalidated.empty());
+  CHECK_EQ(observed.fullFetches, 0);
+  manager.disconnect();
+}
+
+TEST(websocket_reconnect_resumes_through_query) {
+  using cocos2d::network::WebSocket;
+  GatrixClientConfig config = makeConfig(StreamingTransport::WEBSOCKET);
+  config.features.streaming.ws.binaryFrames = true;
+  GatrixEventEmitter emitter;
+  ReplayServer unused(1);
+  StreamingManager manager(config, emitter, unused);
+  Observed observed;
+  observe(manager, observed);
+
+  auto text = [](WebSocket* ws, const std::string& message) {
+    std::string copy = message;
+    WebSocket::Data data;
+    data.bytes = &copy[0];
+    data.len = static_cast<ssize_t>(copy.size());
+    ws->getDelegate()->onMessage(ws, data);
+  };
+  auto binary = [](WebSocket* ws, std::initializer_list<int> bytes) {
+    std::string copy;
+    for (int b : bytes)
+      copy += static_cast<char>(b);
+    WebSocket::Data data;
+    data.bytes = &copy[0];
+    data.len = static_cast<ssize_t>(copy.size());
+    data.isBinary = true;
+    ws->getDelegate()->onMessage(ws, data);
+  };
+
+  manager.connect();
+  WebSocket* first = WebSocket::latest();
+  CHECK(first->url().find("lastEventId") == std::string::npos);
+  first->getDelegate()->onOpen(first);
+  text(first, "{\"type\":\"connected\",\"data\":{\"globalRevision\":5}}");
+  text(first, "{\"type\":\"flags_changed\",\"data\":{\"globalRevision\":6,\"changedKeys\":[\"f6\"]}}");
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 1; }));
+
+  first->getDelegate()->onClose(first);
+  CHECK(pumpUntil([&] { return WebSocket::latest() != first; }));
+  WebSocket* second = WebSocket::latest();
+  CHECK(second->url().find("lastEventId=6") != std::string::npos);
+  CHECK(!second->protocols().empty());
+
+  // Binary connected frame at revision 8 with the resumed flag, then the replay of 7 and 8
+  second->getDelegate()->onOpen(second);
+  binary(second, {1, 1, 8, 8, 0});
+  binary(second, {1, 2, 0, 7, 1, 2, 'f', '7'});
+  binary(second, {1, 2, 0, 8, 1, 2, 'f', '8'});
+  CHECK(pumpUntil([&] { return observed.invalidated.size() == 3; }));
+  settle();
+  CHECK(observed.invalidated == keys({"f6", "f7", "f8"}));
+  CHECK_EQ(observed.fullFetches, 0);
+
+  // Without the resumed flag the same gap means the server cannot replay: refetch
+  second->getDelegate()->onClose(second);
+  CHECK(pumpUntil([&] { return WebSocket::latest() != second; }));
+  WebSocket* third = WebSocket::latest();
+  CHECK(third->url().find("lastEventId=8") != std::string::npos);
+  third->getDelegate()->onOpen(third);
+  binary(third, {1, 1, 0, 12, 0});
+  CHECK(pumpUntil([&] { return observed.fullFetches == 1; }));
+  manager.disconnect();
+}
+
+TEST(work_queued_for_a_destroyed_manager_is_dropped) {
+  using cocos2d::network::WebSocket;
+  ReplayServer server(100);
+  server.publish("f1");
+  Observed observed;
+  GatrixEventEmitter emitter;
+
+  // SSE: the open notice and events are posted by the streaming thread, not yet run
+  GatrixClientConfig sseConfig = makeConfig(StreamingTransport::SSE);
+  auto sse = std::unique_ptr<StreamingManager>(new StreamingManager(sseConfig, emitter, server));
+  observe(*sse, observed);
+  sse->connect();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (server.requests().empty() && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  server.publish("f2");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sse.reset();
+
+  // WebSocket: a frame and a close delivered just before the manager goes away
+  GatrixClientConfig wsConfig = makeConfig(StreamingTransport::WEBSOCKET);
+  auto ws = std::unique_ptr<StreamingManager>(new StreamingManager(wsConfig, emitter, server));
+  observe(*ws, observed);
+  ws->connect();
+  WebSocket* socket = WebSocket::latest();
+  socket->getDelegate()->onOpen(socket);
+  std::string frame =
+      "{\"type\":\"flags_changed\",\"data\":{\"globalRevision\":2,\"changedKeys\":[\"f2\"]}}";
+  WebSocket::Data data;
+  data.bytes = &frame[0];
+  data.len = static_cast<ssize_t>(frame.size());
+  socket->getDelegate()->onMessage(socket, data);
+  socket->getDelegate()->onClose(socket);
+  ws.reset();
+
+  // Run under ASan: none of this may touch either manager
+  settle();
+  CHECK(observed.invalidated.empty());
+  CHECK_EQ(observed.fullFetches, 0);
+}
+
+GATRIX_TEST_MAIN
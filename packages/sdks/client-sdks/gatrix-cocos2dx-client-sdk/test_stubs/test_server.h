@@ -0,0 +1,102 @@
+// test_server.h - In-process stand-in for the edge, shared by the FeaturesClient tests
+//
+// TestServer is an ITransport that records every request and answers fetches
+// only when the test says so; the test thread is the cocos thread. Its SSE
+// stream runs on the streaming thread and sends what the test writes with
+// event().
+#ifndef GATRIX_TEST_SERVER_H
+#define GATRIX_TEST_SERVER_H
+
+#include "GatrixTransport.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gatrix {
+namespace test {
+
+class TestServer : public ITransport {
+public:
+  const char* name() const override { return "test"; }
+
+  void send(const TransportRequest& request, ResponseCallback callback) override {
+    _requests.push_back(request);
+    _pending.push_back(std::move(callback));
+  }
+
+  /** Answers every request in flight with body (an empty flag set by default) */
+  void respond(const std::string& body = "{\"success\":true,\"data\":{\"flags\":[]}}",
+               const std::string& headers = "") {
+    auto pending = std::move(_pending);
+    _pending.clear();
+    for (auto& callback : pending) {
+      TransportResponse response;
+      response.statusCode = 200;
+      response.headers = headers;
+      response.body.assign(body.begin(), body.end());
+      _bytesServed += static_cast<long long>(body.size());
+      callback(response);
+    }
+  }
+
+  SseReader::Result stream(const std::string&, const std::vector<std::string>&,
+                           const SseReader::OpenCallback& onOpen,
+                           const SseReader::DataCallback& onData,
+                           const SseReader::CancelCheck& isCancelled, int) override {
+    onOpen();
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!isCancelled()) {
+      while (!_outbox.empty()) {
+        std::string chunk = std::move(_outbox.front());
+        _outbox.pop_front();
+        lock.unlock();
+        onData(chunk.data(), chunk.size());
+        lock.lock();
+      }
+      _cv.wait_for(lock, std::chrono::milliseconds(5));
+    }
+    SseReader::Result result;
+    result.statusCode = 200;
+    result.opened = true;
+    result.cancelled = true;
+    return result;
+  }
+
+  /** Sends one SSE event on the open stream */
+  void event(const std::string& type, const std::string& data) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _outbox.push_back("event: " + type + "\ndata: " + data + "\n\n");
+    _cv.notify_all();
+  }
+
+  int fetches() const {
+    int count = 0;
+    for (const auto& request : _requests) {
+      if (request.requestClass == RequestClass::FETCH)
+        count++;
+    }
+    return count;
+  }
+
+  const TransportRequest& last() const { return _requests.back(); }
+
+  /** Response body bytes answered so far */
+  long long bytesServed() const { return _bytesServed; }
+
+private:
+  std::vector<TransportRequest> _requests;
+  std::vector<ResponseCallback> _pending;
+  long long _bytesServed = 0;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<std::string> _outbox;
+};
+
+} // namespace test
+} // namespace gatrix
+
+#endif // GATRIX_TEST_SERVER_H
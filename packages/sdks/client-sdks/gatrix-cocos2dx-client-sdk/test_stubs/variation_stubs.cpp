@@ -0,0 +1,111 @@
+// variation_stubs.cpp - Link stand-ins for the FeaturesClient tests
+//
+// The variation overrides of IVariationProvider are not defined in
+// GatrixFeaturesClient.cpp; these stand-ins let the client link in the tests,
+// none of which reach them.
+#include "GatrixFeaturesClient.h"
+#include "gatrix_test.h"
+
+namespace gatrix {
+namespace {
+void unreachable(const char* what) {
+  ::gatrix::test::fail(__FILE__, __LINE__, std::string(what) + " is not linked in this test");
+}
+} // namespace
+
+bool FeaturesClient::isEnabledInternal(const std::string&, bool) {
+  unreachable("isEnabledInternal");
+  return false;
+}
+Variant FeaturesClient::getVariantInternal(const std::string&, bool) {
+  unreachable("getVariantInternal");
+  return {};
+}
+std::string FeaturesClient::variationInternal(const std::string&, const std::string& fallback,
+                                              bool) {
+  unreachable("variationInternal");
+  return fallback;
+}
+bool FeaturesClient::boolVariationInternal(const std::string&, bool fallback, bool) {
+  unreachable("boolVariationInternal");
+  return fallback;
+}
+std::string FeaturesClient::stringVariationInternal(const std::string&,
+                                                    const std::string& fallback, bool) {
+  unreachable("stringVariationInternal");
+  return fallback;
+}
+float FeaturesClient::floatVariationInternal(const std::string&, float fallback, bool) {
+  unreachable("floatVariationInternal");
+  return fallback;
+}
+int FeaturesClient::intVariationInternal(const std::string&, int fallback, bool) {
+  unreachable("intVariationInternal");
+  return fallback;
+}
+double FeaturesClient::doubleVariationInternal(const std::string&, double fallback, bool) {
+  unreachable("doubleVariationInternal");
+  return fallback;
+}
+std::string FeaturesClient::jsonVariationInternal(const std::string&, const std::string& fallback,
+                                                  bool) {
+  unreachable("jsonVariationInternal");
+  return fallback;
+}
+VariationResult<bool> FeaturesClient::boolVariationDetailsInternal(const std::string&,
+                                                                   bool fallback, bool) {
+  unreachable("boolVariationDetailsInternal");
+  return {fallback, "", false, false};
+}
+VariationResult<std::string>
+FeaturesClient::stringVariationDetailsInternal(const std::string&, const std::string& fallback,
+                                               bool) {
+  unreachable("stringVariationDetailsInternal");
+  return {fallback, "", false, false};
+}
+VariationResult<float> FeaturesClient::floatVariationDetailsInternal(const std::string&,
+                                                                     float fallback, bool) {
+  unreachable("floatVariationDetailsInternal");
+  return {fallback, "", false, false};
+}
+VariationResult<int> FeaturesClient::intVariationDetailsInternal(const std::string&, int fallback,
+                                                                 bool) {
+  unreachable("intVariationDetailsInternal");
+  return {fallback, "", false, false};
+}
+VariationResult<double> FeaturesClient::doubleVariationDetailsInternal(const std::string&,
+                                                                       double fallback, bool) {
+  unreachable("doubleVariationDetailsInternal");
+  return {fallback, "", false, false};
+}
+VariationResult<std::string>
+FeaturesClient::jsonVariationDetailsInternal(const std::string&, const std::string& fallback,
+                                             bool) {
+  unreachable("jsonVariationDetailsInternal");
+  return {fallback, "", false, false};
+}
+bool FeaturesClient::boolVariationOrThrowInternal(const std::string&, bool) {
+  unreachable("boolVariationOrThrowInternal");
+  return false;
+}
+std::string FeaturesClient::stringVariationOrThrowInternal(const std::string&, bool) {
+  unreachable("stringVariationOrThrowInternal");
+  return {};
+}
+float FeaturesClient::floatVariationOrThrowInternal(const std::string&, bool) {
+  unreachable("floatVariationOrThrowInternal");
+  return 0;
+}
+int FeaturesClient::intVariationOrThrowInternal(const std::string&, bool) {
+  unreachable("intVariationOrThrowInternal");
+  return 0;
+}
+double FeaturesClient::doubleVariationOrThrowInternal(const std::string&, bool) {
+  unreachable("doubleVariationOrThrowInternal");
+  return 0;
+}
+std::string FeaturesClient::jsonVariationOrThrowInternal(const std::string&, bool) {
+  unreachable("jsonVariationOrThrowInternal");
+  return {};
+}
+} // namespace gatrix
@@ -32,6 +32,9 @@ public class GatrixClientSDK : ModuleRules
             "InputCore"
         });
 
+        // Engine-bundled zlib for gzip/deflate transport compression
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
         // ThirdParty: GIF/WebP decoders
         string ThirdPartyPath = Path.Combine(ModuleDirectory, "ThirdParty");
         PublicIncludePaths.Add(ThirdPartyPath);
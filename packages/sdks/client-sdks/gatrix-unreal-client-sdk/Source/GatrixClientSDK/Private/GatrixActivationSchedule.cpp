@@ -0,0 +1,29 @@
+// Copyright Gatrix. All Rights Reserved.
+// Scheduled flag changes waiting for their activation time
+
+#include "GatrixActivationSchedule.h"
+
+void FGatrixActivationSchedule::Put(FGatrixScheduledChange Change) {
+  Cancel(Change.Id);
+  Heap.HeapPush(MoveTemp(Change), FByDeadline());
+}
+
+bool FGatrixActivationSchedule::Cancel(const FString& Id) {
+  const int32 Index = Heap.IndexOfByPredicate(
+      [&Id](const FGatrixScheduledChange& Change) { return Change.Id == Id; });
+  if (Index == INDEX_NONE) {
+    return false;
+  }
+  Heap.HeapRemoveAt(Index, FByDeadline());
+  return true;
+}
+
+TArray<FGatrixScheduledChange> FGatrixActivationSchedule::TakeDue(int64 ServerNowMs) {
+  TArray<FGatrixScheduledChange> Due;
+  while (Heap.Num() > 0 && Heap.HeapTop().DeadlineMs <= ServerNowMs) {
+    FGatrixScheduledChange Change;
+    Heap.HeapPop(Change, FByDeadline());
+    Due.Add(MoveTemp(Change));
+  }
+  return Due;
+}
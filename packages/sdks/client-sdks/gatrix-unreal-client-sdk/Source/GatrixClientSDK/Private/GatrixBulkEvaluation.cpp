@@ -0,0 +1,102 @@
+// Copyright Gatrix. All Rights Reserved.
+// Flag results of many contexts, indexed by context slot
+
+#include "GatrixBulkEvaluation.h"
+
+int32 FGatrixBulkEvaluation::AddRecord(const FGatrixEvaluatedFlag& Record) {
+  // Parsed records carry their content hash; others get it here
+  const FGatrixFlagHash Hash =
+      Record.ContentHash.IsZero() ? FGatrixFlagHash::Compute(Record) : Record.ContentHash;
+  if (const int32* Existing = RecordByHash.Find(Hash)) {
+    return *Existing;
+  }
+
+  const int32 Index = Records.Add(Record);
+  Records[Index].ContentHash = Hash;
+  RecordByHash.Add(Hash, Index);
+  Columns.FindOrAdd(Record.Name, Columns.Num());
+  return Index;
+}
+
+int32 FGatrixBulkEvaluation::AddSlot() { return Rows.AddDefaulted(); }
+
+void FGatrixBulkEvaluation::SetSlotRecord(int32 RecordIndex) {
+  if (Rows.Num() == 0 || !Records.IsValidIndex(RecordIndex)) {
+    return;
+  }
+
+  // Rows only grow to the columns they use; missing trailing columns read as absent
+  const int32 Column = Columns.FindChecked(Records[RecordIndex].Name);
+  TArray<int32>& Row = Rows.Last();
+  while (Row.Num() <= Column) {
+    Row.Add(INDEX_NONE);
+  }
+  if (Row[Column] == INDEX_NONE) {
+    ResultCount++;
+  }
+  Row[Column] = RecordIndex;
+}
+
+void FGatrixBulkEvaluation::Append(const FGatrixBulkEvaluation& Other) {
+  // Other's record indices, translated into this evaluation
+  TArray<int32> Remap;
+  Remap.Reserve(Other.Records.Num());
+  for (const FGatrixEvaluatedFlag& Record : Other.Records) {
+    Remap.Add(AddRecord(Record));
+  }
+
+  Rows.Reserve(Rows.Num() + Other.Rows.Num());
+  for (const TArray<int32>& OtherRow : Other.Rows) {
+    AddSlot();
+    for (int32 RecordIndex : OtherRow) {
+      if (RecordIndex != INDEX_NONE) {
+        SetSlotRecord(Remap[RecordIndex]);
+      }
+    }
+  }
+}
+
+const FGatrixEvaluatedFlag* FGatrixBulkEvaluation::Find(int32 Slot,
+                                                        const FString& FlagName) const {
+  const int32* Column = Columns.Find(FlagName);
+  if (!Column || !Rows.IsValidIndex(Slot) || !Rows[Slot].IsValidIndex(*Column)) {
+    return nullptr;
+  }
+  const int32 RecordIndex = Rows[Slot][*Column];
+  return RecordIndex != INDEX_NONE ? &Records[RecordIndex] : nullptr;
+}
+
+bool FGatrixBulkEvaluation::IsEnabled(int32 Slot, const FString& FlagName,
+                                      bool bDefaultValue) const {
+  const FGatrixEvaluatedFlag* Flag = Find(Slot, FlagName);
+  return Flag ? Flag->bEnabled : bDefaultValue;
+}
+
+void FGatrixBulkEvaluation::GetFlags(int32 Slot, TArray<FGatrixEvaluatedFlag>& OutFlags) const {
+  if (!Rows.IsValidIndex(Slot)) {
+    return;
+  }
+  for (int32 RecordIndex : Rows[Slot]) {
+    if (RecordIndex != INDEX_NONE) {
+      OutFlags.Add(Records[RecordIndex]);
+    }
+  }
+}
+
+float FGatrixBulkEvaluation::GetReuseRatio() const {
+  return Records.Num() > 0 ? static_cast<float>(ResultCount) / static_cast<float>(Records.Num())
+                           : 0.0f;
+}
+
+int64 FGatrixBulkEvaluation::GetResidentBytes() const {
+  int64 Bytes = Records.GetAllocatedSize() + RecordByHash.GetAllocatedSize() +
+                Columns.GetAllocatedSize() + Rows.GetAllocatedSize();
+  for (const FGatrixEvaluatedFlag& Record : Records) {
+    Bytes += Record.Name.GetAllocatedSize() + Record.Reason.GetAllocatedSize() +
+             Record.Variant.Name.GetAllocatedSize() + Record.Variant.Value.GetAllocatedSize();
+  }
+  for (const TArray<int32>& Row : Rows) {
+    Bytes += Row.GetAllocatedSize();
+  }
+  return Bytes;
+}
@@ -20,6 +20,10 @@ UGatrixClient* UGatrixClient::Get() {
   return Singleton;
 }
 
+UGatrixClient* UGatrixClient::Create(UObject* Outer) {
+  return NewObject<UGatrixClient>(Outer ? Outer : GetTransientPackage());
+}
+
 bool UGatrixClient::InitInternal(const FGatrixClientConfig& InConfig) {
   // Validate required fields
   if (InConfig.ApiUrl.IsEmpty()) {
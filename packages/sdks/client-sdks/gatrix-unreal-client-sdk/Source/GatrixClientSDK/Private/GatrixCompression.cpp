@@ -0,0 +1,79 @@
+// Copyright Gatrix. All Rights Reserved.
+// gzip/deflate helpers for compressed fetch and metrics transport
+
+#include "GatrixCompression.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace {
+constexpr int32 InflateChunkSize = 16 * 1024;
+} // namespace
+
+bool FGatrixCompression::IsCompressed(const TArray<uint8>& Data) {
+  if (Data.Num() < 2)
+    return false;
+
+  // gzip magic
+  if (Data[0] == 0x1f && Data[1] == 0x8b)
+    return true;
+
+  // zlib header: CM=8 (deflate) and header checksum
+  return (Data[0] & 0x0f) == 8 && ((Data[0] << 8) | Data[1]) % 31 == 0;
+}
+
+bool FGatrixCompression::Gzip(const TArray<uint8>& Input, TArray<uint8>& OutCompressed) {
+  z_stream Stream;
+  FMemory::Memzero(&Stream, sizeof(Stream));
+
+  // windowBits 15 + 16 = gzip wrapper
+  if (deflateInit2(&Stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) !=
+      Z_OK) {
+    return false;
+  }
+
+  OutCompressed.SetNumUninitialized(deflateBound(&Stream, Input.Num()));
+  Stream.next_in = const_cast<Bytef*>(Input.GetData());
+  Stream.avail_in = Input.Num();
+  Stream.next_out = OutCompressed.GetData();
+  Stream.avail_out = OutCompressed.Num();
+
+  const int Result = deflate(&Stream, Z_FINISH);
+  OutCompressed.SetNum(Stream.total_out);
+  deflateEnd(&Stream);
+  return Result == Z_STREAM_END;
+}
+
+bool FGatrixCompression::Inflate(const TArray<uint8>& Input, TArray<uint8>& OutDecompressed) {
+  z_stream Stream;
+  FMemory::Memzero(&Stream, sizeof(Stream));
+
+  // windowBits 15 + 32 = auto-detect gzip or zlib header
+  if (inflateInit2(&Stream, 15 + 32) != Z_OK) {
+    return false;
+  }
+
+  Stream.next_in = const_cast<Bytef*>(Input.GetData());
+  Stream.avail_in = Input.Num();
+  OutDecompressed.Reset();
+
+  int Result = Z_OK;
+  while (Result == Z_OK) {
+    const int32 Offset = OutDecompressed.Num();
+    OutDecompressed.AddUninitialized(InflateChunkSize);
+    Stream.next_out = OutDecompressed.GetData() + Offset;
+    Stream.avail_out = InflateChunkSize;
+
+    Result = inflate(&Stream, Z_NO_FLUSH);
+    OutDecompressed.SetNum(Offset + InflateChunkSize - Stream.avail_out, false);
+
+    // Input exhausted without reaching the end of the stream: truncated
+    if (Result == Z_OK && Stream.avail_in == 0 && Stream.avail_out != 0) {
+      Result = Z_DATA_ERROR;
+    }
+  }
+
+  inflateEnd(&Stream);
+  return Result == Z_STREAM_END;
+}
@@ -4,6 +4,7 @@
 
 #include "GatrixFeaturesClient.h"
 #include "GatrixClient.h"
+#include "GatrixCompression.h"
 #include "GatrixEvents.h"
 #include "GatrixJson.h"
 #include "GatrixClientSDKModule.h"
@@ -26,6 +27,15 @@ const FString UGatrixFeaturesClient::StorageKeyEtag = TEXT("gatrix_etag");
 
 UGatrixFeaturesClient::UGatrixFeaturesClient() {}
 
+void UGatrixFeaturesClient::BeginDestroy() {
+  // The hub outlives this instance when others share it; its callbacks capture this
+  if (StreamingHub.IsValid()) {
+    StreamingHub->Unsubscribe(StreamingSubscription);
+    StreamingHub.Reset();
+  }
+  Super::BeginDestroy();
+}
+
 // ==================== Initialization ====================
 
 void UGatrixFeaturesClient::Initialize(const FGatrixClientConfig& Config,
@@ -41,6 +51,16 @@ void UGatrixFeaturesClient::Initialize(const FGatrixClientConfig& Config,
   // Ensure context has system fields
   ClientConfig.Features.Context.AppName = ClientConfig.AppName;
 
+  Invalidations.Configure(ClientConfig.Features.InvalidationCoalesceMinMs,
+                          ClientConfig.Features.InvalidationCoalesceMaxMs);
+  SpreadWindowMs = ClientConfig.Features.InvalidationSpreadWindowMs;
+  Polling.Configure(ClientConfig.Features.RefreshInterval,
+                    ClientConfig.Features.StreamingSafetyPollInterval,
+                    ClientConfig.Features.StreamingFlapThreshold,
+                    ClientConfig.Features.StreamingFlapWindow);
+  Prefetched = AcquirePrefetchPool(ClientConfig);
+  Interest.Configure(ClientConfig.Features.InterestKeys, ClientConfig.Features.bTrackObservedKeys,
+                     ClientConfig.Features.InterestBloomThreshold);
 
   // Load cached data from storage
   LoadFromStorage();
@@ -96,6 +116,7 @@ void UGatrixFeaturesClient::Start() {
 
   // Start streaming if enabled
   if (ClientConfig.Features.Streaming.bEnabled && !ClientConfig.Features.bOfflineMode) {
+    Polling.SetStreamingEnabled(true);
     ConnectStreaming();
   }
 }
@@ -128,6 +149,18 @@ void UGatrixFeaturesClient::Stop() {
   StopPolling();
   StopMetrics();
   DisconnectStreaming();
+  Polling.SetStreamingEnabled(false);
+
+  if (GEngine && GEngine->GetWorldContexts().Num() > 0) {
+    if (UWorld* World = GEngine->GetWorldContexts()[0].World()) {
+      World->GetTimerManager().ClearTimer(InvalidationFlushTimerHandle);
+      World->GetTimerManager().ClearTimer(PrefetchTimerHandle);
+      World->GetTimerManager().ClearTimer(ActivationTimerHandle);
+    }
+  }
+  bInvalidationFlushScheduled = false;
+  Invalidations.Reset();
+  PrefetchQueue.Reset();
 }
 
 // ==================== Flag Access (Thread-Safe) ====================
@@ -210,6 +243,55 @@ bool UGatrixFeaturesClient::HasFlag(const FString& FlagName, bool bForceRealtime
   return FindFlag(FlagName, bForceRealtime, FlagCopy) != nullptr;
 }
 
+// ==================== Change Detection ====================
+
+int64 UGatrixFeaturesClient::GetGeneration(bool bForceRealtime) const {
+  const bool bRealtime = bForceRealtime || !ClientConfig.Features.bExplicitSyncMode;
+  return (bRealtime ? RealtimeGeneration : SyncedGeneration).load(std::memory_order_acquire);
+}
+
+int64 UGatrixFeaturesClient::GetFlagGeneration(const FString& FlagName,
+                                               bool bForceRealtime) const {
+  return GetFlagGenerationCounter(FlagName, bForceRealtime)->load(std::memory_order_acquire);
+}
+
+TSharedRef<const std::atomic<int64>, ESPMode::ThreadSafe>
+UGatrixFeaturesClient::GetFlagGenerationCounter(const FString& FlagName,
+                                                bool bForceRealtime) const {
+  const bool bRealtime = bForceRealtime || !ClientConfig.Features.bExplicitSyncMode;
+  FScopeLock Lock(&FlagsCriticalSection);
+  TMap<FString, FGenerationCounter>& Counters =
+      bRealtime ? RealtimeFlagGenerations : SyncedFlagGenerations;
+  if (const FGenerationCounter* Existing = Counters.Find(FlagName)) {
+    return *Existing;
+  }
+  const int64 Current = GetGeneration(bRealtime);
+  return Counters.Add(FlagName, MakeShared<std::atomic<int64>, ESPMode::ThreadSafe>(Current));
+}
+
+void UGatrixFeaturesClient::AdvanceGeneration(const FGatrixFlagDiff& Diff, bool bForceRealtime) {
+  // Caller holds FlagsCriticalSection
+  if (Diff.IsEmpty()) {
+    return;
+  }
+  std::atomic<int64>& Generation = bForceRealtime ? RealtimeGeneration : SyncedGeneration;
+  TMap<FString, FGenerationCounter>& Counters =
+      bForceRealtime ? RealtimeFlagGenerations : SyncedFlagGenerations;
+  const int64 Next = Generation.load(std::memory_order_relaxed) + 1;
+
+  // Flag versions first: a reader that sees the new generation also sees them
+  if (Counters.Num() > 0) {
+    for (const TArray<FString>* Names : {&Diff.Added, &Diff.Changed, &Diff.Removed}) {
+      for (const FString& Name : *Names) {
+        if (FGenerationCounter* Counter = Counters.Find(Name)) {
+          (*Counter)->store(Next, std::memory_order_release);
+        }
+      }
+    }
+  }
+  Generation.store(Next, std::memory_order_release);
+}
+
 // ==================== Variation Methods ====================
 
 FString UGatrixFeaturesClient::Variation(const FString& FlagName, const FString& FallbackValue,
@@ -352,6 +434,152 @@ FString UGatrixFeaturesClient::ComputeContextHash(const FGatrixContext& Context)
 
 void UGatrixFeaturesClient::UpdateContext(const FGatrixContext& NewContext,
                                           TFunction<void(bool, const FString&)> OnComplete) {
+  // Inside a transaction, or with fields staged this frame, the context merges into the staged
+  // one and completes when it is applied
+  if (ContextUpdateDepth > 0 || bHasStagedContext) {
+    StageContextFields(StageContext(), NewContext);
+    if (OnComplete) {
+      StagedContextCallbacks.Add(MoveTemp(OnComplete));
+    }
+    FlushStagedContext();
+    return;
+  }
+  ApplyContext(NewContext, MoveTemp(OnComplete));
+}
+
+void UGatrixFeaturesClient::SetContextField(const FString& Field, const FString& Value) {
+  FGatrixContext& Context = StageContext();
+  if (Field == TEXT("userId")) {
+    Context.UserId = Value;
+  } else if (Field == TEXT("sessionId")) {
+    Context.SessionId = Value;
+  } else if (Field == TEXT("remoteAddress")) {
+    Context.RemoteAddress = Value;
+  } else if (Field == TEXT("currentTime")) {
+    Context.CurrentTime = Value;
+  } else if (Field != TEXT("appName")) { // system field
+    Context.Properties.Add(Field, Value);
+  }
+  ScheduleContextFlush();
+}
+
+void UGatrixFeaturesClient::RemoveContextField(const FString& Field) {
+  FGatrixContext& Context = StageContext();
+  if (Field == TEXT("userId")) {
+    Context.UserId.Reset();
+  } else if (Field == TEXT("sessionId")) {
+    Context.SessionId.Reset();
+  } else if (Field == TEXT("remoteAddress")) {
+    Context.RemoteAddress.Reset();
+  } else if (Field == TEXT("currentTime")) {
+    Context.CurrentTime.Reset();
+  } else if (Field != TEXT("appName")) {
+    Context.Properties.Remove(Field);
+  }
+  ScheduleContextFlush();
+}
+
+void UGatrixFeaturesClient::BeginContextUpdate() { ContextUpdateDepth++; }
+
+void UGatrixFeaturesClient::CommitContextUpdate() { CommitContextUpdate(nullptr); }
+
+void UGatrixFeaturesClient::CommitContextUpdate(TFunction<void(bool, const FString&)> OnComplete) {
+  if (ContextUpdateDepth == 0) {
+    UE_LOG(LogGatrix, Warning, TEXT("CommitContextUpdate without BeginContextUpdate"));
+  } else {
+    ContextUpdateDepth--;
+  }
+  if (OnComplete) {
+    StagedContextCallbacks.Add(MoveTemp(OnComplete));
+  }
+  FlushStagedContext();
+}
+
+FGatrixContext& UGatrixFeaturesClient::StageContext() {
+  if (!bHasStagedContext) {
+    StagedContext = ClientConfig.Features.Context;
+    bHasStagedContext = true;
+  }
+  StagedChangeCount++;
+  return StagedContext;
+}
+
+void UGatrixFeaturesClient::StageContextFields(FGatrixContext& Staged,
+                                               const FGatrixContext& Update) {
+  // An empty field does not clear one staged earlier in the transaction; RemoveContextField
+  // does that
+  if (!Update.UserId.IsEmpty()) {
+    Staged.UserId = Update.UserId;
+  }
+  if (!Update.SessionId.IsEmpty()) {
+    Staged.SessionId = Update.SessionId;
+  }
+  if (!Update.RemoteAddress.IsEmpty()) {
+    Staged.RemoteAddress = Update.RemoteAddress;
+  }
+  if (!Update.CurrentTime.IsEmpty()) {
+    Staged.CurrentTime = Update.CurrentTime;
+  }
+  for (const TPair<FString, FString>& Property : Update.Properties) {
+    Staged.Properties.Add(Property.Key, Property.Value);
+  }
+}
+
+void UGatrixFeaturesClient::ScheduleContextFlush() {
+  // Inside a transaction the commit applies
+  if (ContextUpdateDepth > 0 || bContextFlushScheduled) {
+    return;
+  }
+
+  // Outside one, everything staged this frame is applied on the next tick
+  UWorld* World = nullptr;
+  if (GEngine && GEngine->GetWorldContexts().Num() > 0) {
+    World = GEngine->GetWorldContexts()[0].World();
+  }
+  if (!World) {
+    FlushStagedContext();
+    return;
+  }
+  bContextFlushScheduled = true;
+  World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this]() {
+    if (bContextFlushScheduled) {
+      FlushStagedContext();
+    }
+  }));
+}
+
+void UGatrixFeaturesClient::FlushStagedContext() {
+  if (ContextUpdateDepth > 0) {
+    return;
+  }
+  bContextFlushScheduled = false;
+
+  // One completion for everyone who waited on the staged changes
+  TFunction<void(bool, const FString&)> OnComplete;
+  if (StagedContextCallbacks.Num() > 0) {
+    OnComplete = [Callbacks = MoveTemp(StagedContextCallbacks)](bool bSuccess,
+                                                                const FString& Error) {
+      for (const auto& Callback : Callbacks) {
+        Callback(bSuccess, Error);
+      }
+    };
+    StagedContextCallbacks.Reset();
+  }
+
+  if (!bHasStagedContext) {
+    if (OnComplete) {
+      OnComplete(true, TEXT(""));
+    }
+    return;
+  }
+  bHasStagedContext = false;
+  ContextCoalescedCount.Add(StagedChangeCount - 1);
+  StagedChangeCount = 0;
+  ApplyContext(StagedContext, MoveTemp(OnComplete));
+}
+
+void UGatrixFeaturesClient::ApplyContext(const FGatrixContext& NewContext,
+                                         TFunction<void(bool, const FString&)> OnComplete) {
   // Preserve system fields
   FGatrixContext MergedContext = NewContext;
   MergedContext.AppName = ClientConfig.AppName;
@@ -420,6 +648,21 @@ void UGatrixFeaturesClient::UpdateContext(const FGatrixContext& NewContext,
   LastContextHash = NewHash;
   ContextChangeCount.Increment();
 
+  // Evaluated ahead of time: publish it and complete without a request
+  TArray<FGatrixEvaluatedFlag> PrefetchedFlags;
+  FString PrefetchedEtag;
+  if (TakePrefetched(NewHash, PrefetchedFlags, PrefetchedEtag)) {
+    Etag = PrefetchedEtag;
+    if (StorageProvider.IsValid()) {
+      StorageProvider->Save(StorageKeyEtag, Etag);
+    }
+    StoreFlags(PrefetchedFlags, !bFetchedFromServer);
+    if (OnComplete) {
+      OnComplete(true, TEXT(""));
+    }
+    return;
+  }
+
   // If not running or offline, no fetch will happen — notify immediately
   if (!bStarted || ClientConfig.Features.bOfflineMode) {
     if (OnComplete) {
@@ -437,6 +680,329 @@ void UGatrixFeaturesClient::UpdateContext(const FGatrixContext& NewContext,
   FetchFlags();
 }
 
+void UGatrixFeaturesClient::PrefetchContext(const FGatrixContext& Context) {
+  // Nothing to fetch offline
+  if (ClientConfig.Features.bOfflineMode || ClientConfig.Features.PrefetchCacheSize <= 0) {
+    return;
+  }
+
+  FGatrixContext MergedContext = Context;
+  MergedContext.AppName = ClientConfig.AppName;
+  FString Hash = ComputeContextHash(MergedContext);
+  if (Hash == LastContextHash || Prefetched->Entries.Contains(Hash)) {
+    return;
+  }
+  for (const auto& Queued : PrefetchQueue) {
+    if (Queued.Key == Hash) {
+      return;
+    }
+  }
+
+  // Only the most recent guesses are worth a request
+  PrefetchQueue.Emplace(MoveTemp(Hash), MoveTemp(MergedContext));
+  if (PrefetchQueue.Num() > ClientConfig.Features.PrefetchCacheSize) {
+    PrefetchQueue.RemoveAt(0);
+  }
+  DrainPrefetchQueue();
+}
+
+TSharedRef<UGatrixFeaturesClient::FPrefetchPool>
+UGatrixFeaturesClient::AcquirePrefetchPool(const FGatrixClientConfig& Config) {
+  static TMap<FString, TWeakPtr<FPrefetchPool>> Pools;
+  const FString Key =
+      FString::Printf(TEXT("%s|%s|%s|%d"), *Config.ApiUrl, *Config.ApiToken, *Config.AppName,
+                      Config.Features.PrefetchCacheSize);
+
+  TSharedPtr<FPrefetchPool> Pool = Pools.FindRef(Key).Pin();
+  if (!Pool.IsValid()) {
+    Pool = MakeShared<FPrefetchPool>();
+    Pools.Add(Key, Pool);
+  }
+  for (auto It = Pools.CreateIterator(); It; ++It) {
+    if (!It->Value.IsValid()) {
+      It.RemoveCurrent();
+    }
+  }
+  return Pool.ToSharedRef();
+}
+
+bool UGatrixFeaturesClient::TakePrefetched(const FString& ContextHash,
+                                           TArray<FGatrixEvaluatedFlag>& OutFlags,
+                                           FString& OutEtag) {
+  FPrefetchedEvaluation Entry;
+  if (!Prefetched->Entries.RemoveAndCopyValue(ContextHash, Entry)) {
+    return false;
+  }
+  Prefetched->Order.Remove(ContextHash);
+
+  if (FPlatformTime::Seconds() - Entry.StoredAt > ClientConfig.Features.PrefetchMaxAge) {
+    // Too old to publish without revalidating; counted as wasted
+    return false;
+  }
+
+  Prefetched->HitCount.Increment();
+  Prefetched->UsedBytes.Add(Entry.Bytes);
+  OutFlags = MoveTemp(Entry.Flags);
+  OutEtag = MoveTemp(Entry.Etag);
+  return true;
+}
+
+void UGatrixFeaturesClient::DrainPrefetchQueue() {
+  if (bPrefetchInFlight || PrefetchQueue.Num() == 0 || !bStarted) {
+    return;
+  }
+
+  // Low priority: never compete with a fetch of the current context
+  if (bIsFetching || bStreamingFetching) {
+    if (GEngine && GEngine->GetWorldContexts().Num() > 0) {
+      if (UWorld* World = GEngine->GetWorldContexts()[0].World()) {
+        World->GetTimerManager().SetTimer(
+            PrefetchTimerHandle,
+            FTimerDelegate::CreateWeakLambda(this, [this]() { DrainPrefetchQueue(); }), 0.25f,
+            false);
+      }
+    }
+    return;
+  }
+
+  const FString Hash = PrefetchQueue[0].Key;
+  const FGatrixContext Context = PrefetchQueue[0].Value;
+  PrefetchQueue.RemoveAt(0);
+  bPrefetchInFlight = true;
+
+  bool bUsePOST = ClientConfig.Features.bUsePOSTRequests;
+  TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+  HttpRequest->SetURL(BuildFetchUrl(Context));
+  HttpRequest->SetVerb(bUsePOST ? TEXT("POST") : TEXT("GET"));
+  HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+  HttpRequest->SetHeader(TEXT("X-API-Token"), ClientConfig.ApiToken);
+  HttpRequest->SetHeader(TEXT("X-Application-Name"), ClientConfig.AppName);
+  HttpRequest->SetHeader(TEXT("X-Connection-Id"), ConnectionId);
+  HttpRequest->SetHeader(TEXT("X-Gatrix-Context-Hash"), Hash);
+  HttpRequest->SetHeader(
+      TEXT("X-SDK-Version"),
+      FString::Printf(TEXT("%s/%s"), *UGatrixClient::SdkName, *UGatrixClient::SdkVersion));
+  if (ClientConfig.Features.bEnableCompression) {
+    HttpRequest->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip, deflate"));
+  }
+  for (const auto& Header : ClientConfig.CustomHeaders) {
+    HttpRequest->SetHeader(Header.Key, Header.Value);
+  }
+  if (bUsePOST) {
+    SetCompressedBody(HttpRequest, FGatrixJson::SerializeContext(ClientConfig.AppName, Context));
+  }
+  HttpRequest->SetTimeout(ClientConfig.Features.FetchRetryOptions.Timeout);
+
+  HttpRequest->OnProcessRequestComplete().BindLambda(
+      [this, Hash](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+        if (!bWasSuccessful || !Response.IsValid() || Response->GetResponseCode() != 200) {
+          UE_LOG(LogGatrix, Verbose, TEXT("Prefetch failed (code=%d)"),
+                 Response.IsValid() ? Response->GetResponseCode() : -1);
+          bPrefetchInFlight = false;
+          DrainPrefetchQueue();
+          return;
+        }
+
+        // Parse off the game thread; only the result is handed back
+        TWeakObjectPtr<UGatrixFeaturesClient> WeakThis(this);
+        const bool bCompressed = ClientConfig.Features.bEnableCompression &&
+                                 FGatrixCompression::IsCompressed(Response->GetContent());
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+                  [WeakThis, Hash, bCompressed, Content = Response->GetContent(),
+                   NewEtag = Response->GetHeader(TEXT("ETag"))]() {
+          TSharedPtr<FGatrixJson::FFlagsPayload, ESPMode::ThreadSafe> Parsed =
+              MakeShared<FGatrixJson::FFlagsPayload, ESPMode::ThreadSafe>();
+          bool bParsed = false;
+          TArray<uint8> Decompressed;
+          if (!bCompressed || FGatrixCompression::Inflate(Content, Decompressed)) {
+            const TArray<uint8>& Body = bCompressed ? Decompressed : Content;
+            FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Body.GetData()), Body.Num());
+            bParsed = FGatrixJson::ParseFlagsPayload(FString(Converter.Length(), Converter.Get()),
+                                                     *Parsed);
+          }
+          const int64 WireBytes = Content.Num();
+
+          AsyncTask(ENamedThreads::GameThread, [WeakThis, Hash, NewEtag, Parsed, bParsed,
+                                                WireBytes]() {
+            UGatrixFeaturesClient* Self = WeakThis.Get();
+            if (!Self) {
+              return;
+            }
+            Self->bPrefetchInFlight = false;
+
+            // A context switched to meanwhile is fetched normally; keep the cache to guesses
+            if (bParsed && Hash != Self->LastContextHash) {
+              FPrefetchPool& Pool = *Self->Prefetched;
+              FPrefetchedEvaluation& Entry = Pool.Entries.Add(Hash);
+              Entry.Flags = MoveTemp(Parsed->Flags);
+              Entry.Etag = NewEtag;
+              Entry.StoredAt = FPlatformTime::Seconds();
+              Entry.Bytes = WireBytes;
+              Pool.Order.Remove(Hash);
+              Pool.Order.Add(Hash);
+              while (Pool.Order.Num() > Self->ClientConfig.Features.PrefetchCacheSize) {
+                Pool.Entries.Remove(Pool.Order[0]);
+                Pool.Order.RemoveAt(0);
+              }
+              Pool.Count.Increment();
+              Pool.Bytes.Add(WireBytes);
+            }
+            Self->DrainPrefetchQueue();
+          });
+        });
+      });
+
+  HttpRequest->ProcessRequest();
+}
+
+// ==================== Bulk Evaluation ====================
+
+struct UGatrixFeaturesClient::FBulkEvaluationCall {
+  TArray<TSharedPtr<FGatrixBulkEvaluation, ESPMode::ThreadSafe>> Batches; // by batch index
+  int32 Pending = 0;
+  FString Error; // first failure
+  TFunction<void(bool, const FString&, FBulkEvaluationPtr)> OnComplete;
+};
+
+void UGatrixFeaturesClient::EvaluateContexts(
+    const TArray<FGatrixContext>& Contexts, const TArray<FString>& FlagNames,
+    TFunction<void(bool, const FString&, FBulkEvaluationPtr)> OnComplete) {
+  if (ClientConfig.Features.bOfflineMode) {
+    if (OnComplete) {
+      OnComplete(false, TEXT("Bulk evaluation is not available offline"), nullptr);
+    }
+    return;
+  }
+  if (Contexts.Num() == 0) {
+    if (OnComplete) {
+      OnComplete(true, FString(), MakeShared<FGatrixBulkEvaluation, ESPMode::ThreadSafe>());
+    }
+    return;
+  }
+
+  // Batches are sent together; their slots are joined in order once all have arrived
+  const int32 BatchSize = FMath::Max(1, ClientConfig.Features.BulkEvaluationBatchSize);
+  const int32 NumBatches = FMath::DivideAndRoundUp(Contexts.Num(), BatchSize);
+  TSharedRef<FBulkEvaluationCall> Call = MakeShared<FBulkEvaluationCall>();
+  Call->Batches.SetNum(NumBatches);
+  Call->Pending = NumBatches;
+  Call->OnComplete = MoveTemp(OnComplete);
+  BulkEvaluationCount.Increment();
+  BulkContextCount.Add(Contexts.Num());
+
+  const TArrayView<const FGatrixContext> AllContexts(Contexts);
+  for (int32 Batch = 0; Batch < NumBatches; ++Batch) {
+    const int32 First = Batch * BatchSize;
+    SendBulkEvaluationBatch(Call, Batch,
+                            AllContexts.Slice(First, FMath::Min(BatchSize, Contexts.Num() - First)),
+                            FlagNames);
+  }
+}
+
+void UGatrixFeaturesClient::SendBulkEvaluationBatch(const TSharedRef<FBulkEvaluationCall>& Call,
+                                                    int32 Batch,
+                                                    TArrayView<const FGatrixContext> Contexts,
+                                                    const TArray<FString>& FlagNames) {
+  TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+  // URL pattern: {apiUrl}/client/features/eval/bulk
+  HttpRequest->SetURL(FString::Printf(TEXT("%s/client/features/eval/bulk"), *ClientConfig.ApiUrl));
+  HttpRequest->SetVerb(TEXT("POST"));
+  HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+  HttpRequest->SetHeader(TEXT("X-API-Token"), ClientConfig.ApiToken);
+  HttpRequest->SetHeader(TEXT("X-Application-Name"), ClientConfig.AppName);
+  HttpRequest->SetHeader(TEXT("X-Connection-Id"), ConnectionId);
+  HttpRequest->SetHeader(
+      TEXT("X-SDK-Version"),
+      FString::Printf(TEXT("%s/%s"), *UGatrixClient::SdkName, *UGatrixClient::SdkVersion));
+  if (ClientConfig.Features.bEnableCompression) {
+    HttpRequest->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip, deflate"));
+  }
+  for (const auto& Header : ClientConfig.CustomHeaders) {
+    HttpRequest->SetHeader(Header.Key, Header.Value);
+  }
+  SetCompressedBody(HttpRequest,
+                    FGatrixJson::SerializeContexts(ClientConfig.AppName, Contexts, FlagNames));
+  HttpRequest->SetTimeout(ClientConfig.Features.FetchRetryOptions.Timeout);
+
+  // Runs on the game thread once per batch; the last one completes the call
+  TWeakObjectPtr<UGatrixFeaturesClient> WeakThis(this);
+  auto FinishBatch = [WeakThis, Call](int32 Index,
+                                      TSharedPtr<FGatrixBulkEvaluation, ESPMode::ThreadSafe> Result,
+                                      const FString& Error) {
+    Call->Batches[Index] = Result;
+    if (!Result.IsValid() && Call->Error.IsEmpty()) {
+      Call->Error = Error;
+    }
+    if (--Call->Pending > 0) {
+      return;
+    }
+
+    if (!Call->Error.IsEmpty()) {
+      UE_LOG(LogGatrix, Warning, TEXT("EvaluateContexts failed: %s"), *Call->Error);
+      if (Call->OnComplete) {
+        Call->OnComplete(false, Call->Error, nullptr);
+      }
+      return;
+    }
+
+    TSharedPtr<FGatrixBulkEvaluation, ESPMode::ThreadSafe> Evaluation = Call->Batches[0];
+    for (int32 Next = 1; Next < Call->Batches.Num(); ++Next) {
+      Evaluation->Append(*Call->Batches[Next]);
+    }
+    Call->Batches.Reset();
+    if (UGatrixFeaturesClient* Self = WeakThis.Get()) {
+      Self->LastBulkReuseRatio = Evaluation->GetReuseRatio();
+    }
+    UE_LOG(LogGatrix, Log, TEXT("EvaluateContexts: %d contexts, %d distinct records (%.1fx reuse)"),
+           Evaluation->GetSlotCount(), Evaluation->GetRecordCount(), Evaluation->GetReuseRatio());
+    if (Call->OnComplete) {
+      Call->OnComplete(true, FString(), Evaluation);
+    }
+  };
+
+  const int32 ExpectedSlots = Contexts.Num();
+  const bool bCompressionEnabled = ClientConfig.Features.bEnableCompression;
+  HttpRequest->OnProcessRequestComplete().BindLambda(
+      [FinishBatch, Batch, ExpectedSlots, bCompressionEnabled](
+          FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+        if (!bWasSuccessful || !Response.IsValid() || Response->GetResponseCode() != 200) {
+          const FString Error =
+              FString::Printf(TEXT("Bulk evaluation request failed (code=%d)"),
+                              Response.IsValid() ? Response->GetResponseCode() : -1);
+          AsyncTask(ENamedThreads::GameThread,
+                    [FinishBatch, Batch, Error]() { FinishBatch(Batch, nullptr, Error); });
+          return;
+        }
+
+        // Hundreds of contexts: parse off the game thread, hand back the batch
+        const bool bCompressed =
+            bCompressionEnabled && FGatrixCompression::IsCompressed(Response->GetContent());
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+                  [FinishBatch, Batch, ExpectedSlots, bCompressed,
+                   Content = Response->GetContent()]() {
+          TSharedPtr<FGatrixBulkEvaluation, ESPMode::ThreadSafe> Result =
+              MakeShared<FGatrixBulkEvaluation, ESPMode::ThreadSafe>();
+          bool bParsed = false;
+          TArray<uint8> Decompressed;
+          if (!bCompressed || FGatrixCompression::Inflate(Content, Decompressed)) {
+            const TArray<uint8>& Body = bCompressed ? Decompressed : Content;
+            FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Body.GetData()), Body.Num());
+            bParsed = FGatrixJson::ParseBulkEvaluation(
+                FString(Converter.Length(), Converter.Get()), ExpectedSlots, *Result);
+          }
+          if (!bParsed) {
+            Result.Reset();
+          }
+
+          AsyncTask(ENamedThreads::GameThread, [FinishBatch, Batch, Result]() {
+            FinishBatch(Batch, Result, TEXT("Invalid bulk evaluation response"));
+          });
+        });
+      });
+
+  HttpRequest->ProcessRequest();
+}
+
 FGatrixContext UGatrixFeaturesClient::GetContext() const {
   return ClientConfig.Features.Context;
 }
@@ -458,16 +1024,14 @@ void UGatrixFeaturesClient::SyncFlags(bool bFetchNow,
 
   {
     FScopeLock Lock(&FlagsCriticalSection);
-    TMap<FString, FGatrixEvaluatedFlag> OldFlags = SynchronizedFlags;
-    FString OldHash = FlagsContextHash;
-    FString NewHash = LastContextHash;
+    const FGatrixFlagDiff Diff = FGatrixFlagDiff::Compute(SynchronizedFlags, RealtimeFlags);
 
     SynchronizedFlags = RealtimeFlags;
-    FlagsContextHash = NewHash;
+    FlagsContextHash = LastContextHash;
+    AdvanceGeneration(Diff, /*bForceRealtime=*/false);
 
-    EmitFlagChanges(OldFlags, SynchronizedFlags);
-    InvokeWatchCallbacks(SyncedWatchCallbacks, OldFlags, SynchronizedFlags,
-                         /*bForceRealtime=*/false, OldHash, NewHash);
+    EmitFlagChanges(Diff, SynchronizedFlags);
+    InvokeWatchCallbacks(SyncedWatchCallbacks, Diff, /*bForceRealtime=*/false);
   }
 
   SyncFlagsCount.Increment();
@@ -497,15 +1061,19 @@ void UGatrixFeaturesClient::SetExplicitSyncMode(bool bEnabled) {
 
   ClientConfig.Features.bExplicitSyncMode = bEnabled;
 
+  FScopeLock Lock(&FlagsCriticalSection);
   if (bEnabled) {
     // Copy current realtime flags as the synchronized snapshot
-    FScopeLock Lock(&FlagsCriticalSection);
+    const FGatrixFlagDiff Diff = FGatrixFlagDiff::Compute(SynchronizedFlags, RealtimeFlags);
     SynchronizedFlags = RealtimeFlags;
-    bPendingSync = false;
-  } else {
-    // Apply any pending flags immediately
-    bPendingSync = false;
+    AdvanceGeneration(Diff, /*bForceRealtime=*/false);
   }
+  // Reads switch snapshots (disabling applies any pending flags immediately); neither
+  // generation may go backwards, so both continue from the larger one
+  const int64 Generation = FMath::Max(RealtimeGeneration.load(), SyncedGeneration.load());
+  RealtimeGeneration.store(Generation, std::memory_order_release);
+  SyncedGeneration.store(Generation, std::memory_order_release);
+  bPendingSync = false;
 }
 
 // ==================== Fetch ====================
@@ -522,7 +1090,14 @@ void UGatrixFeaturesClient::FetchFlags(TFunction<void(bool, const FString&)> OnC
   if (bIsFetching || !bStarted)
     return;
 
+  // Single-flight: run after an in-flight partial fetch instead of racing it
+  if (bStreamingFetching) {
+    bFullFetchQueued = true;
+    return;
+  }
+
   bIsFetching = true;
+  bFullFetchQueued = false;
 
   if (ClientConfig.bEnableDevMode) {
     UE_LOG(LogGatrix, Log, TEXT("[DEV] FetchFlags: starting fetch. etag=%s"), *Etag);
@@ -540,9 +1115,16 @@ void UGatrixFeaturesClient::DoFetchFlags() {
   FetchStartContextHash = LastContextHash;
   LastContextHash = ComputeContextHash(ClientConfig.Features.Context);
 
-  FString Url = BuildFetchUrl();
+  FString Url = BuildFetchUrl(ClientConfig.Features.Context);
   bool bUsePOST = ClientConfig.Features.bUsePOSTRequests;
 
+  // Delta basis: the server answers with only added/changed/removed flags since this revision
+  bDeltaRequested = CanDeltaSync();
+  if (bDeltaRequested) {
+    Url += FString::Printf(TEXT("%ssince=%lld"), Url.Contains(TEXT("?")) ? TEXT("&") : TEXT("?"),
+                           SyncRevision);
+  }
+
   TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
   HttpRequest->SetURL(Url);
   HttpRequest->SetVerb(bUsePOST ? TEXT("POST") : TEXT("GET"));
@@ -560,6 +1142,13 @@ void UGatrixFeaturesClient::DoFetchFlags() {
     HttpRequest->SetHeader(TEXT("If-None-Match"), Etag);
   }
 
+  if (ClientConfig.Features.bEnableCompression) {
+    HttpRequest->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip, deflate"));
+  }
+  if (ClientConfig.Features.bEnableScheduledActivations) {
+    HttpRequest->SetHeader(TEXT("X-Gatrix-Accept-Scheduled"), TEXT("true"));
+  }
+
   // Custom headers
   for (const auto& Header : ClientConfig.CustomHeaders) {
     HttpRequest->SetHeader(Header.Key, Header.Value);
@@ -567,7 +1156,7 @@ void UGatrixFeaturesClient::DoFetchFlags() {
 
   // POST body with context
   if (bUsePOST) {
-    HttpRequest->SetContentAsString(FGatrixJson::SerializeContext(ClientConfig));
+    SetCompressedBody(HttpRequest, FGatrixJson::SerializeContext(ClientConfig));
   }
 
   // Set timeout
@@ -579,11 +1168,12 @@ void UGatrixFeaturesClient::DoFetchFlags() {
 
   // HTTP response callback - runs on game thread in UE4
   HttpRequest->OnProcessRequestComplete().BindLambda(
-      [this](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+      [this, SentSeconds = FPlatformTime::Seconds()](FHttpRequestPtr Request,
+                                                     FHttpResponsePtr Response,
+                                                     bool bWasSuccessful) {
         // Already on game thread in UE4 FHttpModule
-        bIsFetching = false;
-
         if (!bWasSuccessful || !Response.IsValid()) {
+          bIsFetching = false;
           FString ErrorMsg = TEXT("Network error: request failed");
           if (EventEmitter) {
             EventEmitter->Emit(GatrixEvents::FlagsFetchError, ErrorMsg);
@@ -631,48 +1221,122 @@ void UGatrixFeaturesClient::DoFetchFlags() {
         }
 
         int32 HttpStatus = Response->GetResponseCode();
-        FString ResponseBody = Response->GetContentAsString();
+        ApplyPollingHints(Response);
+        SampleServerClock(Response, SentSeconds);
 
         // ETag from response
         FString NewEtag = Response->GetHeader(TEXT("ETag"));
 
-        HandleFetchResponse(ResponseBody, HttpStatus, NewEtag);
-
-        if (EventEmitter) {
-          EventEmitter->Emit(GatrixEvents::FlagsFetchEnd);
+        // Compressed body the HTTP backend did not decode: inflate + parse off the
+        // game thread. bIsFetching stays set until the result is applied.
+        if (HttpStatus == 200 && ClientConfig.Features.bEnableCompression &&
+            FGatrixCompression::IsCompressed(Response->GetContent())) {
+          DecodeFetchResponseAsync(Response->GetContent(), NewEtag);
+          return;
         }
 
-        // Priority 1: Context changed during fetch -> re-fetch with new context
-        if (LastContextHash != FetchStartContextHash) {
-          UE_LOG(LogGatrix, Log, TEXT("Context changed during fetch, triggering re-fetch"));
-          Etag = TEXT("");
-          PendingInvalidationKeys.Empty();
-          FetchFlags();
-        }
-        // Priority 2: Pending invalidation keys from streaming
-        else if (PendingInvalidationKeys.Num() > 0) {
-          TSet<FString> PendingCopy = MoveTemp(PendingInvalidationKeys);
-          PendingInvalidationKeys.Empty();
-          if (PendingCopy.Contains(TEXT("*"))) {
-            Etag = TEXT("");
-            FetchFlags();
-          } else {
-            int32 TotalFlags = RealtimeFlags.Num();
-            if (TotalFlags == 0 || PendingCopy.Num() >= TotalFlags / 2) {
-              Etag = TEXT("");
-              FetchFlags();
-            } else {
-              FetchPartialFlags(PendingCopy.Array());
-            }
-          }
-        }
+        bIsFetching = false;
+        HandleFetchResponse(Response->GetContentAsString(), HttpStatus, NewEtag);
+        FinishFetchCycle();
       });
 
   HttpRequest->ProcessRequest();
 }
 
+void UGatrixFeaturesClient::SetCompressedBody(
+    const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& HttpRequest, const FString& Body) {
+  FTCHARToUTF8 Utf8(*Body);
+  TArray<uint8> Payload(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+  RequestBytesRaw.Add(Payload.Num());
+
+  TArray<uint8> Compressed;
+  if (ClientConfig.Features.bEnableCompression &&
+      Payload.Num() >= ClientConfig.Features.CompressionMinBytes &&
+      FGatrixCompression::Gzip(Payload, Compressed)) {
+    HttpRequest->SetHeader(TEXT("Content-Encoding"), TEXT("gzip"));
+    Payload = MoveTemp(Compressed);
+  }
+
+  RequestBytesSent.Add(Payload.Num());
+  HttpRequest->SetContent(MoveTemp(Payload));
+}
+
+void UGatrixFeaturesClient::DecodeFetchResponseAsync(TArray<uint8> Compressed,
+                                                     const FString& EtagHeader) {
+  TWeakObjectPtr<UGatrixFeaturesClient> WeakThis(this);
+
+  AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis,
+                                                            Compressed = MoveTemp(Compressed),
+                                                            EtagHeader]() {
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<uint8> Decompressed;
+    TSharedPtr<FGatrixJson::FFlagsPayload, ESPMode::ThreadSafe> Parsed =
+        MakeShared<FGatrixJson::FFlagsPayload, ESPMode::ThreadSafe>();
+    FString Error;
+    if (!FGatrixCompression::Inflate(Compressed, Decompressed)) {
+      Error = TEXT("Decompression error");
+    } else {
+      FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Decompressed.GetData()),
+                             Decompressed.Num());
+      FString Body(Converter.Length(), Converter.Get());
+      if (!FGatrixJson::ParseFlagsPayload(Body, *Parsed)) {
+        Error = TEXT("JSON parse error");
+      }
+    }
+
+    const float DecodeMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    const int64 WireBytes = Compressed.Num();
+    const int64 InflatedBytes = Decompressed.Num();
+
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Parsed, Error, EtagHeader, DecodeMs,
+                                          WireBytes, InflatedBytes]() {
+      UGatrixFeaturesClient* Self = WeakThis.Get();
+      if (!Self || !Self->bStarted) {
+        if (Self)
+          Self->bIsFetching = false;
+        return;
+      }
+
+      Self->CompressedBytesReceived.Add(WireBytes);
+      Self->DecompressedBytes.Add(InflatedBytes);
+      Self->LastDecodeTimeMs = DecodeMs;
+      Self->bIsFetching = false;
+
+      if (!Error.IsEmpty()) {
+        UE_LOG(LogGatrix, Error, TEXT("Failed to decode compressed flags response: %s"), *Error);
+        if (Self->EventEmitter) {
+          Self->EventEmitter->Emit(GatrixEvents::FlagsFetchError, Error);
+        }
+      } else {
+        Self->HandleFetchResponse(FString(), 200, EtagHeader, Parsed.Get());
+      }
+      Self->FinishFetchCycle();
+    });
+  });
+}
+
+void UGatrixFeaturesClient::FinishFetchCycle() {
+  if (EventEmitter) {
+    EventEmitter->Emit(GatrixEvents::FlagsFetchEnd);
+  }
+
+  // Priority 1: Context changed during fetch -> re-fetch with new context
+  if (LastContextHash != FetchStartContextHash) {
+    UE_LOG(LogGatrix, Log, TEXT("Context changed during fetch, triggering re-fetch"));
+    Etag = TEXT("");
+    Invalidations.Reset();
+    FetchFlags();
+  }
+  // Priority 2: Invalidations merged while in flight (an open window flushes on its timer)
+  else if (Invalidations.HasPending() && !bInvalidationFlushScheduled) {
+    FlushInvalidations();
+  }
+}
+
 void UGatrixFeaturesClient::HandleFetchResponse(const FString& ResponseBody, int32 HttpStatus,
-                                                const FString& EtagHeader) {
+                                                const FString& EtagHeader,
+                                                const FGatrixJson::FFlagsPayload* PreParsed) {
   // Check for recovery from error state
   if (SdkState == EGatrixSdkState::Error && HttpStatus < 400) {
     SdkState = EGatrixSdkState::Healthy;
@@ -684,26 +1348,65 @@ void UGatrixFeaturesClient::HandleFetchResponse(const FString& ResponseBody, int
   }
 
   if (HttpStatus == 200) {
+    // The response belongs to the context the request was sent for; after a switch
+    // FinishFetchCycle refetches for the current one
+    const bool bContextSwitched = FetchStartContextHash != LastContextHash;
+
     // Update ETag
-    if (!EtagHeader.IsEmpty() && EtagHeader != Etag) {
+    if (!bContextSwitched && !EtagHeader.IsEmpty() && EtagHeader != Etag) {
       Etag = EtagHeader;
       if (StorageProvider.IsValid()) {
         StorageProvider->Save(StorageKeyEtag, Etag);
       }
     }
 
-    // Parse response JSON via GatrixJson utility
-    TArray<FGatrixEvaluatedFlag> ParsedFlags;
-    if (!FGatrixJson::ParseFlagsResponse(ResponseBody, ParsedFlags)) {
-      UE_LOG(LogGatrix, Error, TEXT("Failed to parse flags response JSON"));
-      if (EventEmitter) {
-        EventEmitter->Emit(GatrixEvents::FlagsFetchError, TEXT("JSON parse error"));
+    // Parse response JSON via GatrixJson utility (unless decoded off-thread already)
+    FGatrixJson::FFlagsPayload Parsed;
+    if (!PreParsed) {
+      if (!FGatrixJson::ParseFlagsPayload(ResponseBody, Parsed)) {
+        UE_LOG(LogGatrix, Error, TEXT("Failed to parse flags response JSON"));
+        if (EventEmitter) {
+          EventEmitter->Emit(GatrixEvents::FlagsFetchError, TEXT("JSON parse error"));
+        }
+        return;
       }
-      return;
+      PreParsed = &Parsed;
     }
 
-    bool bIsInitialFetch = !bFetchedFromServer;
-    StoreFlags(ParsedFlags, bIsInitialFetch);
+    if (PreParsed->Revision > 0 && !bContextSwitched) {
+      SyncRevision = PreParsed->Revision;
+      SyncRevisionContextHash = FetchStartContextHash;
+    }
+
+    if (PreParsed->bIsDelta && bContextSwitched) {
+      // Patches the previous context's flags: dropped
+      UE_LOG(LogGatrix, Verbose, TEXT("Dropped delta for a context switched away from"));
+    } else if (PreParsed->bIsDelta) {
+      // Patch the realtime snapshot; only touched records hit the diff
+      MergeFlags(PreParsed->Flags, TSet<FString>(PreParsed->Removed));
+      EnqueueScheduledChanges(PreParsed->Scheduled, false);
+      if (!EtagHeader.IsEmpty() && EtagHeader != Etag) {
+        // The server's own validator over the one recomputed by the merge
+        Etag = EtagHeader;
+        if (StorageProvider.IsValid()) {
+          StorageProvider->Save(StorageKeyEtag, Etag);
+        }
+      }
+      DeltaFetchCount.Increment();
+      UE_LOG(LogGatrix, Verbose, TEXT("Applied delta: %d upserts, %d removed, revision=%lld"),
+             PreParsed->Flags.Num(), PreParsed->Removed.Num(), SyncRevision);
+    } else {
+      if (bDeltaRequested) {
+        // Server could not serve a delta (log truncated or unsupported): full snapshot
+        DeltaFallbackCount.Increment();
+      }
+      bool bIsInitialFetch = !bFetchedFromServer;
+      StoreFlags(PreParsed->Flags, bIsInitialFetch);
+      // A full response lists every pending change; ones missing from it were withdrawn
+      if (PreParsed->bHasSchedule) {
+        EnqueueScheduledChanges(PreParsed->Scheduled, true);
+      }
+    }
 
     UpdateCount.Increment();
 
@@ -838,22 +1541,27 @@ void UGatrixFeaturesClient::HandleFetchResponse(const FString& ResponseBody, int
 void UGatrixFeaturesClient::StoreFlags(const TArray<FGatrixEvaluatedFlag>& NewFlags,
                                        bool bIsInitialFetch) {
   TMap<FString, FGatrixEvaluatedFlag> OldFlags;
+  FGatrixFlagDiff Diff;
 
   {
     FScopeLock Lock(&FlagsCriticalSection);
-    OldFlags = RealtimeFlags;
-    FString OldHash = FlagsContextHash;
-    FString NewHash = LastContextHash;
+    OldFlags = MoveTemp(RealtimeFlags);
 
-    RealtimeFlags.Empty();
+    RealtimeFlags.Empty(NewFlags.Num());
     for (const auto& Flag : NewFlags) {
       RealtimeFlags.Add(Flag.Name, Flag);
     }
-    FlagsContextHash = NewHash;
+    FlagsContextHash = LastContextHash;
+
+    // Content-hash diff: one integer compare per flag, no variant value comparisons
+    Diff = FGatrixFlagDiff::Compute(OldFlags, RealtimeFlags);
+    UpdateEtagSource(Diff);
+    AdvanceGeneration(Diff, /*bForceRealtime=*/true);
 
     // In non-explicit-sync mode, also update synchronized flags
     if (!ClientConfig.Features.bExplicitSyncMode) {
       SynchronizedFlags = RealtimeFlags;
+      AdvanceGeneration(Diff, /*bForceRealtime=*/false);
     } else {
       bool bWasPending = bPendingSync;
       bPendingSync = true;
@@ -863,14 +1571,12 @@ void UGatrixFeaturesClient::StoreFlags(const TArray<FGatrixEvaluatedFlag>& NewFl
     }
 
     // Always invoke realtime flag changes (events) and watch callbacks
-    EmitFlagChanges(OldFlags, RealtimeFlags);
-    InvokeWatchCallbacks(RealtimeWatchCallbacks, OldFlags, RealtimeFlags, /*bForceRealtime=*/true, OldHash,
-                         NewHash);
+    EmitFlagChanges(Diff, RealtimeFlags);
+    InvokeWatchCallbacks(RealtimeWatchCallbacks, Diff, /*bForceRealtime=*/true);
 
     if (!ClientConfig.Features.bExplicitSyncMode) {
       // In non-explicit mode, also invoke synced callbacks and global change events
-      InvokeWatchCallbacks(SyncedWatchCallbacks, OldFlags, RealtimeFlags, /*bForceRealtime=*/false,
-                           OldHash, NewHash);
+      InvokeWatchCallbacks(SyncedWatchCallbacks, Diff, /*bForceRealtime=*/false);
 
       if (EventEmitter) {
         EventEmitter->Emit(GatrixEvents::FlagsChange);
@@ -886,19 +1592,20 @@ void UGatrixFeaturesClient::StoreFlags(const TArray<FGatrixEvaluatedFlag>& NewFl
   }
 
   if (!bIsInitialFetch) {
-    // Log detected changes
-    for (const auto& Pair : RealtimeFlags) {
-      const FGatrixEvaluatedFlag* Old = OldFlags.Find(Pair.Key);
-      if (!Old) {
-        UE_LOG(LogGatrix, Verbose, TEXT("StoreFlags: ADDED '%s' enabled=%d value='%s'"), *Pair.Key,
-               (int)Pair.Value.bEnabled, *Pair.Value.Variant.Value);
-      } else if (Old->Version != Pair.Value.Version) {
-        UE_LOG(
-            LogGatrix, Log,
-            TEXT("StoreFlags: CHANGED '%s' version %lld->%lld, enabled %d->%d, value '%s'->'%s'"),
-            *Pair.Key, Old->Version, (int64)Pair.Value.Version, (int)Old->bEnabled,
-            (int)Pair.Value.bEnabled, *Old->Variant.Value, *Pair.Value.Variant.Value);
-      }
+    // Log detected changes (only the flags listed in the diff are visited)
+    FScopeLock Lock(&FlagsCriticalSection);
+    for (const FString& Name : Diff.Added) {
+      const FGatrixEvaluatedFlag& New = RealtimeFlags.FindChecked(Name);
+      UE_LOG(LogGatrix, Verbose, TEXT("StoreFlags: ADDED '%s' enabled=%d value='%s'"), *Name,
+             (int)New.bEnabled, *New.Variant.Value);
+    }
+    for (const FString& Name : Diff.Changed) {
+      const FGatrixEvaluatedFlag& Old = OldFlags.FindChecked(Name);
+      const FGatrixEvaluatedFlag& New = RealtimeFlags.FindChecked(Name);
+      UE_LOG(LogGatrix, Log,
+             TEXT("StoreFlags: CHANGED '%s' version %d->%d, enabled %d->%d, value '%s'->'%s'"),
+             *Name, Old.Version, New.Version, (int)Old.bEnabled, (int)New.bEnabled,
+             *Old.Variant.Value, *New.Variant.Value);
     }
   }
 }
@@ -926,8 +1633,13 @@ void UGatrixFeaturesClient::LoadFromStorage() {
   for (const auto& Flag : ParsedFlags) {
     RealtimeFlags.Add(Flag.Name, Flag);
   }
+  RealtimeEtag.Reset(RealtimeFlags);
 
   SynchronizedFlags = RealtimeFlags;
+  const FGatrixFlagDiff Loaded =
+      FGatrixFlagDiff::Compute(TMap<FString, FGatrixEvaluatedFlag>(), RealtimeFlags);
+  AdvanceGeneration(Loaded, /*bForceRealtime=*/true);
+  AdvanceGeneration(Loaded, /*bForceRealtime=*/false);
 }
 
 void UGatrixFeaturesClient::ApplyBootstrap() {
@@ -946,9 +1658,15 @@ void UGatrixFeaturesClient::ApplyBootstrap() {
     {
       FScopeLock Lock(&FlagsCriticalSection);
       for (const auto& Flag : Bootstrap) {
-        RealtimeFlags.Add(Flag.Name, Flag);
+        FGatrixEvaluatedFlag& Stored = RealtimeFlags.Add(Flag.Name, Flag);
+        Stored.ContentHash = FGatrixFlagHash::Compute(Stored);
       }
+      RealtimeEtag.Reset(RealtimeFlags);
       SynchronizedFlags = RealtimeFlags;
+      const FGatrixFlagDiff Loaded =
+          FGatrixFlagDiff::Compute(TMap<FString, FGatrixEvaluatedFlag>(), RealtimeFlags);
+      AdvanceGeneration(Loaded, /*bForceRealtime=*/true);
+      AdvanceGeneration(Loaded, /*bForceRealtime=*/false);
     }
 
     // Persist bootstrap flags to storage
@@ -988,30 +1706,24 @@ void UGatrixFeaturesClient::SetReady() {
 
 // ==================== Flag Change Emission ====================
 
-void UGatrixFeaturesClient::EmitFlagChanges(const TMap<FString, FGatrixEvaluatedFlag>& OldFlags,
+void UGatrixFeaturesClient::EmitFlagChanges(const FGatrixFlagDiff& Diff,
                                             const TMap<FString, FGatrixEvaluatedFlag>& NewFlags) {
   if (!EventEmitter)
     return;
 
-  // Detect changed/created flags
-  for (const auto& Pair : NewFlags) {
-    const FGatrixEvaluatedFlag* OldFlag = OldFlags.Find(Pair.Key);
-    if (!OldFlag || OldFlag->Version != Pair.Value.Version) {
-      FString ChangeType = OldFlag ? TEXT("updated") : TEXT("created");
-      EventEmitter->Emit(GatrixEvents::FlagChange(Pair.Key),
-                         Pair.Value.Variant.Name + TEXT("|") + ChangeType);
-    }
+  // Changed/created flags
+  for (const FString& Name : Diff.Added) {
+    EventEmitter->Emit(GatrixEvents::FlagChange(Name),
+                       NewFlags.FindChecked(Name).Variant.Name + TEXT("|created"));
   }
-
-  // Detect removed flags - emit bulk event, not per-flag change
-  TArray<FString> RemovedNames;
-  for (const auto& Pair : OldFlags) {
-    if (!NewFlags.Contains(Pair.Key)) {
-      RemovedNames.Add(Pair.Key);
-    }
+  for (const FString& Name : Diff.Changed) {
+    EventEmitter->Emit(GatrixEvents::FlagChange(Name),
+                       NewFlags.FindChecked(Name).Variant.Name + TEXT("|updated"));
   }
-  if (RemovedNames.Num() > 0) {
-    EventEmitter->Emit(GatrixEvents::FlagsRemoved, FString::Join(RemovedNames, TEXT(",")));
+
+  // Removed flags - emit bulk event, not per-flag change
+  if (Diff.Removed.Num() > 0) {
+    EventEmitter->Emit(GatrixEvents::FlagsRemoved, FString::Join(Diff.Removed, TEXT(",")));
   }
 }
 
@@ -1058,6 +1770,8 @@ void UGatrixFeaturesClient::TrackAccess(const FString& FlagName, const FGatrixEv
     }
   }
 
+  ObserveInterest(FlagName);
+
   if (Flag && Flag->bImpressionData) {
     const_cast<UGatrixFeaturesClient*>(this)->TrackImpression(FlagName, Flag->bEnabled, VariantName,
                                                               EventType);
@@ -1067,11 +1781,29 @@ void UGatrixFeaturesClient::TrackAccess(const FString& FlagName, const FGatrixEv
   }
 }
 
+void UGatrixFeaturesClient::ObserveInterest(const FString& FlagName) const {
+  if (!Interest.Observe(FlagName)) {
+    return;
+  }
+  InterestObservedCount.Increment();
+
+  // Outside the set until now, so never fetched: fetch it alone (single-flight folds
+  // several first reads into one follow-up request)
+  TWeakObjectPtr<UGatrixFeaturesClient> WeakThis(const_cast<UGatrixFeaturesClient*>(this));
+  AsyncTask(ENamedThreads::GameThread, [WeakThis, FlagName]() {
+    UGatrixFeaturesClient* Self = WeakThis.Get();
+    if (Self && Self->bStarted && !Self->ClientConfig.Features.bOfflineMode) {
+      Self->FetchPartialFlags(TArray<FString>{FlagName});
+    }
+  });
+}
+
 // ==================== Watch ====================
 
 int32 UGatrixFeaturesClient::WatchRealtimeFlag(const FString& FlagName,
                                                FGatrixFlagWatchDelegate Callback,
                                                const FString& Name) {
+  ObserveInterest(FlagName);
   FWatchCallbackEntry Entry;
   Entry.FlagName = FlagName;
   Entry.Callback = Callback;
@@ -1083,6 +1815,7 @@ int32 UGatrixFeaturesClient::WatchRealtimeFlag(const FString& FlagName,
 int32 UGatrixFeaturesClient::WatchSyncedFlag(const FString& FlagName,
                                              FGatrixFlagWatchDelegate Callback,
                                              const FString& Name) {
+  ObserveInterest(FlagName);
   FWatchCallbackEntry Entry;
   Entry.FlagName = FlagName;
   Entry.Callback = Callback;
@@ -1205,56 +1938,23 @@ FGatrixEvaluatedFlag UGatrixFeaturesClient::GetRawFlagInternal(const FString& Fl
   return Empty;
 }
 
-void UGatrixFeaturesClient::InvokeWatchCallbacks(
-    const TArray<FWatchCallbackEntry>& CallbackList,
-    const TMap<FString, FGatrixEvaluatedFlag>& OldFlags,
-    const TMap<FString, FGatrixEvaluatedFlag>& NewFlags, bool bForceRealtime,
-    const FString& OldContextHash, const FString& NewContextHash) {
-  // Check for changed/new flags
-  for (const auto& Pair : NewFlags) {
-    const FGatrixEvaluatedFlag& NewFlag = Pair.Value;
-    const FGatrixEvaluatedFlag* OldFlag = OldFlags.Find(Pair.Key);
-
-    bool bIsSame = false;
-    if (OldFlag) {
-      // Fast path: same context and version means same outcome
-      if (!OldContextHash.IsEmpty() && !NewContextHash.IsEmpty() &&
-          OldContextHash == NewContextHash && OldFlag->Version == NewFlag.Version) {
-        bIsSame = true;
-      } else {
-        // Detailed comparison
-        if (OldFlag->bEnabled == NewFlag.bEnabled &&
-            OldFlag->Variant.Name == NewFlag.Variant.Name &&
-            OldFlag->Variant.bEnabled == NewFlag.Variant.bEnabled &&
-            OldFlag->Variant.Value == NewFlag.Variant.Value) {
-          bIsSame = true;
-        }
-      }
-    }
-
-    if (!bIsSame) {
-      // Invoke watch callbacks for this flag
-      for (const auto& Entry : CallbackList) {
-        UE_LOG(LogGatrix, Verbose,
-               TEXT("InvokeWatchCallbacks: changed='%s', watching='%s', match=%d"), *Pair.Key,
-               *Entry.FlagName, (int)(Entry.FlagName == Pair.Key));
-        if (Entry.FlagName == Pair.Key) {
-          UGatrixFlagProxy* Proxy = CreateProxyForWatch(Pair.Key, bForceRealtime);
-          Entry.Callback.ExecuteIfBound(Proxy);
-        }
-      }
-    }
-  }
+void UGatrixFeaturesClient::InvokeWatchCallbacks(const TArray<FWatchCallbackEntry>& CallbackList,
+                                                 const FGatrixFlagDiff& Diff,
+                                                 bool bForceRealtime) {
+  if (CallbackList.Num() == 0 || Diff.IsEmpty())
+    return;
 
-  // Check for removed flags
-  for (const auto& Pair : OldFlags) {
-    if (!NewFlags.Contains(Pair.Key)) {
-      for (const auto& Entry : CallbackList) {
-        if (Entry.FlagName == Pair.Key) {
-          UGatrixFlagProxy* Proxy = CreateProxyForWatch(Pair.Key, bForceRealtime);
-          Entry.Callback.ExecuteIfBound(Proxy);
-        }
-      }
+  TSet<FString> Affected;
+  Affected.Reserve(Diff.Num());
+  Affected.Append(Diff.Added);
+  Affected.Append(Diff.Changed);
+  Affected.Append(Diff.Removed);
+
+  for (const auto& Entry : CallbackList) {
+    if (Affected.Contains(Entry.FlagName)) {
+      UE_LOG(LogGatrix, Verbose, TEXT("InvokeWatchCallbacks: changed='%s'"), *Entry.FlagName);
+      UGatrixFlagProxy* Proxy = CreateProxyForWatch(Entry.FlagName, bForceRealtime);
+      Entry.Callback.ExecuteIfBound(Proxy);
     }
   }
 }
@@ -1270,33 +1970,23 @@ void UGatrixFeaturesClient::ScheduleNextPoll() {
   // Stop existing timer
   StopPolling();
 
-  float Interval = ClientConfig.Features.RefreshInterval;
-  if (Interval <= 0.0f)
-    Interval = 30.0f;
-
-  // Apply exponential backoff on consecutive failures
+  // Mode-dependent interval (safety poll while streaming is healthy, backoff while it
+  // flaps), failure backoff, X-Poll-Interval and Retry-After are resolved by the scheduler
+  const FGatrixFetchRetryOptions& Retry = ClientConfig.Features.FetchRetryOptions;
+  const float Interval = Polling.NextDelay(ConsecutiveFailures.GetValue(), Retry.InitialBackoff,
+                                           Retry.MaxBackoff);
   if (ConsecutiveFailures.GetValue() > 0) {
-    float InitialBackoff = ClientConfig.Features.FetchRetryOptions.InitialBackoff;
-    float MaxBackoffVal = ClientConfig.Features.FetchRetryOptions.MaxBackoff;
-    float BackoffSec = FMath::Min(
-        InitialBackoff * FMath::Pow(2.0f, static_cast<float>(ConsecutiveFailures.GetValue() - 1)),
-        MaxBackoffVal);
-    Interval = BackoffSec;
     UE_LOG(LogGatrix, Warning,
            TEXT("Scheduling retry after %.1fs (consecutive "
                 "failures: %d)"),
            Interval, ConsecutiveFailures.GetValue());
-  } else {
-    // Add jitter (+/-10%) to prevent thundering herd
-    const float JitterRange = Interval * 0.1f;
-    Interval += FMath::FRandRange(-JitterRange, JitterRange);
   }
 
   if (ClientConfig.bEnableDevMode) {
     UE_LOG(LogGatrix, Log,
-           TEXT("[DEV] ScheduleNextPoll: delay=%.1fs, "
+           TEXT("[DEV] ScheduleNextPoll: delay=%.1fs, mode=%s, "
                 "consecutiveFailures=%d, pollingStopped=%s"),
-           Interval, ConsecutiveFailures.GetValue(),
+           Interval, *UEnum::GetValueAsString(Polling.GetMode()), ConsecutiveFailures.GetValue(),
            bPollingStopped ? TEXT("True") : TEXT("False"));
   }
 
@@ -1332,6 +2022,24 @@ void UGatrixFeaturesClient::StopPolling() {
   }
 }
 
+void UGatrixFeaturesClient::ApplyPollingHints(const FHttpResponsePtr& Response) {
+  const FString PollInterval = Response->GetHeader(TEXT("X-Poll-Interval"));
+  if (PollInterval.IsNumeric()) {
+    Polling.SetServerInterval(FCString::Atof(*PollInterval));
+  }
+
+  // Retry-After: delta-seconds or an HTTP-date
+  const FString RetryAfter = Response->GetHeader(TEXT("Retry-After"));
+  if (RetryAfter.IsNumeric()) {
+    Polling.SetRetryAfter(FCString::Atof(*RetryAfter));
+  } else if (!RetryAfter.IsEmpty()) {
+    FDateTime RetryAt;
+    if (FDateTime::ParseHttpDate(RetryAfter, RetryAt)) {
+      Polling.SetRetryAfter(static_cast<float>((RetryAt - FDateTime::UtcNow()).GetTotalSeconds()));
+    }
+  }
+}
+
 // ==================== Metrics ====================
 
 void UGatrixFeaturesClient::StartMetrics() {
@@ -1435,7 +2143,7 @@ void UGatrixFeaturesClient::SendMetrics() {
       HttpRequest->SetHeader(Header.Key, Header.Value);
     }
 
-    HttpRequest->SetContentAsString(PayloadJson);
+    SetCompressedBody(HttpRequest, PayloadJson);
     return HttpRequest;
   };
 
@@ -1490,40 +2198,44 @@ void UGatrixFeaturesClient::SendMetrics() {
 
 // ==================== URL Building ====================
 
-FString UGatrixFeaturesClient::BuildFetchUrl() const {
+FString UGatrixFeaturesClient::BuildFetchUrl(const FGatrixContext& Context) const {
   // URL pattern: {apiUrl}/client/features/eval
   FString BaseUrl = FString::Printf(TEXT("%s/client/features/eval"), *ClientConfig.ApiUrl);
 
+  TArray<FString> Query;
   if (!ClientConfig.Features.bUsePOSTRequests) {
-    const FString QueryString = BuildContextQueryString();
-    if (!QueryString.IsEmpty()) {
-      BaseUrl += TEXT("?") + QueryString;
-    }
+    Query.Add(BuildContextQueryString(Context));
+  }
+  // Interest set in the query for both verbs: the server evaluates only those flags
+  Query.Add(Interest.ToQueryString());
+  Query.RemoveAll([](const FString& Part) { return Part.IsEmpty(); });
+  if (Query.Num() > 0) {
+    BaseUrl += TEXT("?") + FString::Join(Query, TEXT("&"));
   }
 
   return BaseUrl;
 }
 
-FString UGatrixFeaturesClient::BuildContextQueryString() const {
+FString UGatrixFeaturesClient::BuildContextQueryString(const FGatrixContext& Context) const {
   TArray<FString> Params;
 
   Params.Add(
       FString::Printf(TEXT("appName=%s"), *FGenericPlatformHttp::UrlEncode(ClientConfig.AppName)));
 
-  if (!ClientConfig.Features.Context.UserId.IsEmpty())
-    Params.Add(FString::Printf(
-        TEXT("userId=%s"), *FGenericPlatformHttp::UrlEncode(ClientConfig.Features.Context.UserId)));
-  if (!ClientConfig.Features.Context.SessionId.IsEmpty())
-    Params.Add(FString::Printf(TEXT("sessionId=%s"), *FGenericPlatformHttp::UrlEncode(
-                                                         ClientConfig.Features.Context.SessionId)));
-  if (!ClientConfig.Features.Context.RemoteAddress.IsEmpty())
-    Params.Add(FString::Printf(TEXT("remoteAddress=%s"), *FGenericPlatformHttp::UrlEncode(
-                                                             ClientConfig.Features.Context.RemoteAddress)));
-  if (!ClientConfig.Features.Context.CurrentTime.IsEmpty())
-    Params.Add(FString::Printf(TEXT("currentTime=%s"), *FGenericPlatformHttp::UrlEncode(
-                                                           ClientConfig.Features.Context.CurrentTime)));
-
-  for (const auto& Prop : ClientConfig.Features.Context.Properties) {
+  if (!Context.UserId.IsEmpty())
+    Params.Add(
+        FString::Printf(TEXT("userId=%s"), *FGenericPlatformHttp::UrlEncode(Context.UserId)));
+  if (!Context.SessionId.IsEmpty())
+    Params.Add(FString::Printf(TEXT("sessionId=%s"),
+                               *FGenericPlatformHttp::UrlEncode(Context.SessionId)));
+  if (!Context.RemoteAddress.IsEmpty())
+    Params.Add(FString::Printf(TEXT("remoteAddress=%s"),
+                               *FGenericPlatformHttp::UrlEncode(Context.RemoteAddress)));
+  if (!Context.CurrentTime.IsEmpty())
+    Params.Add(FString::Printf(TEXT("currentTime=%s"),
+                               *FGenericPlatformHttp::UrlEncode(Context.CurrentTime)));
+
+  for (const auto& Prop : Context.Properties) {
     Params.Add(FString::Printf(TEXT("properties[%s]=%s"),
                                *FGenericPlatformHttp::UrlEncode(Prop.Key),
                                *FGenericPlatformHttp::UrlEncode(Prop.Value)));
@@ -1544,6 +2256,7 @@ FGatrixFeaturesStats UGatrixFeaturesClient::GetStats() const {
   Stats.SyncFlagsCount = SyncFlagsCount.GetValue();
   Stats.ImpressionCount = ImpressionCount.GetValue();
   Stats.ContextChangeCount = ContextChangeCount.GetValue();
+  Stats.ContextCoalescedCount = ContextCoalescedCount.GetValue();
   Stats.MetricsSentCount = MetricsSentCount.GetValue();
   Stats.MetricsErrorCount = MetricsErrorCount.GetValue();
   Stats.Etag = Etag;
@@ -1556,10 +2269,81 @@ FGatrixFeaturesStats UGatrixFeaturesClient::GetStats() const {
   Stats.StreamingEventCount = StreamingEventCount;
   Stats.StreamingErrorCount = StreamingErrorCount;
   Stats.StreamingRecoveryCount = StreamingRecoveryCount;
+  Stats.StreamingRecycleCount = StreamingRecycleCount;
+  Stats.StreamingResidentBytes = StreamingHub.IsValid() ? StreamingHub->GetResidentBytes() : 0;
+
+  // Compression stats
+  Stats.CompressedBytesReceived = CompressedBytesReceived.GetValue();
+  Stats.DecompressedBytes = DecompressedBytes.GetValue();
+  Stats.RequestBytesRaw = RequestBytesRaw.GetValue();
+  Stats.RequestBytesSent = RequestBytesSent.GetValue();
+  Stats.CompressionRatio = GetCompressionRatio();
+  Stats.LastDecodeTimeMs = LastDecodeTimeMs;
+
+  // Delta sync stats
+  Stats.DeltaFetchCount = DeltaFetchCount.GetValue();
+  Stats.DeltaFallbackCount = DeltaFallbackCount.GetValue();
+  Stats.SyncRevision = SyncRevision;
+
+  // Invalidation coalescing stats
+  Stats.InvalidationEventCount = InvalidationEventCount.GetValue();
+  Stats.InvalidationFlushCount = InvalidationFlushCount.GetValue();
+  Stats.LastCoalesceWindowMs = LastCoalesceWindowMs;
+  Stats.LastSpreadDelayMs = LastSpreadDelayMs;
+  Stats.UrgentInvalidationCount = UrgentInvalidationCount.GetValue();
+
+  // Interest set stats
+  Stats.InterestKeyCount = Interest.IsEnabled() ? Interest.Num() : 0;
+  Stats.InterestObservedCount = InterestObservedCount.GetValue();
+  Stats.InterestDroppedCount = InterestDroppedCount.GetValue();
+
+  // Scheduled activation stats
+  Stats.ScheduledActivationPending = Activations.Num();
+  Stats.ScheduledActivationCount = ScheduledActivationCount;
+  Stats.ServerClockOffsetMs =
+      GetServerNowMs() -
+      static_cast<int64>((FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds());
+
+  // Push payload stats
+  Stats.PushPayloadAppliedCount = PushPayloadAppliedCount.GetValue();
+  Stats.PushPayloadFallbackCount = PushPayloadFallbackCount.GetValue();
+  Stats.LastPushLatencyMs = LastPushLatencyMs;
+
+  // Prefetch stats, of the environment's shared cache (bytes of evaluations still
+  // cached are neither used nor wasted)
+  int64 PendingPrefetchBytes = 0;
+  for (const auto& Entry : Prefetched->Entries) {
+    PendingPrefetchBytes += Entry.Value.Bytes;
+  }
+  Stats.PrefetchCount = Prefetched->Count.GetValue();
+  Stats.PrefetchHitCount = Prefetched->HitCount.GetValue();
+  Stats.PrefetchHitRate =
+      Stats.PrefetchCount > 0
+          ? static_cast<float>(Stats.PrefetchHitCount) / static_cast<float>(Stats.PrefetchCount)
+          : 0.0f;
+  Stats.PrefetchBytes = Prefetched->Bytes.GetValue();
+  Stats.PrefetchWastedBytes =
+      Stats.PrefetchBytes - Prefetched->UsedBytes.GetValue() - PendingPrefetchBytes;
+
+  // Bulk evaluation stats
+  Stats.BulkEvaluationCount = BulkEvaluationCount.GetValue();
+  Stats.BulkContextCount = BulkContextCount.GetValue();
+  Stats.BulkReuseRatio = LastBulkReuseRatio;
+
+  // Polling stats
+  Stats.PollingMode = Polling.GetMode();
+  Stats.PollingInterval = Polling.GetLastDelay();
+  Stats.ServerPollInterval = Polling.GetServerInterval();
 
   return Stats;
 }
 
+float UGatrixFeaturesClient::GetCompressionRatio() const {
+  const int64 Wire = CompressedBytesReceived.GetValue();
+  return Wire > 0 ? static_cast<float>(DecompressedBytes.GetValue()) / static_cast<float>(Wire)
+                  : 0.0f;
+}
+
 FGatrixLightStats UGatrixFeaturesClient::GetLightStats() const {
   FGatrixLightStats Light;
   Light.SdkState = SdkState;
@@ -1576,6 +2360,13 @@ FGatrixLightStats UGatrixFeaturesClient::GetLightStats() const {
   Light.MetricsErrorCount = MetricsErrorCount.GetValue();
   Light.StreamingState = StreamingState;
   Light.StreamingReconnectCount = StreamingReconnectCount;
+  Light.CompressionRatio = GetCompressionRatio();
+  Light.LastDecodeTimeMs = LastDecodeTimeMs;
+  Light.DeltaFetchCount = DeltaFetchCount.GetValue();
+  Light.SyncRevision = SyncRevision;
+  Light.InvalidationEventCount = InvalidationEventCount.GetValue();
+  Light.InvalidationFlushCount = InvalidationFlushCount.GetValue();
+  Light.PollingMode = Polling.GetMode();
   return Light;
 }
 
@@ -1879,93 +2670,61 @@ void UGatrixFeaturesClient::ConnectStreaming() {
   for (const auto& Header : ClientConfig.CustomHeaders) {
     Headers.Add(Header.Key, Header.Value);
   }
+  // Event ids are global revisions: the server replays what was missed since this one.
+  // Both transports send it with the request (SSE) or upgrade request (WebSocket).
+  if (LocalGlobalRevision > 0) {
+    Headers.Add(TEXT("Last-Event-ID"), FString::Printf(TEXT("%lld"), LocalGlobalRevision));
+  }
 
-  if (StreamConfig.Transport == EGatrixStreamingTransport::WebSocket) {
-    // WebSocket transport
-    WebSocketConnection = MakeUnique<FGatrixWebSocketConnection>();
-
-    WebSocketConnection->OnConnected.BindLambda([this]() {
-      AsyncTask(ENamedThreads::GameThread, [this]() {
-        SetStreamingState(EGatrixStreamingConnectionState::Connected);
-        StreamingReconnectAttempt = 0;
-        if (EventEmitter) {
-          EventEmitter->Emit(GatrixEvents::FlagsStreamingConnected);
-        }
-      });
-    });
-
-    WebSocketConnection->OnEvent.BindLambda([this](const FString& EventType,
-                                                   const FString& EventData) {
-      AsyncTask(ENamedThreads::GameThread,
-                [this, EventType, EventData]() { ProcessStreamingEvent(EventType, EventData); });
-    });
-
-    WebSocketConnection->OnError.BindLambda([this](const FString& ErrorMsg) {
-      AsyncTask(ENamedThreads::GameThread, [this, ErrorMsg]() {
-        StreamingErrorCount++;
-        if (EventEmitter) {
-          EventEmitter->Emit(GatrixEvents::FlagsStreamingError, ErrorMsg);
-        }
-      });
-    });
+  // Instances of the same environment share one connection (FGatrixStreamingHub)
+  StreamingHub = FGatrixStreamingHub::Acquire(BuildStreamingHubKey());
 
-    WebSocketConnection->OnDisconnected.BindLambda([this]() {
-      AsyncTask(ENamedThreads::GameThread, [this]() {
-        if (bStarted && ClientConfig.Features.Streaming.bEnabled) {
-          ScheduleStreamingReconnect();
-        } else {
-          SetStreamingState(EGatrixStreamingConnectionState::Disconnected);
-          if (EventEmitter) {
-            EventEmitter->Emit(GatrixEvents::FlagsStreamingDisconnected);
-          }
-        }
-      });
-    });
+  FGatrixStreamingSubscriber Subscriber;
+  Subscriber.OnConnected = [this]() {
+    SetStreamingState(EGatrixStreamingConnectionState::Connected);
+    StreamingReconnectAttempt = 0;
+    if (EventEmitter) {
+      EventEmitter->Emit(GatrixEvents::FlagsStreamingConnected);
+    }
+  };
+  Subscriber.OnEvent = [this](const FGatrixJson::FStreamingEvent& Event) {
+    ProcessStreamingEvent(Event);
+  };
+  Subscriber.OnError = [this](const FString& ErrorMsg) {
+    StreamingErrorCount++;
+    if (EventEmitter) {
+      EventEmitter->Emit(GatrixEvents::FlagsStreamingError, ErrorMsg);
+    }
+  };
+  Subscriber.OnDisconnected = [this]() {
+    if (bStarted && ClientConfig.Features.Streaming.bEnabled) {
+      ScheduleStreamingReconnect();
+    } else {
+      SetStreamingState(EGatrixStreamingConnectionState::Disconnected);
+      if (EventEmitter) {
+        EventEmitter->Emit(GatrixEvents::FlagsStreamingDisconnected);
+      }
+    }
+  };
+  Subscriber.OnRecycled = [this]() { StreamingRecycleCount++; };
+  StreamingSubscription = StreamingHub->Subscribe(MoveTemp(Subscriber));
 
-    WebSocketConnection->Connect(Url, Headers, StreamConfig.WebSocket.PingInterval);
+  if (StreamingHub->IsOpen()) {
+    UE_LOG(LogGatrix, Log, TEXT("Streaming: Sharing the environment's connection (%d clients)"),
+           StreamingHub->GetSubscriberCount());
+    return;
+  }
 
+  if (StreamConfig.Transport == EGatrixStreamingTransport::WebSocket) {
+    StreamingHub->ConnectWebSocket(Url, Headers, StreamConfig.WebSocket.PingInterval,
+                                   StreamConfig.WebSocket.bBinaryFrames);
   } else {
     // SSE transport (default)
-    SseConnection = MakeUnique<FGatrixSseConnection>();
-
-    SseConnection->OnConnected.BindLambda([this]() {
-      AsyncTask(ENamedThreads::GameThread, [this]() {
-        SetStreamingState(EGatrixStreamingConnectionState::Connected);
-        StreamingReconnectAttempt = 0;
-        if (EventEmitter) {
-          EventEmitter->Emit(GatrixEvents::FlagsStreamingConnected);
-        }
-      });
-    });
-
-    SseConnection->OnEvent.BindLambda([this](const FString& EventType, const FString& EventData) {
-      AsyncTask(ENamedThreads::GameThread,
-                [this, EventType, EventData]() { ProcessStreamingEvent(EventType, EventData); });
-    });
-
-    SseConnection->OnError.BindLambda([this](const FString& ErrorMsg) {
-      AsyncTask(ENamedThreads::GameThread, [this, ErrorMsg]() {
-        StreamingErrorCount++;
-        if (EventEmitter) {
-          EventEmitter->Emit(GatrixEvents::FlagsStreamingError, ErrorMsg);
-        }
-      });
-    });
-
-    SseConnection->OnDisconnected.BindLambda([this]() {
-      AsyncTask(ENamedThreads::GameThread, [this]() {
-        if (bStarted && ClientConfig.Features.Streaming.bEnabled) {
-          ScheduleStreamingReconnect();
-        } else {
-          SetStreamingState(EGatrixStreamingConnectionState::Disconnected);
-          if (EventEmitter) {
-            EventEmitter->Emit(GatrixEvents::FlagsStreamingDisconnected);
-          }
-        }
-      });
-    });
-
-    SseConnection->Connect(Url, Headers);
+    FGatrixSseConnectionLimits Limits;
+    Limits.MaxEventBytes = StreamConfig.Sse.MaxEventSize;
+    Limits.MaxConnectionBytes = StreamConfig.Sse.MaxConnectionBytes;
+    Limits.MaxConnectionAge = StreamConfig.Sse.MaxConnectionAge;
+    StreamingHub->ConnectSse(Url, Headers, Limits);
   }
 
   UE_LOG(LogGatrix, Log, TEXT("Streaming: Connecting via %s to %s"),
@@ -1984,69 +2743,77 @@ void UGatrixFeaturesClient::DisconnectStreaming() {
     World->GetTimerManager().ClearTimer(StreamingReconnectTimerHandle);
   }
 
-  if (SseConnection.IsValid()) {
-    SseConnection->Disconnect();
-    SseConnection.Reset();
-  }
-
-  if (WebSocketConnection.IsValid()) {
-    WebSocketConnection->Disconnect();
-    WebSocketConnection.Reset();
+  // Closes the connection if no other instance is using it
+  if (StreamingHub.IsValid()) {
+    StreamingHub->Unsubscribe(StreamingSubscription);
+    StreamingHub.Reset();
   }
 
   SetStreamingState(EGatrixStreamingConnectionState::Disconnected);
   StreamingReconnectAttempt = 0;
 }
 
-void UGatrixFeaturesClient::ProcessStreamingEvent(const FString& EventType,
-                                                  const FString& EventData) {
+void UGatrixFeaturesClient::ProcessStreamingEvent(const FGatrixJson::FStreamingEvent& Event) {
+  const FString& EventType = Event.Type;
   StreamingEventCount++;
   UE_LOG(LogGatrix, Log, TEXT("Streaming: ProcessStreamingEvent type='%s'"), *EventType);
 
   if (EventType == TEXT("connected")) {
     // Server acknowledged connection, extract connectionId if present
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(EventData);
-    if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid()) {
-      FString ServerConnectionId;
-      if (JsonObject->TryGetStringField(TEXT("connectionId"), ServerConnectionId)) {
-        UE_LOG(LogGatrix, Log, TEXT("Streaming: Server connectionId=%s"), *ServerConnectionId);
+    FString ServerConnectionId;
+    if (Event.Body.IsValid() &&
+        Event.Body->TryGetStringField(TEXT("connectionId"), ServerConnectionId)) {
+      UE_LOG(LogGatrix, Log, TEXT("Streaming: Server connectionId=%s"), *ServerConnectionId);
+    }
+
+    if (Event.bHasGlobalRevision && Event.GlobalRevision > LocalGlobalRevision) {
+      if (LocalGlobalRevision == 0) {
+        LocalGlobalRevision = Event.GlobalRevision;
+      } else if (Event.bResumed) {
+        // Every revision after ours is replayed next as ordinary flags_changed events
+        UE_LOG(LogGatrix, Log, TEXT("Streaming: Resuming from revision %lld (server=%lld)"),
+               LocalGlobalRevision, Event.GlobalRevision);
+      } else {
+        // Replay log truncated past our revision (or not kept): resync everything
+        UE_LOG(LogGatrix, Log,
+               TEXT("Streaming: Gap detected (local=%lld, server=%lld), resyncing"),
+               LocalGlobalRevision, Event.GlobalRevision);
+        LocalGlobalRevision = Event.GlobalRevision;
+        ResyncChangedKeys(TArray<FString>());
       }
     }
   } else if (EventType == TEXT("flags_changed") || EventType == TEXT("invalidate")) {
-    // Parse changed flag keys
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(EventData);
-    if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid()) {
-      TArray<FString> ChangedKeys;
+    if (Event.bHasData) {
+      const TSharedPtr<FJsonObject>& JsonObject = Event.Body;
 
       // Only process if server revision is ahead (skip stale/duplicate events)
-      int64 ServerRevision = 0;
-      if (JsonObject->TryGetNumberField(TEXT("globalRevision"), ServerRevision)) {
+      const int64 ServerRevision = Event.GlobalRevision;
+      bool bContiguous = false;
+      if (Event.bHasGlobalRevision) {
         if (ServerRevision <= LocalGlobalRevision) {
           UE_LOG(LogGatrix, Verbose,
                  TEXT("Streaming: Ignoring stale event (local=%lld, server=%lld)"),
                  LocalGlobalRevision, ServerRevision);
           return;
         }
+        bContiguous = LocalGlobalRevision > 0 && ServerRevision == LocalGlobalRevision + 1;
         LocalGlobalRevision = ServerRevision;
       }
 
-      // Get changed keys
-      const TArray<TSharedPtr<FJsonValue>>* KeysArray;
-      if (JsonObject->TryGetArrayField(TEXT("changedKeys"), KeysArray)) {
-        for (const auto& KeyVal : *KeysArray) {
-          FString Key;
-          if (KeyVal->TryGetString(Key)) {
-            ChangedKeys.Add(Key);
-          }
+      // Push-with-payload: inline records on the next revision skip the fetch entirely
+      if (ClientConfig.Features.Streaming.bPushPayload && JsonObject.IsValid() &&
+          JsonObject->HasField(TEXT("flags")) &&
+          ApplyStreamingPayload(JsonObject, ServerRevision, bContiguous)) {
+        if (EventEmitter) {
+          EventEmitter->Emit(GatrixEvents::FlagsInvalidated, EventType);
         }
+        return;
       }
 
-      // Delegate to HandleStreamingInvalidation:
+      // Delegate to HandleStreamingInvalidation (with the server's fetch-spread hints):
       // - changedKeys present → partial fetch
       // - changedKeys absent  → full fetch (clears ETag internally)
-      HandleStreamingInvalidation(ChangedKeys);
+      HandleStreamingInvalidation(Event.ChangedKeys, Event.SpreadWindowMs, Event.bUrgent);
     }
   } else if (EventType == TEXT("heartbeat") || EventType == TEXT("ping")) {
     // Heartbeat received, connection is alive
@@ -2058,35 +2825,146 @@ void UGatrixFeaturesClient::ProcessStreamingEvent(const FString& EventType,
   }
 }
 
-void UGatrixFeaturesClient::HandleStreamingInvalidation(const TArray<FString>& ChangedKeys) {
+bool UGatrixFeaturesClient::ApplyStreamingPayload(const TSharedPtr<FJsonObject>& EventObj,
+                                                  int64 GlobalRevision, bool bContiguous) {
+  // Not applicable: skipped revisions, records evaluated for another context, or a fetch in
+  // flight whose response could land after (and overwrite) these newer records
+  FString PayloadContextHash;
+  const bool bContextMatches =
+      !EventObj->TryGetStringField(TEXT("contextHash"), PayloadContextHash) ||
+      PayloadContextHash == LastContextHash;
+  FGatrixJson::FFlagsPayload Payload;
+  if (!bContiguous || !bContextMatches || bIsFetching ||
+      !FGatrixJson::ParsePushedFlags(EventObj, Payload)) {
+    PushPayloadFallbackCount.Increment();
+    return false;
+  }
+
+  // Keys listed in removed (and not re-sent) are deleted by the merge
+  MergeFlags(Payload.Flags, TSet<FString>(Payload.Removed));
+  EnqueueScheduledChanges(MoveTemp(Payload.Scheduled), false);
+  PushPayloadAppliedCount.Increment();
+
+  // The snapshot now includes this revision, so the next since= starts after it. Only when
+  // it directly follows the basis: a skipped revision still awaiting its fetch stays covered
+  if (SyncRevision > 0 && GlobalRevision == SyncRevision + 1 &&
+      SyncRevisionContextHash == LastContextHash) {
+    SyncRevision = GlobalRevision;
+  }
+
+  // Publish -> apply latency, from the server's event timestamp (epoch ms)
+  double PublishedMs = 0.0;
+  if (EventObj->TryGetNumberField(TEXT("timestamp"), PublishedMs)) {
+    const double NowMs = (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds();
+    LastPushLatencyMs = static_cast<int64>(NowMs - PublishedMs);
+  }
+  UE_LOG(LogGatrix, Log,
+         TEXT("Streaming: applied pushed payload (upserts=%d, removed=%d, %lldms)"),
+         Payload.Flags.Num(), Payload.Removed.Num(), LastPushLatencyMs);
+  return true;
+}
+
+void UGatrixFeaturesClient::HandleStreamingInvalidation(const TArray<FString>& ChangedKeys,
+                                                        int32 SpreadWindowHint, bool bUrgent) {
   UE_LOG(LogGatrix, Log,
-         TEXT("HandleStreamingInvalidation: keys=%d, bStreamingFetching=%d, bIsFetching=%d"),
-         ChangedKeys.Num(), (int)bStreamingFetching, (int)bIsFetching);
+         TEXT("HandleStreamingInvalidation: keys=%d, urgent=%d, bStreamingFetching=%d, "
+              "bIsFetching=%d"),
+         ChangedKeys.Num(), (int)bUrgent, (int)bStreamingFetching, (int)bIsFetching);
 
-  if (ChangedKeys.Num() == 0) {
-    // No specific keys: clear ETag and do full fetch
-    Etag = TEXT("");
-    if (!bIsFetching) {
-      FetchFlags();
-    } else {
-      // Full fetch pending
-      PendingInvalidationKeys.Add(TEXT("*"));
-    }
+  InvalidationEventCount.Increment();
+
+  // Keys outside the interest set were never fetched: nothing to refresh
+  const TArray<FString> Keys = Interest.Intersect(ChangedKeys);
+  if (ChangedKeys.Num() > 0 && Keys.Num() == 0) {
+    InterestDroppedCount.Increment();
     return;
   }
 
-  // If already fetching, queue the keys for later
-  if (bStreamingFetching) {
-    for (const FString& Key : ChangedKeys) {
-      PendingInvalidationKeys.Add(Key);
+  // Gather the burst; one fetch goes out when the debounce window closes
+  Invalidations.Add(Keys);
+  if (SpreadWindowHint >= 0) {
+    SpreadWindowMs = SpreadWindowHint;
+  }
+
+  UWorld* World = nullptr;
+  if (GEngine && GEngine->GetWorldContexts().Num() > 0) {
+    World = GEngine->GetWorldContexts()[0].World();
+  }
+
+  // Urgent: flush everything gathered so far without waiting out the window or spread
+  if (bUrgent) {
+    UrgentInvalidationCount.Increment();
+    if (bInvalidationFlushScheduled && World) {
+      World->GetTimerManager().ClearTimer(InvalidationFlushTimerHandle);
     }
-    UE_LOG(LogGatrix, Log, TEXT("HandleStreamingInvalidation: queued (bStreamingFetching=true)"));
+    bInvalidationFlushScheduled = false;
+    FlushInvalidations();
+    return;
+  }
+
+  if (bInvalidationFlushScheduled) {
+    return;
+  }
+
+  // Debounce window plus this session's stable offset within the spread window
+  const FString& Seed = ClientConfig.Features.Context.SessionId.IsEmpty()
+                            ? ConnectionId
+                            : ClientConfig.Features.Context.SessionId;
+  const int32 WindowMs = Invalidations.GetWindowMs();
+  const int32 SpreadMs = FGatrixInvalidationCoalescer::SpreadDelayMs(Seed, SpreadWindowMs);
+  const int32 DelayMs = WindowMs + SpreadMs;
+  LastCoalesceWindowMs = WindowMs;
+  LastSpreadDelayMs = SpreadMs;
+
+  if (!World || DelayMs <= 0) {
+    FlushInvalidations();
+    return;
+  }
+
+  bInvalidationFlushScheduled = true;
+  FTimerDelegate FlushDelegate = FTimerDelegate::CreateWeakLambda(this, [this]() {
+    bInvalidationFlushScheduled = false;
+    FlushInvalidations();
+  });
+  World->GetTimerManager().SetTimer(InvalidationFlushTimerHandle, FlushDelegate,
+                                    DelayMs / 1000.0f, false);
+}
+
+void UGatrixFeaturesClient::FlushInvalidations() {
+  // Single-flight: an in-flight fetch flushes the batch when it completes
+  if (!bStarted || bIsFetching || bStreamingFetching || !Invalidations.HasPending()) {
+    return;
+  }
+
+  TArray<FString> Batch = Invalidations.Take();
+  InvalidationFlushCount.Increment();
+  // Flags changed on the server: evaluations prefetched before that are outdated
+  Prefetched->Entries.Reset();
+  Prefetched->Order.Reset();
+  UE_LOG(LogGatrix, Log, TEXT("FlushInvalidations: %d coalesced keys"), Batch.Num());
+  ResyncChangedKeys(Batch);
+}
+
+bool UGatrixFeaturesClient::CanDeltaSync() const {
+  return ClientConfig.Features.bEnableDeltaSync && SyncRevision > 0 &&
+         SyncRevisionContextHash == LastContextHash;
+}
+
+void UGatrixFeaturesClient::ResyncChangedKeys(const TArray<FString>& ChangedKeys) {
+  // A since= delta covers any set of changes (including "*")
+  if (CanDeltaSync()) {
+    FetchFlags();
     return;
   }
 
-  // Do partial fetch for affected keys
-  UE_LOG(LogGatrix, Log, TEXT("HandleStreamingInvalidation: calling FetchPartialFlags"));
-  FetchPartialFlags(ChangedKeys);
+  int32 TotalFlags = RealtimeFlags.Num();
+  if (ChangedKeys.Num() == 0 || ChangedKeys.Contains(TEXT("*")) || TotalFlags == 0 ||
+      ChangedKeys.Num() >= TotalFlags / 2) {
+    Etag = TEXT("");
+    FetchFlags();
+  } else {
+    FetchPartialFlags(ChangedKeys);
+  }
 }
 
 void UGatrixFeaturesClient::FetchPartialFlags(const TArray<FString>& FlagKeys) {
@@ -2094,26 +2972,23 @@ void UGatrixFeaturesClient::FetchPartialFlags(const TArray<FString>& FlagKeys) {
     return;
   }
 
+  // Single-flight: fold the keys into the follow-up of the in-flight request
+  if (bIsFetching || bStreamingFetching) {
+    Invalidations.Add(FlagKeys);
+    return;
+  }
+
   bStreamingFetching = true;
   FString PartialFetchStartHash = LastContextHash;
 
-  // Build URL with specific flag keys
-  FString BaseUrl = BuildFetchUrl();
-
-  // Add flagKeys parameter
-  FString KeysParam;
-  for (int32 i = 0; i < FlagKeys.Num(); ++i) {
-    if (i > 0)
-      KeysParam += TEXT(",");
-    KeysParam += FGenericPlatformHttp::UrlEncode(FlagKeys[i]);
-  }
-  BaseUrl += FString::Printf(TEXT("&flagKeys=%s"), *KeysParam);
-
-  UE_LOG(LogGatrix, Log, TEXT("FetchPartialFlags: url=%s"), *BaseUrl);
+  // POST: the key batch travels in the body, so its size is not bounded by URL length
+  FString Url = FString::Printf(TEXT("%s/client/features/eval"), *ClientConfig.ApiUrl);
+  UE_LOG(LogGatrix, Log, TEXT("FetchPartialFlags: url=%s, keys=%d"), *Url, FlagKeys.Num());
 
   TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
-  HttpRequest->SetURL(BaseUrl);
-  HttpRequest->SetVerb(TEXT("GET"));
+  HttpRequest->SetURL(Url);
+  HttpRequest->SetVerb(TEXT("POST"));
+  HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
   HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
   HttpRequest->SetHeader(TEXT("X-API-Token"), ClientConfig.ApiToken);
   HttpRequest->SetHeader(TEXT("X-Application-Name"), ClientConfig.AppName);
@@ -2128,6 +3003,8 @@ void UGatrixFeaturesClient::FetchPartialFlags(const TArray<FString>& FlagKeys) {
     HttpRequest->SetHeader(Header.Key, Header.Value);
   }
 
+  SetCompressedBody(HttpRequest, FGatrixJson::SerializeContext(ClientConfig, FlagKeys));
+
   // Capture requested keys for merge
   TSet<FString> RequestedKeys;
   for (const FString& Key : FlagKeys) {
@@ -2144,9 +3021,8 @@ void UGatrixFeaturesClient::FetchPartialFlags(const TArray<FString>& FlagKeys) {
                StatusCode, (int)bWasSuccessful);
 
         if (bWasSuccessful && Response.IsValid() && StatusCode == 200) {
-          FString Body = Response->GetContentAsString();
-          // Update flags via normal path (StoreFlags handles Version-based change detection)
-          HandleFetchResponse(Body, 200, TEXT(""));
+          // Merge only the requested keys; unchanged flags keep their records and hashes
+          MergePartialResponse(Response->GetContentAsString(), RequestedKeys);
         } else {
           // On failure, fall back to full fetch with cleared ETag
           UE_LOG(LogGatrix, Warning,
@@ -2159,25 +3035,16 @@ void UGatrixFeaturesClient::FetchPartialFlags(const TArray<FString>& FlagKeys) {
         if (LastContextHash != PartialFetchStartHash) {
           UE_LOG(LogGatrix, Log, TEXT("Context changed during partial fetch, triggering full re-fetch"));
           Etag = TEXT("");
-          PendingInvalidationKeys.Empty();
+          Invalidations.Reset();
           FetchFlags();
         }
-        // Priority 2: Process accumulated pending invalidation keys
-        else if (PendingInvalidationKeys.Num() > 0) {
-          TSet<FString> PendingCopy = MoveTemp(PendingInvalidationKeys);
-          PendingInvalidationKeys.Empty();
-          if (PendingCopy.Contains(TEXT("*"))) {
-            Etag = TEXT("");
-            FetchFlags();
-          } else {
-            int32 TotalFlags = RealtimeFlags.Num();
-            if (TotalFlags == 0 || PendingCopy.Num() >= TotalFlags / 2) {
-              Etag = TEXT("");
-              FetchFlags();
-            } else {
-              FetchPartialFlags(PendingCopy.Array());
-            }
-          }
+        // Priority 2: A full fetch was requested while this one was in flight
+        else if (bFullFetchQueued) {
+          FetchFlags();
+        }
+        // Priority 3: Invalidations merged while in flight (unless their window is still open)
+        else if (!bInvalidationFlushScheduled) {
+          FlushInvalidations();
         }
       });
 
@@ -2204,81 +3071,106 @@ void UGatrixFeaturesClient::MergePartialResponse(const FString& ResponseBody,
   }
 
   // Merge into existing cache (update/add returned; remove requested-but-absent)
-  TMap<FString, FGatrixEvaluatedFlag> OldFlags;
+  TSet<FString> RemovedKeys = RequestedKeys;
+  for (const auto& Flag : PartialFlags) {
+    RemovedKeys.Remove(Flag.Name);
+  }
+  MergeFlags(PartialFlags, RemovedKeys);
+
+  UpdateCount.Increment();
+  ConsecutiveFailures.Reset();
+  if (EventEmitter) {
+    EventEmitter->Emit(GatrixEvents::FlagsFetchSuccess);
+  }
+}
+
+void UGatrixFeaturesClient::MergeFlags(const TArray<FGatrixEvaluatedFlag>& Upserts,
+                                       const TSet<FString>& RemovedKeys) {
+  FGatrixFlagDiff Diff;
   {
     FScopeLock Lock(&FlagsCriticalSection);
-    OldFlags = RealtimeFlags;
 
-    for (const auto& Flag : PartialFlags) {
-      RealtimeFlags.Add(Flag.Name, Flag);
+    // Update/add returned flags; the diff only sees touched records
+    for (const auto& Flag : Upserts) {
+      if (FGatrixEvaluatedFlag* Existing = RealtimeFlags.Find(Flag.Name)) {
+        if (Existing->ContentHash != Flag.ContentHash) {
+          Diff.Changed.Add(Flag.Name);
+          *Existing = Flag;
+        }
+      } else {
+        Diff.Added.Add(Flag.Name);
+        RealtimeFlags.Add(Flag.Name, Flag);
+      }
     }
 
-    TSet<FString> ReturnedNames;
-    for (const auto& Flag : PartialFlags)
-      ReturnedNames.Add(Flag.Name);
-    for (const FString& Key : RequestedKeys) {
-      if (!ReturnedNames.Contains(Key))
-        RealtimeFlags.Remove(Key);
+    for (const FString& Key : RemovedKeys) {
+      if (RealtimeFlags.Remove(Key) > 0) {
+        Diff.Removed.Add(Key);
+      }
+    }
+
+    // Nothing moved: no storage write, change event or pending sync
+    if (Diff.IsEmpty()) {
+      return;
     }
+    AdvanceGeneration(Diff, /*bForceRealtime=*/true);
+
+    // The edge's ETag for the merged set, so the next poll can still come back 304
+    UpdateEtagSource(Diff);
+    Etag = RealtimeEtag.ToEtag(LastContextHash);
 
     if (!ClientConfig.Features.bExplicitSyncMode) {
-      SynchronizedFlags = RealtimeFlags;
+      // Only the touched keys: outside explicit sync mode the synced map mirrors the realtime one
+      for (const TArray<FString>* Names : {&Diff.Added, &Diff.Changed}) {
+        for (const FString& Name : *Names) {
+          SynchronizedFlags.Add(Name, RealtimeFlags[Name]);
+        }
+      }
+      for (const FString& Name : Diff.Removed) {
+        SynchronizedFlags.Remove(Name);
+      }
+      AdvanceGeneration(Diff, /*bForceRealtime=*/false);
+    } else {
+      bool bWasPending = bPendingSync;
+      bPendingSync = true;
+      if (!bWasPending && EventEmitter) {
+        EventEmitter->Emit(GatrixEvents::FlagsPendingSync);
+      }
     }
   }
 
   // Emit watch callbacks for changed flags using RealtimeFlags directly
   TMap<FString, FGatrixEvaluatedFlag> NewRealtime = RealtimeFlags;
 
-  EmitFlagChanges(OldFlags, NewRealtime);
-  InvokeWatchCallbacks(RealtimeWatchCallbacks, OldFlags, NewRealtime, /*bForceRealtime=*/true, LastContextHash, LastContextHash);
+  EmitFlagChanges(Diff, NewRealtime);
+  InvokeWatchCallbacks(RealtimeWatchCallbacks, Diff, /*bForceRealtime=*/true);
 
   if (!ClientConfig.Features.bExplicitSyncMode) {
-    InvokeWatchCallbacks(SyncedWatchCallbacks, OldFlags, NewRealtime, /*bForceRealtime=*/false, LastContextHash, LastContextHash);
+    InvokeWatchCallbacks(SyncedWatchCallbacks, Diff, /*bForceRealtime=*/false);
     if (EventEmitter)
       EventEmitter->Emit(GatrixEvents::FlagsChange);
     OnChange.Broadcast();
   }
 
-  // Recalculate ETag after partial update to match full state evaluation
-  {
-    FScopeLock Lock(&FlagsCriticalSection);
-    FString NewEtag = ComputeEtag(RealtimeFlags, LastContextHash);
-    if (!NewEtag.IsEmpty() && NewEtag != Etag) {
-      Etag = NewEtag;
-      if (StorageProvider.IsValid()) {
-        StorageProvider->Save(StorageKeyEtag, Etag);
-      }
-      UE_LOG(LogGatrix, Log, TEXT("[DEV] Recalculated ETag after partial update: %s"), *Etag);
-    }
+  // Persist merged state
+  if (StorageProvider.IsValid()) {
+    TArray<FGatrixEvaluatedFlag> MergedFlags;
+    NewRealtime.GenerateValueArray(MergedFlags);
+    StorageProvider->Save(StorageKeyFlags, FGatrixJson::SerializeFlags(MergedFlags));
+    StorageProvider->Save(StorageKeyEtag, Etag);
   }
 }
 
-FString UGatrixFeaturesClient::ComputeEtag(const TMap<FString, FGatrixEvaluatedFlag>& Flags,
-                                           const FString& ContextHash) {
-  TArray<FGatrixEvaluatedFlag> FlagArray;
-  Flags.GenerateValueArray(FlagArray);
-
-  // Sort flags by name ascending to match server-side sorting
-  FlagArray.Sort([](const FGatrixEvaluatedFlag& A, const FGatrixEvaluatedFlag& B) {
-    return A.Name < B.Name;
-  });
-
-  FString EtagSource = ContextHash;
-  for (const auto& F : FlagArray) {
-    FString VariantPart =
-        F.Variant.Name.IsEmpty()
-            ? TEXT("no-variant")
-            : FString::Printf(TEXT("%s:%s"), *F.Variant.Name,
-                              F.Variant.bEnabled ? TEXT("true") : TEXT("false"));
-
-    EtagSource += FString::Printf(TEXT("|%s:%d:%s:%s"), *F.Name, F.Version,
-                                  F.bEnabled ? TEXT("true") : TEXT("false"), *VariantPart);
+void UGatrixFeaturesClient::UpdateEtagSource(const FGatrixFlagDiff& Diff) {
+  // Caller holds FlagsCriticalSection
+  for (const TArray<FString>* Names : {&Diff.Added, &Diff.Changed}) {
+    for (const FString& Name : *Names) {
+      RealtimeEtag.Put(RealtimeFlags[Name]);
+    }
+  }
+  for (const FString& Name : Diff.Removed) {
+    RealtimeEtag.Remove(Name);
   }
-
-  // Use MD5 for ETag computation (fast, collision-resistant enough for caching)
-  FString Result = FMD5::HashAnsiString(*EtagSource);
-
-  return FString::Printf(TEXT("\"%s\""), *Result);
 }
 
 void UGatrixFeaturesClient::ScheduleStreamingReconnect() {
@@ -2346,20 +3238,18 @@ void UGatrixFeaturesClient::SetStreamingState(EGatrixStreamingConnectionState Ne
              StateNames[static_cast<int32>(NewState)]);
     }
 
-    // Manage polling based on streaming state:
-    // - Connected: streaming delivers real-time updates, stop polling to avoid race conditions
-    // - Disconnected/Degraded: fall back to polling as the only update mechanism
-    if (NewState == EGatrixStreamingConnectionState::Connected) {
-      bPollingStopped = true;
-      StopPolling();
-      UE_LOG(LogGatrix, Log, TEXT("Polling stopped: streaming connected"));
-    } else if (NewState == EGatrixStreamingConnectionState::Disconnected ||
-               NewState == EGatrixStreamingConnectionState::Degraded) {
-      bPollingStopped = false;
-      ScheduleNextPoll();
-      UE_LOG(LogGatrix, Log, TEXT("Polling resumed: streaming %s"),
-             NewState == EGatrixStreamingConnectionState::Degraded ? TEXT("degraded")
-                                                                   : TEXT("disconnected"));
+    // Streaming health selects the polling mode:
+    // - Connected: streaming delivers real-time updates, polling drops to a long safety poll
+    // - Otherwise: polling takes over at the regular interval (or backs off while flapping)
+    const EGatrixPollingMode PrevMode = Polling.GetMode();
+    Polling.OnStreamingState(NewState == EGatrixStreamingConnectionState::Connected);
+    const EGatrixPollingMode NewMode = Polling.GetMode();
+    if (NewMode != PrevMode) {
+      UE_LOG(LogGatrix, Log, TEXT("Polling mode: %s"), *UEnum::GetValueAsString(NewMode));
+      // Re-arm so the new interval applies now rather than after the old one runs out
+      if (!bIsFetching) {
+        ScheduleNextPoll();
+      }
     }
   }
 }
@@ -2394,6 +3284,164 @@ FString UGatrixFeaturesClient::BuildStreamingUrl() const {
   if (LocalGlobalRevision > 0) {
     QueryString += FString::Printf(TEXT("&globalRevision=%lld"), LocalGlobalRevision);
   }
+  if (StreamConfig.bPushPayload) {
+    QueryString += TEXT("&payload=true");
+  }
+  if (ClientConfig.Features.bEnableScheduledActivations) {
+    QueryString += TEXT("&scheduled=true");
+  }
+  // A declared-only set lets the server filter events; one that grows at runtime
+  // would go stale on the open stream, so observed sets are filtered here instead
+  if (Interest.IsStatic()) {
+    QueryString += TEXT("&") + Interest.ToQueryString();
+  }
 
   return BaseUrl + QueryString;
 }
+
+FString UGatrixFeaturesClient::BuildStreamingHubKey() const {
+  // Everything that makes two connections deliver different events
+  const FGatrixStreamingConfig& StreamConfig = ClientConfig.Features.Streaming;
+  FString Key = FString::Printf(
+      TEXT("%s|%s|%s|%d|%d|%s|%s|%d"), *ClientConfig.ApiUrl, *ClientConfig.ApiToken,
+      *ClientConfig.AppName, static_cast<int32>(StreamConfig.Transport),
+      StreamConfig.bPushPayload ? 1 : 0, *StreamConfig.Sse.Url, *StreamConfig.WebSocket.Url,
+      StreamConfig.WebSocket.bBinaryFrames ? 1 : 0);
+  if (ClientConfig.Features.bEnableScheduledActivations) {
+    Key += TEXT("|scheduled");
+  }
+  for (const auto& Header : ClientConfig.CustomHeaders) {
+    Key += FString::Printf(TEXT("|%s=%s"), *Header.Key, *Header.Value);
+  }
+  if (Interest.IsStatic()) {
+    Key += TEXT("|") + Interest.ToQueryString();
+  }
+  return Key;
+}
+
+// ==================== Scheduled Activations ====================
+
+int64 UGatrixFeaturesClient::GetServerNowMs() const {
+  if (!bServerClockSynced) {
+    return static_cast<int64>(
+        (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds());
+  }
+  return ServerClockBaseMs +
+         static_cast<int64>((FPlatformTime::Seconds() - ServerClockBaseSeconds) * 1000.0);
+}
+
+void UGatrixFeaturesClient::SampleServerClock(const FHttpResponsePtr& Response,
+                                              double SentSeconds) {
+  // X-Server-Time: server epoch ms when the response was produced, taken to be the
+  // midpoint of the round trip (error at most half of it)
+  const FString ServerTime = Response->GetHeader(TEXT("X-Server-Time"));
+  if (ServerTime.IsEmpty() || !ServerTime.IsNumeric()) {
+    return;
+  }
+  const double ReceivedSeconds = FPlatformTime::Seconds();
+  const double RttSeconds = ReceivedSeconds - SentSeconds;
+
+  // The sample with the shortest round trip bounds the error best; a basis older than an
+  // hour is replaced anyway so a long session follows the server's clock
+  const bool bStale = bServerClockSynced && ReceivedSeconds - ServerClockBaseSeconds > 3600.0;
+  if (bServerClockSynced && RttSeconds > ServerClockRttSeconds && !bStale) {
+    return;
+  }
+  bServerClockSynced = true;
+  ServerClockRttSeconds = RttSeconds;
+  ServerClockBaseMs = FCString::Atoi64(*ServerTime);
+  ServerClockBaseSeconds = SentSeconds + RttSeconds / 2.0;
+}
+
+void UGatrixFeaturesClient::EnqueueScheduledChanges(TArray<FGatrixScheduledChange> Changes,
+                                                    bool bReplaceAll) {
+  if (!ClientConfig.Features.bEnableScheduledActivations) {
+    return;
+  }
+  if (bReplaceAll) {
+    Activations.Reset();
+  }
+
+  // Each client activates at a stable offset within the change's jitter window
+  const FString& Seed = ClientConfig.Features.Context.SessionId.IsEmpty()
+                            ? ConnectionId
+                            : ClientConfig.Features.Context.SessionId;
+  for (FGatrixScheduledChange& Change : Changes) {
+    if (Change.bCancelled) {
+      Activations.Cancel(Change.Id);
+      continue;
+    }
+    const FString ChangeSeed = Seed + TEXT("|") + Change.Id;
+    Change.DeadlineMs = Change.ActivateAtMs +
+                        FGatrixInvalidationCoalescer::SpreadDelayMs(ChangeSeed, Change.JitterMs);
+    Change.ContextHash = LastContextHash;
+    Activations.Put(MoveTemp(Change));
+  }
+  ScheduleActivationTimer();
+}
+
+void UGatrixFeaturesClient::ScheduleActivationTimer() {
+  UWorld* World = nullptr;
+  if (GEngine && GEngine->GetWorldContexts().Num() > 0) {
+    World = GEngine->GetWorldContexts()[0].World();
+  }
+  if (World) {
+    World->GetTimerManager().ClearTimer(ActivationTimerHandle);
+  }
+  if (Activations.IsEmpty() || !bStarted) {
+    return;
+  }
+
+  // Re-checked at least every minute: world time stops while the game is paused, the
+  // server clock does not
+  const int64 DelayMs =
+      FMath::Clamp<int64>(Activations.GetNextDeadlineMs() - GetServerNowMs(), 0, 60000);
+  if (!World || DelayMs <= 0) {
+    // Due now (published late or received after the deadline): next tick
+    TWeakObjectPtr<UGatrixFeaturesClient> WeakThis(this);
+    AsyncTask(ENamedThreads::GameThread, [WeakThis]() {
+      if (UGatrixFeaturesClient* Self = WeakThis.Get()) {
+        Self->ApplyDueActivations();
+      }
+    });
+    return;
+  }
+  FTimerDelegate ActivationDelegate =
+      FTimerDelegate::CreateWeakLambda(this, [this]() { ApplyDueActivations(); });
+  World->GetTimerManager().SetTimer(ActivationTimerHandle, ActivationDelegate, DelayMs / 1000.0f,
+                                    false);
+}
+
+void UGatrixFeaturesClient::ApplyDueActivations() {
+  if (!bStarted) {
+    return;
+  }
+
+  // Everything due is merged into one update (a later change overrides an earlier one)
+  TMap<FString, FGatrixEvaluatedFlag> Upserts;
+  TSet<FString> Removed;
+  for (FGatrixScheduledChange& Change : Activations.TakeDue(GetServerNowMs())) {
+    // Evaluated for a context switched away from; that context's fetch brings its own
+    if (Change.ContextHash != LastContextHash) {
+      continue;
+    }
+    for (const FString& Name : Change.Removed) {
+      Upserts.Remove(Name);
+      Removed.Add(Name);
+    }
+    for (FGatrixEvaluatedFlag& Flag : Change.Flags) {
+      Removed.Remove(Flag.Name);
+      Upserts.Add(Flag.Name, MoveTemp(Flag));
+    }
+    ScheduledActivationCount++;
+  }
+
+  if (Upserts.Num() > 0 || Removed.Num() > 0) {
+    TArray<FGatrixEvaluatedFlag> Flags;
+    Upserts.GenerateValueArray(Flags);
+    MergeFlags(Flags, Removed);
+    UE_LOG(LogGatrix, Log, TEXT("Applied scheduled activation (upserts=%d, removed=%d)"),
+           Flags.Num(), Removed.Num());
+  }
+  ScheduleActivationTimer();
+}
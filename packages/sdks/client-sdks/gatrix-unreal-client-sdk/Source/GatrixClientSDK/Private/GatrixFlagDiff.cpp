@@ -0,0 +1,29 @@
+// Copyright Gatrix. All Rights Reserved.
+// Content-hash based flag snapshot diffing
+
+#include "GatrixFlagDiff.h"
+
+FGatrixFlagDiff FGatrixFlagDiff::Compute(const TMap<FString, FGatrixEvaluatedFlag>& OldFlags,
+                                         const TMap<FString, FGatrixEvaluatedFlag>& NewFlags) {
+  FGatrixFlagDiff Diff;
+
+  for (const auto& Pair : NewFlags) {
+    const FGatrixEvaluatedFlag* OldFlag = OldFlags.Find(Pair.Key);
+    if (!OldFlag) {
+      Diff.Added.Add(Pair.Key);
+    } else if (OldFlag->ContentHash != Pair.Value.ContentHash) {
+      Diff.Changed.Add(Pair.Key);
+    }
+  }
+
+  // Only scan for removals when the key sets can differ
+  if (OldFlags.Num() + Diff.Added.Num() != NewFlags.Num()) {
+    for (const auto& Pair : OldFlags) {
+      if (!NewFlags.Contains(Pair.Key)) {
+        Diff.Removed.Add(Pair.Key);
+      }
+    }
+  }
+
+  return Diff;
+}
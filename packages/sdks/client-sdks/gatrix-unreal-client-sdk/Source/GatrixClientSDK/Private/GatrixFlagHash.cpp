@@ -0,0 +1,210 @@
+// Copyright Gatrix. All Rights Reserved.
+// Per-flag content hashes and the edge-compatible set ETag
+
+#include "GatrixFlagHash.h"
+
+#include "GatrixTypes.h"
+
+#include "Algo/BinarySearch.h"
+
+namespace {
+constexpr uint64 FnvPrime = 0x100000001b3ULL;
+
+uint64 Rotl64(uint64 X, int32 R) {
+  return (X << R) | (X >> (64 - R));
+}
+
+// localeCompare (root collation) weights: controls, then the ASCII punctuation and
+// digits in this order, then letters; case only breaks ties (lowercase first)
+const ANSICHAR EdgeAsciiOrder[] = " _-,;:!?.'\"()[]{}@*/\\&#%`^+<=>|~$0123456789";
+
+struct FNameWeight {
+  uint32 Primary;
+  uint8 Tertiary;
+};
+
+const FNameWeight* EdgeAsciiWeights() {
+  static const FNameWeight* Table = [] {
+    static FNameWeight Weights[128];
+    for (int32 C = 0; C < 128; ++C) {
+      Weights[C] = {static_cast<uint32>(C < 0x20 ? C : 0x100 + C), 0};
+    }
+    uint32 Next = 0x20;
+    for (const ANSICHAR* P = EdgeAsciiOrder; *P; ++P) {
+      Weights[static_cast<uint8>(*P)] = {Next++, 0};
+    }
+    for (int32 C = 'a'; C <= 'z'; ++C) {
+      Weights[C] = {Next + (C - 'a'), 0};
+      Weights[C - 'a' + 'A'] = {Next + (C - 'a'), 1};
+    }
+    Weights[0x7f] = {Next + 26, 0};
+    return Weights;
+  }();
+  return Table;
+}
+
+FNameWeight EdgeNameWeight(TCHAR C) {
+  const uint32 Code = static_cast<uint32>(C);
+  return Code < 128 ? EdgeAsciiWeights()[Code] : FNameWeight{0x100 + Code, 0};
+}
+
+// Same rendering as the edge: `${name}:${version}:${enabled}:${variant ?? 'no-variant'}`
+FString EdgeSegment(const FGatrixEvaluatedFlag& Flag) {
+  FString Segment = FString::Printf(TEXT("%s:%d:%s:"), *Flag.Name, Flag.Version,
+                                    Flag.bEnabled ? TEXT("true") : TEXT("false"));
+  if (Flag.Variant.Name.IsEmpty()) {
+    Segment += TEXT("no-variant");
+  } else {
+    Segment += Flag.Variant.Name;
+    Segment += Flag.Variant.bEnabled ? TEXT(":true") : TEXT(":false");
+  }
+  return Segment;
+}
+
+// MurmurHash3 64-bit finalizer
+uint64 FMix64(uint64 K) {
+  K ^= K >> 33;
+  K *= 0xff51afd7ed558ccdULL;
+  K ^= K >> 33;
+  K *= 0xc4ceb9fe1a85ec53ULL;
+  K ^= K >> 33;
+  return K;
+}
+} // namespace
+
+// ==================== Hasher ====================
+
+FGatrixFlagHasher& FGatrixFlagHasher::Update(const void* Data, int64 Len) {
+  const uint8* Bytes = static_cast<const uint8*>(Data);
+  for (int64 i = 0; i < Len; ++i) {
+    Lo = (Lo ^ Bytes[i]) * FnvPrime;
+    Hi = (Hi ^ Bytes[i] ^ (Lo >> 56)) * FnvPrime;
+  }
+  return *this;
+}
+
+FGatrixFlagHasher& FGatrixFlagHasher::Update(const FString& Value) {
+  Update(static_cast<uint64>(Value.Len()));
+  return Update(*Value, static_cast<int64>(Value.Len()) * sizeof(TCHAR));
+}
+
+FGatrixFlagHasher& FGatrixFlagHasher::Update(uint64 Value) {
+  uint8 Bytes[8];
+  for (int32 i = 0; i < 8; ++i) {
+    Bytes[i] = static_cast<uint8>(Value >> (i * 8));
+  }
+  return Update(Bytes, sizeof(Bytes));
+}
+
+FGatrixFlagHash FGatrixFlagHasher::Finish() const {
+  FGatrixFlagHash Out;
+  Out.Lo = FMix64(Lo ^ Rotl64(Hi, 31));
+  Out.Hi = FMix64(Hi + Out.Lo);
+  return Out;
+}
+
+// ==================== Flag Content Hash ====================
+
+FGatrixFlagHash FGatrixFlagHash::Compute(const FGatrixEvaluatedFlag& Flag) {
+  FGatrixFlagHasher Hasher;
+  Hasher.Update(Flag.Name)
+      .Update(static_cast<uint64>(static_cast<int64>(Flag.Version)))
+      .Update(Flag.bEnabled)
+      .Update(static_cast<uint64>(Flag.ValueType))
+      .Update(Flag.Variant.Name)
+      .Update(Flag.Variant.bEnabled)
+      .Update(Flag.Variant.Value)
+      .Update(Flag.Reason)
+      .Update(Flag.bImpressionData);
+  return Hasher.Finish();
+}
+
+// ==================== Edge ETag ====================
+
+bool FGatrixEdgeNameOrder::operator()(const FString& A, const FString& B) const {
+  const int32 N = FMath::Min(A.Len(), B.Len());
+  for (int32 i = 0; i < N; ++i) {
+    const uint32 PA = EdgeNameWeight(A[i]).Primary;
+    const uint32 PB = EdgeNameWeight(B[i]).Primary;
+    if (PA != PB) {
+      return PA < PB;
+    }
+  }
+  if (A.Len() != B.Len()) {
+    return A.Len() < B.Len();
+  }
+  for (int32 i = 0; i < N; ++i) {
+    const uint8 TA = EdgeNameWeight(A[i]).Tertiary;
+    const uint8 TB = EdgeNameWeight(B[i]).Tertiary;
+    if (TA != TB) {
+      return TA < TB;
+    }
+  }
+  return false;
+}
+
+void FGatrixFlagSetEtag::Put(const FGatrixEvaluatedFlag& Flag) {
+  FString Segment = EdgeSegment(Flag);
+  const int32 Index =
+      Algo::LowerBoundBy(Entries, Flag.Name, &FEntry::Name, FGatrixEdgeNameOrder());
+  if (Entries.IsValidIndex(Index) &&
+      Entries[Index].Name.Equals(Flag.Name, ESearchCase::CaseSensitive)) {
+    if (Entries[Index].Segment.Equals(Segment, ESearchCase::CaseSensitive)) {
+      return;
+    }
+    Entries[Index].Segment = MoveTemp(Segment);
+  } else {
+    Entries.Insert(FEntry{Flag.Name, MoveTemp(Segment), FGatrixSha256()}, Index);
+  }
+  InvalidateFrom(Index);
+}
+
+void FGatrixFlagSetEtag::Remove(const FString& Name) {
+  const int32 Index = Algo::LowerBoundBy(Entries, Name, &FEntry::Name, FGatrixEdgeNameOrder());
+  if (Entries.IsValidIndex(Index) && Entries[Index].Name.Equals(Name, ESearchCase::CaseSensitive)) {
+    Entries.RemoveAt(Index);
+    InvalidateFrom(Index);
+  }
+}
+
+void FGatrixFlagSetEtag::Reset(const TMap<FString, FGatrixEvaluatedFlag>& Flags) {
+  Entries.Reset(Flags.Num());
+  for (const auto& Pair : Flags) {
+    Entries.Add(FEntry{Pair.Value.Name, EdgeSegment(Pair.Value), FGatrixSha256()});
+  }
+  Entries.Sort(
+      [](const FEntry& A, const FEntry& B) { return FGatrixEdgeNameOrder()(A.Name, B.Name); });
+  StaleFrom = 0;
+}
+
+void FGatrixFlagSetEtag::InvalidateFrom(int32 Index) {
+  StaleFrom = StaleFrom == INDEX_NONE ? Index : FMath::Min(StaleFrom, Index);
+}
+
+FString FGatrixFlagSetEtag::ToEtag(const FString& InContextHash) {
+  if (!bPrimed || !InContextHash.Equals(ContextHash, ESearchCase::CaseSensitive)) {
+    bPrimed = true;
+    ContextHash = InContextHash;
+    Prefix = FGatrixSha256();
+    Prefix.Update(ContextHash).Update("|", 1);
+    StaleFrom = 0;
+  }
+  if (StaleFrom == INDEX_NONE) {
+    return CachedEtag;
+  }
+
+  // Resume from the checkpoint before the first stale record; earlier ones are unchanged
+  const FGatrixSha256* State = StaleFrom == 0 ? &Prefix : &Entries[StaleFrom - 1].After;
+  for (int32 i = StaleFrom; i < Entries.Num(); ++i) {
+    FGatrixSha256 Next = *State;
+    if (i > 0) {
+      Next.Update("|", 1);
+    }
+    Next.Update(Entries[i].Segment);
+    Entries[i].After = Next;
+    State = &Entries[i].After;
+  }
+  StaleFrom = INDEX_NONE;
+  CachedEtag = FString::Printf(TEXT("\"%s\""), *State->HexDigest());
+  return CachedEtag;
+}
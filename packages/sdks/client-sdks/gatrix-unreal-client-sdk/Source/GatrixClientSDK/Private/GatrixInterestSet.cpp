@@ -0,0 +1,117 @@
+// Copyright Gatrix. All Rights Reserved.
+// Flag keys a client reads: declared keys and prefixes plus keys observed at runtime
+
+#include "GatrixInterestSet.h"
+
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Misc/Base64.h"
+
+namespace {
+// 64-bit FNV-1a over the key's UTF-8 bytes (the server hashes the same bytes)
+uint64 Fnv1a64(const FString& Key) {
+  FTCHARToUTF8 Utf8(*Key);
+  uint64 Hash = 0xcbf29ce484222325ULL;
+  for (int32 i = 0; i < Utf8.Length(); ++i) {
+    Hash = (Hash ^ static_cast<uint8>(Utf8.Get()[i])) * 0x100000001b3ULL;
+  }
+  return Hash;
+}
+} // namespace
+
+void FGatrixInterestSet::Configure(const TArray<FString>& DeclaredKeys, bool bInTrackObserved,
+                                   int32 InBloomThreshold) {
+  FScopeLock Lock(&CriticalSection);
+  Keys.Reset();
+  Prefixes.Reset();
+  for (const FString& Key : DeclaredKeys) {
+    if (Key.EndsWith(TEXT("*"))) {
+      Prefixes.Add(Key.LeftChop(1));
+    } else if (!Key.IsEmpty()) {
+      Keys.Add(Key);
+    }
+  }
+  bTrackObserved = bInTrackObserved;
+  bEnabled = bTrackObserved || DeclaredKeys.Num() > 0;
+  BloomThreshold = FMath::Max(0, InBloomThreshold);
+}
+
+bool FGatrixInterestSet::Contains(const FString& Key) const {
+  FScopeLock Lock(&CriticalSection);
+  if (!bEnabled || Keys.Contains(Key)) {
+    return true;
+  }
+  for (const FString& Prefix : Prefixes) {
+    if (Key.StartsWith(Prefix, ESearchCase::CaseSensitive)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FGatrixInterestSet::Observe(const FString& Key) {
+  if (!bTrackObserved || Contains(Key)) {
+    return false;
+  }
+  FScopeLock Lock(&CriticalSection);
+  bool bAlreadyInSet = false;
+  Keys.Add(Key, &bAlreadyInSet);
+  return !bAlreadyInSet;
+}
+
+TArray<FString> FGatrixInterestSet::Intersect(const TArray<FString>& ChangedKeys) const {
+  if (!bEnabled || ChangedKeys.Num() == 0) {
+    return ChangedKeys;
+  }
+  TArray<FString> Result;
+  for (const FString& Key : ChangedKeys) {
+    if (Key == TEXT("*")) {
+      return ChangedKeys;
+    }
+    if (Contains(Key)) {
+      Result.Add(Key);
+    }
+  }
+  return Result;
+}
+
+FString FGatrixInterestSet::ToQueryString() const {
+  FScopeLock Lock(&CriticalSection);
+  if (!bEnabled) {
+    return FString();
+  }
+
+  TArray<FString> Listed;
+  for (const FString& Prefix : Prefixes) {
+    Listed.Add(Prefix + TEXT("*"));
+  }
+  const bool bBloom = Keys.Num() > BloomThreshold;
+  if (!bBloom) {
+    Listed.Append(Keys.Array());
+  }
+  // An empty list is still sent: nothing is of interest yet
+  FString Query =
+      TEXT("interest=") + FGenericPlatformHttp::UrlEncode(FString::Join(Listed, TEXT(",")));
+
+  if (bBloom) {
+    const int32 NumBytes = FMath::Max(8, (Keys.Num() * BloomBitsPerKey + 7) / 8);
+    const uint64 NumBits = static_cast<uint64>(NumBytes) * 8;
+    TArray<uint8> Bits;
+    Bits.SetNumZeroed(NumBytes);
+    for (const FString& Key : Keys) {
+      const uint64 H1 = Fnv1a64(Key);
+      const uint64 H2 = (H1 >> 32) | 1;
+      for (int32 i = 0; i < BloomHashCount; ++i) {
+        const uint64 Bit = (H1 + static_cast<uint64>(i) * H2) % NumBits;
+        Bits[Bit / 8] |= static_cast<uint8>(1u << (Bit % 8));
+      }
+    }
+    Query += FString::Printf(TEXT("&interestBloom=%d.%s"), BloomHashCount,
+                             *FGenericPlatformHttp::UrlEncode(FBase64::Encode(Bits)));
+  }
+  return Query;
+}
+
+int32 FGatrixInterestSet::Num() const {
+  FScopeLock Lock(&CriticalSection);
+  return Keys.Num() + Prefixes.Num();
+}
@@ -0,0 +1,61 @@
+// Copyright Gatrix. All Rights Reserved.
+// Adaptive debounce window for streaming invalidations
+
+#include "GatrixInvalidationCoalescer.h"
+#include "GatrixFlagHash.h"
+
+namespace {
+// Weight of the newest inter-arrival gap in the moving average
+constexpr double GapSmoothing = 0.3;
+} // namespace
+
+void FGatrixInvalidationCoalescer::Configure(int32 InMinWindowMs, int32 InMaxWindowMs) {
+  MinWindowMs = FMath::Max(0, InMinWindowMs);
+  MaxWindowMs = FMath::Max(MinWindowMs, InMaxWindowMs);
+  AvgGapMs = MaxWindowMs;
+}
+
+void FGatrixInvalidationCoalescer::Add(const TArray<FString>& InKeys, double NowSeconds) {
+  if (LastEventSeconds >= 0.0) {
+    const double GapMs = (NowSeconds - LastEventSeconds) * 1000.0;
+    AvgGapMs = GapSmoothing * GapMs + (1.0 - GapSmoothing) * AvgGapMs;
+  }
+  LastEventSeconds = NowSeconds;
+
+  if (InKeys.Num() == 0 || InKeys.Contains(TEXT("*"))) {
+    bFull = true;
+    Keys.Empty();
+  } else if (!bFull) {
+    Keys.Append(InKeys);
+  }
+}
+
+int32 FGatrixInvalidationCoalescer::GetWindowMs() const {
+  // Gap >= max -> isolated event, flush fast; gap <= min -> burst, wait the longest
+  const double Window = MaxWindowMs - (AvgGapMs - MinWindowMs);
+  return static_cast<int32>(FMath::Clamp(Window, (double)MinWindowMs, (double)MaxWindowMs));
+}
+
+TArray<FString> FGatrixInvalidationCoalescer::Take() {
+  TArray<FString> Batch;
+  if (bFull) {
+    Batch.Add(TEXT("*"));
+  } else {
+    Batch = Keys.Array();
+  }
+  Reset();
+  return Batch;
+}
+
+void FGatrixInvalidationCoalescer::Reset() {
+  Keys.Empty();
+  bFull = false;
+}
+
+int32 FGatrixInvalidationCoalescer::SpreadDelayMs(const FString& Seed, int32 WindowMs) {
+  if (WindowMs <= 0) {
+    return 0;
+  }
+  const FGatrixFlagHash Hash = FGatrixFlagHasher().Update(Seed).Finish();
+  return static_cast<int32>(Hash.Lo % static_cast<uint64>(WindowMs));
+}
@@ -7,6 +7,47 @@
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 
+// ==================== Streaming Events ====================
+
+FGatrixJson::FStreamingEvent FGatrixJson::MakeStreamingEvent(const FString& Type,
+                                                             const TSharedPtr<FJsonObject>& Body) {
+  FStreamingEvent Event;
+  Event.Type = Type;
+  Event.Body = Body;
+  if (!Body.IsValid()) {
+    return Event;
+  }
+
+  Event.bHasData = true;
+  Event.bHasGlobalRevision = Body->TryGetNumberField(TEXT("globalRevision"), Event.GlobalRevision);
+  Body->TryGetNumberField(TEXT("spreadWindowMs"), Event.SpreadWindowMs);
+  Body->TryGetBoolField(TEXT("urgent"), Event.bUrgent);
+  Body->TryGetBoolField(TEXT("resumed"), Event.bResumed);
+  const TArray<TSharedPtr<FJsonValue>>* KeysArray = nullptr;
+  if (Body->TryGetArrayField(TEXT("changedKeys"), KeysArray)) {
+    Event.ChangedKeys.Reserve(KeysArray->Num());
+    for (const auto& KeyVal : *KeysArray) {
+      FString Key;
+      if (KeyVal->TryGetString(Key)) {
+        Event.ChangedKeys.Add(MoveTemp(Key));
+      }
+    }
+  }
+  return Event;
+}
+
+FGatrixJson::FStreamingEvent FGatrixJson::ParseStreamingEvent(const FString& Type,
+                                                              const FString& Data) {
+  TSharedPtr<FJsonObject> Body;
+  if (!Data.IsEmpty()) {
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Data);
+    if (!FJsonSerializer::Deserialize(Reader, Body)) {
+      Body.Reset();
+    }
+  }
+  return MakeStreamingEvent(Type, Body);
+}
+
 // ==================== Value Type Helpers ====================
 
 EGatrixValueType FGatrixJson::ParseValueType(const FString& TypeStr) {
@@ -144,12 +185,56 @@ FGatrixEvaluatedFlag FGatrixJson::ParseFlag(const TSharedPtr<FJsonObject>& FlagO
     ParseVariantValue(PayloadValue, Flag.ValueType, Flag.Variant.Value);
   }
 
+  Flag.ContentHash = FGatrixFlagHash::Compute(Flag);
   return Flag;
 }
 
 // ==================== Flags Response Parsing ====================
 
 bool FGatrixJson::ParseFlagsResponse(const FString& Json, TArray<FGatrixEvaluatedFlag>& OutFlags) {
+  FFlagsPayload Payload;
+  if (!ParseFlagsPayload(Json, Payload)) {
+    return false;
+  }
+  OutFlags.Append(MoveTemp(Payload.Flags));
+  return true;
+}
+
+bool FGatrixJson::ParsePushedFlags(const TSharedPtr<FJsonObject>& EventObj,
+                                   FFlagsPayload& OutPayload) {
+  const TArray<TSharedPtr<FJsonValue>>* FlagsArray = nullptr;
+  if (!EventObj.IsValid() || !EventObj->TryGetArrayField(TEXT("flags"), FlagsArray)) {
+    return false;
+  }
+
+  const TArray<TSharedPtr<FJsonValue>>* RemovedArray = nullptr;
+  if (EventObj->TryGetArrayField(TEXT("removed"), RemovedArray)) {
+    for (const auto& NameValue : *RemovedArray) {
+      FString Name;
+      if (NameValue->TryGetString(Name)) {
+        OutPayload.Removed.Add(MoveTemp(Name));
+      }
+    }
+  }
+
+  OutPayload.bIsDelta = true;
+  OutPayload.Flags.Reserve(FlagsArray->Num());
+  for (const auto& FlagValue : *FlagsArray) {
+    // A malformed record rejects the event: it falls back to a fetch instead of merging a
+    // nameless or half-read flag
+    const TSharedPtr<FJsonObject>* FlagObj = nullptr;
+    if (!FlagValue->TryGetObject(FlagObj) ||
+        !(*FlagObj)->HasTypedField<EJson::String>(TEXT("name")) ||
+        !(*FlagObj)->HasTypedField<EJson::Boolean>(TEXT("enabled"))) {
+      return false;
+    }
+    OutPayload.Flags.Add(ParseFlag(*FlagObj));
+  }
+  ParseScheduledChanges(EventObj, OutPayload);
+  return true;
+}
+
+bool FGatrixJson::ParseFlagsPayload(const FString& Json, FFlagsPayload& OutPayload) {
   TSharedPtr<FJsonObject> JsonObject;
   TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
   if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid()) {
@@ -174,13 +259,120 @@ bool FGatrixJson::ParseFlagsResponse(const FString& Json, TArray<FGatrixEvaluate
     return false;
   }
 
+  // Delta envelope (servers without delta support omit these fields)
+  (*DataObj)->TryGetNumberField(TEXT("revision"), OutPayload.Revision);
+  (*DataObj)->TryGetBoolField(TEXT("delta"), OutPayload.bIsDelta);
+  const TArray<TSharedPtr<FJsonValue>>* RemovedArray = nullptr;
+  if (OutPayload.bIsDelta && (*DataObj)->TryGetArrayField(TEXT("removed"), RemovedArray)) {
+    for (const auto& NameValue : *RemovedArray) {
+      FString Name;
+      if (NameValue->TryGetString(Name)) {
+        OutPayload.Removed.Add(MoveTemp(Name));
+      }
+    }
+  }
+
   // Parse each flag
+  OutPayload.Flags.Reserve(FlagsArray->Num());
   for (const auto& FlagValue : *FlagsArray) {
     const TSharedPtr<FJsonObject>* FlagObj = nullptr;
     if (!FlagValue->TryGetObject(FlagObj)) {
       continue;
     }
-    OutFlags.Add(ParseFlag(*FlagObj));
+    OutPayload.Flags.Add(ParseFlag(*FlagObj));
+  }
+
+  ParseScheduledChanges(*DataObj, OutPayload);
+  return true;
+}
+
+void FGatrixJson::ParseScheduledChanges(const TSharedPtr<FJsonObject>& Obj,
+                                        FFlagsPayload& OutPayload) {
+  const TArray<TSharedPtr<FJsonValue>>* ScheduledArray = nullptr;
+  if (!Obj->TryGetArrayField(TEXT("scheduled"), ScheduledArray)) {
+    return;
+  }
+
+  OutPayload.bHasSchedule = true;
+  for (const auto& ChangeValue : *ScheduledArray) {
+    const TSharedPtr<FJsonObject>* ChangeObj = nullptr;
+    FGatrixScheduledChange Change;
+    if (!ChangeValue->TryGetObject(ChangeObj) ||
+        !(*ChangeObj)->TryGetStringField(TEXT("id"), Change.Id) ||
+        !(*ChangeObj)->TryGetNumberField(TEXT("activateAt"), Change.ActivateAtMs)) {
+      continue;
+    }
+    (*ChangeObj)->TryGetNumberField(TEXT("jitterMs"), Change.JitterMs);
+    (*ChangeObj)->TryGetBoolField(TEXT("cancelled"), Change.bCancelled);
+
+    const TArray<TSharedPtr<FJsonValue>>* FlagsArray = nullptr;
+    if ((*ChangeObj)->TryGetArrayField(TEXT("flags"), FlagsArray)) {
+      for (const auto& FlagValue : *FlagsArray) {
+        const TSharedPtr<FJsonObject>* FlagObj = nullptr;
+        if (FlagValue->TryGetObject(FlagObj)) {
+          Change.Flags.Add(ParseFlag(*FlagObj));
+        }
+      }
+    }
+    const TArray<TSharedPtr<FJsonValue>>* RemovedArray = nullptr;
+    if ((*ChangeObj)->TryGetArrayField(TEXT("removed"), RemovedArray)) {
+      for (const auto& NameValue : *RemovedArray) {
+        FString Name;
+        if (NameValue->TryGetString(Name)) {
+          Change.Removed.Add(MoveTemp(Name));
+        }
+      }
+    }
+    OutPayload.Scheduled.Add(MoveTemp(Change));
+  }
+}
+
+// ==================== Bulk Evaluation Parsing ====================
+
+bool FGatrixJson::ParseBulkEvaluation(const FString& Json, int32 ExpectedSlots,
+                                      FGatrixBulkEvaluation& OutEvaluation) {
+  TSharedPtr<FJsonObject> JsonObject;
+  TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+  if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid()) {
+    return false;
+  }
+
+  bool bSuccess = false;
+  JsonObject->TryGetBoolField(TEXT("success"), bSuccess);
+  const TSharedPtr<FJsonObject>* DataObj = nullptr;
+  const TArray<TSharedPtr<FJsonValue>>* FlagsArray = nullptr;
+  const TArray<TSharedPtr<FJsonValue>>* ResultsArray = nullptr;
+  if (!bSuccess || !JsonObject->TryGetObjectField(TEXT("data"), DataObj) ||
+      !(*DataObj)->TryGetArrayField(TEXT("flags"), FlagsArray) ||
+      !(*DataObj)->TryGetArrayField(TEXT("results"), ResultsArray) ||
+      ResultsArray->Num() != ExpectedSlots) {
+    return false;
+  }
+
+  // Distinct records first; the server already deduplicates, AddRecord catches the rest
+  TArray<int32> RecordIndices;
+  RecordIndices.Reserve(FlagsArray->Num());
+  for (const auto& FlagValue : *FlagsArray) {
+    const TSharedPtr<FJsonObject>* FlagObj = nullptr;
+    RecordIndices.Add(FlagValue->TryGetObject(FlagObj)
+                          ? OutEvaluation.AddRecord(ParseFlag(*FlagObj))
+                          : INDEX_NONE);
+  }
+
+  // One array of indices into flags per context, in request order
+  for (const auto& ResultValue : *ResultsArray) {
+    OutEvaluation.AddSlot();
+    const TArray<TSharedPtr<FJsonValue>>* Indices = nullptr;
+    if (!ResultValue->TryGetArray(Indices)) {
+      continue;
+    }
+    for (const auto& IndexValue : *Indices) {
+      int32 WireIndex = INDEX_NONE;
+      if (IndexValue->TryGetNumber(WireIndex) && RecordIndices.IsValidIndex(WireIndex) &&
+          RecordIndices[WireIndex] != INDEX_NONE) {
+        OutEvaluation.SetSlotRecord(RecordIndices[WireIndex]);
+      }
+    }
   }
 
   return true;
@@ -244,31 +436,73 @@ FString FGatrixJson::SerializeFlags(const TArray<FGatrixEvaluatedFlag>& Flags) {
 
 // ==================== Context Serialization ====================
 
-FString FGatrixJson::SerializeContext(const FGatrixClientConfig& Config) {
-  FString Json;
-  TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
-  Writer->WriteObjectStart();
-  Writer->WriteObjectStart(TEXT("context"));
-
-  Writer->WriteValue(TEXT("appName"), Config.AppName);
+FString FGatrixJson::SerializeContext(const FGatrixClientConfig& Config,
+                                     const TArray<FString>& FlagNames) {
+  return SerializeContext(Config.AppName, Config.Features.Context, FlagNames);
+}
 
+namespace {
+// Context fields (inside an already started object)
+void WriteContextFields(TJsonWriter<>& Writer, const FString& AppName,
+                        const FGatrixContext& Context) {
+  Writer.WriteValue(TEXT("appName"), AppName);
 
-  if (!Config.Features.Context.UserId.IsEmpty()) {
-    Writer->WriteValue(TEXT("userId"), Config.Features.Context.UserId);
+  if (!Context.UserId.IsEmpty()) {
+    Writer.WriteValue(TEXT("userId"), Context.UserId);
   }
-  if (!Config.Features.Context.SessionId.IsEmpty()) {
-    Writer->WriteValue(TEXT("sessionId"), Config.Features.Context.SessionId);
+  if (!Context.SessionId.IsEmpty()) {
+    Writer.WriteValue(TEXT("sessionId"), Context.SessionId);
   }
 
-  if (Config.Features.Context.Properties.Num() > 0) {
-    Writer->WriteObjectStart(TEXT("properties"));
-    for (const auto& Prop : Config.Features.Context.Properties) {
-      Writer->WriteValue(Prop.Key, Prop.Value);
+  if (Context.Properties.Num() > 0) {
+    Writer.WriteObjectStart(TEXT("properties"));
+    for (const auto& Prop : Context.Properties) {
+      Writer.WriteValue(Prop.Key, Prop.Value);
     }
-    Writer->WriteObjectEnd();
+    Writer.WriteObjectEnd();
   }
+}
 
+void WriteFlagNames(TJsonWriter<>& Writer, const TArray<FString>& FlagNames) {
+  if (FlagNames.Num() > 0) {
+    Writer.WriteArrayStart(TEXT("flagNames"));
+    for (const FString& Name : FlagNames) {
+      Writer.WriteValue(Name);
+    }
+    Writer.WriteArrayEnd();
+  }
+}
+} // namespace
+
+FString FGatrixJson::SerializeContext(const FString& AppName, const FGatrixContext& Context,
+                                     const TArray<FString>& FlagNames) {
+  FString Json;
+  TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+  Writer->WriteObjectStart();
+  Writer->WriteObjectStart(TEXT("context"));
+  WriteContextFields(*Writer, AppName, Context);
   Writer->WriteObjectEnd(); // context
+  WriteFlagNames(*Writer, FlagNames);
+  Writer->WriteObjectEnd();
+  Writer->Close();
+
+  return Json;
+}
+
+FString FGatrixJson::SerializeContexts(const FString& AppName,
+                                      TArrayView<const FGatrixContext> Contexts,
+                                      const TArray<FString>& FlagNames) {
+  FString Json;
+  TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+  Writer->WriteObjectStart();
+  Writer->WriteArrayStart(TEXT("contexts"));
+  for (const FGatrixContext& Context : Contexts) {
+    Writer->WriteObjectStart();
+    WriteContextFields(*Writer, AppName, Context);
+    Writer->WriteObjectEnd();
+  }
+  Writer->WriteArrayEnd();
+  WriteFlagNames(*Writer, FlagNames);
   Writer->WriteObjectEnd();
   Writer->Close();
 
@@ -0,0 +1,96 @@
+// Copyright Gatrix. All Rights Reserved.
+// Streaming-aware, server-hinted poll interval selection
+
+#include "GatrixPollingScheduler.h"
+
+namespace {
+// Spread of the healthy/degraded intervals so a fleet does not poll in lockstep
+constexpr float IntervalJitter = 0.1f;
+// Cap on the flapping backoff exponent (base * 2^6)
+constexpr int32 MaxFlapExponent = 6;
+} // namespace
+
+void FGatrixPollingScheduler::Configure(float InRefreshInterval, float InSafetyInterval,
+                                        int32 InFlapThreshold, float InFlapWindow) {
+  RefreshInterval = InRefreshInterval > 0.0f ? InRefreshInterval : 30.0f;
+  SafetyInterval = FMath::Max(RefreshInterval, InSafetyInterval);
+  FlapThreshold = FMath::Max(1, InFlapThreshold);
+  FlapWindow = FMath::Max(1.0f, InFlapWindow);
+}
+
+void FGatrixPollingScheduler::SetStreamingEnabled(bool bEnabled) {
+  bStreamingEnabled = bEnabled;
+  bConnected = false;
+  Disconnects.Reset();
+}
+
+void FGatrixPollingScheduler::OnStreamingState(bool bInConnected, double NowSeconds) {
+  if (bConnected && !bInConnected) {
+    Disconnects.Add(NowSeconds);
+  }
+  bConnected = bInConnected;
+  Disconnects.RemoveAll([&](double T) { return NowSeconds - T > FlapWindow; });
+}
+
+void FGatrixPollingScheduler::SetRetryAfter(float Seconds, double NowSeconds) {
+  if (Seconds > 0.0f) {
+    RetryAfterUntil = NowSeconds + Seconds;
+  }
+}
+
+int32 FGatrixPollingScheduler::RecentFlaps(double NowSeconds) const {
+  int32 Count = 0;
+  for (double T : Disconnects) {
+    if (NowSeconds - T <= FlapWindow)
+      Count++;
+  }
+  return Count;
+}
+
+EGatrixPollingMode FGatrixPollingScheduler::GetMode(double NowSeconds) const {
+  if (!bStreamingEnabled)
+    return EGatrixPollingMode::Normal;
+  if (RecentFlaps(NowSeconds) >= FlapThreshold)
+    return EGatrixPollingMode::Flapping;
+  return bConnected ? EGatrixPollingMode::Healthy : EGatrixPollingMode::Degraded;
+}
+
+float FGatrixPollingScheduler::NextDelay(int32 ConsecutiveFailures, float InitialBackoff,
+                                         float MaxBackoff, double NowSeconds) {
+  const float Base = ServerInterval > 0.0f ? ServerInterval : RefreshInterval;
+  float Delay = Base;
+
+  if (ConsecutiveFailures > 0) {
+    Delay = FMath::Min(
+        InitialBackoff * FMath::Pow(2.0f, static_cast<float>(ConsecutiveFailures - 1)), MaxBackoff);
+  } else {
+    switch (GetMode(NowSeconds)) {
+    case EGatrixPollingMode::Normal:
+    case EGatrixPollingMode::Degraded:
+      Delay = Base * (1.0f + FMath::FRandRange(-IntervalJitter, IntervalJitter));
+      break;
+    case EGatrixPollingMode::Healthy:
+      // The safety interval stands in for the server; an explicit hint, smaller or not, wins
+      Delay = (ServerInterval > 0.0f ? Base : FMath::Max(Base, SafetyInterval)) *
+              (1.0f + FMath::FRandRange(-IntervalJitter, IntervalJitter));
+      break;
+    case EGatrixPollingMode::Flapping: {
+      // Full jitter in [Cap/2, Cap] decorrelates clients that dropped together
+      const int32 Exponent =
+          FMath::Min(MaxFlapExponent, RecentFlaps(NowSeconds) - FlapThreshold + 1);
+      const float Cap = FMath::Min(Base * static_cast<float>(1 << Exponent), SafetyInterval);
+      Delay = FMath::FRandRange(Cap * 0.5f, Cap);
+      break;
+    }
+    }
+  }
+
+  // Retry-After is a floor for the next poll only
+  if (RetryAfterUntil >= 0.0) {
+    Delay = FMath::Max(Delay, static_cast<float>(RetryAfterUntil - NowSeconds));
+    RetryAfterUntil = -1.0;
+  }
+
+  LastDelay = Delay;
+  return Delay;
+}
@@ -0,0 +1,107 @@
+// Copyright Gatrix. All Rights Reserved.
+// Streaming SHA-256 (ETags compatible with the edge)
+
+#include "GatrixSha256.h"
+
+namespace {
+uint32 Rotr(uint32 X, uint32 N) {
+  return (X >> N) | (X << (32 - N));
+}
+
+const uint32 K[] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+} // namespace
+
+FGatrixSha256::FGatrixSha256() {
+  State[0] = 0x6a09e667;
+  State[1] = 0xbb67ae85;
+  State[2] = 0x3c6ef372;
+  State[3] = 0xa54ff53a;
+  State[4] = 0x510e527f;
+  State[5] = 0x9b05688c;
+  State[6] = 0x1f83d9ab;
+  State[7] = 0x5be0cd19;
+}
+
+FGatrixSha256& FGatrixSha256::Update(const void* Data, int64 Len) {
+  const uint8* Bytes = static_cast<const uint8*>(Data);
+  for (int64 i = 0; i < Len; ++i) {
+    Buffer[BufferLen++] = Bytes[i];
+    if (BufferLen == 64) {
+      ProcessBlock(Buffer);
+      TotalLen += 64;
+      BufferLen = 0;
+    }
+  }
+  return *this;
+}
+
+FGatrixSha256& FGatrixSha256::Update(const FString& Value) {
+  FTCHARToUTF8 Utf8(*Value);
+  return Update(Utf8.Get(), Utf8.Length());
+}
+
+FString FGatrixSha256::HexDigest() const {
+  FGatrixSha256 Tail = *this;
+  const uint64 TotalBits = (TotalLen + BufferLen) * 8;
+  const uint8 Pad = 0x80;
+  const uint8 Zero = 0;
+  Tail.Update(&Pad, 1);
+  while (Tail.BufferLen != 56) {
+    Tail.Update(&Zero, 1);
+  }
+  for (int32 i = 7; i >= 0; --i) {
+    const uint8 Byte = static_cast<uint8>(TotalBits >> (i * 8));
+    Tail.Update(&Byte, 1);
+  }
+
+  FString Hex;
+  Hex.Reserve(64);
+  for (int32 i = 0; i < 8; ++i) {
+    Hex += FString::Printf(TEXT("%08x"), Tail.State[i]);
+  }
+  return Hex;
+}
+
+void FGatrixSha256::ProcessBlock(const uint8* Data) {
+  uint32 W[64];
+  for (int32 i = 0; i < 16; i++) {
+    W[i] = (static_cast<uint32>(Data[i * 4]) << 24) | (static_cast<uint32>(Data[i * 4 + 1]) << 16) |
+           (static_cast<uint32>(Data[i * 4 + 2]) << 8) | Data[i * 4 + 3];
+  }
+  for (int32 i = 16; i < 64; i++) {
+    const uint32 S0 = Rotr(W[i - 15], 7) ^ Rotr(W[i - 15], 18) ^ (W[i - 15] >> 3);
+    const uint32 S1 = Rotr(W[i - 2], 17) ^ Rotr(W[i - 2], 19) ^ (W[i - 2] >> 10);
+    W[i] = S1 + W[i - 7] + S0 + W[i - 16];
+  }
+  uint32 A = State[0], B = State[1], C = State[2], D = State[3], E = State[4], F = State[5],
+         G = State[6], H = State[7];
+  for (int32 i = 0; i < 64; i++) {
+    const uint32 T1 =
+        H + (Rotr(E, 6) ^ Rotr(E, 11) ^ Rotr(E, 25)) + ((E & F) ^ (~E & G)) + K[i] + W[i];
+    const uint32 T2 = (Rotr(A, 2) ^ Rotr(A, 13) ^ Rotr(A, 22)) + ((A & B) ^ (A & C) ^ (B & C));
+    H = G;
+    G = F;
+    F = E;
+    E = D + T1;
+    D = C;
+    C = B;
+    B = A;
+    A = T1 + T2;
+  }
+  State[0] += A;
+  State[1] += B;
+  State[2] += C;
+  State[3] += D;
+  State[4] += E;
+  State[5] += F;
+  State[6] += G;
+  State[7] += H;
+}
@@ -3,35 +3,165 @@
 
 #include "GatrixSseConnection.h"
 
+#include "Async/Async.h"
 #include "GatrixClientSDKModule.h"
 
+/**
+ * Receives the response body of one request and parses it as it arrives.
+ * On UE 5.3+ the HTTP module writes into it from the HTTP thread (Serialize);
+ * on older engines the connection feeds it from OnRequestProgress. Nothing is
+ * kept beyond the parser's bounded buffers. Detach() on the game thread cuts
+ * it off from the connection before the connection goes away.
+ */
+class FGatrixSseBodySink final : public FArchive {
+public:
+  using FEventHandler = TFunction<void(const FGatrixJson::FStreamingEvent& Event)>;
+
+  explicit FGatrixSseBodySink(int32 MaxEventBytes) : Parser(MaxEventBytes) { SetIsSaving(true); }
+
+  /** Set before the sink is handed to the request */
+  void SetHandler(FEventHandler InHandler) { Handler = MoveTemp(InHandler); }
+
+  virtual void Serialize(void* V, int64 Length) override {
+    Write(static_cast<const uint8*>(V), Length);
+  }
+
+  void Write(const uint8* Bytes, int64 Num) {
+    FScopeLock Lock(&CriticalSection);
+    if (bDetached || !Handler || Num <= 0) {
+      return;
+    }
+    BytesWritten += Num;
+    Parser.Feed(Bytes, static_cast<int32>(Num),
+                [this](FAnsiStringView EventType, FAnsiStringView EventData) {
+                  // One UTF-8 -> TCHAR conversion and one JSON parse per event
+                  FUTF8ToTCHAR TypeConv(EventType.GetData(), EventType.Len());
+                  FUTF8ToTCHAR DataConv(EventData.GetData(), EventData.Len());
+                  Handler(FGatrixJson::ParseStreamingEvent(
+                      FString(TypeConv.Length(), TypeConv.Get()),
+                      FString(DataConv.Length(), DataConv.Get())));
+                });
+  }
+
+  void Detach() {
+    FScopeLock Lock(&CriticalSection);
+    bDetached = true;
+  }
+
+  bool IsDetached() const {
+    FScopeLock Lock(&CriticalSection);
+    return bDetached;
+  }
+
+  int64 GetBytesWritten() const {
+    FScopeLock Lock(&CriticalSection);
+    return BytesWritten;
+  }
+
+  int32 GetBufferedBytes() const {
+    FScopeLock Lock(&CriticalSection);
+    return Parser.GetBufferedBytes();
+  }
+
+  int32 GetDroppedEventCount() const {
+    FScopeLock Lock(&CriticalSection);
+    return Parser.GetDroppedEventCount();
+  }
+
+  FString GetLastEventId() const {
+    FScopeLock Lock(&CriticalSection);
+    return Parser.GetLastEventId();
+  }
+
+private:
+  mutable FCriticalSection CriticalSection;
+  FGatrixSseParser Parser;
+  FEventHandler Handler;
+  int64 BytesWritten = 0;
+  bool bDetached = false;
+};
+
 FGatrixSseConnection::FGatrixSseConnection() {}
 
 FGatrixSseConnection::~FGatrixSseConnection() {
   Disconnect();
 }
 
-void FGatrixSseConnection::Connect(const FString& Url, const TMap<FString, FString>& Headers) {
+void FGatrixSseConnection::Connect(const FString& Url, const TMap<FString, FString>& Headers,
+                                   const FGatrixSseConnectionLimits& InLimits) {
   // Disconnect any existing connection
   Disconnect();
 
   bDisconnecting = false;
+  ConnectUrl = Url;
+  ConnectHeaders = Headers;
+  Limits = InLimits;
+
+  UE_LOG(LogGatrix, Log, TEXT("SSE: Connecting to %s"), *Url);
+  OpenRequest();
+}
+
+void FGatrixSseConnection::Disconnect() {
+  bDisconnecting = true;
+  bConnected = false;
+  bRecycling = false;
+  bRecyclePending = false;
+  CloseRequest();
+}
+
+int64 FGatrixSseConnection::GetResidentBytes() const {
+  if (!BodySink.IsValid()) {
+    return 0;
+  }
+#if GATRIX_SSE_STREAMED_BODY
+  return BodySink->GetBufferedBytes();
+#else
+  // The response keeps every byte received on this request
+  return BodySink->GetBufferedBytes() + ProcessedBytes;
+#endif
+}
+
+void FGatrixSseConnection::OpenRequest() {
   ProcessedBytes = 0;
-  ReceiveBuffer.Empty();
-  CurrentEventType.Empty();
-  CurrentEventData.Empty();
+  ReportedDrops = 0;
+  bConnected = false;
+
+  // Events parsed on the HTTP thread hop to the game thread; a sink detached
+  // in the meantime belongs to a closed request and its events are dropped
+  BodySink = MakeShared<FGatrixSseBodySink>(Limits.MaxEventBytes);
+  TWeakPtr<FGatrixSseBodySink> WeakSink = BodySink;
+  BodySink->SetHandler([this, WeakSink](const FGatrixJson::FStreamingEvent& Event) {
+    if (IsInGameThread()) {
+      OnEvent.ExecuteIfBound(Event);
+      return;
+    }
+    AsyncTask(ENamedThreads::GameThread, [this, WeakSink, Event]() {
+      TSharedPtr<FGatrixSseBodySink> Sink = WeakSink.Pin();
+      if (Sink.IsValid() && !Sink->IsDetached()) {
+        OnEvent.ExecuteIfBound(Event);
+      }
+    });
+  });
 
   // Create HTTP request for SSE streaming
   ActiveRequest = FHttpModule::Get().CreateRequest();
-  ActiveRequest->SetURL(Url);
+  ActiveRequest->SetURL(ConnectUrl);
   ActiveRequest->SetVerb(TEXT("GET"));
   ActiveRequest->SetHeader(TEXT("Accept"), TEXT("text/event-stream"));
   ActiveRequest->SetHeader(TEXT("Cache-Control"), TEXT("no-cache"));
 
   // Apply custom headers
-  for (const auto& Header : Headers) {
+  for (const auto& Header : ConnectHeaders) {
     ActiveRequest->SetHeader(Header.Key, Header.Value);
   }
+  if (!LastEventId.IsEmpty()) {
+    ActiveRequest->SetHeader(TEXT("Last-Event-ID"), LastEventId);
+  }
+
+#if GATRIX_SSE_STREAMED_BODY
+  // Body bytes go straight to the parser and are never accumulated
+  ActiveRequest->SetResponseBodyReceiveStream(BodySink.ToSharedRef());
+#endif
 
   // Bind progress callback for real-time data reception
   ActiveRequest->OnRequestProgress().BindRaw(this, &FGatrixSseConnection::HandleRequestProgress);
@@ -40,66 +170,112 @@ void FGatrixSseConnection::Connect(const FString& Url, const TMap<FString, FStri
   ActiveRequest->OnProcessRequestComplete().BindRaw(this,
                                                     &FGatrixSseConnection::HandleRequestComplete);
 
-  UE_LOG(LogGatrix, Log, TEXT("SSE: Connecting to %s"), *Url);
   ActiveRequest->ProcessRequest();
 }
 
-void FGatrixSseConnection::Disconnect() {
-  bDisconnecting = true;
-  bConnected = false;
+void FGatrixSseConnection::CloseRequest() {
+  if (BodySink.IsValid()) {
+    BodySink->Detach();
+    BodySink.Reset();
+  }
 
   if (ActiveRequest.IsValid()) {
+    ActiveRequest->OnRequestProgress().Unbind();
+    ActiveRequest->OnProcessRequestComplete().Unbind();
     ActiveRequest->CancelRequest();
     ActiveRequest.Reset();
   }
 
-  ReceiveBuffer.Empty();
   ProcessedBytes = 0;
-  CurrentEventType.Empty();
-  CurrentEventData.Empty();
 }
 
 void FGatrixSseConnection::HandleRequestProgress(FHttpRequestPtr Request, int32 BytesSent,
                                                  int32 BytesReceived) {
-  if (bDisconnecting || !Request.IsValid()) {
+  if (bDisconnecting || !Request.IsValid() || Request != ActiveRequest || !BodySink.IsValid()) {
     return;
   }
 
-  // Get the response content received so far
+#if GATRIX_SSE_STREAMED_BODY
+  const int64 Received = BodySink->GetBytesWritten();
+  if (Received <= ProcessedBytes) {
+    return;
+  }
+#else
+  // Get the response content received so far and parse only the new bytes
   const TArray<uint8>& Content = Request->GetResponse()->GetContent();
-  if (Content.Num() <= ProcessedBytes) {
+  const int64 Received = Content.Num();
+  if (Received <= ProcessedBytes) {
     return;
   }
+  BodySink->Write(Content.GetData() + ProcessedBytes, Received - ProcessedBytes);
+#endif
+  UE_LOG(LogGatrix, Verbose, TEXT("SSE: Received %lld new bytes (total processed=%lld)"),
+         Received - ProcessedBytes, Received);
+  ProcessedBytes = Received;
 
-  // Mark as connected on first data reception
+  // Mark as connected on first data reception; a recycled stream stays quiet
   if (!bConnected) {
     bConnected = true;
-    OnConnected.ExecuteIfBound();
-  }
-
-  // Extract only the new bytes since last progress callback
-  const int32 NewBytes = Content.Num() - ProcessedBytes;
-  FString NewData;
-  // Convert UTF-8 bytes to FString
-  FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Content.GetData() + ProcessedBytes),
-                         NewBytes);
-  NewData = FString(Converter.Length(), Converter.Get());
-  ProcessedBytes = Content.Num();
-
-  // Append to buffer and parse SSE events
-  UE_LOG(LogGatrix, Log, TEXT("SSE: Received %d new bytes (total processed=%d)"), NewBytes,
-         ProcessedBytes);
-  ReceiveBuffer += NewData;
-  ParseSseBuffer();
+    ConnectedAt = FPlatformTime::Seconds();
+    if (bRecycling) {
+      bRecycling = false;
+      OnRecycled.ExecuteIfBound();
+    } else {
+      OnConnected.ExecuteIfBound();
+    }
+  }
+
+  const int32 Drops = BodySink->GetDroppedEventCount();
+  if (Drops != ReportedDrops) {
+    ReportedDrops = Drops;
+    UE_LOG(LogGatrix, Warning, TEXT("SSE: Dropped oversized event (%d so far)"), ReportedDrops);
+    OnError.ExecuteIfBound(TEXT("SSE event exceeded MaxEventSize and was dropped"));
+  }
+
+  MaybeRecycle();
+}
+
+void FGatrixSseConnection::MaybeRecycle() {
+  if (bRecyclePending) {
+    return;
+  }
+
+  const double Age = FPlatformTime::Seconds() - ConnectedAt;
+  const bool bTooOld = Limits.MaxConnectionAge > 0.0f && Age >= Limits.MaxConnectionAge;
+  const bool bTooBig = Limits.MaxConnectionBytes > 0 && ProcessedBytes >= Limits.MaxConnectionBytes;
+  if (!(bTooOld || bTooBig) || BodySink->GetBufferedBytes() > 0) {
+    // Under the limits, or mid-event: the next chunk completes it
+    return;
+  }
+
+  UE_LOG(LogGatrix, Log, TEXT("SSE: Recycling connection after %lld bytes / %.0fs"),
+         ProcessedBytes, Age);
+
+  // Not from inside this request's own progress callback; the detached sink
+  // tells the deferred task that the connection was closed meanwhile
+  bRecyclePending = true;
+  TWeakPtr<FGatrixSseBodySink> WeakSink = BodySink;
+  AsyncTask(ENamedThreads::GameThread, [this, WeakSink]() {
+    TSharedPtr<FGatrixSseBodySink> Sink = WeakSink.Pin();
+    if (!Sink.IsValid() || Sink->IsDetached()) {
+      return;
+    }
+    bRecyclePending = false;
+    LastEventId = Sink->GetLastEventId();
+    CloseRequest();
+    bRecycling = true;
+    OpenRequest();
+  });
 }
 
 void FGatrixSseConnection::HandleRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response,
                                                  bool bWasSuccessful) {
-  if (bDisconnecting) {
+  if (bDisconnecting || Request != ActiveRequest) {
     return;
   }
 
   bConnected = false;
+  bRecycling = false;
 
   if (!bWasSuccessful) {
     const FString ErrorMsg =
@@ -114,57 +290,3 @@ void FGatrixSseConnection::HandleRequestComplete(FHttpRequestPtr Request, FHttpR
   // Stream ended (server closed or network error)
   OnDisconnected.ExecuteIfBound();
 }
-
-void FGatrixSseConnection::ParseSseBuffer() {
-  // SSE protocol: events are separated by empty lines (\n\n)
-  // Each event can have:
-  //   event: <type>
-  //   data: <payload>
-  //   id: <id> (ignored)
-  //   retry: <ms> (ignored)
-  //   : <comment> (ignored)
-
-  int32 LineStart = 0;
-  while (LineStart < ReceiveBuffer.Len()) {
-    // Find next newline
-    int32 NewlinePos = ReceiveBuffer.Find(TEXT("\n"), ESearchCase::CaseSensitive,
-                                          ESearchDir::FromStart, LineStart);
-    if (NewlinePos == INDEX_NONE) {
-      // No complete line yet, keep remaining in buffer
-      break;
-    }
-
-    // Extract the line (strip \r if present)
-    FString Line = ReceiveBuffer.Mid(LineStart, NewlinePos - LineStart).TrimEnd();
-    LineStart = NewlinePos + 1;
-
-    if (Line.IsEmpty()) {
-      // Empty line = dispatch event
-      if (!CurrentEventType.IsEmpty() || !CurrentEventData.IsEmpty()) {
-        FString EventType = CurrentEventType.IsEmpty() ? TEXT("message") : CurrentEventType;
-        UE_LOG(LogGatrix, Log, TEXT("SSE: Dispatching event type='%s' data='%s'"), *EventType,
-               *CurrentEventData.Left(200));
-        OnEvent.ExecuteIfBound(EventType, CurrentEventData);
-        CurrentEventType.Empty();
-        CurrentEventData.Empty();
-      }
-      continue;
-    }
-
-    // Parse SSE field
-    if (Line.StartsWith(TEXT("event:"))) {
-      CurrentEventType = Line.Mid(6).TrimStart();
-    } else if (Line.StartsWith(TEXT("data:"))) {
-      if (!CurrentEventData.IsEmpty()) {
-        CurrentEventData += TEXT("\n");
-      }
-      CurrentEventData += Line.Mid(5).TrimStart();
-    }
-    // Ignore 'id:', 'retry:', and comment lines starting with ':'
-  }
-
-  // Remove processed data from buffer
-  if (LineStart > 0) {
-    ReceiveBuffer = ReceiveBuffer.Mid(LineStart);
-  }
-}
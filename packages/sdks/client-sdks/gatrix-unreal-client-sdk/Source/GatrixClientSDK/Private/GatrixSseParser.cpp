@@ -0,0 +1,154 @@
+// Copyright Gatrix. All Rights Reserved.
+// Zero-copy, bounded text/event-stream parser implementation
+
+#include "GatrixSseParser.h"
+
+#include <cstring>
+
+FGatrixSseParser::FGatrixSseParser(int32 InMaxEventBytes) : MaxEventBytes(InMaxEventBytes) {}
+
+void FGatrixSseParser::Reset() {
+  // Keep allocations; they are bounded by MaxEventBytes
+  Carry.Reset();
+  Type.Reset();
+  Data.Reset();
+  bHasData = false;
+  bDiscarding = false;
+  bSkippingLine = false;
+  bAtStreamStart = true;
+}
+
+void FGatrixSseParser::Feed(const uint8* Bytes, int32 Num, FEventCallback OnEvent) {
+  const ANSICHAR* P = reinterpret_cast<const ANSICHAR*>(Bytes);
+  const ANSICHAR* End = P + Num;
+
+  while (P < End) {
+    const ANSICHAR* Newline = static_cast<const ANSICHAR*>(memchr(P, '\n', End - P));
+    if (!Newline) {
+      // Incomplete line: carry it to the next chunk, unless it alone breaks the limit
+      const int32 Rest = static_cast<int32>(End - P);
+      if (bSkippingLine || Carry.Num() + Rest > MaxEventBytes) {
+        Carry.Reset();
+        bSkippingLine = true;
+        bDiscarding = true;
+        bAtStreamStart = false;
+      } else {
+        Carry.Append(P, Rest);
+      }
+      break;
+    }
+
+    if (bSkippingLine) {
+      // Tail of an oversized line; the event it belonged to is already dropped
+      bSkippingLine = false;
+      P = Newline + 1;
+      continue;
+    }
+
+    if (Carry.Num() + static_cast<int32>(Newline - P) > MaxEventBytes) {
+      // Oversized line that arrived whole: dropped exactly as if it had been split
+      Carry.Reset();
+      bDiscarding = true;
+      bAtStreamStart = false;
+      P = Newline + 1;
+      continue;
+    }
+
+    FAnsiStringView Line;
+    if (Carry.Num() == 0) {
+      Line = FAnsiStringView(P, static_cast<int32>(Newline - P));
+    } else {
+      Carry.Append(P, static_cast<int32>(Newline - P));
+      Line = FAnsiStringView(Carry.GetData(), Carry.Num());
+    }
+    if (Line.Len() > 0 && Line[Line.Len() - 1] == '\r') {
+      Line.RemoveSuffix(1);
+    }
+    if (bAtStreamStart) {
+      // Optional UTF-8 BOM at the very start of the stream
+      if (Line.Len() >= 3 && FMemory::Memcmp(Line.GetData(), "\xEF\xBB\xBF", 3) == 0) {
+        Line.RemovePrefix(3);
+      }
+      bAtStreamStart = false;
+    }
+
+    ProcessLine(Line, OnEvent);
+    Carry.Reset();
+    P = Newline + 1;
+  }
+}
+
+void FGatrixSseParser::ProcessLine(FAnsiStringView Line, FEventCallback OnEvent) {
+  if (Line.Len() == 0) {
+    Dispatch(OnEvent);
+    return;
+  }
+  if (bDiscarding || Line[0] == ':') {
+    return; // oversized event being skipped, or a comment
+  }
+
+  FAnsiStringView Field = Line;
+  FAnsiStringView Value;
+  int32 Colon = INDEX_NONE;
+  if (Line.FindChar(':', Colon)) {
+    Field = Line.Left(Colon);
+    Value = Line.RightChop(Colon + 1);
+    if (Value.Len() > 0 && Value[0] == ' ') {
+      Value.RemovePrefix(1);
+    }
+  }
+
+  if (Field == "data") {
+    const int32 Needed = Data.Num() + (bHasData ? 1 : 0) + Value.Len() + Type.Num();
+    if (Needed > MaxEventBytes) {
+      bDiscarding = true;
+      Data.Reset();
+      Type.Reset();
+      bHasData = false;
+      return;
+    }
+    if (bHasData) {
+      Data.Add('\n');
+    }
+    Data.Append(Value.GetData(), Value.Len());
+    bHasData = true;
+  } else if (Field == "event") {
+    Type.Reset();
+    Type.Append(Value.GetData(), Value.Len());
+  } else if (Field == "id") {
+    int32 NulIndex = INDEX_NONE;
+    if (!Value.FindChar('\0', NulIndex)) {
+      FUTF8ToTCHAR Converter(Value.GetData(), Value.Len());
+      LastEventId = FString(Converter.Length(), Converter.Get());
+    }
+  } else if (Field == "retry") {
+    if (Value.Len() > 9) {
+      return; // would overflow; no sane reconnect delay is this long
+    }
+    int32 Ms = 0;
+    for (ANSICHAR C : Value) {
+      if (C < '0' || C > '9') {
+        return;
+      }
+      Ms = Ms * 10 + (C - '0');
+    }
+    if (Value.Len() > 0) {
+      RetryMs = Ms;
+    }
+  }
+  // Unknown fields are ignored
+}
+
+void FGatrixSseParser::Dispatch(FEventCallback OnEvent) {
+  if (bDiscarding) {
+    DroppedEvents++;
+  } else if (bHasData || Type.Num() > 0) {
+    const FAnsiStringView EventType =
+        Type.Num() > 0 ? FAnsiStringView(Type.GetData(), Type.Num()) : FAnsiStringView("message");
+    OnEvent(EventType, FAnsiStringView(Data.GetData(), Data.Num()));
+  }
+  Type.Reset();
+  Data.Reset();
+  bHasData = false;
+  bDiscarding = false;
+}
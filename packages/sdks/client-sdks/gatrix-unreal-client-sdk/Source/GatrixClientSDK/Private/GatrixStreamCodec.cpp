@@ -0,0 +1,126 @@
+// Copyright Gatrix. All Rights Reserved.
+// Binary WebSocket streaming frame decoding
+
+#include "GatrixStreamCodec.h"
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+const TCHAR* FGatrixStreamCodec::BinaryProtocol = TEXT("gatrix.stream.bin.v1");
+const TCHAR* FGatrixStreamCodec::TextProtocol = TEXT("gatrix.stream.json.v1");
+
+namespace {
+
+constexpr uint8 FrameVersion = 1;
+constexpr uint8 FlagUrgent = 0x01;
+constexpr uint8 FlagSpread = 0x02;
+constexpr uint8 FlagBody = 0x04;
+constexpr uint8 FlagResumed = 0x08;
+
+const TCHAR* const TypeNames[] = {TEXT(""), TEXT("connected"), TEXT("flags_changed"),
+                                  TEXT("heartbeat"), TEXT("pong")};
+
+struct FFrameReader {
+  const uint8* P;
+  const uint8* End;
+
+  bool Byte(uint8& Out) {
+    if (P >= End) {
+      return false;
+    }
+    Out = *P++;
+    return true;
+  }
+
+  bool UVarint(uint64& Out) {
+    Out = 0;
+    for (int32 Shift = 0; Shift < 64; Shift += 7) {
+      uint8 B;
+      if (!Byte(B)) {
+        return false;
+      }
+      Out |= static_cast<uint64>(B & 0x7f) << Shift;
+      if ((B & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false; // overlong
+  }
+
+  bool Str(FString& Out) {
+    uint64 Len;
+    if (!UVarint(Len) || Len > static_cast<uint64>(End - P)) {
+      return false;
+    }
+    FUTF8ToTCHAR Conv(reinterpret_cast<const ANSICHAR*>(P), static_cast<int32>(Len));
+    Out = FString(Conv.Length(), Conv.Get());
+    P += Len;
+    return true;
+  }
+};
+
+} // namespace
+
+bool FGatrixStreamCodec::Decode(const uint8* Data, int32 Num,
+                                FGatrixJson::FStreamingEvent& OutEvent) {
+  FFrameReader R{Data, Data + Num};
+
+  uint8 Version, Type, Flags;
+  if (!R.Byte(Version) || Version != FrameVersion || !R.Byte(Type) || !R.Byte(Flags)) {
+    return false;
+  }
+
+  if (Type == 0) {
+    if (!R.Str(OutEvent.Type)) {
+      return false;
+    }
+  } else if (Type < UE_ARRAY_COUNT(TypeNames)) {
+    OutEvent.Type = TypeNames[Type];
+  } else {
+    return false;
+  }
+
+  uint64 Value;
+  if (!R.UVarint(Value)) {
+    return false;
+  }
+  OutEvent.bHasGlobalRevision = true;
+  OutEvent.GlobalRevision = static_cast<int64>(Value);
+
+  uint64 KeyCount;
+  // Every key takes at least one byte, which bounds the reservation
+  if (!R.UVarint(KeyCount) || KeyCount > static_cast<uint64>(R.End - R.P)) {
+    return false;
+  }
+  OutEvent.ChangedKeys.Reset(static_cast<int32>(KeyCount));
+  for (uint64 i = 0; i < KeyCount; i++) {
+    if (!R.Str(OutEvent.ChangedKeys.AddDefaulted_GetRef())) {
+      return false;
+    }
+  }
+
+  OutEvent.bUrgent = (Flags & FlagUrgent) != 0;
+  OutEvent.bResumed = (Flags & FlagResumed) != 0;
+  OutEvent.SpreadWindowMs = -1;
+  if (Flags & FlagSpread) {
+    if (!R.UVarint(Value)) {
+      return false;
+    }
+    OutEvent.SpreadWindowMs = static_cast<int32>(FMath::Min<uint64>(Value, MAX_int32));
+  }
+
+  OutEvent.Body.Reset();
+  if (Flags & FlagBody) {
+    FString BodyJson;
+    if (!R.Str(BodyJson)) {
+      return false;
+    }
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BodyJson);
+    if (!FJsonSerializer::Deserialize(Reader, OutEvent.Body)) {
+      OutEvent.Body.Reset();
+    }
+  }
+  OutEvent.bHasData = true;
+  return true;
+}
@@ -0,0 +1,161 @@
+// Copyright Gatrix. All Rights Reserved.
+// One streaming connection per environment, shared by the feature clients using it
+
+#include "GatrixStreamingHub.h"
+
+#include "Async/Async.h"
+#include "GatrixClientSDKModule.h"
+
+TSharedRef<FGatrixStreamingHub> FGatrixStreamingHub::Acquire(const FString& Key) {
+  check(IsInGameThread());
+  static TMap<FString, TWeakPtr<FGatrixStreamingHub>> Hubs;
+
+  TSharedPtr<FGatrixStreamingHub> Hub = Hubs.FindRef(Key).Pin();
+  if (!Hub.IsValid()) {
+    Hub = MakeShared<FGatrixStreamingHub>();
+    Hubs.Add(Key, Hub);
+  }
+  // Drop the entries of hubs no client holds anymore
+  for (auto It = Hubs.CreateIterator(); It; ++It) {
+    if (!It->Value.IsValid()) {
+      It.RemoveCurrent();
+    }
+  }
+  return Hub.ToSharedRef();
+}
+
+FGatrixStreamingHub::~FGatrixStreamingHub() { Close(); }
+
+template <typename CallbackType, typename... ArgTypes>
+void FGatrixStreamingHub::Dispatch(CallbackType FGatrixStreamingSubscriber::*Callback,
+                                   const ArgTypes&... Args) {
+  // Over a copy of the ids: callbacks may unsubscribe (themselves or others)
+  TArray<int32> Ids;
+  Subscribers.GetKeys(Ids);
+  for (int32 Id : Ids) {
+    if (const FGatrixStreamingSubscriber* Subscriber = Subscribers.Find(Id)) {
+      // Copied so that unsubscribing does not destroy it while it runs
+      CallbackType Function = Subscriber->*Callback;
+      if (Function) {
+        Function(Args...);
+      }
+    }
+  }
+}
+
+template <typename ConnectionType>
+void FGatrixStreamingHub::BindConnection(ConnectionType& Connection) {
+  const int32 Serial = ++ConnectionSerial;
+  TWeakPtr<FGatrixStreamingHub> WeakThis = AsShared();
+
+  // Everything is re-dispatched on the game thread; a closed or replaced
+  // connection's late callbacks see another serial and are dropped
+  auto OnGameThread = [WeakThis, Serial](TFunction<void(FGatrixStreamingHub&)> Callback) {
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Callback = MoveTemp(Callback)]() {
+      TSharedPtr<FGatrixStreamingHub> Hub = WeakThis.Pin();
+      if (Hub.IsValid() && Hub->ConnectionSerial == Serial) {
+        Callback(*Hub);
+      }
+    });
+  };
+
+  Connection.OnConnected.BindLambda(
+      [OnGameThread]() { OnGameThread([](FGatrixStreamingHub& Hub) { Hub.HandleConnected(); }); });
+
+  Connection.OnEvent.BindLambda([OnGameThread](const FGatrixJson::FStreamingEvent& Event) {
+    OnGameThread([Event](FGatrixStreamingHub& Hub) {
+      Hub.Dispatch(&FGatrixStreamingSubscriber::OnEvent, Event);
+    });
+  });
+
+  Connection.OnError.BindLambda([OnGameThread](const FString& ErrorMsg) {
+    OnGameThread([ErrorMsg](FGatrixStreamingHub& Hub) {
+      Hub.Dispatch(&FGatrixStreamingSubscriber::OnError, ErrorMsg);
+    });
+  });
+
+  Connection.OnDisconnected.BindLambda([OnGameThread]() {
+    OnGameThread([](FGatrixStreamingHub& Hub) { Hub.HandleDisconnected(); });
+  });
+}
+
+int32 FGatrixStreamingHub::Subscribe(FGatrixStreamingSubscriber Subscriber) {
+  const int32 Id = NextSubscriberId++;
+  TFunction<void()> OnConnected = Subscriber.OnConnected;
+  Subscribers.Add(Id, MoveTemp(Subscriber));
+
+  // Joined a live connection: start from its state
+  if (bConnected && OnConnected) {
+    UE_LOG(LogGatrix, Log, TEXT("Streaming: Joined shared connection (%d subscribers)"),
+           Subscribers.Num());
+    OnConnected();
+  }
+  return Id;
+}
+
+void FGatrixStreamingHub::Unsubscribe(int32 SubscriberId) {
+  if (Subscribers.Remove(SubscriberId) > 0 && Subscribers.Num() == 0) {
+    Close();
+  }
+}
+
+void FGatrixStreamingHub::ConnectSse(const FString& Url, const TMap<FString, FString>& Headers,
+                                     const FGatrixSseConnectionLimits& Limits) {
+  if (IsOpen()) {
+    return;
+  }
+  SseConnection = MakeUnique<FGatrixSseConnection>();
+  BindConnection(*SseConnection);
+
+  const int32 Serial = ConnectionSerial;
+  TWeakPtr<FGatrixStreamingHub> WeakThis = AsShared();
+  SseConnection->OnRecycled.BindLambda([WeakThis, Serial]() {
+    TSharedPtr<FGatrixStreamingHub> Hub = WeakThis.Pin();
+    if (Hub.IsValid() && Hub->ConnectionSerial == Serial) {
+      Hub->Dispatch(&FGatrixStreamingSubscriber::OnRecycled);
+    }
+  });
+
+  SseConnection->Connect(Url, Headers, Limits);
+}
+
+void FGatrixStreamingHub::ConnectWebSocket(const FString& Url,
+                                           const TMap<FString, FString>& Headers,
+                                           int32 PingIntervalSeconds, bool bBinaryFrames) {
+  if (IsOpen()) {
+    return;
+  }
+  WebSocketConnection = MakeUnique<FGatrixWebSocketConnection>();
+  BindConnection(*WebSocketConnection);
+  WebSocketConnection->Connect(Url, Headers, PingIntervalSeconds, bBinaryFrames);
+}
+
+int64 FGatrixStreamingHub::GetResidentBytes() const {
+  return SseConnection.IsValid() ? SseConnection->GetResidentBytes() : 0;
+}
+
+void FGatrixStreamingHub::Close() {
+  ++ConnectionSerial;
+  bConnected = false;
+
+  if (SseConnection.IsValid()) {
+    SseConnection->Disconnect();
+    SseConnection.Reset();
+  }
+
+  if (WebSocketConnection.IsValid()) {
+    WebSocketConnection->Disconnect();
+    WebSocketConnection.Reset();
+  }
+}
+
+void FGatrixStreamingHub::HandleConnected() {
+  bConnected = true;
+  Dispatch(&FGatrixStreamingSubscriber::OnConnected);
+}
+
+void FGatrixStreamingHub::HandleDisconnected() {
+  // Closed for everyone; whichever subscriber reconnects first opens the next one
+  Close();
+  Dispatch(&FGatrixStreamingSubscriber::OnDisconnected);
+}
@@ -4,6 +4,7 @@
 #include "GatrixWebSocketConnection.h"
 
 #include "GatrixClientSDKModule.h"
+#include "GatrixStreamCodec.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 #include "WebSocketsModule.h"
@@ -15,7 +16,7 @@ FGatrixWebSocketConnection::~FGatrixWebSocketConnection() {
 }
 
 void FGatrixWebSocketConnection::Connect(const FString& Url, const TMap<FString, FString>& Headers,
-                                         int32 PingIntervalSeconds) {
+                                         int32 PingIntervalSeconds, bool bBinaryFrames) {
   // Disconnect any existing connection
   Disconnect();
 
@@ -26,17 +27,25 @@ void FGatrixWebSocketConnection::Connect(const FString& Url, const TMap<FString,
     FModuleManager::Get().LoadModule(TEXT("WebSockets"));
   }
 
-  // Build protocol and header strings for IWebSocket
-  const FString Protocol = TEXT("wss");
+  // Build protocol and header strings for IWebSocket; the binary encoding is
+  // offered first and the server answers with the one it supports
+  TArray<FString> Protocols;
+  if (bBinaryFrames) {
+    Protocols.Add(FGatrixStreamCodec::BinaryProtocol);
+    Protocols.Add(FGatrixStreamCodec::TextProtocol);
+  }
+  Protocols.Add(TEXT("wss"));
   TMap<FString, FString> UpgradeHeaders = Headers;
+  BinaryBuffer.Reset();
 
-  WebSocket = FWebSocketsModule::Get().CreateWebSocket(Url, Protocol, UpgradeHeaders);
+  WebSocket = FWebSocketsModule::Get().CreateWebSocket(Url, Protocols, UpgradeHeaders);
 
   // Bind delegates
   WebSocket->OnConnected().AddRaw(this, &FGatrixWebSocketConnection::HandleConnected);
   WebSocket->OnConnectionError().AddRaw(this, &FGatrixWebSocketConnection::HandleConnectionError);
   WebSocket->OnClosed().AddRaw(this, &FGatrixWebSocketConnection::HandleClosed);
   WebSocket->OnMessage().AddRaw(this, &FGatrixWebSocketConnection::HandleMessage);
+  WebSocket->OnBinaryMessage().AddRaw(this, &FGatrixWebSocketConnection::HandleBinaryMessage);
 
   UE_LOG(LogGatrix, Log, TEXT("WebSocket: Connecting to %s"), *Url);
   WebSocket->Connect();
@@ -117,16 +126,47 @@ void FGatrixWebSocketConnection::HandleMessage(const FString& Message) {
     return;
   }
 
-  // Extract data as JSON string
-  FString EventData;
-  const TSharedPtr<FJsonObject>* DataObject;
-  if (JsonObject->TryGetObjectField(TEXT("data"), DataObject)) {
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&EventData);
-    FJsonSerializer::Serialize(DataObject->ToSharedRef(), Writer);
-    Writer->Close();
+  // Hand on the parsed data object itself; it is not re-serialized
+  TSharedPtr<FJsonObject> DataObject;
+  const TSharedPtr<FJsonObject>* DataField = nullptr;
+  if (JsonObject->TryGetObjectField(TEXT("data"), DataField)) {
+    DataObject = *DataField;
   }
 
-  OnEvent.ExecuteIfBound(EventType, EventData);
+  OnEvent.ExecuteIfBound(FGatrixJson::MakeStreamingEvent(EventType, DataObject));
+}
+
+void FGatrixWebSocketConnection::HandleBinaryMessage(const void* Data, SIZE_T Size,
+                                                     bool bIsLastFragment) {
+  if (bDisconnecting) {
+    return;
+  }
+
+  const uint8* Bytes = static_cast<const uint8*>(Data);
+  if (!bIsLastFragment) {
+    BinaryBuffer.Append(Bytes, static_cast<int32>(Size));
+    return;
+  }
+  if (BinaryBuffer.Num() > 0) {
+    BinaryBuffer.Append(Bytes, static_cast<int32>(Size));
+    Bytes = BinaryBuffer.GetData();
+    Size = BinaryBuffer.Num();
+  }
+
+  FGatrixJson::FStreamingEvent Event;
+  const bool bDecoded = FGatrixStreamCodec::Decode(Bytes, static_cast<int32>(Size), Event);
+  BinaryBuffer.Reset();
+  if (!bDecoded) {
+    UE_LOG(LogGatrix, Warning, TEXT("WebSocket: Failed to decode binary frame (%d bytes)"),
+           static_cast<int32>(Size));
+    return;
+  }
+
+  // Handle pong locally
+  if (Event.Type == TEXT("pong")) {
+    return;
+  }
+  OnEvent.ExecuteIfBound(Event);
 }
 
 void FGatrixWebSocketConnection::StartPingTimer(int32 IntervalSeconds) {
@@ -0,0 +1,155 @@
+// Copyright Gatrix. All Rights Reserved.
+// Automation tests for bulk evaluation: 1k contexts parse into deduplicated slots
+
+#include "GatrixBulkEvaluation.h"
+#include "GatrixJson.h"
+#include "GatrixTypes.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GatrixBulkEvaluationTests {
+
+constexpr int32 ContextCount = 1000;
+constexpr int32 SharedFlagCount = 18;
+
+FString Record(const FString& Name, bool bEnabled, const FString& Variant = FString()) {
+  FString Json = FString::Printf(TEXT("{\"name\":\"%s\",\"enabled\":%s,\"version\":3"), *Name,
+                                 bEnabled ? TEXT("true") : TEXT("false"));
+  if (!Variant.IsEmpty()) {
+    Json += FString::Printf(
+        TEXT(",\"valueType\":\"string\",\"variant\":{\"name\":\"%s\",\"enabled\":true,"
+             "\"value\":\"%s-payload\"}"),
+        *Variant, *Variant);
+  }
+  return Json + TEXT("}");
+}
+
+/**
+ * A response for Count contexts starting at First. Every context gets the 18
+ * shared flags, "half" enabled for even contexts and one of four "ab-test"
+ * variants. The flags array lists each distinct record twice, as a server that
+ * did not deduplicate would; the client has to.
+ */
+FString Response(int32 First, int32 Count) {
+  TArray<FString> Records;
+  for (int32 i = 0; i < SharedFlagCount; ++i) {
+    Records.Add(Record(FString::Printf(TEXT("shared-%02d"), i), i % 2 == 0));
+  }
+  const int32 HalfOn = Records.Add(Record(TEXT("half"), true));
+  const int32 HalfOff = Records.Add(Record(TEXT("half"), false));
+  const int32 FirstVariant = Records.Num();
+  for (int32 v = 0; v < 4; ++v) {
+    Records.Add(Record(TEXT("ab-test"), true, FString::Printf(TEXT("v%d"), v)));
+  }
+  const int32 Distinct = Records.Num();
+  TArray<FString> Wire = Records;
+  Wire.Append(Records);
+
+  TArray<FString> Results;
+  Results.Reserve(Count);
+  for (int32 Slot = First; Slot < First + Count; ++Slot) {
+    // Alternate between the two copies of each record
+    const int32 Copy = (Slot % 2) * Distinct;
+    TArray<FString> Indices;
+    for (int32 i = 0; i < SharedFlagCount; ++i) {
+      Indices.Add(FString::FromInt(Copy + i));
+    }
+    Indices.Add(FString::FromInt(Copy + (Slot % 2 == 0 ? HalfOn : HalfOff)));
+    Indices.Add(FString::FromInt(Copy + FirstVariant + Slot % 4));
+    Results.Add(TEXT("[") + FString::Join(Indices, TEXT(",")) + TEXT("]"));
+  }
+
+  return TEXT("{\"success\":true,\"data\":{\"flags\":[") + FString::Join(Wire, TEXT(",")) +
+         TEXT("],\"results\":[") + FString::Join(Results, TEXT(",")) + TEXT("]}}");
+}
+
+} // namespace GatrixBulkEvaluationTests
+
+using namespace GatrixBulkEvaluationTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixBulkEvaluationParseTest, "Gatrix.BulkEvaluation.Parse1k",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixBulkEvaluationParseTest::RunTest(const FString& Parameters) {
+  FGatrixBulkEvaluation Evaluation;
+  if (!TestTrue(TEXT("parsed"),
+                FGatrixJson::ParseBulkEvaluation(Response(0, ContextCount), ContextCount,
+                                                 Evaluation))) {
+    return false;
+  }
+
+  // 18 shared + 2 "half" + 4 "ab-test": duplicates on the wire are stored once
+  const int32 FlagsPerSlot = SharedFlagCount + 2;
+  TestEqual(TEXT("slots"), Evaluation.GetSlotCount(), ContextCount);
+  TestEqual(TEXT("distinct records"), Evaluation.GetRecordCount(), SharedFlagCount + 6);
+  TestEqual(TEXT("reuse"), Evaluation.GetReuseRatio(),
+            static_cast<float>(ContextCount * FlagsPerSlot) / (SharedFlagCount + 6));
+
+  for (int32 Slot = 0; Slot < ContextCount; ++Slot) {
+    const FGatrixEvaluatedFlag* Variant = Evaluation.Find(Slot, TEXT("ab-test"));
+    if (!Variant || Variant->Variant.Name != FString::Printf(TEXT("v%d"), Slot % 4) ||
+        Evaluation.IsEnabled(Slot, TEXT("half")) != (Slot % 2 == 0) ||
+        !Evaluation.IsEnabled(Slot, TEXT("shared-00")) ||
+        Evaluation.IsEnabled(Slot, TEXT("shared-01"), true)) {
+      AddError(FString::Printf(TEXT("slot %d does not hold its own results"), Slot));
+      return false;
+    }
+  }
+
+  TArray<FGatrixEvaluatedFlag> Flags;
+  Evaluation.GetFlags(ContextCount - 1, Flags);
+  TestEqual(TEXT("flags of a slot"), Flags.Num(), FlagsPerSlot);
+  TestNull(TEXT("unknown flag"), Evaluation.Find(0, TEXT("missing")));
+  TestNull(TEXT("slot out of range"), Evaluation.Find(ContextCount, TEXT("half")));
+
+  // The slot rows are small integers: far below one record per slot-flag result
+  const int64 PerResultBytes = static_cast<int64>(sizeof(FGatrixEvaluatedFlag)) +
+                               Flags[0].Name.GetAllocatedSize();
+  TestTrue(TEXT("resident bytes"), Evaluation.GetResidentBytes() <
+                                       ContextCount * FlagsPerSlot * PerResultBytes / 4);
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixBulkEvaluationBatchTest, "Gatrix.BulkEvaluation.Batches",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixBulkEvaluationBatchTest::RunTest(const FString& Parameters) {
+  // Batches of the default BulkEvaluationBatchSize, appended in order as EvaluateContexts does
+  FGatrixBulkEvaluation Whole;
+  FGatrixJson::ParseBulkEvaluation(Response(0, ContextCount), ContextCount, Whole);
+  FGatrixBulkEvaluation Joined;
+  const int32 BatchSize = FGatrixFeaturesConfig().BulkEvaluationBatchSize;
+  for (int32 First = 0; First < ContextCount; First += BatchSize) {
+    const int32 Count = FMath::Min(BatchSize, ContextCount - First);
+    FGatrixBulkEvaluation Batch;
+    if (!TestTrue(TEXT("batch parsed"),
+                  FGatrixJson::ParseBulkEvaluation(Response(First, Count), Count, Batch))) {
+      return false;
+    }
+    Joined.Append(Batch);
+  }
+
+  TestEqual(TEXT("slots"), Joined.GetSlotCount(), ContextCount);
+  TestEqual(TEXT("records shared across batches"), Joined.GetRecordCount(),
+            Whole.GetRecordCount());
+  for (int32 Slot = 0; Slot < ContextCount; ++Slot) {
+    if (Joined.Find(Slot, TEXT("ab-test")) == nullptr ||
+        Joined.Find(Slot, TEXT("ab-test"))->ContentHash !=
+            Whole.Find(Slot, TEXT("ab-test"))->ContentHash ||
+        Joined.IsEnabled(Slot, TEXT("half")) != Whole.IsEnabled(Slot, TEXT("half"))) {
+      AddError(FString::Printf(TEXT("slot %d differs from the single response"), Slot));
+      return false;
+    }
+  }
+
+  // A response for another number of contexts belongs to another request
+  FGatrixBulkEvaluation Mismatched;
+  TestFalse(TEXT("slot count mismatch"),
+            FGatrixJson::ParseBulkEvaluation(Response(0, 10), 11, Mismatched));
+  return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,147 @@
+// Copyright Gatrix. All Rights Reserved.
+// Automation tests for context transactions: N staged changes apply once, with one fetch
+
+#include "GatrixFeaturesClient.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GatrixContextUpdateTests {
+
+/**
+ * Initialized but not started, so no request is sent. Every context that
+ * reaches ApplyContext with a new hash counts one ContextChangeCount and is
+ * fetched once when the client runs; that count is what these tests check.
+ */
+UGatrixFeaturesClient* NewClient() {
+  FGatrixClientConfig Config;
+  Config.ApiUrl = TEXT("https://edge.test/api/v1");
+  Config.ApiToken = TEXT("token");
+  Config.AppName = TEXT("context-update-test");
+  UGatrixFeaturesClient* Client = NewObject<UGatrixFeaturesClient>();
+  Client->Initialize(Config, nullptr, nullptr, TEXT("context-update-test"));
+  return Client;
+}
+
+} // namespace GatrixContextUpdateTests
+
+using namespace GatrixContextUpdateTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixContextTransactionTest, "Gatrix.ContextUpdate.Transaction",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixContextTransactionTest::RunTest(const FString& Parameters) {
+  UGatrixFeaturesClient* Client = NewClient();
+  int32 Completions = 0;
+  auto OnComplete = [&Completions](bool bSuccess, const FString&) {
+    if (bSuccess) {
+      Completions++;
+    }
+  };
+
+  // Five changes, one of them in a nested transaction
+  const int32 N = 5;
+  Client->BeginContextUpdate();
+  Client->SetContextField(TEXT("level"), TEXT("3"));
+  Client->SetContextField(TEXT("country"), TEXT("JP"));
+  Client->RemoveContextField(TEXT("country"));
+  Client->BeginContextUpdate();
+  Client->SetContextField(TEXT("userId"), TEXT("user-2"));
+  Client->CommitContextUpdate();
+  Client->SetContextField(TEXT("level"), TEXT("4"));
+  TestEqual(TEXT("nothing applied before the outer commit"),
+            Client->GetStats().ContextChangeCount, 0);
+
+  Client->CommitContextUpdate(OnComplete);
+  const FGatrixFeaturesStats Stats = Client->GetStats();
+  TestEqual(TEXT("applied once"), Stats.ContextChangeCount, 1);
+  TestEqual(TEXT("coalesced"), Stats.ContextCoalescedCount, N - 1);
+  TestEqual(TEXT("completed once"), Completions, 1);
+
+  const FGatrixContext Context = Client->GetContext();
+  TestEqual(TEXT("userId"), Context.UserId, FString(TEXT("user-2")));
+  TestEqual(TEXT("level"), Context.Properties.FindRef(TEXT("level")), FString(TEXT("4")));
+  TestFalse(TEXT("country removed"), Context.Properties.Contains(TEXT("country")));
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixContextTransactionUpdateTest,
+                                 "Gatrix.ContextUpdate.UpdateContextInTransaction",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixContextTransactionUpdateTest::RunTest(const FString& Parameters) {
+  UGatrixFeaturesClient* Client = NewClient();
+  int32 Completions = 0;
+  auto OnComplete = [&Completions](bool bSuccess, const FString&) {
+    if (bSuccess) {
+      Completions++;
+    }
+  };
+
+  // UpdateContext merges into what was staged before it; later fields apply on top
+  FGatrixContext Context;
+  Context.UserId = TEXT("user-3");
+  Context.Properties.Add(TEXT("tier"), TEXT("gold"));
+
+  Client->BeginContextUpdate();
+  Client->SetContextField(TEXT("level"), TEXT("7"));
+  Client->UpdateContext(Context, OnComplete);
+  Client->SetContextField(TEXT("country"), TEXT("US"));
+  TestEqual(TEXT("waits for the commit"), Completions, 0);
+  Client->CommitContextUpdate(OnComplete);
+
+  const FGatrixFeaturesStats Stats = Client->GetStats();
+  TestEqual(TEXT("applied once"), Stats.ContextChangeCount, 1);
+  TestEqual(TEXT("coalesced"), Stats.ContextCoalescedCount, 2);
+  TestEqual(TEXT("both waiters completed"), Completions, 2);
+
+  const FGatrixContext Applied = Client->GetContext();
+  TestEqual(TEXT("userId"), Applied.UserId, FString(TEXT("user-3")));
+  TestEqual(TEXT("tier"), Applied.Properties.FindRef(TEXT("tier")), FString(TEXT("gold")));
+  TestEqual(TEXT("country"), Applied.Properties.FindRef(TEXT("country")), FString(TEXT("US")));
+  TestEqual(TEXT("level kept"), Applied.Properties.FindRef(TEXT("level")), FString(TEXT("7")));
+
+  // Changes that cancel out apply nothing
+  Client->BeginContextUpdate();
+  Client->SetContextField(TEXT("level"), TEXT("1"));
+  Client->RemoveContextField(TEXT("level"));
+  Client->CommitContextUpdate();
+  TestEqual(TEXT("unchanged context not applied"), Client->GetStats().ContextChangeCount, 1);
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixContextStagedTwiceTest,
+                                 "Gatrix.ContextUpdate.UpdateContextTwiceInTransaction",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixContextStagedTwiceTest::RunTest(const FString& Parameters) {
+  UGatrixFeaturesClient* Client = NewClient();
+  FGatrixContext Identity;
+  Identity.UserId = TEXT("user-4");
+  Identity.SessionId = TEXT("session-4");
+  Identity.Properties.Add(TEXT("tier"), TEXT("gold"));
+  FGatrixContext Progress;
+  Progress.Properties.Add(TEXT("level"), TEXT("9"));
+  Progress.Properties.Add(TEXT("tier"), TEXT("platinum"));
+
+  // The second update sets neither UserId nor SessionId: the staged ones stay
+  Client->BeginContextUpdate();
+  Client->SetContextField(TEXT("country"), TEXT("KR"));
+  Client->UpdateContext(Identity);
+  Client->UpdateContext(Progress);
+  Client->CommitContextUpdate();
+  TestEqual(TEXT("applied once"), Client->GetStats().ContextChangeCount, 1);
+
+  const FGatrixContext Applied = Client->GetContext();
+  TestEqual(TEXT("userId"), Applied.UserId, FString(TEXT("user-4")));
+  TestEqual(TEXT("sessionId"), Applied.SessionId, FString(TEXT("session-4")));
+  TestEqual(TEXT("country"), Applied.Properties.FindRef(TEXT("country")), FString(TEXT("KR")));
+  TestEqual(TEXT("level"), Applied.Properties.FindRef(TEXT("level")), FString(TEXT("9")));
+  TestEqual(TEXT("tier"), Applied.Properties.FindRef(TEXT("tier")), FString(TEXT("platinum")));
+  return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,92 @@
+// Copyright Gatrix. All Rights Reserved.
+// Automation tests for the locally maintained ETag: it equals the one the edge sends
+
+#include "GatrixFlagHash.h"
+#include "GatrixTypes.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GatrixFlagEtagTests {
+
+FGatrixEvaluatedFlag Flag(const FString& Name, int32 Version, bool bEnabled,
+                          const FString& Variant = FString(), bool bVariantEnabled = false) {
+  FGatrixEvaluatedFlag Out;
+  Out.Name = Name;
+  Out.Version = Version;
+  Out.bEnabled = bEnabled;
+  Out.Variant.Name = Variant;
+  Out.Variant.bEnabled = bVariantEnabled;
+  return Out;
+}
+
+/** The cocos2d-x fixture without "a": TMap keys ignore case, so it would replace "A" */
+TMap<FString, FGatrixEvaluatedFlag> Fixture() {
+  TMap<FString, FGatrixEvaluatedFlag> Flags;
+  for (const FGatrixEvaluatedFlag& F :
+       {Flag(TEXT("b-flag"), 3, true, TEXT("blue"), true), Flag(TEXT("B_flag"), 1, false),
+        Flag(TEXT("a1"), 2, true), Flag(TEXT("A"), 7, true, TEXT("off"), false),
+        Flag(TEXT("a.b"), 1, true), Flag(TEXT("Zeta"), 0, true)}) {
+    Flags.Add(F.Name, F);
+  }
+  return Flags;
+}
+
+// EvaluationUtils.generateETag over the edge's localeCompare-sorted list (packages/evaluator)
+const TCHAR* const FixtureEtag =
+    TEXT("\"bfe4a4b45a3f932c68d582d895edefdc2567cefd93e1a9aa2f4dd0cae9a94810\"");
+// Without a1, A at version 8, c added
+const TCHAR* const MergedEtag =
+    TEXT("\"e379fb322f9b2f1908d19c0de2fb9820dc431436df9df41527177c8bfd384414\"");
+
+} // namespace GatrixFlagEtagTests
+
+using namespace GatrixFlagEtagTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixEdgeNameOrderTest, "Gatrix.FlagEtag.NameOrder",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixEdgeNameOrderTest::RunTest(const FString& Parameters) {
+  // node: [...].sort((a, b) => a.localeCompare(b))
+  TArray<FString> Names = {TEXT("b-flag"), TEXT("B_flag"), TEXT("a1"), TEXT("A"), TEXT("a.b"),
+                           TEXT("Zeta")};
+  Names.Sort(FGatrixEdgeNameOrder());
+  TestEqual(TEXT("edge order"), FString::Join(Names, TEXT(",")),
+            FString(TEXT("A,a.b,a1,B_flag,b-flag,Zeta")));
+
+  const FGatrixEdgeNameOrder Less;
+  TestTrue(TEXT("case only breaks ties"), Less(TEXT("Aa"), TEXT("ab")));
+  TestTrue(TEXT("punctuation in collation order"), Less(TEXT("a_b"), TEXT("a-b")));
+  TestTrue(TEXT("punctuation before digits"), Less(TEXT("a-"), TEXT("a0")));
+  TestTrue(TEXT("prefix first"), Less(TEXT("a"), TEXT("a-")));
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixFlagSetEtagTest, "Gatrix.FlagEtag.MatchesEdge",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixFlagSetEtagTest::RunTest(const FString& Parameters) {
+  FGatrixFlagSetEtag Etag;
+  Etag.Reset(Fixture());
+  TestEqual(TEXT("full set"), Etag.ToEtag(TEXT("ctx-1")), FString(FixtureEtag));
+
+  // A merge only re-hashes from the first touched name, and yields the merged set's ETag
+  Etag.Remove(TEXT("a1"));
+  Etag.Put(Flag(TEXT("A"), 8, true, TEXT("off"), false));
+  Etag.Put(Flag(TEXT("c"), 1, true));
+  TestEqual(TEXT("merged set"), Etag.ToEtag(TEXT("ctx-1")), FString(MergedEtag));
+
+  FGatrixFlagSetEtag Rebuilt;
+  TMap<FString, FGatrixEvaluatedFlag> Merged = Fixture();
+  Merged.Remove(TEXT("a1"));
+  Merged.Add(TEXT("A"), Flag(TEXT("A"), 8, true, TEXT("off"), false));
+  Merged.Add(TEXT("c"), Flag(TEXT("c"), 1, true));
+  Rebuilt.Reset(Merged);
+  TestEqual(TEXT("incremental equals rebuilt"), Etag.ToEtag(TEXT("ctx-2")),
+            Rebuilt.ToEtag(TEXT("ctx-2")));
+  return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,144 @@
+// Copyright Gatrix. All Rights Reserved.
+// Automation tests for the fleet spread of post-invalidation fetches and the poll scheduler
+
+#include "GatrixInvalidationCoalescer.h"
+#include "GatrixPollingScheduler.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GatrixInvalidationSpreadTests {
+
+// Upper 0.1% point of chi-squared with 99 degrees of freedom
+constexpr double Chi2Df99P001 = 148.23;
+
+/** Fetches per slot when every session receives the same event at t=0 */
+TArray<int32> FleetHistogram(const TArray<FString>& Sessions, int32 WindowMs, int32 Slots) {
+  TArray<int32> PerSlot;
+  PerSlot.Init(0, Slots);
+  for (const FString& Session : Sessions) {
+    const int32 Delay = FGatrixInvalidationCoalescer::SpreadDelayMs(Session, WindowMs);
+    PerSlot[static_cast<int64>(Delay) * Slots / WindowMs]++;
+  }
+  return PerSlot;
+}
+
+/** Pearson's chi-squared statistic against a uniform distribution */
+double ChiSquared(const TArray<int32>& Observed, double Total) {
+  const double Expected = Total / Observed.Num();
+  double Chi = 0.0;
+  for (int32 Count : Observed) {
+    Chi += (Count - Expected) * (Count - Expected) / Expected;
+  }
+  return Chi;
+}
+
+/** Deterministic GUID-like session IDs */
+TArray<FString> GuidSessions(int32 Count, uint32 Seed) {
+  FRandomStream Rng(Seed);
+  TArray<FString> Sessions;
+  for (int32 I = 0; I < Count; I++) {
+    const FGuid Guid(Rng.GetUnsignedInt(), Rng.GetUnsignedInt(), Rng.GetUnsignedInt(),
+                     Rng.GetUnsignedInt());
+    Sessions.Add(Guid.ToString(EGuidFormats::DigitsWithHyphensLower));
+  }
+  return Sessions;
+}
+
+} // namespace GatrixInvalidationSpreadTests
+
+using namespace GatrixInvalidationSpreadTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixInvalidationSpreadDistributionTest,
+                                 "Gatrix.InvalidationSpread.Distribution",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixInvalidationSpreadDistributionTest::RunTest(const FString& Parameters) {
+  TestEqual(TEXT("disabled"), FGatrixInvalidationCoalescer::SpreadDelayMs(TEXT("s"), 0), 0);
+
+  // SpreadDelayMs is a pure function of the session ID: the same fleet spreads the same way
+  const int32 Fleet = 100000;
+  TArray<FString> Sequential;
+  for (int32 I = 0; I < Fleet; I++) {
+    Sequential.Add(FString::Printf(TEXT("session-%d"), I));
+  }
+  for (int32 Count : FleetHistogram(Sequential, 10000, 10)) {
+    TestTrue(TEXT("per second"), Count >= 9500 && Count <= 10500);
+  }
+  TestTrue(TEXT("sequential chi2"),
+           ChiSquared(FleetHistogram(Sequential, 10000, 100), Fleet) < Chi2Df99P001);
+
+  const TArray<FString> Guids = GuidSessions(Fleet, 0x5EED);
+  for (int32 WindowMs : {1000, 5000, 30000}) {
+    const TArray<int32> PerSlot = FleetHistogram(Guids, WindowMs, 100);
+    TestTrue(TEXT("guid chi2"), ChiSquared(PerSlot, Fleet) < Chi2Df99P001);
+    TestTrue(TEXT("peak slot"), FMath::Max(PerSlot) <= Fleet / 100 * 12 / 10);
+  }
+
+  for (int32 I = 0; I < 1000; I++) {
+    const int32 Delay = FGatrixInvalidationCoalescer::SpreadDelayMs(Guids[I], 10000);
+    TestTrue(TEXT("range"), Delay >= 0 && Delay < 10000);
+    TestEqual(TEXT("stable"), FGatrixInvalidationCoalescer::SpreadDelayMs(Guids[I], 10000), Delay);
+  }
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixPollingSchedulerModesTest, "Gatrix.PollingScheduler.Modes",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixPollingSchedulerModesTest::RunTest(const FString& Parameters) {
+  FGatrixPollingScheduler Scheduler;
+  Scheduler.Configure(30.0f, 300.0f, 3, 60.0f);
+  TestTrue(TEXT("normal"), Scheduler.GetMode(0.0) == EGatrixPollingMode::Normal);
+
+  Scheduler.SetStreamingEnabled(true);
+  TestTrue(TEXT("degraded"), Scheduler.GetMode(0.0) == EGatrixPollingMode::Degraded);
+  for (int32 I = 0; I < 200; I++) {
+    const float Delay = Scheduler.NextDelay(0, 1.0f, 60.0f, 0.0);
+    TestTrue(TEXT("degraded delay"), Delay >= 27.0f && Delay <= 33.0f);
+  }
+
+  Scheduler.OnStreamingState(true, 0.0);
+  TestTrue(TEXT("healthy"), Scheduler.GetMode(0.0) == EGatrixPollingMode::Healthy);
+  for (int32 I = 0; I < 200; I++) {
+    const float Delay = Scheduler.NextDelay(0, 1.0f, 60.0f, 0.0);
+    TestTrue(TEXT("healthy delay"), Delay >= 270.0f && Delay <= 330.0f);
+  }
+
+  // Ten drops within the flap window: the backoff reaches the safety interval
+  for (int32 I = 0; I < 10; I++) {
+    Scheduler.OnStreamingState(false, I);
+    Scheduler.OnStreamingState(true, I);
+  }
+  TestTrue(TEXT("flapping"), Scheduler.GetMode(10.0) == EGatrixPollingMode::Flapping);
+  for (int32 I = 0; I < 200; I++) {
+    const float Delay = Scheduler.NextDelay(0, 1.0f, 60.0f, 10.0);
+    TestTrue(TEXT("flapping delay"), Delay >= 150.0f && Delay <= 300.0f);
+  }
+  TestTrue(TEXT("recovered"), Scheduler.GetMode(71.0) == EGatrixPollingMode::Healthy);
+
+  // A server hint replaces the healthy safety interval, shorter or longer
+  Scheduler.SetServerInterval(60.0f);
+  for (int32 I = 0; I < 200; I++) {
+    const float Delay = Scheduler.NextDelay(0, 1.0f, 60.0f, 71.0);
+    TestTrue(TEXT("hinted healthy delay"), Delay >= 54.0f && Delay <= 66.0f);
+  }
+  Scheduler.SetServerInterval(600.0f);
+  for (int32 I = 0; I < 200; I++) {
+    const float Delay = Scheduler.NextDelay(0, 1.0f, 60.0f, 71.0);
+    TestTrue(TEXT("long hinted healthy delay"), Delay >= 540.0f && Delay <= 660.0f);
+  }
+  Scheduler.SetServerInterval(0.0f);
+
+  // Failures back off on their own; Retry-After is a floor for the next poll only
+  TestEqual(TEXT("backoff"), Scheduler.NextDelay(4, 2.0f, 60.0f, 0.0), 16.0f);
+  TestEqual(TEXT("backoff cap"), Scheduler.NextDelay(10, 2.0f, 60.0f, 0.0), 60.0f);
+  Scheduler.SetRetryAfter(900.0f, 0.0);
+  TestEqual(TEXT("retry after"), Scheduler.NextDelay(2, 1.0f, 60.0f, 100.0), 800.0f);
+  TestEqual(TEXT("retry after once"), Scheduler.NextDelay(2, 1.0f, 60.0f, 100.0), 2.0f);
+  return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,155 @@
+// Copyright Gatrix. All Rights Reserved.
+// Automation tests for FGatrixSseParser: chunking independence and bounded buffering
+
+#include "GatrixSseParser.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GatrixSseParserTests {
+
+/** splitmix64, so failures reproduce from the seed on every platform */
+struct FRng {
+  uint64 State;
+  explicit FRng(uint64 Seed) : State(Seed) {}
+  uint64 Next() {
+    uint64 Z = (State += 0x9E3779B97F4A7C15ULL);
+    Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+    return Z ^ (Z >> 31);
+  }
+  int32 Below(int32 N) { return N <= 0 ? 0 : static_cast<int32>(Next() % N); }
+};
+
+/** Events and end state as one comparable string; chunk sizes cycle, none feeds all at once */
+FString Transcript(const TArray<uint8>& Input, int32 MaxEventBytes, const TArray<int32>& Chunks,
+                   int32* OutPeakBuffered = nullptr) {
+  FGatrixSseParser Parser(MaxEventBytes);
+  FString Out;
+  auto OnEvent = [&Out](FAnsiStringView Type, FAnsiStringView Data) {
+    Out += FString::Printf(TEXT("event %s|%s\n"), *FString(Type), *FString(Data));
+  };
+  int32 Peak = 0;
+  int32 Pos = 0;
+  for (int32 I = 0; Pos < Input.Num(); I++) {
+    int32 N = Chunks.Num() > 0 ? Chunks[I % Chunks.Num()] : Input.Num();
+    N = FMath::Min(N, Input.Num() - Pos);
+    Parser.Feed(Input.GetData() + Pos, N, OnEvent);
+    Pos += N;
+    Peak = FMath::Max(Peak, Parser.GetBufferedBytes());
+  }
+  if (OutPeakBuffered) {
+    *OutPeakBuffered = Peak;
+  }
+  Out += FString::Printf(TEXT("id %s retry %d dropped %d"), *Parser.GetLastEventId(),
+                         Parser.GetRetryMs(), Parser.GetDroppedEventCount());
+  return Out;
+}
+
+TArray<uint8> Bytes(const ANSICHAR* Text, int32 Len) {
+  return TArray<uint8>(reinterpret_cast<const uint8*>(Text), Len);
+}
+
+void Append(TArray<uint8>& Out, const ANSICHAR* Text) {
+  Out.Append(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+}
+
+TArray<int32> RandomChunks(FRng& Rng, int32 MaxChunk) {
+  TArray<int32> Chunks;
+  for (int32 I = 0; I < 64; I++) {
+    Chunks.Add(1 + Rng.Below(MaxChunk));
+  }
+  return Chunks;
+}
+
+/** Bytes biased towards SSE syntax so that random input reaches every branch */
+TArray<uint8> Noise(FRng& Rng, int32 Len) {
+  static const ANSICHAR* Pieces[] = {"data", "event", "id", "retry", ":",  ": ", " ", "\n",
+                                     "\r\n", "\r",    "\n\n", "x",   "123", "\xEF\xBB\xBF", "yy"};
+  TArray<uint8> Out;
+  while (Out.Num() < Len) {
+    Append(Out, Pieces[Rng.Below(UE_ARRAY_COUNT(Pieces))]);
+  }
+  return Out;
+}
+
+} // namespace GatrixSseParserTests
+
+using namespace GatrixSseParserTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixSseParserStreamTest, "Gatrix.SseParser.Stream",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixSseParserStreamTest::RunTest(const FString& Parameters) {
+  const ANSICHAR Stream[] = "\xEF\xBB\xBF"
+                            "event: connected\r\ndata: {}\r\n\r\n"
+                            ": heartbeat\n\n"
+                            "id: 41\nevent: flags_changed\ndata: {\"revision\":41}\n\n"
+                            "retry: 3000\nretry: 99999999999999999999\n"
+                            "data:one\ndata:  two\n\n"
+                            "event: flags_changed\ndata: {\"revision\":42";
+  const TArray<uint8> Input = Bytes(Stream, UE_ARRAY_COUNT(Stream) - 1);
+  const FString Expected = TEXT("event connected|{}\n"
+                                "event flags_changed|{\"revision\":41}\n"
+                                "event message|one\n two\n"
+                                "id 41 retry 3000 dropped 0");
+
+  TestEqual(TEXT("whole"), Transcript(Input, FGatrixSseParser::DefaultMaxEventBytes, {}),
+            Expected);
+  TestEqual(TEXT("byte by byte"),
+            Transcript(Input, FGatrixSseParser::DefaultMaxEventBytes, {1}), Expected);
+  FRng Rng(0x55E);
+  for (int32 Round = 0; Round < 200; Round++) {
+    TestEqual(TEXT("random chunks"),
+              Transcript(Input, FGatrixSseParser::DefaultMaxEventBytes, RandomChunks(Rng, 16)),
+              Expected);
+  }
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixSseParserOversizedTest, "Gatrix.SseParser.Oversized",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixSseParserOversizedTest::RunTest(const FString& Parameters) {
+  TArray<uint8> Long;
+  Long.Init('z', 100);
+  TArray<uint8> Input;
+  Append(Input, "data: a\n\ndata: ");
+  Input.Append(Long);
+  Append(Input, "\n\n: ");
+  Input.Append(Long);
+  Append(Input, "\ndata: comment too long\n\ndata: b\n\n");
+  const FString Expected = TEXT("event message|a\nevent message|b\nid  retry -1 dropped 2");
+
+  // The oversized lines drop their events wherever the chunk boundaries fall
+  for (int32 Split = 1; Split < Input.Num(); Split++) {
+    TestEqual(TEXT("split"), Transcript(Input, 32, {Split, Input.Num()}), Expected);
+  }
+  TestEqual(TEXT("whole"), Transcript(Input, 32, {}), Expected);
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixSseParserNoiseTest, "Gatrix.SseParser.Noise",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixSseParserNoiseTest::RunTest(const FString& Parameters) {
+  FRng Rng(7);
+  for (int32 Round = 0; Round < 2000; Round++) {
+    const int32 MaxEventBytes = 1 + Rng.Below(48);
+    const TArray<uint8> Input = Noise(Rng, Rng.Below(400));
+    const FString Whole = Transcript(Input, MaxEventBytes, {});
+    int32 Peak = 0;
+    TestEqual(TEXT("random chunks"),
+              Transcript(Input, MaxEventBytes, RandomChunks(Rng, 24), &Peak), Whole);
+    // Carry, pending data and event type are each capped at MaxEventBytes
+    TestTrue(TEXT("bounded"), Peak <= 3 * MaxEventBytes);
+    TestEqual(TEXT("byte by byte"), Transcript(Input, MaxEventBytes, {1}, &Peak), Whole);
+    TestTrue(TEXT("bounded"), Peak <= 3 * MaxEventBytes);
+  }
+  return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
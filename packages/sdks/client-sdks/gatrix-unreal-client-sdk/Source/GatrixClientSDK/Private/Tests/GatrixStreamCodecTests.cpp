@@ -0,0 +1,202 @@
+// Copyright Gatrix. All Rights Reserved.
+// Automation tests for FGatrixStreamCodec: round trips, wire vectors, malformed frames
+
+#include "GatrixStreamCodec.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GatrixStreamCodecTests {
+
+/** What a server puts on the wire; type 0 carries the name */
+struct FFrame {
+  uint8 Type = 2;
+  FString Name;
+  uint64 GlobalRevision = 0;
+  TArray<FString> ChangedKeys;
+  bool bUrgent = false;
+  bool bResumed = false;
+  int64 SpreadWindowMs = -1;
+  FString Body; // empty: not sent
+};
+
+void PutUVarint(TArray<uint8>& Out, uint64 Value) {
+  do {
+    const uint8 B = Value & 0x7f;
+    Value >>= 7;
+    Out.Add(Value ? (B | 0x80) : B);
+  } while (Value);
+}
+
+void PutStr(TArray<uint8>& Out, const FString& S) {
+  FTCHARToUTF8 Utf8(*S);
+  PutUVarint(Out, Utf8.Length());
+  Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+TArray<uint8> Encode(const FFrame& F) {
+  TArray<uint8> Out;
+  Out.Add(1);
+  Out.Add(F.Type);
+  Out.Add((F.bUrgent ? 1 : 0) | (F.SpreadWindowMs >= 0 ? 2 : 0) | (F.Body.IsEmpty() ? 0 : 4) |
+          (F.bResumed ? 8 : 0));
+  if (F.Type == 0) {
+    PutStr(Out, F.Name);
+  }
+  PutUVarint(Out, F.GlobalRevision);
+  PutUVarint(Out, F.ChangedKeys.Num());
+  for (const FString& Key : F.ChangedKeys) {
+    PutStr(Out, Key);
+  }
+  if (F.SpreadWindowMs >= 0) {
+    PutUVarint(Out, static_cast<uint64>(F.SpreadWindowMs));
+  }
+  if (!F.Body.IsEmpty()) {
+    PutStr(Out, F.Body);
+  }
+  return Out;
+}
+
+FString RandomKey(FRandomStream& Rng) {
+  FString Key;
+  const int32 Len = Rng.RandRange(0, 16);
+  for (int32 I = 0; I < Len; I++) {
+    // ASCII plus a few multi-byte code points
+    const int32 Pick = Rng.RandRange(0, 40);
+    Key.AppendChar(Pick < 36 ? TEXT("abcdefghijklmnopqrstuvwxyz0123456789")[Pick]
+                             : TEXT("-_.\x00E9\xAC00")[Pick - 36]);
+  }
+  return Key;
+}
+
+FFrame RandomFrame(FRandomStream& Rng) {
+  static const uint64 Edges[] = {0, 1, 127, 128, 16383, 16384, MAX_int32, 1ULL << 35, MAX_int64};
+  FFrame F;
+  F.Type = static_cast<uint8>(Rng.RandRange(0, 4));
+  if (F.Type == 0) {
+    F.Name = RandomKey(Rng);
+  }
+  F.GlobalRevision = Edges[Rng.RandRange(0, UE_ARRAY_COUNT(Edges) - 1)];
+  const int32 Keys = Rng.RandRange(0, 3) == 0 ? Rng.RandRange(0, 200) : Rng.RandRange(0, 4);
+  for (int32 I = 0; I < Keys; I++) {
+    F.ChangedKeys.Add(RandomKey(Rng));
+  }
+  F.bUrgent = Rng.RandRange(0, 1) != 0;
+  F.bResumed = Rng.RandRange(0, 1) != 0;
+  if (Rng.RandRange(0, 1)) {
+    F.SpreadWindowMs = static_cast<int64>(Edges[Rng.RandRange(0, UE_ARRAY_COUNT(Edges) - 1)]);
+  }
+  if (Rng.RandRange(0, 1)) {
+    F.Body = FString::Printf(TEXT("{\"revision\":%d,\"key\":\"%s\"}"), Rng.RandRange(0, 1000),
+                             *RandomKey(Rng));
+  }
+  return F;
+}
+
+} // namespace GatrixStreamCodecTests
+
+using namespace GatrixStreamCodecTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixStreamCodecRoundTripTest, "Gatrix.StreamCodec.RoundTrip",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixStreamCodecRoundTripTest::RunTest(const FString& Parameters) {
+  static const TCHAR* TypeNames[] = {TEXT(""), TEXT("connected"), TEXT("flags_changed"),
+                                     TEXT("heartbeat"), TEXT("pong")};
+
+  // flags_changed, revision 300 (0xAC 0x02), keys "a" and "bc", urgent
+  const uint8 Vector[] = {1, 2, 1, 0xAC, 0x02, 2, 1, 'a', 2, 'b', 'c'};
+  FGatrixJson::FStreamingEvent Event;
+  TestTrue(TEXT("vector"), FGatrixStreamCodec::Decode(Vector, UE_ARRAY_COUNT(Vector), Event));
+  TestEqual(TEXT("vector type"), Event.Type, FString(TEXT("flags_changed")));
+  TestEqual(TEXT("vector revision"), Event.GlobalRevision, static_cast<int64>(300));
+  TestEqual(TEXT("vector keys"), Event.ChangedKeys, TArray<FString>{TEXT("a"), TEXT("bc")});
+  TestTrue(TEXT("vector flags"), Event.bUrgent && !Event.bResumed && !Event.Body.IsValid());
+
+  FRandomStream Rng(0xC0DEC);
+  for (int32 Round = 0; Round < 5000; Round++) {
+    const FFrame F = RandomFrame(Rng);
+    const TArray<uint8> Wire = Encode(F);
+    FGatrixJson::FStreamingEvent D;
+    if (!FGatrixStreamCodec::Decode(Wire.GetData(), Wire.Num(), D)) {
+      AddError(FString::Printf(TEXT("round trip %d rejected"), Round));
+      continue;
+    }
+    TestEqual(TEXT("type"), D.Type, F.Type == 0 ? F.Name : FString(TypeNames[F.Type]));
+    TestEqual(TEXT("revision"), D.GlobalRevision, static_cast<int64>(F.GlobalRevision));
+    TestEqual(TEXT("keys"), D.ChangedKeys, F.ChangedKeys);
+    TestEqual(TEXT("urgent"), D.bUrgent, F.bUrgent);
+    TestEqual(TEXT("resumed"), D.bResumed, F.bResumed);
+    TestEqual(TEXT("spread"), static_cast<int64>(D.SpreadWindowMs),
+              FMath::Min<int64>(F.SpreadWindowMs, MAX_int32));
+    TestEqual(TEXT("body"), D.Body.IsValid(), !F.Body.IsEmpty());
+    if (D.Body.IsValid()) {
+      TestEqual(TEXT("body key"), D.Body->GetStringField(TEXT("key")),
+                F.Body.Mid(F.Body.Find(TEXT("\"key\":\"")) + 7).LeftChop(2));
+    }
+  }
+  return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGatrixStreamCodecMalformedTest, "Gatrix.StreamCodec.Malformed",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                     EAutomationTestFlags::EngineFilter)
+
+bool FGatrixStreamCodecMalformedTest::RunTest(const FString& Parameters) {
+  // Every strict prefix of a valid frame is missing a field its header promised
+  FRandomStream Rng(7);
+  for (int32 Round = 0; Round < 500; Round++) {
+    const TArray<uint8> Wire = Encode(RandomFrame(Rng));
+    for (int32 Len = 0; Len < Wire.Num(); Len++) {
+      const TArray<uint8> Prefix(Wire.GetData(), Len);
+      FGatrixJson::FStreamingEvent D;
+      if (FGatrixStreamCodec::Decode(Prefix.GetData(), Prefix.Num(), D)) {
+        AddError(FString::Printf(TEXT("accepted %d of %d bytes"), Len, Wire.Num()));
+        break;
+      }
+    }
+  }
+
+  const TArray<TArray<uint8>> Malformed = {
+      // Version, unknown type
+      {0, 2, 0, 0, 0},
+      {1, 5, 0, 0, 0},
+      // Varint that never ends within 64 bits
+      {1, 2, 0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0},
+      // More keys than bytes; key longer than the frame; name length 2^64-1
+      {1, 2, 0, 0, 3, 0, 0},
+      {1, 2, 0, 0, 1, 5, 'a', 'b'},
+      {1, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01},
+      // Flags announce a spread window or body that is missing or short
+      {1, 2, 2, 0, 0},
+      {1, 2, 4, 0, 0, 3, '{', '}'},
+  };
+  for (const TArray<uint8>& Frame : Malformed) {
+    FGatrixJson::FStreamingEvent D;
+    TestFalse(TEXT("malformed"), FGatrixStreamCodec::Decode(Frame.GetData(), Frame.Num(), D));
+  }
+
+  // Random edits either decode or fail; they never read outside the frame
+  for (int32 Round = 0; Round < 5000; Round++) {
+    TArray<uint8> Wire = Encode(RandomFrame(Rng));
+    for (int32 Edit = Rng.RandRange(1, 4); Edit > 0 && Wire.Num() > 0; Edit--) {
+      const int32 At = Rng.RandRange(0, Wire.Num() - 1);
+      switch (Rng.RandRange(0, 2)) {
+      case 0:
+        Wire[At] = static_cast<uint8>(Rng.RandRange(0, 255));
+        break;
+      case 1:
+        Wire.RemoveAt(At);
+        break;
+      default:
+        Wire.Insert(static_cast<uint8>(Rng.RandRange(0, 255)), At);
+      }
+    }
+    FGatrixJson::FStreamingEvent D;
+    FGatrixStreamCodec::Decode(Wire.GetData(), Wire.Num(), D);
+  }
+  return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
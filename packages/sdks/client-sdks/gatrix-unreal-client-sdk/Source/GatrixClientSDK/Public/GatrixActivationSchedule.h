@@ -0,0 +1,58 @@
+// Copyright Gatrix. All Rights Reserved.
+// Scheduled flag changes waiting for their activation time
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixTypes.h"
+
+/** Flag records the server published ahead of their activation time */
+struct FGatrixScheduledChange {
+  FString Id;                         // stable per scheduled change; a resend replaces it
+  int64 ActivateAtMs = 0;             // server time (epoch ms)
+  int32 JitterMs = 0;                 // window each client spreads its activation over
+  bool bCancelled = false;            // withdraws an earlier change of the same id
+  TArray<FGatrixEvaluatedFlag> Flags; // upserted at activation
+  TArray<FString> Removed;            // deleted at activation
+  int64 DeadlineMs = 0;               // ActivateAtMs plus this client's jitter offset
+  FString ContextHash;                // context the records were evaluated for
+};
+
+/**
+ * Pending scheduled changes, a min-heap on deadline that also replaces or
+ * withdraws entries by id.
+ *
+ * A live-ops event starting at a fixed time is published minutes ahead; each
+ * client holds the records and applies them at the deadline on its own, so
+ * the start of the event causes no fetches at all.
+ *
+ * Game thread only.
+ */
+class GATRIXCLIENTSDK_API FGatrixActivationSchedule {
+public:
+  /** Add a change, replacing a pending one of the same id */
+  void Put(FGatrixScheduledChange Change);
+
+  /** Withdraw a pending change; false if none has the id */
+  bool Cancel(const FString& Id);
+
+  void Reset() { Heap.Reset(); }
+
+  bool IsEmpty() const { return Heap.Num() == 0; }
+  int32 Num() const { return Heap.Num(); }
+
+  /** Earliest deadline (server epoch ms); only meaningful when not empty */
+  int64 GetNextDeadlineMs() const { return Heap.HeapTop().DeadlineMs; }
+
+  /** Remove and return the changes due at ServerNowMs, in deadline order */
+  TArray<FGatrixScheduledChange> TakeDue(int64 ServerNowMs);
+
+private:
+  struct FByDeadline {
+    bool operator()(const FGatrixScheduledChange& A, const FGatrixScheduledChange& B) const {
+      return A.DeadlineMs < B.DeadlineMs;
+    }
+  };
+
+  TArray<FGatrixScheduledChange> Heap;
+};
@@ -0,0 +1,58 @@
+// Copyright Gatrix. All Rights Reserved.
+// Flag results of many contexts, indexed by context slot
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixTypes.h"
+
+/**
+ * Evaluations of many contexts at once (the players of a dedicated server),
+ * as returned by UGatrixFeaturesClient::EvaluateContexts. Slot i holds the
+ * flags of the i-th context. Identical results are stored once: each slot is
+ * a row of record indices, one column per flag name, so a hundred players
+ * who mostly see the same variants cost a hundred small integer rows plus
+ * the distinct records.
+ *
+ * Built on one thread, then read-only; reads are safe from any thread.
+ */
+class GATRIXCLIENTSDK_API FGatrixBulkEvaluation {
+public:
+  /** Store a record unless an identical one is stored; returns its index */
+  int32 AddRecord(const FGatrixEvaluatedFlag& Record);
+
+  /** Start the next slot; returns its index */
+  int32 AddSlot();
+
+  /** Give the last slot a stored record (replacing one of the same flag) */
+  void SetSlotRecord(int32 RecordIndex);
+
+  /** Append another evaluation's slots (a later batch of the same call) */
+  void Append(const FGatrixBulkEvaluation& Other);
+
+  int32 GetSlotCount() const { return Rows.Num(); }
+
+  /** Distinct records held */
+  int32 GetRecordCount() const { return Records.Num(); }
+
+  /** Flag of a slot; nullptr if the slot is out of range or the flag was not evaluated */
+  const FGatrixEvaluatedFlag* Find(int32 Slot, const FString& FlagName) const;
+
+  bool IsEnabled(int32 Slot, const FString& FlagName, bool bDefaultValue = false) const;
+
+  /** Every flag of a slot */
+  void GetFlags(int32 Slot, TArray<FGatrixEvaluatedFlag>& OutFlags) const;
+
+  /** Slot-flag results per distinct record (1 = nothing shared) */
+  float GetReuseRatio() const;
+
+  /** Approximate bytes held by the records and the slot rows */
+  int64 GetResidentBytes() const;
+
+private:
+  TArray<FGatrixEvaluatedFlag> Records;      // distinct records
+  TMap<FGatrixFlagHash, int32> RecordByHash; // content hash -> Records index
+  TMap<FString, int32> Columns;              // flag name -> column
+  TArray<TArray<int32>> Rows; // per slot, record index by column (INDEX_NONE: not evaluated)
+  int64 ResultCount = 0;      // slot-flag results stored
+};
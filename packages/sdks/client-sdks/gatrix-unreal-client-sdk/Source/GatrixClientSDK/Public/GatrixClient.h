@@ -17,6 +17,14 @@
  * FeaturesClient. Thread-safe: internal state protected, HTTP callbacks
  * marshalled to game thread.
  *
+ * Get() is the default client. Independently configured clients (split-screen
+ * players, one per hosted player on a dedicated server, several environments
+ * in a tool) come from Create(); each has its own context, flags and events.
+ * Clients of the same environment (ApiUrl, ApiToken, AppName) share one
+ * streaming connection and the prefetched evaluations; every request goes
+ * through FHttpModule's shared connection pool. Give clients that should not
+ * share persisted flags different Features.CacheKeyPrefix values.
+ *
  * Usage (C++):
  *   FGatrixClientConfig Config;
  *   Config.ApiUrl = TEXT("http://localhost:3400/api/v1");
@@ -37,6 +45,14 @@ public:
             meta = (DisplayName = "Get Gatrix Client"))
   static UGatrixClient* Get();
 
+  /**
+   * Create an independent client, owned by Outer (the transient package if
+   * none). Keep a reference to it (a UPROPERTY) for as long as it is used.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Gatrix",
+            meta = (DisplayName = "Create Gatrix Client"))
+  static UGatrixClient* Create(UObject* Outer = nullptr);
+
   /** Start the SDK with configuration (Blueprint) */
   UFUNCTION(BlueprintCallable, Category = "Gatrix")
   void Start(const FGatrixClientConfig& Config);
@@ -0,0 +1,26 @@
+// Copyright Gatrix. All Rights Reserved.
+// gzip/deflate helpers for compressed fetch and metrics transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * zlib-backed helpers (engine-bundled zlib).
+ * Detection works on magic bytes because some HTTP backends decode
+ * Content-Encoding transparently and others hand back the raw body.
+ */
+struct GATRIXCLIENTSDK_API FGatrixCompression {
+  /** True if the buffer starts with a gzip or zlib (deflate) header */
+  static bool IsCompressed(const TArray<uint8>& Data);
+
+  /** gzip-encode a request body. Returns false on zlib failure. */
+  static bool Gzip(const TArray<uint8>& Input, TArray<uint8>& OutCompressed);
+
+  /**
+   * Inflate a gzip or zlib body in fixed-size chunks (output grows as needed,
+   * the compressed size never has to be trusted up front).
+   * Returns false on corrupt or truncated input.
+   */
+  static bool Inflate(const TArray<uint8>& Input, TArray<uint8>& OutDecompressed);
+};
@@ -3,16 +3,20 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GatrixActivationSchedule.h"
 #include "GatrixEventEmitter.h"
+#include "GatrixFlagDiff.h"
 #include "GatrixJson.h"
 #include "GatrixFlagProxy.h"
 #include "GatrixFlagWatchDelegate.h"
-#include "GatrixSseConnection.h"
+#include "GatrixInterestSet.h"
+#include "GatrixInvalidationCoalescer.h"
+#include "GatrixPollingScheduler.h"
 #include "GatrixStorageProvider.h"
+#include "GatrixStreamingHub.h"
 #include "GatrixTypes.h"
 #include "GatrixVariationProvider.h"
 #include "GatrixWatchFlagGroup.h"
-#include "GatrixWebSocketConnection.h"
 #include "Http.h"
 #include "Runtime/Engine/Public/TimerManager.h"
 #include <atomic>
@@ -37,6 +41,9 @@ class GATRIXCLIENTSDK_API UGatrixFeaturesClient : public UObject, public IGatrix
 public:
   UGatrixFeaturesClient();
 
+  /** Leaves the shared streaming connection if the client was never stopped */
+  virtual void BeginDestroy() override;
+
   /**
    * Initialize the client with config, emitter, and storage.
    * Called by UGatrixClient::Start() during initialization.
@@ -87,6 +94,31 @@ public:
   UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Gatrix|Features")
   bool HasFlag(const FString& FlagName, bool bForceRealtime = true) const;
 
+  // ==================== Change Detection ====================
+
+  /**
+   * Snapshot generation: starts at 0 and advances every time the flags of the
+   * selected snapshot change. Cache values read from the client together with
+   * the generation and re-read them only when it differs.
+   */
+  UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Gatrix|Features")
+  int64 GetGeneration(bool bForceRealtime = true) const;
+
+  /**
+   * Per-flag version: changes whenever the flag does. The flag is tracked from
+   * the first call on; until then it reports the current snapshot generation.
+   */
+  UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Gatrix|Features")
+  int64 GetFlagGeneration(const FString& FlagName, bool bForceRealtime = true) const;
+
+  /**
+   * The per-flag version counter itself (C++ only). Hold on to it and
+   * re-validate with a single atomic load from any thread, with no lock or
+   * lookup.
+   */
+  TSharedRef<const std::atomic<int64>, ESPMode::ThreadSafe>
+  GetFlagGenerationCounter(const FString& FlagName, bool bForceRealtime = true) const;
+
   // ==================== Flag Access - Typed Variations ====================
 
   /** Get variant name (returns the matched variant's name, or fallback) */
@@ -191,6 +223,60 @@ public:
   void UpdateContext(const FGatrixContext& NewContext,
                      TFunction<void(bool, const FString&)> OnComplete);
 
+  /**
+   * Evaluate an anticipated context (next level, upcoming match) ahead of
+   * time. Requests run one at a time and only while no fetch is in flight;
+   * the result is kept in a bounded side cache (PrefetchCacheSize) for up to
+   * PrefetchMaxAge seconds. An UpdateContext to the same context then
+   * publishes it and completes synchronously, without a request. The cache
+   * is shared by the instances of an environment.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Gatrix|Features|Context")
+  void PrefetchContext(const FGatrixContext& Context);
+
+  /**
+   * Set one context field: UserId, SessionId, RemoteAddress, CurrentTime, or
+   * a custom property. Changes are staged: those made in the same frame are
+   * applied together on the next tick (one context hash, one request body,
+   * one fetch), or at CommitContextUpdate inside a transaction.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Gatrix|Features|Context")
+  void SetContextField(const FString& Field, const FString& Value);
+
+  /** Clear a context field or remove a custom property (staged like SetContextField) */
+  UFUNCTION(BlueprintCallable, Category = "Gatrix|Features|Context")
+  void RemoveContextField(const FString& Field);
+
+  /**
+   * Open a context transaction: SetContextField, RemoveContextField and
+   * UpdateContext calls until the matching CommitContextUpdate are applied at
+   * once. Transactions nest; the outermost commit applies. An UpdateContext
+   * inside one merges into the staged context: only the fields it sets
+   * override, so earlier staged fields are kept.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Gatrix|Features|Context")
+  void BeginContextUpdate();
+
+  /** Close a context transaction (Blueprint) */
+  UFUNCTION(BlueprintCallable, Category = "Gatrix|Features|Context")
+  void CommitContextUpdate();
+
+  /** Close a context transaction; OnComplete is called like UpdateContext's (C++ only) */
+  void CommitContextUpdate(TFunction<void(bool, const FString&)> OnComplete);
+
+  using FBulkEvaluationPtr = TSharedPtr<const FGatrixBulkEvaluation, ESPMode::ThreadSafe>;
+
+  /**
+   * Evaluate many contexts in bulk (every player of a dedicated server)
+   * without touching this client's context or flags. Contexts are sent in
+   * batches of BulkEvaluationBatchSize per request, and identical results
+   * come back and are stored once. OnComplete(bSuccess, ErrorMessage,
+   * Evaluation) runs on the game thread; slot i of the evaluation holds the
+   * flags of Contexts[i]. FlagNames restricts evaluation (all flags if empty).
+   */
+  void EvaluateContexts(const TArray<FGatrixContext>& Contexts, const TArray<FString>& FlagNames,
+                        TFunction<void(bool, const FString&, FBulkEvaluationPtr)> OnComplete);
+
   /** Get current context */
   UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Gatrix|Features|Context")
   FGatrixContext GetContext() const;
@@ -397,7 +483,13 @@ private:
   void ApplyBootstrap();
   void DoFetchFlags();
   void HandleFetchResponse(const FString& ResponseBody, int32 HttpStatus,
-                           const FString& EtagHeader);
+                           const FString& EtagHeader,
+                           const FGatrixJson::FFlagsPayload* PreParsed = nullptr);
+  void DecodeFetchResponseAsync(TArray<uint8> Compressed, const FString& EtagHeader);
+  void FinishFetchCycle();
+  float GetCompressionRatio() const;
+  void SetCompressedBody(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& HttpRequest,
+                         const FString& Body);
   void StoreFlags(const TArray<FGatrixEvaluatedFlag>& NewFlags, bool bIsInitialFetch);
   TMap<FString, FGatrixEvaluatedFlag> CopyFlags(bool bForceRealtime) const;
 
@@ -410,7 +502,7 @@ private:
   const FGatrixEvaluatedFlag* FindFlag(const FString& FlagName, bool bForceRealtime,
                                        FGatrixEvaluatedFlag& OutFlag) const;
   void SetReady();
-  void EmitFlagChanges(const TMap<FString, FGatrixEvaluatedFlag>& OldFlags,
+  void EmitFlagChanges(const FGatrixFlagDiff& Diff,
                        const TMap<FString, FGatrixEvaluatedFlag>& NewFlags);
   void TrackImpression(const FString& FlagName, bool bEnabled, const FString& VariantName,
                        const FString& EventType);
@@ -418,30 +510,59 @@ private:
                    const FString& EventType, const FString& VariantName) const;
   void ScheduleNextPoll();
   void StopPolling();
+  void ApplyPollingHints(const FHttpResponsePtr& Response);
   void InvokeWatchCallbacks(const TArray<FWatchCallbackEntry>& CallbackList,
-                            const TMap<FString, FGatrixEvaluatedFlag>& OldFlags,
-                            const TMap<FString, FGatrixEvaluatedFlag>& NewFlags,
-                            bool bForceRealtime, const FString& OldContextHash,
-                            const FString& NewContextHash);
+                            const FGatrixFlagDiff& Diff, bool bForceRealtime);
+  void AdvanceGeneration(const FGatrixFlagDiff& Diff, bool bForceRealtime);
 
   // Metrics
   void StartMetrics();
   void StopMetrics();
   void SendMetrics();
 
-  FString BuildFetchUrl() const;
-  FString BuildContextQueryString() const;
+  FString BuildFetchUrl(const FGatrixContext& Context) const;
+  FString BuildContextQueryString(const FGatrixContext& Context) const;
+
+  // Speculative prefetch
+  void DrainPrefetchQueue();
+  bool TakePrefetched(const FString& ContextHash, TArray<FGatrixEvaluatedFlag>& OutFlags,
+                      FString& OutEtag);
+
+  // Bulk evaluation: one batch of an EvaluateContexts call
+  struct FBulkEvaluationCall;
+  void SendBulkEvaluationBatch(const TSharedRef<FBulkEvaluationCall>& Call, int32 Batch,
+                               TArrayView<const FGatrixContext> Contexts,
+                               const TArray<FString>& FlagNames);
+
+  // Interest set: records a key read at runtime, fetching it if it was new
+  void ObserveInterest(const FString& FlagName) const;
 
   // Streaming
   void ConnectStreaming();
   void DisconnectStreaming();
-  void ProcessStreamingEvent(const FString& EventType, const FString& EventData);
-  void HandleStreamingInvalidation(const TArray<FString>& ChangedKeys);
+  void ProcessStreamingEvent(const FGatrixJson::FStreamingEvent& Event);
+  void HandleStreamingInvalidation(const TArray<FString>& ChangedKeys,
+                                   int32 SpreadWindowHint = -1, bool bUrgent = false);
   void ScheduleStreamingReconnect();
   void FetchPartialFlags(const TArray<FString>& FlagKeys);
   void MergePartialResponse(const FString& ResponseBody, const TSet<FString>& RequestedKeys);
+  void MergeFlags(const TArray<FGatrixEvaluatedFlag>& Upserts, const TSet<FString>& RemovedKeys);
+  void UpdateEtagSource(const FGatrixFlagDiff& Diff);
+  bool ApplyStreamingPayload(const TSharedPtr<FJsonObject>& EventObj, int64 GlobalRevision,
+                             bool bContiguous);
+  void FlushInvalidations();
+  bool CanDeltaSync() const;
+  void ResyncChangedKeys(const TArray<FString>& ChangedKeys);
   void SetStreamingState(EGatrixStreamingConnectionState NewState);
   FString BuildStreamingUrl() const;
+  FString BuildStreamingHubKey() const;
+
+  // Scheduled activations
+  int64 GetServerNowMs() const;
+  void SampleServerClock(const FHttpResponsePtr& Response, double SentSeconds);
+  void EnqueueScheduledChanges(TArray<FGatrixScheduledChange> Changes, bool bReplaceAll);
+  void ScheduleActivationTimer();
+  void ApplyDueActivations();
 
   // ==================== State ====================
 
@@ -453,6 +574,14 @@ private:
   mutable FCriticalSection FlagsCriticalSection;
   TMap<FString, FGatrixEvaluatedFlag> RealtimeFlags;
   TMap<FString, FGatrixEvaluatedFlag> SynchronizedFlags;
+  FGatrixFlagSetEtag RealtimeEtag; // edge ETag of RealtimeFlags, recomputed after merges
+
+  // Change detection: written under FlagsCriticalSection, read without it
+  using FGenerationCounter = TSharedRef<std::atomic<int64>, ESPMode::ThreadSafe>;
+  std::atomic<int64> RealtimeGeneration{0};
+  std::atomic<int64> SyncedGeneration{0};
+  mutable TMap<FString, FGenerationCounter> RealtimeFlagGenerations; // created on request
+  mutable TMap<FString, FGenerationCounter> SyncedFlagGenerations;
 
   // State tracking
   EGatrixSdkState SdkState = EGatrixSdkState::Initializing;
@@ -471,9 +600,27 @@ private:
   FString LastContextHash;
   FString FetchStartContextHash;
   FString FlagsContextHash;
+
+  // Delta sync basis: server revision the realtime snapshot is based on
+  int64 SyncRevision = 0;
+  FString SyncRevisionContextHash;
+  bool bDeltaRequested = false; // in-flight fetch carried since=<revision>
   static FString ComputeContextHash(const FGatrixContext& Context);
-  static FString ComputeEtag(const TMap<FString, FGatrixEvaluatedFlag>& Flags,
-                             const FString& ContextHash);
+
+  // Context changes staged by SetContextField / transactions, applied together
+  void ApplyContext(const FGatrixContext& NewContext,
+                    TFunction<void(bool, const FString&)> OnComplete);
+  FGatrixContext& StageContext();
+  /** Staged changes: only the fields Update sets override; unset ones keep what is staged */
+  static void StageContextFields(FGatrixContext& Staged, const FGatrixContext& Update);
+  void ScheduleContextFlush();
+  void FlushStagedContext();
+  FGatrixContext StagedContext;
+  bool bHasStagedContext = false;
+  int32 StagedChangeCount = 0;
+  int32 ContextUpdateDepth = 0;
+  bool bContextFlushScheduled = false;
+  TArray<TFunction<void(bool, const FString&)>> StagedContextCallbacks;
 
   // Statistics (lock-free via FThreadSafeCounter)
   FThreadSafeCounter FetchFlagsCount;
@@ -483,9 +630,21 @@ private:
   FThreadSafeCounter SyncFlagsCount;
   FThreadSafeCounter ImpressionCount;
   FThreadSafeCounter ContextChangeCount;
+  FThreadSafeCounter ContextCoalescedCount;
   FThreadSafeCounter MetricsSentCount;
   FThreadSafeCounter MetricsErrorCount;
 
+  // Compression statistics (ratio/decode time written on the game thread only)
+  FThreadSafeCounter64 CompressedBytesReceived;
+  FThreadSafeCounter64 DecompressedBytes;
+  FThreadSafeCounter64 RequestBytesRaw;
+  FThreadSafeCounter64 RequestBytesSent;
+  float LastDecodeTimeMs = 0.0f;
+
+  // Delta sync statistics
+  FThreadSafeCounter DeltaFetchCount;
+  FThreadSafeCounter DeltaFallbackCount;
+
   // Metrics tracking (type defined in GatrixJson.h)
   using FFlagMetrics = FGatrixJson::FFlagMetrics;
 
@@ -496,6 +655,7 @@ private:
 
   // Polling timer
   FTimerHandle PollTimerHandle;
+  FGatrixPollingScheduler Polling; // next poll delay from streaming health + server hints
   FTimerHandle MetricsTimerHandle;
 
   // Storage keys
@@ -524,16 +684,76 @@ private:
   int32 NextWatchHandle = 100000; // Start high to avoid collision with EventEmitter handles
 
   // Streaming state
-  TUniquePtr<FGatrixSseConnection> SseConnection;
-  TUniquePtr<FGatrixWebSocketConnection> WebSocketConnection;
+  TSharedPtr<FGatrixStreamingHub> StreamingHub; // shared with same-environment instances
+  int32 StreamingSubscription = 0;
   EGatrixStreamingConnectionState StreamingState = EGatrixStreamingConnectionState::Disconnected;
   int32 StreamingReconnectAttempt = 0;
   int32 StreamingReconnectCount = 0;
   int32 StreamingEventCount = 0;
   int32 StreamingErrorCount = 0;
   int32 StreamingRecoveryCount = 0;
+  int32 StreamingRecycleCount = 0;
   int64 LocalGlobalRevision = 0;
-  TSet<FString> PendingInvalidationKeys;
   bool bStreamingFetching = false;
+  bool bFullFetchQueued = false; // FetchFlags() requested while a partial fetch was in flight
+
+  // Invalidation coalescing (adaptive debounce window)
+  FGatrixInvalidationCoalescer Invalidations;
+  FTimerHandle InvalidationFlushTimerHandle;
+  bool bInvalidationFlushScheduled = false;
+  FThreadSafeCounter InvalidationEventCount;
+  FThreadSafeCounter InvalidationFlushCount;
+  int32 LastCoalesceWindowMs = 0;
+  int32 SpreadWindowMs = 0; // fetch spread window (config default, server hint overrides)
+  int32 LastSpreadDelayMs = 0;
+  FThreadSafeCounter UrgentInvalidationCount;
+
+  // Interest set (keys read from any thread)
+  mutable FGatrixInterestSet Interest;
+  mutable FThreadSafeCounter InterestObservedCount;
+  FThreadSafeCounter InterestDroppedCount;
+
+  // Scheduled activations, and the server clock their deadlines are on: server time at a
+  // FPlatformTime instant (a user changing the device clock does not move it)
+  FGatrixActivationSchedule Activations;
+  FTimerHandle ActivationTimerHandle;
+  int32 ScheduledActivationCount = 0;
+  bool bServerClockSynced = false;
+  int64 ServerClockBaseMs = 0;
+  double ServerClockBaseSeconds = 0.0;
+  double ServerClockRttSeconds = 0.0; // round trip of the sample the base came from
+
+  // Push-with-payload streaming
+  FThreadSafeCounter PushPayloadAppliedCount;
+  FThreadSafeCounter PushPayloadFallbackCount;
+  int64 LastPushLatencyMs = 0;
   FTimerHandle StreamingReconnectTimerHandle;
+
+  // Speculative prefetch: evaluations by context hash (oldest first in Order), shared by
+  // the instances of an environment so a context one of them prefetched is fetched once
+  // and can serve any of them; and this instance's contexts waiting for their request
+  struct FPrefetchedEvaluation {
+    TArray<FGatrixEvaluatedFlag> Flags;
+    FString Etag;
+    double StoredAt = 0.0; // FPlatformTime::Seconds()
+    int64 Bytes = 0;       // response bytes
+  };
+  struct FPrefetchPool {
+    TMap<FString, FPrefetchedEvaluation> Entries;
+    TArray<FString> Order;
+    FThreadSafeCounter Count;
+    FThreadSafeCounter HitCount;
+    FThreadSafeCounter64 Bytes;
+    FThreadSafeCounter64 UsedBytes;
+  };
+  static TSharedRef<FPrefetchPool> AcquirePrefetchPool(const FGatrixClientConfig& Config);
+  TSharedPtr<FPrefetchPool> Prefetched = MakeShared<FPrefetchPool>(); // shared from Initialize
+  TArray<TPair<FString, FGatrixContext>> PrefetchQueue;
+  bool bPrefetchInFlight = false;
+  FTimerHandle PrefetchTimerHandle;
+
+  // Bulk evaluation
+  FThreadSafeCounter BulkEvaluationCount;
+  FThreadSafeCounter BulkContextCount;
+  float LastBulkReuseRatio = 0.0f;
 };
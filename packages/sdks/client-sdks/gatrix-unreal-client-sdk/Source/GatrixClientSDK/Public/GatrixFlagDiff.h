@@ -0,0 +1,28 @@
+// Copyright Gatrix. All Rights Reserved.
+// Content-hash based flag snapshot diffing
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixTypes.h"
+
+/**
+ * Compact result of comparing two flag snapshots.
+ * Only flags that differ are listed; unchanged flags cost one hash compare.
+ */
+struct GATRIXCLIENTSDK_API FGatrixFlagDiff {
+  TArray<FString> Added;
+  TArray<FString> Changed;
+  TArray<FString> Removed;
+
+  bool IsEmpty() const { return Added.Num() == 0 && Changed.Num() == 0 && Removed.Num() == 0; }
+  int32 Num() const { return Added.Num() + Changed.Num() + Removed.Num(); }
+
+  /**
+   * Diff two snapshots by per-flag content hash (computed at parse time).
+   * O(n + m) map lookups with one 128-bit compare per common flag —
+   * variant values are never compared.
+   */
+  static FGatrixFlagDiff Compute(const TMap<FString, FGatrixEvaluatedFlag>& OldFlags,
+                                 const TMap<FString, FGatrixEvaluatedFlag>& NewFlags);
+};
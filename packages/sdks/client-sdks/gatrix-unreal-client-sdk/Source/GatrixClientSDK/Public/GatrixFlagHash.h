@@ -0,0 +1,89 @@
+// Copyright Gatrix. All Rights Reserved.
+// Per-flag content hashes and the edge-compatible set ETag
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixSha256.h"
+
+struct FGatrixEvaluatedFlag;
+
+/**
+ * 128-bit content hash of a single flag record.
+ * Not cryptographic — used for change detection only.
+ */
+struct GATRIXCLIENTSDK_API FGatrixFlagHash {
+  uint64 Hi = 0;
+  uint64 Lo = 0;
+
+  bool IsZero() const { return Hi == 0 && Lo == 0; }
+  bool operator==(const FGatrixFlagHash& Other) const { return Hi == Other.Hi && Lo == Other.Lo; }
+  bool operator!=(const FGatrixFlagHash& Other) const { return !(*this == Other); }
+
+  /** Hash every observable field of a flag record (name, state, variant, type, version). */
+  static FGatrixFlagHash Compute(const FGatrixEvaluatedFlag& Flag);
+
+  /** Usable as a TMap/TSet key (records deduplicated by content) */
+  friend uint32 GetTypeHash(const FGatrixFlagHash& Hash) { return static_cast<uint32>(Hash.Lo); }
+};
+
+/**
+ * Streaming 128-bit hasher (two independent FNV-1a lanes with a murmur-style
+ * finalizer). Strings are length-prefixed so adjacent fields cannot collide.
+ */
+class GATRIXCLIENTSDK_API FGatrixFlagHasher {
+public:
+  FGatrixFlagHasher& Update(const void* Data, int64 Len);
+  FGatrixFlagHasher& Update(const FString& Value);
+  FGatrixFlagHasher& Update(uint64 Value);
+  FGatrixFlagHasher& Update(bool bValue) { return Update(static_cast<uint64>(bValue ? 1 : 0)); }
+
+  FGatrixFlagHash Finish() const;
+
+private:
+  uint64 Lo = 0xcbf29ce484222325ULL;
+  uint64 Hi = 0x6c62272e07bb0142ULL;
+};
+
+/**
+ * Name order of the edge's flag list (String.localeCompare, root collation).
+ * Exact for ASCII names; other characters sort after ASCII.
+ */
+struct GATRIXCLIENTSDK_API FGatrixEdgeNameOrder {
+  bool operator()(const FString& A, const FString& B) const;
+};
+
+/**
+ * The ETag the edge sends for a flag set: quoted sha256 of
+ * "contextHash|name:version:enabled:variant|..." over the names in edge order.
+ * The hash state after each record is kept, so a merge only re-hashes from
+ * the first touched name onward.
+ */
+class GATRIXCLIENTSDK_API FGatrixFlagSetEtag {
+public:
+  /** Adds or replaces a record's segment */
+  void Put(const FGatrixEvaluatedFlag& Flag);
+  void Remove(const FString& Name);
+  void Reset(const TMap<FString, FGatrixEvaluatedFlag>& Flags);
+
+  int32 Num() const { return Entries.Num(); }
+
+  /** Validator for the set evaluated under ContextHash, as the edge would send it */
+  FString ToEtag(const FString& InContextHash);
+
+private:
+  struct FEntry {
+    FString Name;
+    FString Segment;     // name:version:enabled:variant
+    FGatrixSha256 After; // state once this segment is absorbed
+  };
+
+  void InvalidateFrom(int32 Index);
+
+  TArray<FEntry> Entries; // sorted by FGatrixEdgeNameOrder
+  FString ContextHash;
+  FGatrixSha256 Prefix; // ContextHash|
+  bool bPrimed = false;
+  int32 StaleFrom = 0; // first entry whose checkpoint is out of date; INDEX_NONE when none
+  FString CachedEtag;
+};
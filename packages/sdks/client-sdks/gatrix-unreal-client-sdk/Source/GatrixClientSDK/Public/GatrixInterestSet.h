@@ -0,0 +1,69 @@
+// Copyright Gatrix. All Rights Reserved.
+// Flag keys a client reads: declared keys and prefixes plus keys observed at runtime
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The flags a client cares about. Declared entries are exact keys or, with a
+ * trailing '*', prefixes; with observation on, every key read at runtime is
+ * added as well. Fetches send the set so the server can evaluate only those
+ * flags, and streaming invalidations of other keys are dropped before any
+ * request is made.
+ *
+ * On the wire (query parameters):
+ *   interest=<key>,<prefix>*,...  prefixes always, exact keys while there are
+ *                                 at most BloomThreshold of them
+ *   interestBloom=<k>.<base64>    otherwise, exact keys as a bloom filter: bit
+ *                                 (h1 + i * h2) mod m for i < k, where h1 is the
+ *                                 64-bit FNV-1a of the UTF-8 key, h2 = h1 >> 32 | 1
+ *                                 and m is 8 * the byte count; bit j is
+ *                                 byte j / 8, mask 1 << (j % 8)
+ *
+ * Thread-safe: flags are read (and keys observed) from any thread.
+ */
+class GATRIXCLIENTSDK_API FGatrixInterestSet {
+public:
+  void Configure(const TArray<FString>& DeclaredKeys, bool bInTrackObserved,
+                 int32 InBloomThreshold);
+
+  /** Off when nothing was declared and observation is off: every flag is of interest */
+  bool IsEnabled() const { return bEnabled; }
+
+  /** The set only changes by declaration (can be sent once, e.g. on the stream) */
+  bool IsStatic() const { return bEnabled && !bTrackObserved; }
+
+  bool Contains(const FString& Key) const;
+
+  /**
+   * Record a key read at runtime.
+   * @return true if it was not in the set before (its flag has not been fetched)
+   */
+  bool Observe(const FString& Key);
+
+  /**
+   * Keys of a change that are in the set. Empty ChangedKeys ("everything")
+   * are returned as is; otherwise an empty result means nothing of interest changed.
+   */
+  TArray<FString> Intersect(const TArray<FString>& ChangedKeys) const;
+
+  /** Query parameters for the set (without leading '&'); empty when disabled */
+  FString ToQueryString() const;
+
+  int32 Num() const;
+
+  /** Bloom filter hashes per key */
+  static constexpr int32 BloomHashCount = 7;
+
+  /** Bloom filter bits per key (about 1% false positives) */
+  static constexpr int32 BloomBitsPerKey = 10;
+
+private:
+  mutable FCriticalSection CriticalSection;
+  TSet<FString> Keys;       // declared and observed exact keys
+  TArray<FString> Prefixes; // declared prefixes, without the '*'
+  bool bEnabled = false;
+  bool bTrackObserved = false;
+  int32 BloomThreshold = 64;
+};
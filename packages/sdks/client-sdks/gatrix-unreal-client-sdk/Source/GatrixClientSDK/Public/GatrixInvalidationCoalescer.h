@@ -0,0 +1,46 @@
+// Copyright Gatrix. All Rights Reserved.
+// Adaptive debounce window for streaming invalidations
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Gathers streaming invalidations into one batch per debounce window.
+ * Isolated events flush after MinWindowMs; a dense burst (events closer
+ * together than MinWindowMs) stretches the window up to MaxWindowMs so the
+ * whole burst becomes a single fetch. The rate is an exponentially weighted
+ * average of inter-arrival gaps. Game thread only.
+ */
+class GATRIXCLIENTSDK_API FGatrixInvalidationCoalescer {
+public:
+  void Configure(int32 InMinWindowMs, int32 InMaxWindowMs);
+
+  /** Merge changed keys. Empty keys or "*" mean "everything changed". */
+  void Add(const TArray<FString>& Keys, double NowSeconds = FPlatformTime::Seconds());
+
+  /** Debounce window for the next flush, derived from the recent event rate */
+  int32 GetWindowMs() const;
+
+  bool HasPending() const { return bFull || Keys.Num() > 0; }
+
+  /** Drain the batch. A full invalidation is returned as {"*"}. */
+  TArray<FString> Take();
+
+  void Reset();
+
+  /**
+   * Per-client offset in [0, WindowMs) for the follow-up fetch, hashed from a
+   * stable seed (session ID): the fleet's fetches spread evenly over the window
+   * while each client keeps the same offset from one event to the next.
+   */
+  static int32 SpreadDelayMs(const FString& Seed, int32 WindowMs);
+
+private:
+  int32 MinWindowMs = 50;
+  int32 MaxWindowMs = 500;
+  double AvgGapMs = 500.0;
+  double LastEventSeconds = -1.0;
+  TSet<FString> Keys;
+  bool bFull = false;
+};
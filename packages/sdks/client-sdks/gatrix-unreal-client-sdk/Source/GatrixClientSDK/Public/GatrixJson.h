@@ -6,6 +6,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GatrixActivationSchedule.h"
+#include "GatrixBulkEvaluation.h"
 #include "GatrixTypes.h"
 
 /**
@@ -26,6 +28,42 @@ public:
    */
   static bool ParseFlagsResponse(const FString& Json, TArray<FGatrixEvaluatedFlag>& OutFlags);
 
+  /** Flags response body, either a full snapshot or a since=<revision> delta */
+  struct FFlagsPayload {
+    TArray<FGatrixEvaluatedFlag> Flags; // full snapshot, or upserts when bIsDelta
+    TArray<FString> Removed;            // delta only: names deleted since the basis
+    bool bIsDelta = false;
+    int64 Revision = 0; // 0 when the server did not report one
+    TArray<FGatrixScheduledChange> Scheduled; // changes published ahead of activation
+    bool bHasSchedule = false; // the body carried a scheduled list (possibly empty)
+  };
+
+  /**
+   * Parse a flags API response including the optional delta envelope:
+   * { "data": { "delta": true, "revision": N, "flags": [...], "removed": [...] } }
+   * and scheduled changes: "scheduled": [{ "id", "activateAt" (epoch ms), "jitterMs",
+   * "cancelled", "flags": [...], "removed": [...] }] (pushed events carry them too)
+   * @return true if parsing succeeded and success==true
+   */
+  static bool ParseFlagsPayload(const FString& Json, FFlagsPayload& OutPayload);
+
+  /**
+   * Parse inline records from a push-with-payload flags_changed event:
+   * { "globalRevision": N, "changedKeys": [...], "flags": [...], "removed": [...] }
+   * @return true if the event carries a flags array whose records all have a string
+   *         "name" and a boolean "enabled"
+   */
+  static bool ParsePushedFlags(const TSharedPtr<FJsonObject>& EventObj, FFlagsPayload& OutPayload);
+
+  /**
+   * Parse a bulk evaluation response into OutEvaluation (one slot per context):
+   * { "data": { "flags": [distinct records], "results": [[record index, ...], ...] } }
+   * @param ExpectedSlots   Contexts sent; a response with another count is rejected
+   * @return true if parsing succeeded and success==true
+   */
+  static bool ParseBulkEvaluation(const FString& Json, int32 ExpectedSlots,
+                                  FGatrixBulkEvaluation& OutEvaluation);
+
   /**
    * Parse a stored flags JSON string (bare array) into evaluated flags.
    * Used when loading cached flags from local storage.
@@ -48,11 +86,25 @@ public:
 
   /**
    * Serialize an evaluation context to a POST request body.
-   * Output format: { "context": { ... } }
+   * Output format: { "context": { ... }, "flagNames": [...] }
    * @param Config          Client config containing context data
+   * @param FlagNames       Restrict evaluation to these flags (omitted when empty)
    * @return JSON string
    */
-  static FString SerializeContext(const FGatrixClientConfig& Config);
+  static FString SerializeContext(const FGatrixClientConfig& Config,
+                                  const TArray<FString>& FlagNames = TArray<FString>());
+
+  /** Same, for a context other than the configured one (e.g. a prefetched one) */
+  static FString SerializeContext(const FString& AppName, const FGatrixContext& Context,
+                                  const TArray<FString>& FlagNames = TArray<FString>());
+
+  /**
+   * Serialize a bulk evaluation request body.
+   * Output format: { "contexts": [{ ... }, ...], "flagNames": [...] }
+   */
+  static FString SerializeContexts(const FString& AppName,
+                                   TArrayView<const FGatrixContext> Contexts,
+                                   const TArray<FString>& FlagNames = TArray<FString>());
 
   // ==================== Metrics Serialization ====================
 
@@ -80,6 +132,36 @@ public:
                                   const TMap<FString, FFlagMetrics>& FlagBucket,
                                   const TMap<FString, int32>& MissingFlags);
 
+  // ==================== Streaming Events ====================
+
+  /** A streaming event after its single JSON parse; consumers read fields from here */
+  struct FStreamingEvent {
+    FString Type;
+    bool bHasData = false;        // the event carried a (parsable) body
+    TSharedPtr<FJsonObject> Body; // JSON fields, if any (push payload, connectionId)
+    bool bHasGlobalRevision = false;
+    int64 GlobalRevision = 0;
+    TArray<FString> ChangedKeys;
+    int32 SpreadWindowMs = -1; // -1: not sent
+    bool bUrgent = false;
+    bool bResumed = false; // connected: missed events are replayed next
+  };
+
+  /**
+   * Build the event view over an already-parsed body (the WebSocket "data" member).
+   * @param Type            Event type (flags_changed, connected, heartbeat, ...)
+   * @param Body            Event data object, may be null
+   */
+  static FStreamingEvent MakeStreamingEvent(const FString& Type,
+                                            const TSharedPtr<FJsonObject>& Body);
+
+  /**
+   * Parse an SSE event's data field once and build the event view.
+   * @param Type            SSE event: field
+   * @param Data            SSE data: field (JSON object, or empty)
+   */
+  static FStreamingEvent ParseStreamingEvent(const FString& Type, const FString& Data);
+
   // ==================== Value Type Helpers ====================
 
   /**
@@ -103,6 +185,10 @@ private:
    */
   static FGatrixEvaluatedFlag ParseFlag(const TSharedPtr<FJsonObject>& FlagObj);
 
+  /** Parse the optional "scheduled" array of a response data object or a pushed event */
+  static void ParseScheduledChanges(const TSharedPtr<FJsonObject>& Obj,
+                                    FFlagsPayload& OutPayload);
+
   /**
    * Parse a variant value with proper type coercion based on valueType.
    * Handles mismatches between JSON wire type and declared valueType.
@@ -0,0 +1,61 @@
+// Copyright Gatrix. All Rights Reserved.
+// Streaming-aware, server-hinted poll interval selection
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixTypes.h"
+
+/**
+ * Picks the delay of the next background poll.
+ * Streaming connected -> long safety poll; streaming down -> regular poll;
+ * streaming dropping FlapThreshold times within FlapWindow -> exponential
+ * backoff with full jitter. The server can override the base interval
+ * (X-Poll-Interval), which also replaces the healthy safety interval even
+ * when shorter, and push the next poll out (Retry-After). Fetch failures
+ * keep their own exponential backoff. Game thread only.
+ */
+class GATRIXCLIENTSDK_API FGatrixPollingScheduler {
+public:
+  void Configure(float InRefreshInterval, float InSafetyInterval, int32 InFlapThreshold,
+                 float InFlapWindow);
+
+  /** Streaming enabled/disabled. Disabled means Normal mode. */
+  void SetStreamingEnabled(bool bEnabled);
+
+  /** Record a streaming state change; disconnects feed flap detection */
+  void OnStreamingState(bool bConnected, double NowSeconds = FPlatformTime::Seconds());
+
+  /** Server interval hint in seconds (X-Poll-Interval). 0 clears the hint. */
+  void SetServerInterval(float Seconds) { ServerInterval = FMath::Max(0.0f, Seconds); }
+
+  /** Retry-After: the next poll is not scheduled earlier than this */
+  void SetRetryAfter(float Seconds, double NowSeconds = FPlatformTime::Seconds());
+
+  EGatrixPollingMode GetMode(double NowSeconds = FPlatformTime::Seconds()) const;
+
+  /**
+   * Delay in seconds for the next poll. ConsecutiveFailures > 0 uses the
+   * failure backoff (InitialBackoff * 2^(n-1), capped at MaxBackoff).
+   */
+  float NextDelay(int32 ConsecutiveFailures, float InitialBackoff, float MaxBackoff,
+                  double NowSeconds = FPlatformTime::Seconds());
+
+  float GetLastDelay() const { return LastDelay; }
+  float GetServerInterval() const { return ServerInterval; }
+
+private:
+  int32 RecentFlaps(double NowSeconds) const;
+
+  float RefreshInterval = 30.0f;
+  float SafetyInterval = 300.0f;
+  int32 FlapThreshold = 3;
+  float FlapWindow = 60.0f;
+
+  bool bStreamingEnabled = false;
+  bool bConnected = false;
+  TArray<double> Disconnects; // within the flap window
+  float ServerInterval = 0.0f;
+  double RetryAfterUntil = -1.0;
+  float LastDelay = 0.0f;
+};
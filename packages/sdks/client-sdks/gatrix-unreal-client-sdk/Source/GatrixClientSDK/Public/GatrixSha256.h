@@ -0,0 +1,30 @@
+// Copyright Gatrix. All Rights Reserved.
+// Streaming SHA-256 (ETags compatible with the edge)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Streaming SHA-256. The engine core only ships MD5 and SHA-1.
+ * Copyable: a copy is a checkpoint that later input can resume from.
+ */
+class GATRIXCLIENTSDK_API FGatrixSha256 {
+public:
+  FGatrixSha256();
+
+  FGatrixSha256& Update(const void* Data, int64 Len);
+  /** Absorbs the UTF-8 encoding of Value, as the server hashes its strings */
+  FGatrixSha256& Update(const FString& Value);
+
+  /** Lowercase hex digest of everything absorbed so far; the state itself is left as is */
+  FString HexDigest() const;
+
+private:
+  void ProcessBlock(const uint8* Data);
+
+  uint32 State[8];
+  uint8 Buffer[64];
+  int32 BufferLen = 0;
+  uint64 TotalLen = 0;
+};
@@ -4,17 +4,41 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GatrixJson.h"
+#include "GatrixSseParser.h"
 #include "Http.h"
+#include "Misc/EngineVersionComparison.h"
 
-DECLARE_DELEGATE_TwoParams(FGatrixSseEventDelegate, const FString& /*EventType*/,
-                           const FString& /*EventData*/);
+// UE 5.3+ can write the response body into an FArchive instead of accumulating it
+#define GATRIX_SSE_STREAMED_BODY !UE_VERSION_OLDER_THAN(5, 3, 0)
+
+DECLARE_DELEGATE_OneParam(FGatrixSseEventDelegate, const FGatrixJson::FStreamingEvent& /*Event*/);
 DECLARE_DELEGATE(FGatrixSseConnectedDelegate);
 DECLARE_DELEGATE_OneParam(FGatrixSseErrorDelegate, const FString& /*ErrorMessage*/);
 DECLARE_DELEGATE(FGatrixSseDisconnectedDelegate);
+DECLARE_DELEGATE(FGatrixSseRecycledDelegate);
+
+class FGatrixSseBodySink;
+
+/** Memory bounds for one SSE connection */
+struct FGatrixSseConnectionLimits {
+  /** Larger events are dropped instead of buffered */
+  int32 MaxEventBytes = FGatrixSseParser::DefaultMaxEventBytes;
+
+  /** Reopen the stream after this many bytes (0 = never) */
+  int64 MaxConnectionBytes = 0;
+
+  /** Reopen the stream after this many seconds (0 = never) */
+  float MaxConnectionAge = 0.0f;
+};
 
 /**
  * SSE connection manager.
- * Uses FHttpModule OnRequestProgress delegate for real-time chunk reception.
+ * Bytes are parsed as they arrive and then discarded: on UE 5.3+ the response
+ * body is streamed into a sink on the HTTP thread; on older engines new bytes
+ * are read from the response in OnRequestProgress, and the byte limit bounds
+ * what the response accumulates. Past either limit the connection is reopened
+ * at the next event boundary, resuming with Last-Event-ID.
  * All callbacks are invoked on the game thread.
  */
 class GATRIXCLIENTSDK_API FGatrixSseConnection {
@@ -26,8 +50,10 @@ public:
    * Connect to the SSE endpoint.
    * @param Url Full SSE endpoint URL
    * @param Headers HTTP headers to send (X-API-Token, etc.)
+   * @param InLimits Event size and connection recycling limits
    */
-  void Connect(const FString& Url, const TMap<FString, FString>& Headers);
+  void Connect(const FString& Url, const TMap<FString, FString>& Headers,
+               const FGatrixSseConnectionLimits& InLimits = FGatrixSseConnectionLimits());
 
   /** Disconnect and cancel pending request */
   void Disconnect();
@@ -35,13 +61,27 @@ public:
   /** Check if currently connected */
   bool IsConnected() const { return bConnected; }
 
+  /** Bytes held for this stream: parser buffers, plus the response body on older engines */
+  int64 GetResidentBytes() const;
+
   // Delegates
   FGatrixSseEventDelegate OnEvent;
   FGatrixSseConnectedDelegate OnConnected;
   FGatrixSseErrorDelegate OnError;
   FGatrixSseDisconnectedDelegate OnDisconnected;
+  /** The stream was reopened to bound memory; OnConnected is not repeated */
+  FGatrixSseRecycledDelegate OnRecycled;
 
 private:
+  /** Create and start the HTTP request for the current Url/Headers */
+  void OpenRequest();
+
+  /** Cancel the active request without notifying delegates */
+  void CloseRequest();
+
+  /** Reopen the stream if a limit was reached and no event is half-received */
+  void MaybeRecycle();
+
   /** Handle partial data received from HTTP streaming */
   void HandleRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived);
 
@@ -49,25 +89,32 @@ private:
   void HandleRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response,
                              bool bWasSuccessful);
 
-  /** Parse SSE data from buffer and dispatch events */
-  void ParseSseBuffer();
-
   /** Active HTTP request */
   TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> ActiveRequest;
 
-  /** Buffer for accumulating received SSE data */
-  FString ReceiveBuffer;
+  /** Parser for the active request; detached when the request is abandoned */
+  TSharedPtr<FGatrixSseBodySink> BodySink;
+
+  /** Endpoint and headers, kept to reopen the stream */
+  FString ConnectUrl;
+  TMap<FString, FString> ConnectHeaders;
+  FGatrixSseConnectionLimits Limits;
+
+  /** Resume point carried into the next request */
+  FString LastEventId;
 
-  /** Bytes already processed from previous progress callbacks */
-  int32 ProcessedBytes = 0;
+  /** Bytes received on the active request */
+  int64 ProcessedBytes = 0;
 
-  /** Current SSE event type being parsed */
-  FString CurrentEventType;
+  /** Parser drops already reported through OnError */
+  int32 ReportedDrops = 0;
 
-  /** Current SSE data being parsed */
-  FString CurrentEventData;
+  /** When the active request received its first bytes */
+  double ConnectedAt = 0.0;
 
   /** Connection state */
   bool bConnected = false;
   bool bDisconnecting = false;
+  bool bRecycling = false;
+  bool bRecyclePending = false;
 };
@@ -0,0 +1,61 @@
+// Copyright Gatrix. All Rights Reserved.
+// Zero-copy, bounded text/event-stream parser over raw UTF-8 bytes
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Incremental SSE parser fed straight from the HTTP response bytes.
+ *
+ * Lines are located with memchr and passed around as FAnsiStringView: a line
+ * that lies entirely inside the fed chunk is never copied. Only a line split
+ * across chunks is carried over, and only the pending event's data is
+ * buffered; both buffers are reused and bounded by MaxEventBytes. An event
+ * (or single line) larger than that is dropped whole and parsing resumes at
+ * the next blank line. Nothing is converted to TCHAR here - the caller does
+ * that once per dispatched event.
+ */
+class GATRIXCLIENTSDK_API FGatrixSseParser {
+public:
+  /** Views are UTF-8 and only valid for the duration of the callback */
+  using FEventCallback = TFunctionRef<void(FAnsiStringView EventType, FAnsiStringView Data)>;
+
+  static constexpr int32 DefaultMaxEventBytes = 1024 * 1024;
+
+  explicit FGatrixSseParser(int32 InMaxEventBytes = DefaultMaxEventBytes);
+
+  /** Parse the next chunk; complete events are dispatched in order */
+  void Feed(const uint8* Bytes, int32 Num, FEventCallback OnEvent);
+
+  /** Forget any partial line/event (new connection). LastEventId survives. */
+  void Reset();
+
+  /** id of the most recent event that carried one (for Last-Event-ID) */
+  const FString& GetLastEventId() const { return LastEventId; }
+
+  /** Server-requested reconnect delay (retry: field), -1 if none */
+  int32 GetRetryMs() const { return RetryMs; }
+
+  /** Events dropped for exceeding MaxEventBytes */
+  int32 GetDroppedEventCount() const { return DroppedEvents; }
+
+  /** Bytes currently held for partial lines and the pending event */
+  int32 GetBufferedBytes() const { return Carry.Num() + Data.Num() + Type.Num(); }
+
+private:
+  void ProcessLine(FAnsiStringView Line, FEventCallback OnEvent);
+  void Dispatch(FEventCallback OnEvent);
+
+  int32 MaxEventBytes;
+  TArray<ANSICHAR> Carry; // partial line spanning chunk boundaries
+  TArray<ANSICHAR> Type;  // event: field of the pending event
+  TArray<ANSICHAR> Data;  // data: lines of the pending event, LF-joined
+  bool bHasData = false;
+  bool bDiscarding = false;   // pending event exceeded the limit; skip until blank line
+  bool bSkippingLine = false; // inside a line that alone exceeded the limit
+  bool bAtStreamStart = true;
+  FString LastEventId;
+  int32 RetryMs = -1;
+  int32 DroppedEvents = 0;
+};
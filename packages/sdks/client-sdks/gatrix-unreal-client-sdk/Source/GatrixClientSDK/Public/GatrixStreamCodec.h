@@ -0,0 +1,35 @@
+// Copyright Gatrix. All Rights Reserved.
+// Compact binary encoding of WebSocket streaming events
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixJson.h"
+
+/**
+ * Binary streaming frames, negotiated through the WebSocket subprotocol.
+ * Text JSON frames stay valid on every connection, so a server that does not
+ * pick BinaryProtocol keeps working unchanged.
+ *
+ *   frame   := version:u8(=1) type:u8 flags:u8 [name:str if type==0]
+ *              globalRevision:uvarint keyCount:uvarint key:str*
+ *              [spreadWindowMs:uvarint if flags&2] [body:str if flags&4]
+ *   str     := byteLength:uvarint utf8
+ *   type    := 0 named | 1 connected | 2 flags_changed | 3 heartbeat | 4 pong
+ *   flags   := 1 urgent | 2 spreadWindowMs present | 4 body present | 8 resumed
+ *   uvarint := unsigned LEB128
+ *
+ * body carries whatever has no field of its own (push-payload flags/removed,
+ * contextHash, timestamp) as a JSON object.
+ */
+class GATRIXCLIENTSDK_API FGatrixStreamCodec {
+public:
+  static const TCHAR* BinaryProtocol;
+  static const TCHAR* TextProtocol;
+
+  /**
+   * Decode a binary frame into an event view.
+   * @return false on a truncated or unknown frame
+   */
+  static bool Decode(const uint8* Data, int32 Num, FGatrixJson::FStreamingEvent& OutEvent);
+};
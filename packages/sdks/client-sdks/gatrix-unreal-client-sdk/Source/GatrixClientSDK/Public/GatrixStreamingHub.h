@@ -0,0 +1,81 @@
+// Copyright Gatrix. All Rights Reserved.
+// One streaming connection per environment, shared by the feature clients using it
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GatrixJson.h"
+#include "GatrixSseConnection.h"
+#include "GatrixWebSocketConnection.h"
+
+/** Callbacks of one feature client on a shared connection (game thread) */
+struct FGatrixStreamingSubscriber {
+  TFunction<void()> OnConnected;
+  TFunction<void(const FGatrixJson::FStreamingEvent& Event)> OnEvent;
+  TFunction<void(const FString& ErrorMessage)> OnError;
+  TFunction<void()> OnDisconnected;
+  TFunction<void()> OnRecycled;
+};
+
+/**
+ * Streaming connection shared by every UGatrixFeaturesClient in the process
+ * that talks to the same environment (API URL, token, application) with the
+ * same streaming settings. The first subscriber to connect opens it with its
+ * URL and headers; later ones join it, and are told at once if it is already
+ * connected. Events go to every subscriber, each of which tracks its own
+ * revision, context and reconnect backoff. A dropped connection is closed
+ * for all; the first subscriber to reconnect opens the next one. The last
+ * one to unsubscribe closes it. Game thread only.
+ */
+class GATRIXCLIENTSDK_API FGatrixStreamingHub : public TSharedFromThis<FGatrixStreamingHub> {
+public:
+  /** Hub for an environment key, created if no client holds one */
+  static TSharedRef<FGatrixStreamingHub> Acquire(const FString& Key);
+
+  ~FGatrixStreamingHub();
+
+  /** Add a subscriber; returns its id for Unsubscribe */
+  int32 Subscribe(FGatrixStreamingSubscriber Subscriber);
+
+  /** Remove a subscriber, closing the connection with the last */
+  void Unsubscribe(int32 SubscriberId);
+
+  /** Open an SSE connection unless one is already open */
+  void ConnectSse(const FString& Url, const TMap<FString, FString>& Headers,
+                  const FGatrixSseConnectionLimits& Limits);
+
+  /** Open a WebSocket connection unless one is already open */
+  void ConnectWebSocket(const FString& Url, const TMap<FString, FString>& Headers,
+                        int32 PingIntervalSeconds, bool bBinaryFrames);
+
+  /** A connection is open (connecting or connected) */
+  bool IsOpen() const { return SseConnection.IsValid() || WebSocketConnection.IsValid(); }
+
+  bool IsConnected() const { return bConnected; }
+
+  int32 GetSubscriberCount() const { return Subscribers.Num(); }
+
+  /** Bytes held by the SSE stream (0 for WebSocket) */
+  int64 GetResidentBytes() const;
+
+private:
+  /** Close the connection without notifying subscribers */
+  void Close();
+
+  /** Bind the connection's delegates; events of a replaced connection are dropped */
+  template <typename ConnectionType> void BindConnection(ConnectionType& Connection);
+
+  void HandleConnected();
+  void HandleDisconnected();
+
+  /** Invoke one callback of every subscriber */
+  template <typename CallbackType, typename... ArgTypes>
+  void Dispatch(CallbackType FGatrixStreamingSubscriber::*Callback, const ArgTypes&... Args);
+
+  TUniquePtr<FGatrixSseConnection> SseConnection;
+  TUniquePtr<FGatrixWebSocketConnection> WebSocketConnection;
+  TMap<int32, FGatrixStreamingSubscriber> Subscribers;
+  int32 NextSubscriberId = 1;
+  int32 ConnectionSerial = 0;
+  bool bConnected = false;
+};
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GatrixFlagHash.h"
 #include "GatrixVariantSource.h"
 #include "GatrixTypes.generated.h"
 
@@ -77,6 +78,9 @@ struct GATRIXCLIENTSDK_API FGatrixEvaluatedFlag {
 
   UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
   bool bImpressionData = false;
+
+  /** Content hash computed once when the record is parsed (not exposed to Blueprint) */
+  FGatrixFlagHash ContentHash;
 };
 
 /** Evaluation context (global for client-side).
@@ -217,6 +221,20 @@ enum class EGatrixStreamingConnectionState : uint8 {
   Degraded UMETA(DisplayName = "Degraded")
 };
 
+/**
+ * Background polling mode, driven by streaming health.
+ * Normal: no streaming. Healthy: streaming connected, long safety poll only.
+ * Degraded: streaming down, regular poll. Flapping: streaming keeps dropping,
+ * poll backs off with jitter.
+ */
+UENUM(BlueprintType)
+enum class EGatrixPollingMode : uint8 {
+  Normal UMETA(DisplayName = "Normal"),
+  Healthy UMETA(DisplayName = "Healthy"),
+  Degraded UMETA(DisplayName = "Degraded"),
+  Flapping UMETA(DisplayName = "Flapping")
+};
+
 /** SSE streaming configuration */
 USTRUCT(BlueprintType)
 struct GATRIXCLIENTSDK_API FGatrixSseStreamingConfig {
@@ -233,6 +251,18 @@ struct GATRIXCLIENTSDK_API FGatrixSseStreamingConfig {
   /** Reconnect max delay in seconds (default: 30) */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   int32 ReconnectMax = 30;
+
+  /** Events larger than this many bytes are dropped instead of buffered (default: 1 MB) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 MaxEventSize = 1024 * 1024;
+
+  /** Reopen the stream (resuming via Last-Event-ID) after this many bytes; 0 = never */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int64 MaxConnectionBytes = 4 * 1024 * 1024;
+
+  /** Reopen the stream (resuming via Last-Event-ID) after this many seconds; 0 = never */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  float MaxConnectionAge = 3600.0f;
 };
 
 /** WebSocket streaming configuration */
@@ -255,6 +285,10 @@ struct GATRIXCLIENTSDK_API FGatrixWebSocketStreamingConfig {
   /** Client-side ping interval in seconds (default: 30) */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   int32 PingInterval = 30;
+
+  /** Offer compact binary event frames via subprotocol; text JSON stays the fallback */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  bool bBinaryFrames = false;
 };
 
 /** Streaming configuration */
@@ -277,6 +311,13 @@ struct GATRIXCLIENTSDK_API FGatrixStreamingConfig {
   /** WebSocket-specific configuration */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   FGatrixWebSocketStreamingConfig WebSocket;
+
+  /**
+   * Ask the server to inline evaluated records in flags_changed and apply them
+   * without a follow-up fetch; a revision gap still falls back to fetching (opt-in)
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  bool bPushPayload = false;
 };
 
 /** Feature flags configuration */
@@ -304,6 +345,21 @@ struct GATRIXCLIENTSDK_API FGatrixFeaturesConfig {
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   bool bDisableRefresh = false;
 
+  /**
+   * Seconds between safety polls while streaming is connected (default: 300).
+   * A server X-Poll-Interval hint takes its place while one is in effect.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  float StreamingSafetyPollInterval = 300.0f;
+
+  /** Streaming drops within StreamingFlapWindow that make polling back off (default: 3) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 StreamingFlapThreshold = 3;
+
+  /** Window in seconds for counting streaming drops (default: 60) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  float StreamingFlapWindow = 60.0f;
+
   /** Enable explicit sync mode */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   bool bExplicitSyncMode = true;
@@ -328,6 +384,70 @@ struct GATRIXCLIENTSDK_API FGatrixFeaturesConfig {
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   bool bUsePOSTRequests = false;
 
+  /** Advertise gzip/deflate responses and gzip request bodies (opt-in) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  bool bEnableCompression = false;
+
+  /** Request bodies smaller than this are sent uncompressed (default: 1024) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 CompressionMinBytes = 1024;
+
+  /** Send since=<revision> so the server can answer with only added/changed/removed flags */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  bool bEnableDeltaSync = false;
+
+  /** Shortest invalidation debounce window in ms (isolated events) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 InvalidationCoalesceMinMs = 50;
+
+  /** Longest invalidation debounce window in ms (dense bursts) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 InvalidationCoalesceMaxMs = 500;
+
+  /**
+   * Window in ms over which clients spread the fetch that follows a flag change; each
+   * client waits a stable, session-derived offset. 0 disables. A spreadWindowMs hint on
+   * flags_changed overrides it; urgent events skip the delay.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 InvalidationSpreadWindowMs = 0;
+
+  /** Evaluations kept by PrefetchContext until a matching UpdateContext (0 disables) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 PrefetchCacheSize = 4;
+
+  /** Seconds a prefetched evaluation stays usable (default: 120) */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  float PrefetchMaxAge = 120.0f;
+
+  /** Contexts per EvaluateContexts request; larger calls are split into parallel batches */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 BulkEvaluationBatchSize = 256;
+
+  /**
+   * Interest set: flag keys this client reads, a trailing * making a prefix. When
+   * set (or with bTrackObservedKeys), fetches ask for these flags only and streaming
+   * invalidations of other keys are dropped before any request. Empty: all flags.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  TArray<FString> InterestKeys;
+
+  /** Add keys read or watched at runtime to the interest set; each is fetched on first use */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  bool bTrackObservedKeys = false;
+
+  /** Above this many exact interest keys the set is sent as a bloom filter */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  int32 InterestBloomThreshold = 64;
+
+  /**
+   * Accept flag changes published ahead of their activation time and apply them
+   * locally at the deadline (server-corrected time, plus a stable per-client jitter
+   * when the server asks for one), so an event start needs no fetch
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
+  bool bEnableScheduledActivations = false;
+
   /** Initial delay before first metrics send in seconds (default: 2) */
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gatrix")
   float MetricsIntervalInitial = 2.0f;
@@ -410,6 +530,10 @@ struct GATRIXCLIENTSDK_API FGatrixFeaturesStats {
   UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
   int32 ContextChangeCount = 0;
 
+  /** Staged context changes applied together with others (one fetch for all) */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 ContextCoalescedCount = 0;
+
   UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
   int32 MetricsSentCount = 0;
 
@@ -441,6 +565,167 @@ struct GATRIXCLIENTSDK_API FGatrixFeaturesStats {
 
   UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
   int32 StreamingRecoveryCount = 0;
+
+  /** SSE connections reopened on reaching MaxConnectionBytes/MaxConnectionAge */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 StreamingRecycleCount = 0;
+
+  /** Bytes currently held by the SSE connection (parser buffers and response body) */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 StreamingResidentBytes = 0;
+
+  // ==================== Compression Stats ====================
+
+  /** Wire bytes of compressed responses */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 CompressedBytesReceived = 0;
+
+  /** Bytes after inflation */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 DecompressedBytes = 0;
+
+  /** Request bodies before gzip */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 RequestBytesRaw = 0;
+
+  /** Request bodies after gzip */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 RequestBytesSent = 0;
+
+  /** DecompressedBytes / CompressedBytesReceived */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  float CompressionRatio = 0.0f;
+
+  /** Inflate + parse time of the last compressed response */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  float LastDecodeTimeMs = 0.0f;
+
+  // ==================== Delta Sync Stats ====================
+
+  /** Responses applied as a since= patch */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 DeltaFetchCount = 0;
+
+  /** since= requests the server answered with a full snapshot */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 DeltaFallbackCount = 0;
+
+  /** Server revision the realtime snapshot is based on */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 SyncRevision = 0;
+
+  // ==================== Invalidation Coalescing Stats ====================
+
+  /** Streaming invalidations received */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 InvalidationEventCount = 0;
+
+  /** Batched fetches issued for them */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 InvalidationFlushCount = 0;
+
+  /** Debounce window of the most recent batch */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 LastCoalesceWindowMs = 0;
+
+  /** Spread offset added to the most recent batch */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 LastSpreadDelayMs = 0;
+
+  /** Invalidations applied without the spread delay */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 UrgentInvalidationCount = 0;
+
+  // ==================== Interest Set Stats ====================
+
+  /** Keys and prefixes in the interest set (0 when off) */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 InterestKeyCount = 0;
+
+  /** Keys added to it at runtime */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 InterestObservedCount = 0;
+
+  /** Invalidations dropped because none of their keys were of interest */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 InterestDroppedCount = 0;
+
+  // ==================== Scheduled Activation Stats ====================
+
+  /** Scheduled changes waiting for their deadline */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 ScheduledActivationPending = 0;
+
+  /** Scheduled changes applied locally at their deadline */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 ScheduledActivationCount = 0;
+
+  /** Server time minus the local wall clock, in milliseconds */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 ServerClockOffsetMs = 0;
+
+  // ==================== Push Payload Stats ====================
+
+  /** flags_changed records applied without a fetch */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 PushPayloadAppliedCount = 0;
+
+  /** Payload events that fell back to a fetch */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 PushPayloadFallbackCount = 0;
+
+  /** Server publish -> local apply of the last payload, ms */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 LastPushLatencyMs = 0;
+
+  // ==================== Prefetch Stats ====================
+
+  /** Prefetched evaluations received */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 PrefetchCount = 0;
+
+  /** UpdateContext calls completed from a prefetched evaluation */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 PrefetchHitCount = 0;
+
+  /** PrefetchHitCount / PrefetchCount */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  float PrefetchHitRate = 0.0f;
+
+  /** Response bytes of the prefetched evaluations */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 PrefetchBytes = 0;
+
+  /** Of those, evicted or expired without being used */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int64 PrefetchWastedBytes = 0;
+
+  // ==================== Bulk Evaluation Stats ====================
+
+  /** EvaluateContexts calls */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 BulkEvaluationCount = 0;
+
+  /** Contexts evaluated by them */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  int32 BulkContextCount = 0;
+
+  /** Slot-flag results per distinct record in the last call (1 = nothing shared) */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  float BulkReuseRatio = 0.0f;
+
+  // ==================== Polling Stats ====================
+
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  EGatrixPollingMode PollingMode = EGatrixPollingMode::Normal;
+
+  /** Delay of the most recently scheduled poll, seconds */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  float PollingInterval = 0.0f;
+
+  /** X-Poll-Interval hint from the server, 0 if none */
+  UPROPERTY(BlueprintReadOnly, Category = "Gatrix")
+  float ServerPollInterval = 0.0f;
 };
 
 /** Overall SDK statistics */
@@ -498,4 +783,19 @@ struct GATRIXCLIENTSDK_API FGatrixLightStats {
   EGatrixStreamingConnectionState StreamingState = EGatrixStreamingConnectionState::Disconnected;
   int32 StreamingReconnectCount = 0;
   FString LastStreamingEventTime;
+
+  // Compression
+  float CompressionRatio = 0.0f;
+  float LastDecodeTimeMs = 0.0f;
+
+  // Delta sync
+  int32 DeltaFetchCount = 0;
+  int64 SyncRevision = 0;
+
+  // Invalidation coalescing
+  int32 InvalidationEventCount = 0;
+  int32 InvalidationFlushCount = 0;
+
+  // Polling
+  EGatrixPollingMode PollingMode = EGatrixPollingMode::Normal;
 };
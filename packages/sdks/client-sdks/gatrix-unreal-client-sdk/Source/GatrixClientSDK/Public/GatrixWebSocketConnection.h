@@ -4,10 +4,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GatrixJson.h"
 #include "IWebSocket.h"
 
-DECLARE_DELEGATE_TwoParams(FGatrixWsEventDelegate, const FString& /*EventType*/,
-                           const FString& /*EventData*/);
+DECLARE_DELEGATE_OneParam(FGatrixWsEventDelegate, const FGatrixJson::FStreamingEvent& /*Event*/);
 DECLARE_DELEGATE(FGatrixWsConnectedDelegate);
 DECLARE_DELEGATE_OneParam(FGatrixWsErrorDelegate, const FString& /*ErrorMessage*/);
 DECLARE_DELEGATE(FGatrixWsDisconnectedDelegate);
@@ -15,7 +15,9 @@ DECLARE_DELEGATE(FGatrixWsDisconnectedDelegate);
 /**
  * WebSocket connection manager for streaming.
  * Uses UE4 IWebSocket (FWebSocketsModule). JSON messages with a "type" field
- * are dispatched as events. Includes client-side ping/pong keep-alive.
+ * are parsed once and dispatched as event views over their "data" object;
+ * binary frames (opt-in subprotocol) are decoded by FGatrixStreamCodec.
+ * Includes client-side ping/pong keep-alive.
  */
 class GATRIXCLIENTSDK_API FGatrixWebSocketConnection {
 public:
@@ -27,9 +29,10 @@ public:
    * @param Url Full WebSocket URL (ws:// or wss://)
    * @param Headers HTTP headers (X-API-Token, etc.)
    * @param PingIntervalSeconds Client-side ping interval
+   * @param bBinaryFrames Offer the binary event subprotocol (FGatrixStreamCodec)
    */
   void Connect(const FString& Url, const TMap<FString, FString>& Headers,
-               int32 PingIntervalSeconds = 30);
+               int32 PingIntervalSeconds = 30, bool bBinaryFrames = false);
 
   /** Disconnect and close WebSocket */
   void Disconnect();
@@ -56,6 +59,9 @@ private:
   /** Handle incoming WebSocket message */
   void HandleMessage(const FString& Message);
 
+  /** Handle a binary frame fragment; decoded once the last fragment arrives */
+  void HandleBinaryMessage(const void* Data, SIZE_T Size, bool bIsLastFragment);
+
   /** Start ping timer */
   void StartPingTimer(int32 IntervalSeconds);
 
@@ -68,6 +74,9 @@ private:
   /** UE4 WebSocket instance */
   TSharedPtr<IWebSocket> WebSocket;
 
+  /** Fragments of the binary frame being received */
+  TArray<uint8> BinaryBuffer;
+
   /** Connection state */
   bool bConnected = false;
   bool bDisconnecting = false;